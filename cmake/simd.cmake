@@ -13,6 +13,7 @@ if(CMAKE_COMPILER_IS_GNUCC
   set(AVX_FLAG "-mavx")
   set(AVX2_FLAG "-mavx2")
   set(AVX512F_FLAG "-mavx512f")
+  set(AVX512VNNI_FLAG "-mavx512f -mavx512vnni")
 elseif(MSVC)
   set(MMX_FLAG "/arch:MMX")
   set(SSE2_FLAG "/arch:SSE2")
@@ -121,6 +122,22 @@ int main()
 }"
   AVX512F_FOUND)
 
+# Check AVX512 VNNI. Only the compiler is checked, the kernels built with it
+# are picked at runtime on the CPUs that have it.
+if(AVX512VNNI_FLAG)
+  set(CMAKE_REQUIRED_FLAGS ${AVX512VNNI_FLAG})
+  check_cxx_source_compiles(
+    "
+#include <immintrin.h>
+int main()
+{
+    __m512i a = _mm512_set1_epi32(1);
+    __m512i result = _mm512_dpbusd_epi32(a, a, a);
+    return 0;
+}"
+    AVX512VNNI_FOUND)
+endif()
+
 set(CMAKE_REQUIRED_FLAGS ${CMAKE_REQUIRED_FLAGS_RETAINED})
 mark_as_advanced(MMX_FOUND SSE2_FOUND SSE3_FOUND AVX_FOUND AVX2_FOUND
-                 AVX512F_FOUND)
+                 AVX512F_FOUND AVX512VNNI_FOUND)
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "paddle/ir/builtin_trait.h"
 #include "paddle/ir/op_base.h"
 
 namespace paddle {
@@ -21,8 +22,8 @@ namespace dialect {
 
 #define OPNAME(op_name) "pd." #op_name
 
-#define REIGSTER_EMPTY_OP(op_name, className)                   \
-  class className : public ir::Op<className> {                  \
+#define REIGSTER_EMPTY_OP_WITH_BASE(op_name, className, ...)    \
+  class className : public __VA_ARGS__ {                        \
    public:                                                      \
     static const char *name() { return OPNAME(op_name); }       \
     static constexpr const char **attributes_name = nullptr;    \
@@ -34,12 +35,21 @@ namespace dialect {
     }                                                           \
   };
 
+#define REIGSTER_EMPTY_OP(op_name, className) \
+  REIGSTER_EMPTY_OP_WITH_BASE(op_name, className, ir::Op<className>)
+
+// Ops that transforms (dce, cse, constant folding) must keep untouched.
+#define REIGSTER_SIDE_EFFECT_EMPTY_OP(op_name, className) \
+  REIGSTER_EMPTY_OP_WITH_BASE(                            \
+      op_name, className, ir::Op<className, ir::SideEffectTrait>)
+
 // TODO(zhangbo): As operators are supplemented and defined, they are gradually
 // removed.
 REIGSTER_EMPTY_OP(conv2d, Conv2DOp);           // To be customized: conv2d
-REIGSTER_EMPTY_OP(feed, FeedOp);               // To be customized: feed
+REIGSTER_SIDE_EFFECT_EMPTY_OP(feed, FeedOp);  // To be customized: feed
 REIGSTER_EMPTY_OP(batch_norm, BatchNormOp);    // To be customized: batch_norm
-REIGSTER_EMPTY_OP(batch_norm_, BatchNormOp_);  // To be customized: batch_norm_
+REIGSTER_SIDE_EFFECT_EMPTY_OP(batch_norm_,
+                              BatchNormOp_);  // To be customized: batch_norm_
 REIGSTER_EMPTY_OP(elementwise_add,
                   ElementwiseAddOp);  // To be customized: add (elementwise_add)
 REIGSTER_EMPTY_OP(pool2d, Pool2DOp);  // To be customized: pool2d
@@ -78,7 +88,8 @@ REIGSTER_EMPTY_OP(batch_norm_grad,
                   BatchNormGradOp);  // To be customized: batch_norm_grad
 REIGSTER_EMPTY_OP(conv2d_grad, Conv2DGradOp);  // To be customized: conv2d_grad
 REIGSTER_EMPTY_OP(sum, SumOp);           // To be customized: sum(reduce_sum)
-REIGSTER_EMPTY_OP(fetch_v2, FetchV2Op);  // To be customized: fetch_v2
+REIGSTER_SIDE_EFFECT_EMPTY_OP(fetch_v2,
+                              FetchV2Op);  // To be customized: fetch_v2
 REIGSTER_EMPTY_OP(add, AddOp);
 REIGSTER_EMPTY_OP(add_grad, AddGradOp);
 REIGSTER_EMPTY_OP(matmul, MatMulOp);
@@ -29,6 +29,7 @@ H_FILE_TEMPLATE = """#ifdef GET_OP_LIST
 {op_declare}
 #else
 
+#include "paddle/ir/builtin_trait.h"
 #include "paddle/ir/op_base.h"
 
 {input}
@@ -61,6 +62,25 @@ OP_GET_INPUT_TEMPLATE = """  ir::OpOperand {input_name}() {{ return operation()-
 OP_GET_OUTPUT_TEMPLATE = """  ir::OpResult {output_name}() {{ return operation()->GetResultByIndex({output_index}); }}
 """
 
+# Ops which consume random state or have other effects that are not visible
+# through their outputs. Together with inplace ops they are marked by
+# ir::SideEffectTrait, so that transforms keep them untouched.
+SIDE_EFFECT_OPS = {
+    'bernoulli',
+    'dropout',
+    'dropout_nd',
+    'fused_dropout_add',
+    'gaussian',
+    'multinomial',
+    'poisson',
+    'randint',
+    'randperm',
+    'seed',
+    'truncated_gaussian_random',
+    'uniform',
+    'uniform_inplace',
+}
+
 # =====================================
 # String Template for cc file code gen
 # =====================================
@@ -198,6 +218,8 @@ class OpInfoParser:
         self.attribute_type_list = self.parse_attribute_type_list()
         self.cross_check(self.attribute_name_list, self.attribute_type_list)
 
+        self.has_side_effect = self.parse_has_side_effect()
+
     def cross_check(self, name_list, type_list, optional_list=None):
         assert len(name_list) == len(
             type_list
@@ -304,6 +326,11 @@ class OpInfoParser:
     def parse_op_phi_name(self):
         return self.op_yaml_item['name']
 
+    def parse_has_side_effect(self):
+        if self.op_phi_name in SIDE_EFFECT_OPS:
+            return True
+        return bool(self.op_yaml_item.get('inplace'))
+
 
 def to_pascal_case(s):
     words = s.split("_")
@@ -358,13 +385,15 @@ def OpGenerator(
         op_attribute_type_list = op_info.attribute_type_list
         op_interfaces = []
         op_traits = []
+        if op_info.has_side_effect:
+            op_traits.append("ir::SideEffectTrait")
 
         # gen interface/trait str
         op_interfaces_str = ""
         if len(op_interfaces) > 0:
             op_interfaces_str = "," + ",".join(op_interfaces)
         op_traits_str = ""
-        if len(op_interfaces) > 0:
+        if len(op_traits) > 0:
             op_traits_str = "," + ",".join(op_traits)
 
         op_get_inputs_outputs_str = ""
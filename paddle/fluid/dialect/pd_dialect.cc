@@ -23,11 +23,107 @@
 #include "paddle/fluid/dialect/utils.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_type.h"
+#include "paddle/ir/bytecode.h"
 #include "paddle/ir/dialect_interface.h"
 #include "paddle/phi/core/dense_tensor.h"
 
 namespace paddle {
 namespace dialect {
+namespace {
+enum class AttributeKind : uint64_t {
+  kIntArray = 0,
+  kScalar,
+  kDataType,
+  kPlace,
+  kDataLayout,
+};
+
+void WriteScalar(const phi::Scalar &scalar, ir::BytecodeWriter *writer) {
+  writer->WriteVarInt(static_cast<uint64_t>(scalar.dtype()));
+  writer->WriteVarInt(scalar.FromTensor());
+  switch (scalar.dtype()) {
+    case phi::DataType::BOOL:
+      writer->WriteVarInt(scalar.to<bool>());
+      break;
+    case phi::DataType::INT8:
+    case phi::DataType::INT16:
+    case phi::DataType::INT32:
+    case phi::DataType::INT64:
+      writer->WriteSignedVarInt(scalar.to<int64_t>());
+      break;
+    case phi::DataType::UINT8:
+    case phi::DataType::UINT16:
+    case phi::DataType::UINT32:
+    case phi::DataType::UINT64:
+      writer->WriteVarInt(scalar.to<uint64_t>());
+      break;
+    case phi::DataType::FLOAT16:
+    case phi::DataType::BFLOAT16:
+    case phi::DataType::FLOAT32:
+      writer->WriteFloat(scalar.to<float>());
+      break;
+    case phi::DataType::FLOAT64:
+      writer->WriteDouble(scalar.to<double>());
+      break;
+    default:
+      PADDLE_THROW(phi::errors::Unimplemented(
+          "Serializing a scalar of %s is not supported.", scalar.dtype()));
+  }
+}
+
+phi::Scalar ReadScalar(ir::BytecodeReader *reader) {
+  auto dtype = static_cast<phi::DataType>(reader->ReadVarInt());
+  bool from_tensor = reader->ReadVarInt() != 0;
+  phi::Scalar scalar;
+  switch (dtype) {
+    case phi::DataType::BOOL:
+      scalar = phi::Scalar(reader->ReadVarInt() != 0);
+      break;
+    case phi::DataType::INT8:
+      scalar = phi::Scalar(static_cast<int8_t>(reader->ReadSignedVarInt()));
+      break;
+    case phi::DataType::INT16:
+      scalar = phi::Scalar(static_cast<int16_t>(reader->ReadSignedVarInt()));
+      break;
+    case phi::DataType::INT32:
+      scalar = phi::Scalar(static_cast<int32_t>(reader->ReadSignedVarInt()));
+      break;
+    case phi::DataType::INT64:
+      scalar = phi::Scalar(static_cast<int64_t>(reader->ReadSignedVarInt()));
+      break;
+    case phi::DataType::UINT8:
+      scalar = phi::Scalar(static_cast<uint8_t>(reader->ReadVarInt()));
+      break;
+    case phi::DataType::UINT16:
+      scalar = phi::Scalar(static_cast<uint16_t>(reader->ReadVarInt()));
+      break;
+    case phi::DataType::UINT32:
+      scalar = phi::Scalar(static_cast<uint32_t>(reader->ReadVarInt()));
+      break;
+    case phi::DataType::UINT64:
+      scalar = phi::Scalar(static_cast<uint64_t>(reader->ReadVarInt()));
+      break;
+    case phi::DataType::FLOAT16:
+      scalar = phi::Scalar(phi::dtype::float16(reader->ReadFloat()));
+      break;
+    case phi::DataType::BFLOAT16:
+      scalar = phi::Scalar(phi::dtype::bfloat16(reader->ReadFloat()));
+      break;
+    case phi::DataType::FLOAT32:
+      scalar = phi::Scalar(reader->ReadFloat());
+      break;
+    case phi::DataType::FLOAT64:
+      scalar = phi::Scalar(reader->ReadDouble());
+      break;
+    default:
+      PADDLE_THROW(phi::errors::InvalidArgument(
+          "Invalid scalar data type %s in the bytecode.", dtype));
+  }
+  scalar.SetFromTensor(from_tensor);
+  return scalar;
+}
+}  // namespace
+
 std::shared_ptr<paddle::framework::Variable>
 ParameterConvertInterface::ParameterToVariable(ir::Parameter *parameter) {
   if (parameter->type().isa<DenseTensorType>()) {
@@ -162,5 +258,113 @@ void PaddleDialect::PrintType(ir::Type type, std::ostream &os) {
   os << ">";
 }
 
+void PaddleDialect::WriteType(ir::Type type, ir::BytecodeWriter *writer) const {
+  DenseTensorType tensor_type = type.dyn_cast<DenseTensorType>();
+  PADDLE_ENFORCE_EQ(static_cast<bool>(tensor_type),
+                    true,
+                    phi::errors::Unimplemented(
+                        "Only DenseTensorType of pd dialect can be written."));
+  writer->WriteType(tensor_type.dtype());
+  writer->WriteVarInt(tensor_type.dim().size());
+  for (auto d : tensor_type.dim()) {
+    writer->WriteSignedVarInt(d);
+  }
+  writer->WriteVarInt(static_cast<uint64_t>(tensor_type.data_layout()));
+  writer->WriteVarInt(tensor_type.lod().size());
+  for (auto &level : tensor_type.lod()) {
+    writer->WriteVarInt(level.size());
+    for (auto offset : level) {
+      writer->WriteVarInt(offset);
+    }
+  }
+  writer->WriteVarInt(tensor_type.offset());
+}
+
+ir::Type PaddleDialect::ReadType(ir::BytecodeReader *reader) const {
+  ir::Type dtype = reader->ReadType();
+  DenseTensorTypeStorage::Dim dims(reader->ReadCount());
+  for (auto &d : dims) {
+    d = reader->ReadSignedVarInt();
+  }
+  auto layout =
+      static_cast<DenseTensorTypeStorage::DataLayout>(reader->ReadVarInt());
+  DenseTensorTypeStorage::LoD lod(reader->ReadCount());
+  for (auto &level : lod) {
+    level.resize(reader->ReadCount());
+    for (auto &offset : level) {
+      offset = reader->ReadVarInt();
+    }
+  }
+  size_t offset = reader->ReadVarInt();
+  return DenseTensorType::get(
+      reader->ir_context(), dtype, dims, layout, lod, offset);
+}
+
+void PaddleDialect::WriteAttribute(ir::Attribute attr,
+                                   ir::BytecodeWriter *writer) const {
+  if (attr.isa<IntArrayAttribute>()) {
+    phi::IntArray data = attr.dyn_cast<IntArrayAttribute>().data();
+    writer->WriteVarInt(static_cast<uint64_t>(AttributeKind::kIntArray));
+    writer->WriteVarInt(data.FromTensor());
+    writer->WriteVarInt(data.GetData().size());
+    for (auto value : data.GetData()) {
+      writer->WriteSignedVarInt(value);
+    }
+  } else if (attr.isa<ScalarAttribute>()) {
+    writer->WriteVarInt(static_cast<uint64_t>(AttributeKind::kScalar));
+    WriteScalar(attr.dyn_cast<ScalarAttribute>().data(), writer);
+  } else if (attr.isa<DataTypeAttribute>()) {
+    writer->WriteVarInt(static_cast<uint64_t>(AttributeKind::kDataType));
+    writer->WriteVarInt(
+        static_cast<uint64_t>(attr.dyn_cast<DataTypeAttribute>().data()));
+  } else if (attr.isa<PlaceAttribute>()) {
+    phi::Place place = attr.dyn_cast<PlaceAttribute>().data();
+    writer->WriteVarInt(static_cast<uint64_t>(AttributeKind::kPlace));
+    writer->WriteVarInt(static_cast<uint64_t>(place.GetType()));
+    writer->WriteSignedVarInt(place.GetDeviceId());
+    writer->WriteString(place.GetDeviceType());
+  } else if (attr.isa<DataLayoutAttribute>()) {
+    writer->WriteVarInt(static_cast<uint64_t>(AttributeKind::kDataLayout));
+    writer->WriteVarInt(
+        static_cast<uint64_t>(attr.dyn_cast<DataLayoutAttribute>().data()));
+  } else {
+    PADDLE_THROW(phi::errors::Unimplemented(
+        "The attribute of pd dialect can not be written."));
+  }
+}
+
+ir::Attribute PaddleDialect::ReadAttribute(ir::BytecodeReader *reader) const {
+  ir::IrContext *ctx = reader->ir_context();
+  switch (static_cast<AttributeKind>(reader->ReadVarInt())) {
+    case AttributeKind::kIntArray: {
+      bool from_tensor = reader->ReadVarInt() != 0;
+      std::vector<int64_t> data(reader->ReadCount());
+      for (auto &value : data) {
+        value = reader->ReadSignedVarInt();
+      }
+      phi::IntArray int_array(data);
+      int_array.SetFromTensor(from_tensor);
+      return IntArrayAttribute::get(ctx, int_array);
+    }
+    case AttributeKind::kScalar:
+      return ScalarAttribute::get(ctx, ReadScalar(reader));
+    case AttributeKind::kDataType:
+      return DataTypeAttribute::get(
+          ctx, static_cast<phi::DataType>(reader->ReadVarInt()));
+    case AttributeKind::kPlace: {
+      auto type = static_cast<phi::AllocationType>(reader->ReadVarInt());
+      auto device_id = static_cast<int8_t>(reader->ReadSignedVarInt());
+      const std::string &device_type = reader->ReadString();
+      return PlaceAttribute::get(ctx,
+                                 phi::Place(type, device_id, device_type));
+    }
+    case AttributeKind::kDataLayout:
+      return DataLayoutAttribute::get(
+          ctx, static_cast<phi::DataLayout>(reader->ReadVarInt()));
+  }
+  PADDLE_THROW(phi::errors::InvalidArgument(
+      "Invalid attribute kind of pd dialect in the bytecode."));
+}
+
 }  // namespace dialect
 }  // namespace paddle
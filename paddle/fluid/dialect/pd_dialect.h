@@ -41,6 +41,15 @@ class PaddleDialect : public ir::Dialect {
 
   void PrintType(ir::Type type, std::ostream& os);
 
+  void WriteType(ir::Type type, ir::BytecodeWriter* writer) const override;
+
+  ir::Type ReadType(ir::BytecodeReader* reader) const override;
+
+  void WriteAttribute(ir::Attribute attr,
+                      ir::BytecodeWriter* writer) const override;
+
+  ir::Attribute ReadAttribute(ir::BytecodeReader* reader) const override;
+
  private:
   void initialize();
 };
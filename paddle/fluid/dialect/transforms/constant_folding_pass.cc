@@ -0,0 +1,318 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/dialect/transforms/constant_folding_pass.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/fluid/dialect/pd_attribute.h"
+#include "paddle/fluid/dialect/pd_dialect.h"
+#include "paddle/fluid/dialect/pd_type.h"
+#include "paddle/fluid/dialect/utils.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/ir/builtin_attribute.h"
+#include "paddle/ir/builtin_op.h"
+#include "paddle/ir/builtin_trait.h"
+#include "paddle/ir/ir_context.h"
+#include "paddle/ir/op_info_impl.h"
+#include "paddle/ir/program.h"
+#include "paddle/pass/pass.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/kernel_factory.h"
+
+namespace paddle {
+namespace dialect {
+
+namespace {
+
+template <typename T, typename IrAttribute>
+bool ConvertArrayAttribute(ir::Attribute attr, phi::Attribute *out) {
+  if (!attr.isa<ir::ArrayAttribute>()) return false;
+  std::vector<T> data;
+  for (auto &element : attr.dyn_cast<ir::ArrayAttribute>().data()) {
+    if (!element.isa<IrAttribute>()) return false;
+    data.push_back(element.dyn_cast<IrAttribute>().data());
+  }
+  *out = std::move(data);
+  return true;
+}
+
+template <typename IrAttribute>
+bool ConvertAttribute(ir::Attribute attr, phi::Attribute *out) {
+  if (!attr.isa<IrAttribute>()) return false;
+  *out = attr.dyn_cast<IrAttribute>().data();
+  return true;
+}
+
+// Convert an attribute of the new ir to the attribute expected by the kernel
+// argument. Returns false if they do not match.
+bool ConvertAttribute(ir::Attribute attr,
+                      phi::AttributeType type,
+                      phi::Attribute *out) {
+  switch (type) {
+    case phi::AttributeType::BOOL:
+      return ConvertAttribute<ir::BoolAttribute>(attr, out);
+    case phi::AttributeType::INT32:
+      return ConvertAttribute<ir::Int32_tAttribute>(attr, out);
+    case phi::AttributeType::INT64:
+      return ConvertAttribute<ir::Int64_tAttribute>(attr, out);
+    case phi::AttributeType::FLOAT32:
+      return ConvertAttribute<ir::FloatAttribute>(attr, out);
+    case phi::AttributeType::FLOAT64:
+      return ConvertAttribute<ir::DoubleAttribute>(attr, out);
+    case phi::AttributeType::STRING:
+      return ConvertAttribute<ir::StrAttribute>(attr, out);
+    case phi::AttributeType::BOOLS:
+      return ConvertArrayAttribute<bool, ir::BoolAttribute>(attr, out);
+    case phi::AttributeType::INT32S:
+      return ConvertArrayAttribute<int, ir::Int32_tAttribute>(attr, out);
+    case phi::AttributeType::INT64S:
+      return ConvertArrayAttribute<int64_t, ir::Int64_tAttribute>(attr, out);
+    case phi::AttributeType::FLOAT32S:
+      return ConvertArrayAttribute<float, ir::FloatAttribute>(attr, out);
+    case phi::AttributeType::FLOAT64S:
+      return ConvertArrayAttribute<double, ir::DoubleAttribute>(attr, out);
+    case phi::AttributeType::STRINGS:
+      return ConvertArrayAttribute<std::string, ir::StrAttribute>(attr, out);
+    case phi::AttributeType::SCALAR:
+      return ConvertAttribute<ScalarAttribute>(attr, out);
+    case phi::AttributeType::SCALARS:
+      return ConvertArrayAttribute<phi::Scalar, ScalarAttribute>(attr, out);
+    case phi::AttributeType::INT_ARRAY:
+      return ConvertAttribute<IntArrayAttribute>(attr, out);
+    case phi::AttributeType::DATA_TYPE:
+      return ConvertAttribute<DataTypeAttribute>(attr, out);
+    case phi::AttributeType::DATA_LAYOUT:
+      return ConvertAttribute<DataLayoutAttribute>(attr, out);
+    case phi::AttributeType::PLACE:
+      return ConvertAttribute<PlaceAttribute>(attr, out);
+    default:
+      return false;
+  }
+}
+
+bool IsStaticDenseTensorType(ir::Type type) {
+  if (!type.isa<DenseTensorType>()) return false;
+  for (auto dim : type.dyn_cast<DenseTensorType>().dim()) {
+    if (dim < 0) return false;
+  }
+  return true;
+}
+
+phi::DenseTensorMeta MakeTensorMeta(ir::Type type) {
+  auto tensor_type = type.dyn_cast<DenseTensorType>();
+  auto &dim = tensor_type.dim();
+  return phi::DenseTensorMeta(TransToPhiDataType(tensor_type.dtype()),
+                              phi::DDim(dim.data(), dim.size()),
+                              TransToPhiDataLayout(tensor_type.data_layout()),
+                              tensor_type.lod(),
+                              tensor_type.offset());
+}
+
+class ConstantFoldingPass : public ir::ProgramPass {
+ public:
+  ConstantFoldingPass() : ir::ProgramPass("ConstantFoldingPass", 2) {}
+
+  bool Initialize(ir::IrContext *context) override {
+    context_ = context;
+    get_parameter_info_ =
+        context->GetRegisteredOpInfo(ir::GetParameterOp::name());
+    return static_cast<bool>(get_parameter_info_);
+  }
+
+  void RunOnProgram(ir::Program *program) override {
+    CollectMutableParameters(program);
+    ir::Block *block = program->block();
+    size_t num_folded = 0;
+    for (auto it = block->begin(); it != block->end();) {
+      ir::Operation *op = *it;
+      std::vector<std::unique_ptr<ir::Parameter>> outputs;
+      if (!CanBeFolded(op, program) || !Evaluate(op, program, &outputs)) {
+        ++it;
+        continue;
+      }
+      VLOG(4) << "Fold op: " << op->op_name();
+      for (uint32_t i = 0; i < op->num_results(); ++i) {
+        std::string name = "constant_folding@" + std::to_string(op_counter_++);
+        program->SetParameter(name, std::move(outputs[i]));
+        ir::Operation *get_parameter_op = ir::Operation::create(
+            {},
+            {op->GetResultByIndex(i).type()},
+            {{"parameter_name", ir::StrAttribute::get(context_, name)}},
+            get_parameter_info_);
+        block->insert(it, get_parameter_op);
+        get_parameter_op->set_parent_program(program);
+        op->GetResultByIndex(i).ReplaceAllUsesWith(
+            get_parameter_op->GetResultByIndex(0));
+      }
+      it = block->erase(it);
+      ++num_folded;
+    }
+    VLOG(3) << info_.name << " folded " << num_folded << " ops.";
+  }
+
+ private:
+  // Parameters which may change while the program runs are not constant.
+  void CollectMutableParameters(ir::Program *program) {
+    mutable_parameters_.clear();
+    for (auto *op : *program->block()) {
+      if (op->dyn_cast<ir::SetParameterOp>()) {
+        mutable_parameters_.insert(op->attribute()
+                                       .at("parameter_name")
+                                       .dyn_cast<ir::StrAttribute>()
+                                       .data());
+      }
+    }
+  }
+
+  ir::Parameter *GetConstantParameter(ir::Value value,
+                                      ir::Program *program) const {
+    ir::Operation *def_op = value.GetDefiningOp();
+    if (def_op == nullptr || !def_op->dyn_cast<ir::GetParameterOp>()) {
+      return nullptr;
+    }
+    std::string name = def_op->attribute()
+                           .at("parameter_name")
+                           .dyn_cast<ir::StrAttribute>()
+                           .data();
+    ir::Parameter *parameter = program->GetParameter(name);
+    if (parameter == nullptr || parameter->is_mutable() ||
+        mutable_parameters_.count(name) != 0) {
+      return nullptr;
+    }
+    return parameter;
+  }
+
+  bool CanBeFolded(ir::Operation *op, ir::Program *program) const {
+    if (op->op_info().impl()->dialect()->name() != PaddleDialect::name() ||
+        op->HasTrait<ir::SideEffectTrait>() || op->num_operands() == 0 ||
+        op->num_results() == 0) {
+      return false;
+    }
+    for (uint32_t i = 0; i < op->num_operands(); ++i) {
+      ir::Value source = op->GetOperandByIndex(i).impl()->source();
+      if (!IsStaticDenseTensorType(source.type()) ||
+          GetConstantParameter(source, program) == nullptr) {
+        return false;
+      }
+    }
+    for (uint32_t i = 0; i < op->num_results(); ++i) {
+      if (!IsStaticDenseTensorType(op->GetResultByIndex(i).type())) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Run the CPU kernel of op. Inputs are taken from the parameters, and the
+  // output metas are taken from the result types, since ops of the new ir do
+  // not run InferMeta yet.
+  bool Evaluate(ir::Operation *op,
+                ir::Program *program,
+                std::vector<std::unique_ptr<ir::Parameter>> *outputs) const {
+    std::string op_name = op->op_name();
+    std::string kernel_name = op_name.substr(op_name.find('.') + 1);
+    ir::Type first_input_type =
+        op->GetOperandByIndex(0).impl()->source().type();
+    phi::KernelKey kernel_key(
+        phi::Backend::CPU,
+        phi::DataLayout::ALL_LAYOUT,
+        TransToPhiDataType(
+            first_input_type.dyn_cast<DenseTensorType>().dtype()));
+    const phi::Kernel &kernel =
+        phi::KernelFactory::Instance().SelectKernel(kernel_name, kernel_key);
+    if (!kernel.IsValid()) {
+      VLOG(6) << "No CPU kernel for " << op_name << ", skip folding.";
+      return false;
+    }
+
+    const phi::KernelArgsDef &args_def = kernel.args_def();
+    const ir::OpInfoImpl *op_info_impl = op->op_info().impl();
+    if (args_def.input_defs().size() != op->num_operands() ||
+        args_def.output_defs().size() != op->num_results() ||
+        args_def.attribute_defs().size() != op_info_impl->AttributeNum()) {
+      return false;
+    }
+
+    // Attributes are passed to the kernel in the order of declaration.
+    std::vector<phi::Attribute> attributes(op_info_impl->AttributeNum());
+    for (uint32_t i = 0; i < op_info_impl->AttributeNum(); ++i) {
+      auto iter = op->attribute().find(op_info_impl->GetAttributeByIndex(i));
+      if (iter == op->attribute().end() ||
+          !ConvertAttribute(iter->second,
+                            args_def.attribute_defs()[i].type_index,
+                            &attributes[i])) {
+        return false;
+      }
+    }
+
+    auto *dev_ctx = paddle::platform::DeviceContextPool::Instance().Get(
+        paddle::platform::CPUPlace());
+    auto *parameter_interface =
+        context_->GetRegisteredDialect<PaddleDialect>()
+            ->GetRegisteredInterface<ParameterConvertInterface>();
+
+    std::vector<std::shared_ptr<paddle::framework::Variable>> input_vars;
+    for (uint32_t i = 0; i < op->num_operands(); ++i) {
+      input_vars.push_back(parameter_interface->ParameterToVariable(
+          GetConstantParameter(op->GetOperandByIndex(i).impl()->source(),
+                               program)));
+    }
+    std::vector<paddle::framework::Variable> output_vars(op->num_results());
+
+    phi::KernelContext kernel_context(dev_ctx);
+    for (auto &var : input_vars) {
+      kernel_context.EmplaceBackInput(&var->Get<phi::DenseTensor>());
+    }
+    for (auto &attribute : attributes) {
+      kernel_context.EmplaceBackAttr(std::move(attribute));
+    }
+    for (uint32_t i = 0; i < op->num_results(); ++i) {
+      auto *tensor = output_vars[i].GetMutable<phi::DenseTensor>();
+      tensor->set_meta(MakeTensorMeta(op->GetResultByIndex(i).type()));
+      kernel_context.EmplaceBackOutput(tensor);
+    }
+    kernel(&kernel_context);
+
+    for (uint32_t i = 0; i < op->num_results(); ++i) {
+      auto parameter = parameter_interface->VariableToParameter(&output_vars[i]);
+      // The result type of op is kept, the kernel may only change the meta
+      // which the new ir does not model, e.g. lod.
+      if (parameter == nullptr ||
+          output_vars[i].Get<phi::DenseTensor>().dims() !=
+              MakeTensorMeta(op->GetResultByIndex(i).type()).dims) {
+        return false;
+      }
+      outputs->push_back(std::move(parameter));
+    }
+    return true;
+  }
+
+  ir::IrContext *context_{nullptr};
+  ir::OpInfo get_parameter_info_;
+  std::unordered_set<std::string> mutable_parameters_;
+  size_t op_counter_{0};
+};
+
+}  // namespace
+
+std::unique_ptr<ir::Pass> CreateConstantFoldingPass() {
+  return std::make_unique<ConstantFoldingPass>();
+}
+
+}  // namespace dialect
+}  // namespace paddle
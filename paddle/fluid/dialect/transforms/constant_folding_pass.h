@@ -0,0 +1,38 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+
+namespace ir {
+class Pass;
+}  // namespace ir
+
+namespace paddle {
+namespace dialect {
+
+///
+/// \brief Evaluate ops of PaddleDialect whose operands are all constant
+/// parameters (defined by GetParameterOp and never written by
+/// SetParameterOp) with the CPU phi kernel, store the results as new
+/// parameters of the program and replace the folded op by GetParameterOps.
+/// Ops with ir::SideEffectTrait, ops whose output shape is not static and ops
+/// whose attributes can not be matched to the kernel arguments are skipped.
+/// Operands left unused are removed by the dead code elimination pass.
+///
+std::unique_ptr<ir::Pass> CreateConstantFoldingPass();
+
+}  // namespace dialect
+}  // namespace paddle
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <iostream>
+#include <map>
 
 #ifdef _WIN32
 #include <gloo/common/win.h>
@@ -24,6 +25,8 @@
 #include <unistd.h>
 #endif
 
+#include <gloo/allreduce.h>
+#include <gloo/allreduce_halving_doubling.h>
 #include <gloo/broadcast.h>
 #include <gloo/gather.h>
 #include <gloo/reduce.h>
@@ -34,6 +37,11 @@
 #include "paddle/fluid/distributed/collective/process_group_gloo.h"
 #include "paddle/fluid/framework/fleet/gloo_wrapper.h"
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_string(gloo_allreduce_algo);
+PHI_DECLARE_int64(gloo_allreduce_small_bytes);
+PHI_DECLARE_int64(gloo_allreduce_large_bytes);
 
 namespace paddle {
 namespace distributed {
@@ -178,6 +186,36 @@ ProcessGroupGloo::GlooTask::GlooTask(
     int rank, const std::vector<phi::DenseTensor>& inputs, CommType comm_type)
     : ProcessGroup::Task(rank, inputs, comm_type) {}
 
+bool ProcessGroupGloo::GlooTask::Wait(std::chrono::milliseconds timeout) {
+  if (!is_async_) return true;
+  std::unique_lock<std::mutex> lock(mutex_);
+  bool done = true;
+  if (timeout == kWaitTimeout) {
+    cv_.wait(lock, [this] { return is_completed_; });
+  } else {
+    done = cv_.wait_for(lock, timeout, [this] { return is_completed_; });
+  }
+  if (exception_) std::rethrow_exception(exception_);
+  return done;
+}
+
+bool ProcessGroupGloo::GlooTask::IsCompleted() {
+  if (!is_async_) return true;
+  std::lock_guard<std::mutex> lock(mutex_);
+  return is_completed_;
+}
+
+void ProcessGroupGloo::GlooTask::Synchronize() { Wait(kWaitTimeout); }
+
+void ProcessGroupGloo::GlooTask::Finish(std::exception_ptr exception) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    exception_ = exception;
+    is_completed_ = true;
+  }
+  cv_.notify_all();
+}
+
 ProcessGroupGloo::ProcessGroupGloo(
     const std::shared_ptr<phi::distributed::Store>& store,
     int rank,
@@ -186,13 +224,71 @@ ProcessGroupGloo::ProcessGroupGloo(
     const std::shared_ptr<GlooOptions> options)
     : ProcessGroupWithoutStream(rank, world_size, gid),
       _tag(0),
-      _store(new GlooStore(store)) {
+      _store(new GlooStore(store)),
+      _options(options) {
   _context = std::make_shared<gloo::rendezvous::Context>(rank, world_size);
   auto prefix_store =
       ::gloo::rendezvous::PrefixStore(std::to_string(gid), *_store);
   _context->connectFullMesh(prefix_store, options->device);
 }
 
+ProcessGroupGloo::~ProcessGroupGloo() {
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stop_ = true;
+  }
+  queue_cv_.notify_all();
+  if (comm_thread_.joinable()) comm_thread_.join();
+}
+
+void ProcessGroupGloo::RunTask(GlooTask* task) {
+  WaitQueuedTasks();
+  task->Run();
+}
+
+void ProcessGroupGloo::EnqueueTask(const std::shared_ptr<GlooTask>& task) {
+  task->is_async_ = true;
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (!comm_thread_.joinable()) {
+      comm_thread_ = std::thread([this] { CommLoop(); });
+    }
+    task_queue_.push_back(task);
+    pending_tasks_++;
+  }
+  queue_cv_.notify_all();
+}
+
+void ProcessGroupGloo::WaitQueuedTasks() {
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  queue_cv_.wait(lock, [this] { return pending_tasks_ == 0; });
+}
+
+void ProcessGroupGloo::CommLoop() {
+  while (true) {
+    std::shared_ptr<GlooTask> task;
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      queue_cv_.wait(lock, [this] { return stop_ || !task_queue_.empty(); });
+      if (task_queue_.empty()) return;
+      task = std::move(task_queue_.front());
+      task_queue_.pop_front();
+    }
+    std::exception_ptr exception;
+    try {
+      task->Run();
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    task->Finish(exception);
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      pending_tasks_--;
+    }
+    queue_cv_.notify_all();
+  }
+}
+
 class BroadcastGlooTask : public ProcessGroupGloo::GlooTask {
  public:
   BroadcastGlooTask(const std::shared_ptr<gloo::Context>& context,
@@ -259,7 +355,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Broadcast(
   auto context = get_context();
   task = std::make_unique<BroadcastGlooTask>(
       context, inputs, outputs, rank_, root, tag);
-  task->Run();
+  RunTask(task.get());
   return task;
 }
 
@@ -308,7 +404,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Send(
   auto tag = next_tag();
   auto context = get_context();
   task = std::make_unique<SendGlooTask>(context, &inputs, rank_, dst_rank, tag);
-  task->Run();
+  RunTask(task.get());
 
   return task;
 }
@@ -360,10 +456,81 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Recv(
 
   task =
       std::make_unique<RecvGlooTask>(context, &outputs, rank_, src_rank, tag);
-  task->Run();
+  RunTask(task.get());
   return task;
 }
 
+template <typename T>
+const gloo::ReductionFunction<T>* get_reduction_function(const ReduceOp& r) {
+  switch (r) {
+    case ReduceOp::SUM:
+      return gloo::ReductionFunction<T>::sum;
+    case ReduceOp::PRODUCT:
+      return gloo::ReductionFunction<T>::product;
+    case ReduceOp::MIN:
+      return gloo::ReductionFunction<T>::min;
+    case ReduceOp::MAX:
+      return gloo::ReductionFunction<T>::max;
+    case ReduceOp::AVG:
+      VLOG(0) << "Error: Unsupported ReduceOp::AVG.";
+      exit(-1);
+  }
+
+  VLOG(0) << "Error: Unknown ReduceOp.";
+  exit(-1);
+}
+
+template <typename T>
+void set_reduce_function(gloo::AllreduceOptions& opts,  // NOLINT
+                         const ReduceOp op) {
+  opts.setReduceFunction(get_function<T>(op));
+}
+
+// gloo only ships recursive halving-doubling as an in-place algorithm
+// object, so the inputs are copied to the outputs and reduced there.
+template <typename T>
+void halving_doubling_allreduce(
+    const std::shared_ptr<gloo::Context>& context,
+    std::vector<phi::DenseTensor>& ins,   // NOLINT
+    std::vector<phi::DenseTensor>& outs,  // NOLINT
+    const ReduceOp op) {
+  for (size_t i = 0; i < ins.size(); i++) {
+    if (ins[i].data() != outs[i].data()) {
+      memcpy(outs[i].data(), ins[i].data(), ins[i].numel() * sizeof(T));
+    }
+  }
+  gloo::AllreduceHalvingDoubling<T> algorithm(context,
+                                              get_multi_data<T>(outs),
+                                              outs[0].numel(),
+                                              get_reduction_function<T>(op));
+  algorithm.run();
+}
+
+static void do_allreduce(const std::shared_ptr<gloo::Context>& context,
+                         std::vector<phi::DenseTensor>& ins,   // NOLINT
+                         std::vector<phi::DenseTensor>& outs,  // NOLINT
+                         const ReduceOp reduce_op,
+                         uint32_t tag,
+                         ProcessGroupGloo::AllreduceAlgo algo) {
+  const auto& dtype = ins[0].dtype();
+  if (algo == ProcessGroupGloo::AllreduceAlgo::HALVING_DOUBLING) {
+    GENERATE_FUNC(dtype, halving_doubling_allreduce, context, ins, outs,
+                  reduce_op);
+    return;
+  }
+  gloo::AllreduceOptions opts(context);
+  GENERATE_FUNC(dtype, set_inputs, opts, ins);
+  GENERATE_FUNC(dtype, set_outputs, opts, outs);
+  GENERATE_FUNC(dtype, set_reduce_function, opts, reduce_op);
+  if (algo == ProcessGroupGloo::AllreduceAlgo::BCUBE) {
+    opts.setAlgorithm(gloo::AllreduceOptions::Algorithm::BCUBE);
+  } else if (algo == ProcessGroupGloo::AllreduceAlgo::RING) {
+    opts.setAlgorithm(gloo::AllreduceOptions::Algorithm::RING);
+  }
+  opts.setTag(tag);
+  gloo::allreduce(opts);
+}
+
 class AllreduceGlooTask : public ProcessGroupGloo::GlooTask {
  public:
   AllreduceGlooTask(int rank,
@@ -371,15 +538,19 @@ class AllreduceGlooTask : public ProcessGroupGloo::GlooTask {
                     std::vector<phi::DenseTensor>& inputs,   // NOLINT
                     std::vector<phi::DenseTensor>& outputs,  // NOLINT
                     ReduceOp reduce_op,
-                    uint32_t tag)
+                    uint32_t tag,
+                    ProcessGroupGloo::AllreduceAlgo algo)
       : ProcessGroupGloo::GlooTask(rank, inputs, CommType::ALLREDUCE),
         _context(context),
         _inputs(inputs),
         _outputs(outputs),
         _reduce_op(reduce_op),
-        _tag(tag) {}
+        _tag(tag),
+        _algo(algo) {}
 
-  void Run() override { _do_allreduce(_inputs, _outputs); }
+  void Run() override {
+    do_allreduce(_context, _inputs, _outputs, _reduce_op, _tag, _algo);
+  }
 
  private:
   std::shared_ptr<gloo::Context> _context;
@@ -387,31 +558,76 @@ class AllreduceGlooTask : public ProcessGroupGloo::GlooTask {
   std::vector<phi::DenseTensor> _outputs;
   const ReduceOp _reduce_op;
   uint32_t _tag;
+  const ProcessGroupGloo::AllreduceAlgo _algo;
+};
 
-  gloo::AllreduceOptions::Func _get_function(const phi::DataType type,
-                                             const ReduceOp op) {
-    gloo::AllreduceOptions::Func fn;
-    GENERATE_FUNC(type, _get_function_impl, fn, op);
-    return fn;
+class CoalescedAllreduceGlooTask : public ProcessGroupGloo::GlooTask {
+ public:
+  // One allreduce of the packed tensors of one dtype.
+  struct Bucket {
+    std::vector<size_t> indices;
+    int64_t numel;
+    uint32_t tag;
+    ProcessGroupGloo::AllreduceAlgo algo;
+  };
+
+  CoalescedAllreduceGlooTask(int rank,
+                             const std::shared_ptr<gloo::Context>& context,
+                             std::vector<phi::DenseTensor>& tensors,  // NOLINT
+                             std::vector<Bucket>&& buckets,
+                             ReduceOp reduce_op)
+      : ProcessGroupGloo::GlooTask(rank, tensors, CommType::ALLREDUCE),
+        _context(context),
+        _tensors(tensors),
+        _buckets(std::move(buckets)),
+        _reduce_op(reduce_op) {}
+
+  void Run() override {
+    for (auto& bucket : _buckets) {
+      auto dtype = _tensors[bucket.indices[0]].dtype();
+      size_t elem_size = phi::SizeOf(dtype);
+      phi::DenseTensor flat;
+      flat.Resize(phi::make_ddim({bucket.numel}));
+      auto* data =
+          static_cast<char*>(flat.mutable_data(platform::CPUPlace(), dtype));
+      size_t offset = 0;
+      for (auto idx : bucket.indices) {
+        size_t bytes = _tensors[idx].numel() * elem_size;
+        memcpy(data + offset, _tensors[idx].data(), bytes);
+        offset += bytes;
+      }
+      std::vector<phi::DenseTensor> in_out{flat};
+      do_allreduce(
+          _context, in_out, in_out, _reduce_op, bucket.tag, bucket.algo);
+      offset = 0;
+      for (auto idx : bucket.indices) {
+        size_t bytes = _tensors[idx].numel() * elem_size;
+        memcpy(_tensors[idx].data(), data + offset, bytes);
+        offset += bytes;
+      }
+    }
   }
 
-  template <typename T>
-  void _get_function_impl(gloo::AllreduceOptions::Func& fn,  // NOLINT
-                          const ReduceOp op) {
-    fn = get_function<T>(op);
-  }
+ private:
+  std::shared_ptr<gloo::Context> _context;
+  std::vector<phi::DenseTensor> _tensors;
+  std::vector<Bucket> _buckets;
+  const ReduceOp _reduce_op;
+};
 
-  void _do_allreduce(std::vector<phi::DenseTensor>& ins,     // NOLINT
-                     std::vector<phi::DenseTensor>& outs) {  // NOLINT
-    const auto& dtype = ins[0].dtype();
-    gloo::AllreduceOptions opts(_context);
-    GENERATE_FUNC(dtype, set_inputs, opts, ins);
-    GENERATE_FUNC(dtype, set_outputs, opts, outs);
-    opts.setReduceFunction(_get_function(dtype, _reduce_op));
-    opts.setTag(_tag);
-    gloo::allreduce(opts);
+ProcessGroupGloo::AllreduceAlgo ProcessGroupGloo::SelectAllreduceAlgo(
+    int64_t bytes) const {
+  if (_options->allreduce_algo != AllreduceAlgo::AUTO) {
+    return _options->allreduce_algo;
   }
-};
+  if (bytes <= _options->allreduce_small_bytes) {
+    return AllreduceAlgo::BCUBE;
+  }
+  if (bytes <= _options->allreduce_large_bytes) {
+    return AllreduceAlgo::HALVING_DOUBLING;
+  }
+  return AllreduceAlgo::RING;
+}
 
 std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
     phi::DenseTensor* out_tensor,
@@ -420,7 +636,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
     bool sync_op) {
   std::vector<phi::DenseTensor> in_wrapper{in_tensor};
   std::vector<phi::DenseTensor> out_wrapper{*out_tensor};
-  return AllReduce(in_wrapper, out_wrapper, opts, true);
+  return AllReduce(in_wrapper, out_wrapper, opts, sync_op);
 }
 
 std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
@@ -438,9 +654,46 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
   auto tag = next_tag();
   std::shared_ptr<GlooTask> task;
   auto context = get_context();
+  auto algo = SelectAllreduceAlgo(inputs[0].numel() *
+                                  phi::SizeOf(inputs[0].dtype()));
   task = std::make_shared<AllreduceGlooTask>(
-      rank_, context, inputs, outputs, opts.reduce_op, tag);
-  task->Run();
+      rank_, context, inputs, outputs, opts.reduce_op, tag, algo);
+  if (sync_op) {
+    RunTask(task.get());
+  } else {
+    // The task keeps the tensors alive until the communication thread has
+    // reduced them, Wait() on it before reading the outputs.
+    EnqueueTask(task);
+  }
+  return task;
+}
+
+std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduceCoalesced(
+    std::vector<phi::DenseTensor>& tensors,
+    const AllreduceOptions& opts,
+    bool sync_op) {
+  // Ordered by dtype, so every rank issues the buckets in the same order.
+  std::map<phi::DataType, CoalescedAllreduceGlooTask::Bucket> groups;
+  for (size_t i = 0; i < tensors.size(); i++) {
+    auto& bucket = groups[tensors[i].dtype()];
+    if (bucket.indices.empty()) bucket.numel = 0;
+    bucket.indices.push_back(i);
+    bucket.numel += tensors[i].numel();
+  }
+  std::vector<CoalescedAllreduceGlooTask::Bucket> buckets;
+  for (auto& item : groups) {
+    auto& bucket = item.second;
+    bucket.tag = next_tag();
+    bucket.algo = SelectAllreduceAlgo(bucket.numel * phi::SizeOf(item.first));
+    buckets.push_back(std::move(bucket));
+  }
+  std::shared_ptr<GlooTask> task = std::make_shared<CoalescedAllreduceGlooTask>(
+      rank_, get_context(), tensors, std::move(buckets), opts.reduce_op);
+  if (sync_op) {
+    RunTask(task.get());
+  } else {
+    EnqueueTask(task);
+  }
   return task;
 }
 
@@ -467,7 +720,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Barrier(
   std::shared_ptr<BarrierGlooTask> task;
   auto context = get_context();
   task = std::make_shared<BarrierGlooTask>(rank_, context);
-  task->Run();
+  RunTask(task.get());
   return task;
 }
 
@@ -529,7 +782,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllGather(
   auto context = get_context();
   task = std::make_shared<AllgatherGlooTask>(
       rank_, context, in_tensors, out_tensors, tag);
-  task->Run();
+  RunTask(task.get());
   return task;
 }
 
@@ -605,7 +858,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Reduce(
                                           opts.reduce_op,
                                           opts.root_rank,
                                           tag);
-  task->Run();
+  RunTask(task.get());
   return task;
 }
 
@@ -670,7 +923,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Scatter(
   std::vector<phi::DenseTensor> out_wrapper{*out_tensor};
   task = std::make_shared<ScatterGlooTask>(
       rank_, context, in_wrapper, out_wrapper, opts.root_rank, size_, tag);
-  task->Run();
+  RunTask(task.get());
   return task;
 }
 
@@ -736,7 +989,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Gather(
   auto context = get_context();
   task = std::make_shared<GatherGlooTask>(
       rank_, context, in_tensor, out_tensor, opts.root_rank, tag);
-  task->Run();
+  RunTask(task.get());
   return task;
 }
 
@@ -797,6 +1050,23 @@ std::shared_ptr<ProcessGroupGloo> ProcessGroupGloo::CreateProcessGroupGloo(
     int gid) {
   std::string GLOO_SOCKET_IFNAME_ENV = "GLOO_SOCKET_IFNAME";
   auto opts = GlooOptions::create();
+  const auto& algo = FLAGS_gloo_allreduce_algo;
+  if (algo == "auto") {
+    opts->allreduce_algo = AllreduceAlgo::AUTO;
+  } else if (algo == "ring") {
+    opts->allreduce_algo = AllreduceAlgo::RING;
+  } else if (algo == "bcube") {
+    opts->allreduce_algo = AllreduceAlgo::BCUBE;
+  } else if (algo == "halving_doubling") {
+    opts->allreduce_algo = AllreduceAlgo::HALVING_DOUBLING;
+  } else {
+    PADDLE_THROW(platform::errors::InvalidArgument(
+        "FLAGS_gloo_allreduce_algo should be one of auto, ring, bcube and "
+        "halving_doubling, but received %s.",
+        algo));
+  }
+  opts->allreduce_small_bytes = FLAGS_gloo_allreduce_small_bytes;
+  opts->allreduce_large_bytes = FLAGS_gloo_allreduce_large_bytes;
   char* ifname = getenv(GLOO_SOCKET_IFNAME_ENV.c_str());
   if (ifname && strlen(ifname) > 1) {
     opts->device =
@@ -14,9 +14,13 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <thread>
 
 #include "paddle/fluid/distributed/collective/process_group.h"
 #include "paddle/fluid/distributed/collective/process_group_without_stream.h"
@@ -42,12 +46,21 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
     ~GlooTask() = default;
 
     virtual void Run() = 0;
-    bool Wait(std::chrono::milliseconds timeout) override { return true; }
-    bool IsCompleted() override { return true; }
-    void Synchronize() override {}
+    // Tasks run in place are complete when returned, the others complete
+    // once the communication thread has run them.
+    bool Wait(std::chrono::milliseconds timeout) override;
+    bool IsCompleted() override;
+    void Synchronize() override;
 
    protected:
     friend class ProcessGroupGloo;
+
+   private:
+    void Finish(std::exception_ptr exception);
+
+    bool is_async_{false};
+    std::condition_variable cv_;
+    std::exception_ptr exception_;
   };
 
   class GlooStore : public ::gloo::rendezvous::Store {
@@ -89,6 +102,8 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
     std::shared_ptr<phi::distributed::Store> _store;
   };
 
+  enum class AllreduceAlgo { AUTO, RING, BCUBE, HALVING_DOUBLING };
+
   class GlooOptions {
    public:
     GlooOptions() = default;
@@ -97,6 +112,11 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
       return std::make_shared<GlooOptions>();
     }
     std::shared_ptr<::gloo::transport::Device> device;
+    // In AUTO mode, messages up to allreduce_small_bytes use bcube, up to
+    // allreduce_large_bytes halving-doubling and larger ones ring.
+    AllreduceAlgo allreduce_algo{AllreduceAlgo::AUTO};
+    int64_t allreduce_small_bytes{64 << 10};
+    int64_t allreduce_large_bytes{4 << 20};
   };
 
   ProcessGroupGloo(const std::shared_ptr<phi::distributed::Store>& store,
@@ -111,7 +131,7 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
       int world_size,
       int gid);
 
-  ~ProcessGroupGloo() = default;
+  ~ProcessGroupGloo();
 
   std::shared_ptr<ProcessGroup::Task> AllGather(
       phi::DenseTensor* out_tensor,
@@ -207,6 +227,15 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
       std::vector<phi::DenseTensor>& out_tensors,
       const ScatterOptions&) override;
 
+  // Packs the tensors of each dtype into one buffer and reduces it with a
+  // single allreduce, which saves the per-call latency of small tensors.
+  std::shared_ptr<ProcessGroup::Task> AllReduceCoalesced(
+      std::vector<phi::DenseTensor>& tensors,  // NOLINT
+      const AllreduceOptions& opts,
+      bool sync_op);
+
+  AllreduceAlgo SelectAllreduceAlgo(int64_t bytes) const;
+
   std::shared_ptr<::gloo::Context> get_context() { return _context; }
   uint64_t next_tag() { return _tag++; }
 
@@ -233,9 +262,27 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
   static std::shared_ptr<::gloo::transport::Device> createDefaultDevice();
 
  private:
+  // Runs task in place once the queued asynchronous tasks are done, so
+  // every rank issues its collectives in the same order.
+  void RunTask(GlooTask* task);
+  // Hands task to the communication thread, which runs queued tasks one
+  // by one in submission order.
+  void EnqueueTask(const std::shared_ptr<GlooTask>& task);
+  void WaitQueuedTasks();
+  void CommLoop();
+
   uint32_t _tag;
   std::shared_ptr<gloo::rendezvous::Context> _context;
   std::shared_ptr<::gloo::rendezvous::Store> _store;
+  std::shared_ptr<GlooOptions> _options;
+
+  std::thread comm_thread_;
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<std::shared_ptr<GlooTask>> task_queue_;
+  // Queued tasks plus the one being run.
+  size_t pending_tasks_{0};
+  bool stop_{false};
 };
 
 }  // namespace distributed
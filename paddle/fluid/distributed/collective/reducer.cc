@@ -19,6 +19,7 @@
 
 DECLARE_bool(use_stream_safe_cuda_allocator);
 PHI_DECLARE_string(allocator_strategy);
+PHI_DECLARE_string(gloo_reducer_compress_dtype);
 
 namespace paddle {
 namespace distributed {
@@ -489,6 +490,21 @@ EagerReducer::EagerReducer(
   // initialize groups
   InitializeGroups(group_indices);
 
+  comm_async_ = process_group_->GetBackendName() == "GLOO" &&
+                platform::is_cpu_place(inner_place_);
+  if (comm_async_ && !FLAGS_gloo_reducer_compress_dtype.empty()) {
+    const auto &dtype = FLAGS_gloo_reducer_compress_dtype;
+    PADDLE_ENFORCE_EQ(
+        dtype == "float16" || dtype == "bfloat16",
+        true,
+        platform::errors::InvalidArgument(
+            "FLAGS_gloo_reducer_compress_dtype should be float16 or "
+            "bfloat16, but received %s.",
+            dtype));
+    comm_compress_dtype_ = dtype == "float16" ? phi::DataType::FLOAT16
+                                              : phi::DataType::BFLOAT16;
+  }
+
   for (size_t global_var_index = 0; global_var_index < tensors_.size();
        ++global_var_index) {
     auto tensor = tensors_[global_var_index];
@@ -1027,7 +1043,12 @@ void EagerReducer::FinalizeBackward() {
   for (auto &group : groups_) {
     if (!group.is_sparse_) {
       group.task->Synchronize();
-      if (!IsStreamSafeAllocator()) {
+      if (group.compressed_contents_.initialized()) {
+        group.dense_contents_ = paddle::experimental::cast(
+            group.compressed_contents_, group.dtype_);
+        group.compressed_contents_.reset();
+      }
+      if (!IsStreamSafeAllocator() || comm_async_) {
         auto *default_ctx =
             platform::DeviceContextPool::Instance().Get(inner_place_);
         group.SplitTensors(*default_ctx);
@@ -1062,10 +1083,21 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
 
   // all_reduce
   std::vector<Tensor> reduce_tensors = {group->dense_contents_};
+  if (comm_async_ && comm_compress_dtype_ != phi::DataType::UNDEFINED &&
+      group->dtype_ == phi::DataType::FLOAT32) {
+    group->compressed_contents_ = paddle::experimental::cast(
+        group->dense_contents_, comm_compress_dtype_);
+    reduce_tensors = {group->compressed_contents_};
+  }
   std::vector<phi::DenseTensor> in_out;
   for (auto &t : reduce_tensors) {
     in_out.push_back(*std::dynamic_pointer_cast<phi::DenseTensor>(t.impl()));
   }
+  if (comm_async_) {
+    // Split in FinalizeBackward once the communication thread is done.
+    group->task = process_group_->AllReduce(in_out, in_out, opts, false);
+    return;
+  }
   group->task = process_group_->AllReduce(in_out, in_out, opts);
 
   auto *context = process_group_->GetDeviceContext(inner_place_);
@@ -49,6 +49,9 @@ class EagerGroup {
  public:
   Tensor dense_contents_;
   Tensor sparse_contents_;
+  // Low precision copy of dense_contents_ reduced in its place, see
+  // FLAGS_gloo_reducer_compress_dtype.
+  Tensor compressed_contents_;
   bool is_sparse_ = false;
 
   // for concat kernel
@@ -127,6 +130,12 @@ class EagerReducer {
   size_t next_group_ = 0;
   int64_t nranks_ = -1;
 
+  // Gloo runs collectives in place, so CPU groups are instead queued on
+  // its communication thread and only waited in FinalizeBackward, which
+  // overlaps their allreduce with the rest of the backward pass.
+  bool comm_async_{false};
+  phi::DataType comm_compress_dtype_{phi::DataType::UNDEFINED};
+
   bool grad_need_hooks_{false};
 
   std::vector<bool> vars_marked_ready_;
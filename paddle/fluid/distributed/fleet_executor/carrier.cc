@@ -35,6 +35,15 @@ PADDLE_DEFINE_EXPORTED_bool(
     "Use standalone executor to run ops. Temporary FLAGS, will be removed "
     "after all fleet executor cases are modified to run ops with standalone "
     "executor.");
+PADDLE_DEFINE_EXPORTED_int32(
+    fleet_executor_thread_num,
+    1,
+    "Number of task loop threads the carrier runs its interceptors on.");
+PADDLE_DEFINE_EXPORTED_bool(
+    fleet_executor_work_stealing,
+    true,
+    "Let an idle task loop thread run the pending compute interceptor "
+    "tasks of a busy one. Only takes effect with more than one thread.");
 
 namespace paddle {
 namespace distributed {
@@ -52,9 +61,9 @@ void Carrier::Init(
   rank_ = rank;
   interceptor_id_to_rank_ = interceptor_id_to_rank;
 
-  // TODO(fleet_exe dev): thread pool
-  thread_num_ = 1;
+  thread_num_ = FLAGS_fleet_executor_thread_num;
   thread_pool_.SetThreadNum(thread_num_);
+  thread_pool_.SetWorkStealing(FLAGS_fleet_executor_work_stealing);
   thread_pool_.Start();
 }
 
@@ -98,9 +107,9 @@ void Carrier::Init(
   interceptor_id_to_rank_.emplace(SOURCE_ID, rank);
   interceptor_id_to_rank_.emplace(SINK_ID, rank);
 
-  // TODO(fleet_exe dev): thread pool
-  thread_num_ = 1;
+  thread_num_ = FLAGS_fleet_executor_thread_num;
   thread_pool_.SetThreadNum(thread_num_);
+  thread_pool_.SetWorkStealing(FLAGS_fleet_executor_work_stealing);
   thread_pool_.Start();
 
   CreateInterceptors(inference_root_scope_vars);
@@ -255,8 +264,10 @@ Interceptor* Carrier::SetInterceptor(int64_t interceptor_id,
                         interceptor_id));
   interceptor->RegisterCarrier(this);
 
-  // TODO(fleet_exe dev): get loop
-  auto* loop = thread_pool_.GetLoop(interceptor_id % thread_num_);
+  // source and sink have negative ids
+  int tid = static_cast<int>(interceptor_id % thread_num_);
+  if (tid < 0) tid += thread_num_;
+  auto* loop = thread_pool_.GetLoop(tid);
   PADDLE_ENFORCE_NOT_NULL(
       loop, platform::errors::Fatal("thread task loop must not null"));
   interceptor->RegisterTaskLoop(loop);
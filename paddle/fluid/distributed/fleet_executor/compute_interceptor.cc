@@ -26,6 +26,8 @@ namespace distributed {
 
 ComputeInterceptor::ComputeInterceptor(int64_t interceptor_id, TaskNode* node)
     : Interceptor(interceptor_id, node) {
+  // Compute only touches its own scopes, any loop thread may run it.
+  stealable_ = true;
   PrepareDeps();
   RegisterMsgHandle([this](const InterceptorMessage& msg) { Compute(msg); });
 }
@@ -17,12 +17,31 @@
 #include "paddle/fluid/distributed/fleet_executor/carrier.h"
 #include "paddle/fluid/distributed/fleet_executor/task_loop.h"
 #include "paddle/fluid/distributed/fleet_executor/task_node.h"
+#include "paddle/fluid/framework/op_proto_maker.h"
 
 namespace paddle {
 namespace distributed {
 
+namespace {
+
+// Backward frees the activations kept by forward, so it goes first, and
+// forward goes before the once-per-step optimize and lr tasks.
+int RolePriority(int32_t role) {
+  using framework::OpRole;
+  if (role & static_cast<int32_t>(OpRole::kBackward)) return 2;
+  if (role & (static_cast<int32_t>(OpRole::kOptimize) |
+              static_cast<int32_t>(OpRole::kLRSched))) {
+    return 0;
+  }
+  return 1;
+}
+
+}  // namespace
+
 Interceptor::Interceptor(int64_t interceptor_id, TaskNode* node)
-    : interceptor_id_(interceptor_id), node_(node) {}
+    : interceptor_id_(interceptor_id), node_(node) {
+  if (node_ != nullptr) priority_ = RolePriority(node_->role());
+}
 
 Interceptor::~Interceptor() {
   // FIXME(wangxi): throw in stop function
@@ -60,6 +79,21 @@ void Interceptor::LoopOnce() {
 
     Handle(msg);
   }
+
+  // Requeue instead of draining here, so tasks of higher priority queued
+  // meanwhile get their turn.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (messages_.empty()) {
+      scheduled_ = false;
+      return;
+    }
+  }
+  ScheduleLoopOnce();
+}
+
+void Interceptor::ScheduleLoopOnce() {
+  loop_->QueueInLoop([this]() { LoopOnce(); }, priority_, stealable_);
 }
 
 void Interceptor::StopCarrier() {
@@ -75,14 +109,15 @@ void Interceptor::EnqueueRemoteInterceptorMessage(
   VLOG(3) << "Enqueue message: " << message.message_type() << " into "
           << interceptor_id_ << "'s remote mailbox.";
 
-  bool empty = false;
+  bool schedule = false;
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    empty = messages_.empty();
     messages_.emplace_back(message);
+    schedule = !scheduled_;
+    scheduled_ = true;
   }
-  if (empty) {
-    loop_->QueueInLoop([this]() { LoopOnce(); });
+  if (schedule) {
+    ScheduleLoopOnce();
   }
 }
 
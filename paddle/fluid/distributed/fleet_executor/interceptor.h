@@ -113,14 +113,24 @@ class Interceptor {
   Carrier* carrier_;
   TaskLoop* loop_;
 
+  // Priority of this interceptor's tasks in its TaskLoop, derived from the
+  // op role of its node so that backward work is not starved by forward.
+  int priority_{0};
+  // Whether an idle loop may handle the messages of this interceptor.
+  bool stealable_{false};
+
  private:
   void LoopOnce();
+  void ScheduleLoopOnce();
 
   // interceptor handle which process message
   MsgHandle handle_{nullptr};
 
   std::mutex mutex_;
   std::deque<InterceptorMessage> messages_;
+  // A LoopOnce is queued or running, so at most one thread handles the
+  // messages at a time even when the task is stolen.
+  bool scheduled_{false};
 };
 
 class InterceptorFactory {
@@ -21,8 +21,15 @@
 
 #include "paddle/fluid/distributed/fleet_executor/carrier.h"
 #include "paddle/fluid/distributed/fleet_executor/global.h"
+#include "paddle/fluid/platform/flags.h"
 #include "paddle/fluid/platform/gen_comm_id_helper.h"
 
+PADDLE_DEFINE_EXPORTED_bool(
+    fleet_executor_shm_transport,
+    true,
+    "Send the messages between ranks of the same host through shared memory "
+    "instead of brpc.");
+
 namespace paddle {
 namespace distributed {
 
@@ -67,6 +74,11 @@ void MessageBus::Init(
 #endif
 
   ListenPort();
+#if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
+  if (addr_ != "" && FLAGS_fleet_executor_shm_transport) {
+    InitShmTransport();
+  }
+#endif
 }
 
 bool MessageBus::IsInit() const { return is_init_; }
@@ -74,6 +86,8 @@ bool MessageBus::IsInit() const { return is_init_; }
 MessageBus::~MessageBus() {
   VLOG(3) << "Message bus releases resource.";
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
+  shm_stop_ = true;
+  if (shm_poll_thread_.joinable()) shm_poll_thread_.join();
   server_.Stop(1000);
   server_.Join();
 #endif
@@ -95,6 +109,9 @@ bool MessageBus::Send(int64_t dst_rank,
       platform::errors::PreconditionNotMet(
           "Using message bus since it has not been initialized."));
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
+  if (SendShm(dst_rank, interceptor_message)) {
+    return true;
+  }
   int retry_time = 0;  // message bus will retry sending for 10 times
   while (retry_time < 10) {
     ++retry_time;
@@ -248,6 +265,162 @@ bool MessageBus::SendInterRank(int64_t dst_rank,
   }
 }
 
+namespace {
+
+constexpr size_t kShmRingSize = 1 << 20;
+
+std::string GetHost(const std::string& addr) {
+  return addr.substr(0, addr.find(':'));
+}
+
+}  // namespace
+
+std::string MessageBus::ShmRingName(int64_t src_rank, int64_t dst_rank) const {
+  // The brpc address of dst_rank is bound by this job, so it makes the
+  // name unique on the host.
+  std::string name = "/paddle_fleet_executor_" + GetAddr(dst_rank);
+  for (auto& c : name) {
+    if (c == ':' || c == '.') c = '_';
+  }
+  return name + "_from_" + std::to_string(src_rank);
+}
+
+void MessageBus::InitShmTransport() {
+  const auto host = GetHost(addr_);
+  for (const auto& item : rank_to_addr_) {
+    int64_t rank = item.first;
+    if (rank == rank_ || GetHost(item.second) != host) continue;
+    std::unique_ptr<ShmPeer> peer(new ShmPeer());
+    // Opened on the first send, once the peer has created it.
+    peer->ring_name = ShmRingName(rank_, rank);
+    shm_peers_.emplace(rank, std::move(peer));
+
+    std::unique_ptr<ShmRing> ring(new ShmRing());
+    if (ring->Create(ShmRingName(rank, rank_), kShmRingSize)) {
+      shm_inbound_rings_.emplace_back(std::move(ring));
+    } else {
+      // The peer never finds the ring and keeps sending through brpc.
+      LOG(WARNING) << "Message bus can't create the shared memory ring from "
+                   << "rank " << rank << ", will receive through brpc.";
+    }
+  }
+  if (!shm_inbound_rings_.empty()) {
+    shm_poll_thread_ = std::thread([this] { PollShmRings(); });
+  }
+  VLOG(3) << "Message bus reaches " << shm_peers_.size()
+          << " ranks through shared memory.";
+}
+
+bool MessageBus::SendShm(int64_t dst_rank,
+                         const InterceptorMessage& interceptor_message) {
+  auto iter = shm_peers_.find(dst_rank);
+  if (iter == shm_peers_.end()) return false;
+  ShmPeer* peer = iter->second.get();
+  uint64_t seq;
+  {
+    std::lock_guard<std::mutex> lock(peer->queue_mutex);
+    peer->queue.push_back(interceptor_message);
+    seq = ++peer->queued;
+  }
+  // The thread holding flush_mutex writes the messages queued by all
+  // senders as one batch, the others only wait for their message to go.
+  while (peer->flushed.load(std::memory_order_acquire) < seq) {
+    std::unique_lock<std::mutex> lock(peer->flush_mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+      FlushShmPeer(dst_rank, peer);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  return true;
+}
+
+void MessageBus::FlushShmPeer(int64_t dst_rank, ShmPeer* peer) {
+  std::vector<InterceptorMessage> batch;
+  uint64_t last;
+  {
+    std::lock_guard<std::mutex> lock(peer->queue_mutex);
+    batch.swap(peer->queue);
+    last = peer->queued;
+  }
+  if (!peer->ring.IsOpen()) {
+    peer->ring.Open(peer->ring_name);
+  }
+
+  std::vector<std::string> records;
+  size_t i = 0;
+  while (i < batch.size()) {
+    records.clear();
+    if (peer->ring.IsOpen()) {
+      for (; i < batch.size(); i++) {
+        std::string record;
+        batch[i].SerializeToString(&record);
+        if (record.size() > peer->ring.MaxRecordSize()) break;
+        records.push_back(std::move(record));
+      }
+    }
+    size_t written = 0;
+    while (written < records.size()) {
+      written += peer->ring.Write(records, written);
+      if (written < records.size()) {
+        // The ring is full, wait for the receiver to catch up.
+        std::this_thread::yield();
+      }
+    }
+    if (i < batch.size()) {
+      // Too large for the ring or no ring at all. Let the receiver handle
+      // what is in the ring first, so the messages stay in order.
+      while (peer->ring.IsOpen() && !peer->ring.Empty()) {
+        std::this_thread::yield();
+      }
+      int retry_time = 0;
+      while (!SendInterRank(dst_rank, batch[i]) && ++retry_time < 10) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+      }
+      if (retry_time == 10) {
+        LOG(WARNING) << "Message bus sends inter rank fail after 10 times "
+                        "retries.";
+      }
+      i++;
+    }
+  }
+  peer->flushed.store(last, std::memory_order_release);
+}
+
+void MessageBus::PollShmRings() {
+  auto handler = [this](const char* data, size_t size) {
+    InterceptorMessage interceptor_message;
+    PADDLE_ENFORCE_EQ(
+        interceptor_message.ParseFromArray(data, size),
+        true,
+        platform::errors::InvalidArgument(
+            "Message bus: can't parse the message of the shared memory "
+            "ring."));
+    if (interceptor_message.ctrl_message()) {
+      IncreaseBarrierCount();
+    } else if (!DispatchMsgToCarrier(interceptor_message)) {
+      LOG(WARNING) << "Message bus: dispatching the message from interceptor "
+                   << interceptor_message.src_id() << " to interceptor "
+                   << interceptor_message.dst_id() << " failed.";
+    }
+  };
+  // Spin while messages keep coming and back off to sleeping once idle.
+  int idle_rounds = 0;
+  while (!shm_stop_.load(std::memory_order_relaxed)) {
+    size_t num = 0;
+    for (auto& ring : shm_inbound_rings_) {
+      num += ring->Read(handler);
+    }
+    if (num > 0) {
+      idle_rounds = 0;
+    } else if (++idle_rounds > 2000) {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    } else if (idle_rounds > 1000) {
+      std::this_thread::yield();
+    }
+  }
+}
+
 #endif
 
 }  // namespace distributed
@@ -14,11 +14,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
 #include "brpc/channel.h"
@@ -27,6 +30,7 @@
 #endif
 
 #include "paddle/fluid/distributed/fleet_executor/interceptor_message.pb.h"
+#include "paddle/fluid/distributed/fleet_executor/shm_ring.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/errors.h"
 #include "paddle/fluid/platform/macros.h"
@@ -67,6 +71,26 @@ class MessageBus final {
   // send the message inter rank (dst is different rank with src)
   bool SendInterRank(int64_t dst_rank,
                      const InterceptorMessage& interceptor_message);
+
+  // Ranks on the same host exchange messages through shared memory rings,
+  // one per ordered pair of ranks, brpc stays the fallback.
+  struct ShmPeer {
+    std::string ring_name;
+    ShmRing ring;
+    // Messages waiting for a flush and how many were ever queued.
+    std::mutex queue_mutex;
+    std::vector<InterceptorMessage> queue;
+    uint64_t queued{0};
+    // Held by the thread flushing the queue into the ring.
+    std::mutex flush_mutex;
+    std::atomic<uint64_t> flushed{0};
+  };
+  void InitShmTransport();
+  // Returns false if dst_rank can't be reached through shared memory.
+  bool SendShm(int64_t dst_rank, const InterceptorMessage& interceptor_message);
+  void FlushShmPeer(int64_t dst_rank, ShmPeer* peer);
+  void PollShmRings();
+  std::string ShmRingName(int64_t src_rank, int64_t dst_rank) const;
 #endif
 
   bool is_init_{false};
@@ -83,6 +107,11 @@ class MessageBus final {
   MessageServiceImpl message_service_;
   // brpc server
   brpc::Server server_;
+
+  std::unordered_map<int64_t, std::unique_ptr<ShmPeer>> shm_peers_;
+  std::vector<std::unique_ptr<ShmRing>> shm_inbound_rings_;
+  std::thread shm_poll_thread_;
+  std::atomic<bool> shm_stop_{false};
 #endif
 
   // for barrier
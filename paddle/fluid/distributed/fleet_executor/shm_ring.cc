@@ -0,0 +1,198 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/fleet_executor/shm_ring.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "glog/logging.h"
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+
+// Every record is a uint64 length followed by the payload, padded so that
+// the next length stays 8 bytes aligned.
+constexpr size_t kLenSize = sizeof(uint64_t);
+
+inline size_t RecordSpace(size_t size) {
+  return kLenSize + ((size + kLenSize - 1) & ~(kLenSize - 1));
+}
+
+inline size_t HeaderSpace() { return 256; }
+
+}  // namespace
+
+ShmRing::~ShmRing() { Close(); }
+
+bool ShmRing::Create(const std::string& name, size_t capacity) {
+#ifndef _WIN32
+  Close();
+  size_t cap = 4096;
+  while (cap < capacity) cap <<= 1;
+  shm_unlink(name.c_str());  // left over by a crashed job
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd == -1) {
+    VLOG(3) << "ShmRing: shm_open " << name << " failed: " << strerror(errno);
+    return false;
+  }
+  size_t size = HeaderSpace() + cap;
+  if (ftruncate(fd, size) == -1 || !Map(fd, size)) {
+    VLOG(3) << "ShmRing: allocating " << name << " failed.";
+    close(fd);
+    shm_unlink(name.c_str());
+    return false;
+  }
+  close(fd);
+  name_ = name;
+  is_owner_ = true;
+  header_->capacity = cap;
+  header_->head.store(0, std::memory_order_relaxed);
+  header_->tail.store(0, std::memory_order_relaxed);
+  mask_ = cap - 1;
+  // The producer only trusts the ring once it sees the magic.
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->magic = kMagic;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool ShmRing::Open(const std::string& name) {
+#ifndef _WIN32
+  Close();
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd == -1) return false;
+  struct stat st;
+  if (fstat(fd, &st) == -1 ||
+      static_cast<size_t>(st.st_size) <= HeaderSpace() ||
+      !Map(fd, st.st_size)) {
+    close(fd);
+    return false;
+  }
+  close(fd);
+  uint64_t magic = header_->magic;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (magic != kMagic ||
+      header_->capacity != static_cast<uint64_t>(st.st_size) - HeaderSpace()) {
+    Close();
+    return false;
+  }
+  name_ = name;
+  mask_ = header_->capacity - 1;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool ShmRing::Map(int fd, size_t size) {
+#ifndef _WIN32
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED) return false;
+  header_ = reinterpret_cast<Header*>(ptr);
+  data_ = reinterpret_cast<char*>(ptr) + HeaderSpace();
+  map_size_ = size;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void ShmRing::Close() {
+#ifndef _WIN32
+  if (header_ != nullptr) {
+    munmap(header_, map_size_);
+    if (is_owner_) shm_unlink(name_.c_str());
+  }
+#endif
+  header_ = nullptr;
+  data_ = nullptr;
+  map_size_ = 0;
+  is_owner_ = false;
+}
+
+size_t ShmRing::MaxRecordSize() const {
+  return header_ == nullptr ? 0 : header_->capacity / 4;
+}
+
+void ShmRing::CopyIn(uint64_t pos, const void* src, size_t size) {
+  size_t offset = pos & mask_;
+  size_t first = std::min<size_t>(size, header_->capacity - offset);
+  memcpy(data_ + offset, src, first);
+  memcpy(data_, reinterpret_cast<const char*>(src) + first, size - first);
+}
+
+void ShmRing::CopyOut(uint64_t pos, void* dst, size_t size) const {
+  size_t offset = pos & mask_;
+  size_t first = std::min<size_t>(size, header_->capacity - offset);
+  memcpy(dst, data_ + offset, first);
+  memcpy(reinterpret_cast<char*>(dst) + first, data_, size - first);
+}
+
+size_t ShmRing::Write(const std::vector<std::string>& records, size_t begin) {
+  uint64_t head = header_->head.load(std::memory_order_relaxed);
+  uint64_t tail = header_->tail.load(std::memory_order_acquire);
+  size_t i = begin;
+  for (; i < records.size(); i++) {
+    size_t space = RecordSpace(records[i].size());
+    if (records[i].size() > MaxRecordSize() ||
+        head + space - tail > header_->capacity) {
+      break;
+    }
+    uint64_t len = records[i].size();
+    CopyIn(head, &len, kLenSize);
+    CopyIn(head + kLenSize, records[i].data(), records[i].size());
+    head += space;
+  }
+  header_->head.store(head, std::memory_order_release);
+  return i - begin;
+}
+
+size_t ShmRing::Read(const std::function<void(const char*, size_t)>& handler) {
+  uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+  uint64_t head = header_->head.load(std::memory_order_acquire);
+  size_t num = 0;
+  std::string buffer;
+  while (tail < head) {
+    uint64_t len;
+    CopyOut(tail, &len, kLenSize);
+    uint64_t offset = (tail + kLenSize) & mask_;
+    if (offset + len <= header_->capacity) {
+      handler(data_ + offset, len);
+    } else {
+      buffer.resize(len);
+      CopyOut(tail + kLenSize, &buffer[0], len);
+      handler(buffer.data(), len);
+    }
+    tail += RecordSpace(len);
+    num++;
+  }
+  header_->tail.store(tail, std::memory_order_release);
+  return num;
+}
+
+}  // namespace distributed
+}  // namespace paddle
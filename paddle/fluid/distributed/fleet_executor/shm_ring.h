@@ -0,0 +1,86 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/platform/macros.h"
+
+namespace paddle {
+namespace distributed {
+
+// A single-producer single-consumer ring of variable sized records in a
+// POSIX shared memory segment, used by MessageBus between ranks of the
+// same host. Producer and consumer only synchronize through the head and
+// tail counters, so neither side ever takes a lock or makes a syscall.
+// The consumer creates the ring and the producer opens it by name.
+class ShmRing {
+ public:
+  ShmRing() = default;
+  ~ShmRing();
+
+  // capacity is rounded up to a power of two. Returns false if the
+  // segment can't be created, e.g. when /dev/shm is unavailable.
+  bool Create(const std::string& name, size_t capacity);
+  // Returns false until the consumer has created the ring.
+  bool Open(const std::string& name);
+  bool IsOpen() const { return header_ != nullptr; }
+  void Close();
+
+  // Largest record Write accepts.
+  size_t MaxRecordSize() const;
+  // True once the consumer has handled every written record.
+  bool Empty() const {
+    return header_->tail.load(std::memory_order_acquire) ==
+           header_->head.load(std::memory_order_relaxed);
+  }
+
+  // Appends records[begin:] until the ring is full and publishes them at
+  // once. Returns how many records were written.
+  size_t Write(const std::vector<std::string>& records, size_t begin = 0);
+  // Hands every published record to handler, then frees their space at
+  // once. Returns how many records were read.
+  size_t Read(const std::function<void(const char*, size_t)>& handler);
+
+ private:
+  struct Header {
+    uint64_t magic;
+    uint64_t capacity;
+    alignas(64) std::atomic<uint64_t> head;  // advanced by the producer
+    alignas(64) std::atomic<uint64_t> tail;  // advanced by the consumer
+  };
+  static constexpr uint64_t kMagic = 0x474e495248534650;  // "PFSHRING"
+
+  bool Map(int fd, size_t size);
+  void CopyIn(uint64_t pos, const void* src, size_t size);
+  void CopyOut(uint64_t pos, void* dst, size_t size) const;
+
+  std::string name_;
+  bool is_owner_{false};
+  Header* header_{nullptr};
+  char* data_{nullptr};
+  size_t map_size_{0};
+  uint64_t mask_{0};
+
+  DISABLE_COPY_AND_ASSIGN(ShmRing);
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -33,7 +33,10 @@ TaskLoop::TaskLoop()
   thread_local_loop_ = this;
 }
 
-TaskLoop::~TaskLoop() { thread_local_loop_ = nullptr; }
+TaskLoop::~TaskLoop() {
+  // The loop may be destroyed by the thread that joined its loop thread.
+  if (thread_local_loop_ == this) thread_local_loop_ = nullptr;
+}
 
 void TaskLoop::Loop() {
   PADDLE_ENFORCE_EQ(looping_,
@@ -42,21 +45,81 @@ void TaskLoop::Loop() {
                         "Loop can only execute in one loop thread"));
   AssertInLoopThread();
 
+  // quit_ is not reset here, a Quit issued before the thread gets to loop
+  // must not be lost.
   looping_ = true;
-  quit_ = false;
 
   while (!quit_) {
-    auto tasks = tasks_.PopAll();
-    for (auto& task : tasks) {
+    Functor task;
+    if (PopTask(&task)) {
+      busy_ = true;
       task();
+      busy_ = false;
     }
   }
   looping_ = false;
 }
 
+bool TaskLoop::PopTask(Functor* fn) {
+  auto pop = [this, fn] {
+    auto iter = tasks_.begin();
+    *fn = std::move(iter->fn);
+    if (iter->stealable) --stealable_num_;
+    tasks_.erase(iter);
+  };
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!tasks_.empty()) {
+      pop();
+      return true;
+    }
+  }
+  // Out of work, help the peers before going to sleep.
+  for (auto* peer : steal_peers_) {
+    if (peer->StealTask(fn)) return true;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return !tasks_.empty() || steal_hint_ || quit_; });
+  steal_hint_ = false;
+  if (tasks_.empty()) return false;
+  pop();
+  return true;
+}
+
+bool TaskLoop::StealTask(Functor* fn) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stealable_num_ == 0) return false;
+  for (auto iter = tasks_.begin(); iter != tasks_.end(); ++iter) {
+    if (iter->stealable) {
+      *fn = std::move(iter->fn);
+      --stealable_num_;
+      tasks_.erase(iter);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TaskLoop::TryHintSteal() {
+  if (busy_) return false;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!tasks_.empty()) return false;
+  steal_hint_ = true;
+  cv_.notify_one();
+  return true;
+}
+
+void TaskLoop::SetStealPeers(const std::vector<TaskLoop*>& peers) {
+  steal_peers_.clear();
+  for (auto* peer : peers) {
+    if (peer != this) steal_peers_.push_back(peer);
+  }
+}
+
 void TaskLoop::Quit() {
+  std::lock_guard<std::mutex> lock(mutex_);
   quit_ = true;
-  if (!IsInLoopThread()) WakeUp();
+  cv_.notify_one();
 }
 
 void TaskLoop::RunInLoop(Functor cb) {
@@ -67,7 +130,22 @@ void TaskLoop::RunInLoop(Functor cb) {
   }
 }
 
-void TaskLoop::QueueInLoop(Functor cb) { tasks_.Push(cb); }
+void TaskLoop::QueueInLoop(Functor cb, int priority, bool stealable) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.insert(Task{priority, seq_++, stealable, std::move(cb)});
+    if (stealable) ++stealable_num_;
+    // Notify under the lock, the loop must not be able to see the task,
+    // quit and be destroyed before the notify.
+    cv_.notify_one();
+  }
+  // This loop is busy with another task, let an idle peer take it.
+  if (stealable && busy_) {
+    for (auto* peer : steal_peers_) {
+      if (peer->TryHintSteal()) break;
+    }
+  }
+}
 
 void TaskLoop::WakeUp() {
   Functor task([] {});
@@ -14,13 +14,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <future>
 #include <map>
+#include <mutex>
+#include <set>
 #include <thread>
 #include <vector>
 
-#include "paddle/fluid/framework/blocking_queue.h"
 #include "paddle/fluid/platform/macros.h"
 
 namespace paddle {
@@ -39,7 +42,16 @@ class TaskLoop {
   void Quit();
 
   void RunInLoop(Functor cb);
-  void QueueInLoop(Functor cb);
+  // Tasks of higher priority run first, tasks of the same priority run in
+  // queueing order. A stealable task may be run by another loop of the
+  // pool that has nothing to do, so it must not rely on the loop thread.
+  void QueueInLoop(Functor cb, int priority = 0, bool stealable = false);
+
+  // Loops to wake up when stealable tasks pile up here, and to steal from
+  // when idle. The peers are read without a lock, so they must be set
+  // before the loop thread runs Loop and before any task is queued, and
+  // every peer must outlive the loop threads of all the others.
+  void SetStealPeers(const std::vector<TaskLoop*>& peers);
 
   template <class F, class... Args>
   auto Enqueue(F&& f, Args&&... args)
@@ -50,7 +62,7 @@ class TaskLoop {
         std::bind(std::forward<F>(f), std::forward<Args>(args)...));
     std::future<return_type> task_future = task->get_future();
 
-    tasks_.Push([task]() { (*task)(); });
+    QueueInLoop([task]() { (*task)(); });
     return task_future;
   }
 
@@ -69,15 +81,40 @@ class TaskLoop {
  private:
   DISABLE_COPY_AND_ASSIGN(TaskLoop);
 
+  struct Task {
+    int priority;
+    uint64_t seq;
+    bool stealable;
+    mutable Functor fn;
+
+    bool operator<(const Task& other) const {
+      return priority != other.priority ? priority > other.priority
+                                        : seq < other.seq;
+    }
+  };
+
   void AbortNotInLoopThread();
 
+  // Blocks until a task is queued here or a peer hints there is work to
+  // steal. Returns false if there is nothing to run.
+  bool PopTask(Functor* fn);
+  bool StealTask(Functor* fn);
+  bool TryHintSteal();
+
   static thread_local TaskLoop* thread_local_loop_;
 
   bool looping_;
   std::atomic<bool> quit_;
   std::thread::id thread_id_;
 
-  framework::BlockingQueue<Functor> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::set<Task> tasks_;
+  uint64_t seq_{0};
+  size_t stealable_num_{0};
+  bool steal_hint_{false};
+  std::atomic<bool> busy_{false};
+  std::vector<TaskLoop*> steal_peers_;
 };
 
 }  // namespace distributed
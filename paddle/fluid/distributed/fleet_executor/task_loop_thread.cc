@@ -21,16 +21,17 @@
 namespace paddle {
 namespace distributed {
 
-TaskLoopThread::TaskLoopThread() : start_(false), loop_(nullptr) {}
+TaskLoopThread::TaskLoopThread() : start_(false), run_(false) {}
 
-TaskLoopThread::~TaskLoopThread() {
-  if (loop_ != nullptr) {
-    loop_->Quit();
-    thread_.join();
-  }
-}
+TaskLoopThread::~TaskLoopThread() { Join(); }
 
 TaskLoop* TaskLoopThread::StartLoop() {
+  TaskLoop* loop = CreateLoop();
+  Run();
+  return loop;
+}
+
+TaskLoop* TaskLoopThread::CreateLoop() {
   PADDLE_ENFORCE_EQ(
       start_,
       false,
@@ -39,21 +40,33 @@ TaskLoop* TaskLoopThread::StartLoop() {
   thread_ = std::thread([this]() { Loop(); });
 
   std::unique_lock<std::mutex> lock(mutex_);
-  cv_.wait(lock, [=] { return loop_ != nullptr; });
-  return loop_;
+  cv_.wait(lock, [this] { return loop_ != nullptr; });
+  return loop_.get();
 }
 
-void TaskLoopThread::Loop() {
-  TaskLoop loop;
-  {
-    std::unique_lock<std::mutex> lock(mutex_);
-    loop_ = &loop;
-    cv_.notify_one();
-  }
-  loop.Loop();
+void TaskLoopThread::Run() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  run_ = true;
+  cv_.notify_all();
+}
+
+void TaskLoopThread::Join() {
+  if (!thread_.joinable()) return;
+  // A loop that never ran still has to get past the wait in Loop.
+  Run();
+  loop_->Quit();
+  thread_.join();
+}
 
+void TaskLoopThread::Loop() {
+  // The loop must be constructed on its own thread.
   std::unique_lock<std::mutex> lock(mutex_);
-  loop_ = nullptr;
+  loop_.reset(new TaskLoop());
+  cv_.notify_all();
+  cv_.wait(lock, [this] { return run_; });
+  TaskLoop* loop = loop_.get();
+  lock.unlock();
+  loop->Loop();
 }
 
 }  // namespace distributed
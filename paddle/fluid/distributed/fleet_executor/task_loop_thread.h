@@ -15,6 +15,7 @@
 #pragma once
 
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <thread>
 
@@ -30,7 +31,15 @@ class TaskLoopThread {
   TaskLoopThread();
   ~TaskLoopThread();
 
+  // Creates the loop on a new thread and runs it.
   TaskLoop* StartLoop();
+  // Creates the loop on a new thread, which only runs it after Run, so the
+  // loop can be set up before any of its tasks runs.
+  TaskLoop* CreateLoop();
+  void Run();
+  // Quits the loop and joins the thread. The loop itself lives until this
+  // object is destroyed, so other threads may still touch it meanwhile.
+  void Join();
 
  private:
   DISABLE_COPY_AND_ASSIGN(TaskLoopThread);
@@ -38,7 +47,8 @@ class TaskLoopThread {
   void Loop();
 
   bool start_;
-  TaskLoop* loop_;
+  bool run_;
+  std::unique_ptr<TaskLoop> loop_;
   std::thread thread_;
   std::mutex mutex_;
   std::condition_variable cv_;
@@ -27,7 +27,13 @@ TaskLoopThreadPool::TaskLoopThreadPool() : TaskLoopThreadPool(1) {}
 TaskLoopThreadPool::TaskLoopThreadPool(int thread_num)
     : start_(false), thread_num_(thread_num) {}
 
-TaskLoopThreadPool::~TaskLoopThreadPool() = default;
+TaskLoopThreadPool::~TaskLoopThreadPool() {
+  // A running loop may steal from or hint any of its peers, so stop every
+  // thread before the first loop is destroyed with its TaskLoopThread.
+  for (auto& thread : threads_) {
+    thread->Join();
+  }
+}
 
 void TaskLoopThreadPool::Start() {
   PADDLE_ENFORCE_EQ(
@@ -43,7 +49,17 @@ void TaskLoopThreadPool::Start() {
   start_ = true;
   for (int i = 0; i < thread_num_; ++i) {
     threads_.emplace_back(new TaskLoopThread());
-    loops_.push_back(threads_[i]->StartLoop());
+    loops_.push_back(threads_[i]->CreateLoop());
+  }
+  // The peers are handed over before the loops run, Run publishes them to
+  // the loop threads.
+  if (work_stealing_ && thread_num_ > 1) {
+    for (auto* loop : loops_) {
+      loop->SetStealPeers(loops_);
+    }
+  }
+  for (auto& thread : threads_) {
+    thread->Run();
   }
 }
 
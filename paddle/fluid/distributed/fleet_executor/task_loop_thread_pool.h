@@ -32,6 +32,8 @@ class TaskLoopThreadPool {
   ~TaskLoopThreadPool();
 
   void SetThreadNum(int thread_num) { thread_num_ = thread_num; }
+  // Lets idle loops run the stealable tasks queued in busy ones.
+  void SetWorkStealing(bool work_stealing) { work_stealing_ = work_stealing; }
 
   void Start();
 
@@ -43,6 +45,7 @@ class TaskLoopThreadPool {
 
   bool start_;
   int thread_num_;
+  bool work_stealing_{false};
   std::vector<std::unique_ptr<TaskLoopThread>> threads_;
   std::vector<TaskLoop*> loops_;
 };
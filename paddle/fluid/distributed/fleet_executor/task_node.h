@@ -144,7 +144,7 @@ class TaskNode final {
       unused_vars_;
   std::vector<std::string> while_block_vars_;
 
-  int32_t role_;
+  int32_t role_{0};
   int64_t rank_;
   int64_t task_id_;
   int64_t max_run_times_;
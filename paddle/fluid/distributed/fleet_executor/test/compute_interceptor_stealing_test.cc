@@ -0,0 +1,137 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/fleet_executor/carrier.h"
+#include "paddle/fluid/distributed/fleet_executor/compute_interceptor.h"
+#include "paddle/fluid/distributed/fleet_executor/global.h"
+#include "paddle/fluid/distributed/fleet_executor/interceptor.h"
+#include "paddle/fluid/distributed/fleet_executor/message_bus.h"
+#include "paddle/fluid/distributed/fleet_executor/task_node.h"
+#include "paddle/fluid/framework/op_proto_maker.h"
+
+DECLARE_int32(fleet_executor_thread_num);
+DECLARE_bool(fleet_executor_work_stealing);
+
+namespace paddle {
+namespace distributed {
+
+// What every compute interceptor of the pipeline saw, keyed by its id.
+struct RunRecord {
+  std::vector<int64_t> scopes;
+  bool overlapped{false};
+};
+static std::mutex record_mutex;
+static std::map<int64_t, RunRecord> records;
+
+// Records each run instead of running ops. Interceptor 0 is the slow
+// first forward stage, so the loop holding it falls behind and its peer
+// steals the stealable compute tasks queued behind it.
+class RecordComputeInterceptor : public ComputeInterceptor {
+ public:
+  RecordComputeInterceptor(int64_t interceptor_id, TaskNode* node)
+      : ComputeInterceptor(interceptor_id, node) {}
+
+ protected:
+  void RunOps() override {
+    bool overlapped = running_.exchange(true);
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(GetInterceptorId() == 0 ? 2000 : 200));
+    {
+      std::lock_guard<std::mutex> lock(record_mutex);
+      auto& record = records[GetInterceptorId()];
+      record.scopes.push_back(cur_scope_id_);
+      record.overlapped |= overlapped;
+    }
+    running_ = false;
+  }
+
+ private:
+  std::atomic<bool> running_{false};
+};
+
+REGISTER_INTERCEPTOR(RecordCompute, RecordComputeInterceptor);
+
+TEST(ComputeInterceptor, WorkStealing) {
+  FLAGS_fleet_executor_thread_num = 2;
+  FLAGS_fleet_executor_work_stealing = true;
+
+  std::string carrier_id = "0";
+  Carrier* carrier =
+      GlobalMap<std::string, Carrier>::Create(carrier_id, carrier_id);
+  carrier->Init(0,
+                {{SOURCE_ID, 0}, {0, 0}, {1, 0}, {2, 0}, {3, 0}, {SINK_ID, 0}});
+  MessageBus* msg_bus = GlobalVal<MessageBus>::Create();
+  msg_bus->Init(0, {{0, "127.0.0.0:0"}}, "");
+
+  const int64_t micro_steps = 8;
+  const int32_t forward = static_cast<int32_t>(framework::OpRole::kForward);
+  const int32_t backward = static_cast<int32_t>(framework::OpRole::kBackward);
+  // NOTE: don't delete, otherwise interceptor will use undefined node
+  TaskNode* source = new TaskNode(0, SOURCE_ID, micro_steps);
+  std::vector<TaskNode*> nodes = {new TaskNode(forward, 0, 0, micro_steps),
+                                  new TaskNode(forward, 0, 1, micro_steps),
+                                  new TaskNode(backward, 0, 2, micro_steps),
+                                  new TaskNode(backward, 0, 3, micro_steps)};
+  TaskNode* sink = new TaskNode(0, SINK_ID, micro_steps);
+
+  // source->f0->f1->b1->b0->sink, interceptors 0 and 2 share a loop, so do
+  // 1 and 3.
+  source->AddDownstreamTask(0);
+  nodes[0]->AddUpstreamTask(SOURCE_ID);
+  for (size_t i = 0; i + 1 < nodes.size(); ++i) {
+    nodes[i]->AddDownstreamTask(i + 1, 2);
+    nodes[i + 1]->AddUpstreamTask(i, 2);
+  }
+  nodes.back()->AddDownstreamTask(SINK_ID);
+  sink->AddUpstreamTask(nodes.size() - 1);
+
+  carrier->SetInterceptor(
+      SOURCE_ID, InterceptorFactory::Create("Source", SOURCE_ID, source));
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    carrier->SetInterceptor(
+        i, InterceptorFactory::Create("RecordCompute", i, nodes[i]));
+  }
+  carrier->SetInterceptor(SINK_ID,
+                          InterceptorFactory::Create("Sink", SINK_ID, sink));
+
+  InterceptorMessage msg;
+  msg.set_message_type(START);
+  msg.set_dst_id(SOURCE_ID);
+  carrier->EnqueueInterceptorMessage(msg);
+  carrier->Wait();
+  carrier->Release();
+
+  // Stolen or not, every stage ran each micro step once and in order, and
+  // never on two threads at the same time.
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < micro_steps; ++i) expected.push_back(i);
+  std::lock_guard<std::mutex> lock(record_mutex);
+  ASSERT_EQ(records.size(), nodes.size());
+  for (auto& item : records) {
+    EXPECT_EQ(item.second.scopes, expected) << "interceptor " << item.first;
+    EXPECT_FALSE(item.second.overlapped) << "interceptor " << item.first;
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
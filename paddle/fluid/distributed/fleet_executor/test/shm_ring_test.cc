@@ -0,0 +1,163 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/fleet_executor/shm_ring.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+static std::string RingName(const std::string& suffix) {
+  return "/paddle_shm_ring_test_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+TEST(ShmRing, WriteAndRead) {
+  ShmRing consumer;
+  ASSERT_TRUE(consumer.Create(RingName("rw"), 4096));
+  ShmRing producer;
+  ASSERT_TRUE(producer.Open(RingName("rw")));
+  ASSERT_FALSE(ShmRing().Open(RingName("not_exist")));
+
+  // Odd sizes wrap the ring many times.
+  std::vector<std::string> received;
+  auto handler = [&](const char* data, size_t size) {
+    received.emplace_back(data, size);
+  };
+  std::vector<std::string> sent;
+  for (int round = 0; round < 100; round++) {
+    std::vector<std::string> records;
+    for (int i = 0; i < 7; i++) {
+      records.push_back(std::string(round * 7 + i, 'a' + (round + i) % 26));
+    }
+    size_t written = 0;
+    while (written < records.size()) {
+      written += producer.Write(records, written);
+      consumer.Read(handler);
+    }
+    sent.insert(sent.end(), records.begin(), records.end());
+  }
+  consumer.Read(handler);
+  EXPECT_TRUE(producer.Empty());
+  ASSERT_EQ(received, sent);
+
+  // Records larger than a quarter of the ring are refused.
+  std::vector<std::string> large = {std::string(2048, 'x')};
+  EXPECT_EQ(producer.Write(large), 0UL);
+}
+
+// Kills the child unless it was reaped, so a failed assertion of the parent
+// never leaves it spinning.
+class ChildGuard {
+ public:
+  explicit ChildGuard(pid_t pid) : pid_(pid) {}
+  ~ChildGuard() {
+    if (pid_ > 0) {
+      kill(pid_, SIGKILL);
+      waitpid(pid_, nullptr, 0);
+    }
+  }
+
+  int Wait() {
+    int status = 0;
+    waitpid(pid_, &status, 0);
+    pid_ = -1;
+    return status;
+  }
+
+ private:
+  pid_t pid_;
+};
+
+// Round trip of small messages between two processes, one ring per
+// direction, as MessageBus uses them. Run with
+// --gtest_also_run_disabled_tests to time them.
+TEST(ShmRing, DISABLED_PingPongLatency) {
+  const int rounds = 5000;
+  const std::string ping = RingName("ping");
+  const std::string pong = RingName("pong");
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    // The child is killed by SIGALRM if the parent stops answering.
+    alarm(60);
+    ShmRing in;
+    if (!in.Create(pong, 1 << 16)) _exit(1);
+    ShmRing out;
+    while (!out.Open(ping)) usleep(1000);
+    std::vector<std::string> reply(1);
+    int count = 0;
+    while (count < rounds) {
+      count += in.Read([&](const char* data, size_t size) {
+        reply[0].assign(data, size);
+        while (out.Write(reply) == 0) {
+          std::this_thread::yield();
+        }
+      });
+      // Spinning alone would starve the other side on a single core.
+      std::this_thread::yield();
+    }
+    while (!out.Empty()) usleep(100);
+    _exit(0);
+  }
+
+  ChildGuard child(pid);
+  ShmRing in;
+  ASSERT_TRUE(in.Create(ping, 1 << 16));
+  ShmRing out;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!out.Open(pong)) {
+    ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+    usleep(1000);
+  }
+  std::vector<std::string> msg = {std::string(64, 'm')};
+  auto start = std::chrono::steady_clock::now();
+  deadline = start + std::chrono::seconds(60);
+  for (int i = 0; i < rounds; i++) {
+    msg[0][0] = static_cast<char>(i);
+    ASSERT_EQ(out.Write(msg), 1UL);
+    size_t got = 0;
+    while (got == 0) {
+      got = in.Read([&](const char* data, size_t size) {
+        ASSERT_EQ(std::string(data, size), msg[0]);
+      });
+      if (got == 0) {
+        ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+        std::this_thread::yield();
+      }
+    }
+  }
+  double us = std::chrono::duration<double, std::micro>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  LOG(INFO) << "shared memory ring round trip of a 64B message: "
+            << us / rounds << " us";
+
+  int status = child.Wait();
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,249 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/fleet_executor/task_loop.h"
+#include "paddle/fluid/distributed/fleet_executor/task_loop_thread_pool.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(TaskLoop, Priority) {
+  TaskLoopThreadPool pool(1);
+  pool.Start();
+  TaskLoop* loop = pool.GetLoop(0);
+
+  std::promise<void> blocker;
+  std::shared_future<void> blocked = blocker.get_future().share();
+  loop->QueueInLoop([blocked] { blocked.wait(); });
+
+  std::mutex mutex;
+  std::vector<int> order;
+  std::vector<int> priorities = {0, 2, 1, 2, 0};
+  for (size_t i = 0; i < priorities.size(); ++i) {
+    loop->QueueInLoop(
+        [&, i] {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(static_cast<int>(i));
+        },
+        priorities[i]);
+  }
+  blocker.set_value();
+  loop->Enqueue([] {}).wait();
+
+  std::vector<int> expected = {1, 3, 2, 0, 4};
+  EXPECT_EQ(order, expected);
+}
+
+TEST(TaskLoop, WorkStealing) {
+  TaskLoopThreadPool pool(2);
+  pool.SetWorkStealing(true);
+  pool.Start();
+  TaskLoop* busy = pool.GetLoop(0);
+
+  std::promise<void> blocker;
+  std::shared_future<void> blocked = blocker.get_future().share();
+  std::promise<std::thread::id> busy_thread;
+  busy->QueueInLoop([&] {
+    busy_thread.set_value(std::this_thread::get_id());
+    blocked.wait();
+  });
+  std::thread::id busy_id = busy_thread.get_future().get();
+
+  // The busy loop can't run it, the idle one must.
+  std::promise<std::thread::id> stolen;
+  busy->QueueInLoop(
+      [&] { stolen.set_value(std::this_thread::get_id()); }, 0, true);
+  EXPECT_NE(stolen.get_future().get(), busy_id);
+
+  // Tasks that are not stealable stay in their loop.
+  std::promise<std::thread::id> pinned;
+  auto pinned_id = pinned.get_future();
+  busy->QueueInLoop([&] { pinned.set_value(std::this_thread::get_id()); });
+  EXPECT_EQ(pinned_id.wait_for(std::chrono::milliseconds(50)),
+            std::future_status::timeout);
+  blocker.set_value();
+  EXPECT_EQ(pinned_id.get(), busy_id);
+}
+
+// A pipeline of stages pinned to the loops round robin, the way Carrier
+// binds interceptors. Like an interceptor, each stage has a mailbox and at
+// most one task draining it. Every micro batch runs forward through all
+// stages, then backward in reverse, and the first stage is the slowest, so
+// the loop holding it keeps the others waiting. Reports the makespan and
+// how long each micro batch holds its activations, i.e. the time between
+// its first forward and its last backward.
+struct PipelineResult {
+  double makespan_ms;
+  double hold_ms;
+};
+
+static PipelineResult RunPipeline(int thread_num,
+                                  bool priority,
+                                  bool stealing) {
+  const int stage_num = 4;
+  const int micro_batch_num = 8;
+  const std::vector<int> cost_us = {800, 200, 200, 200};
+
+  std::unique_ptr<TaskLoopThreadPool> pool(
+      new TaskLoopThreadPool(thread_num));
+  pool->SetWorkStealing(stealing);
+  pool->Start();
+
+  struct Stage {
+    std::mutex mutex;
+    // (micro batch, step), step in [0, 2 * stage_num), forward first
+    std::deque<std::pair<int, int>> mailbox;
+    bool scheduled{false};
+  };
+  std::vector<Stage> stages(stage_num);
+  std::vector<std::chrono::steady_clock::time_point> begin(micro_batch_num);
+  std::vector<std::chrono::steady_clock::time_point> end(micro_batch_num);
+  std::promise<void> done;
+  std::atomic<int> remain(micro_batch_num);
+
+  std::function<void(int)> schedule;
+  auto post = [&](int micro_batch, int step) {
+    int stage = step < stage_num ? step : 2 * stage_num - 1 - step;
+    bool need_schedule = false;
+    {
+      std::lock_guard<std::mutex> lock(stages[stage].mutex);
+      stages[stage].mailbox.emplace_back(micro_batch, step);
+      need_schedule = !stages[stage].scheduled;
+      stages[stage].scheduled = true;
+    }
+    if (need_schedule) schedule(stage);
+  };
+  schedule = [&](int stage) {
+    int step;
+    {
+      std::lock_guard<std::mutex> lock(stages[stage].mutex);
+      step = stages[stage].mailbox.front().second;
+    }
+    TaskLoop* loop = pool->GetLoop(stage % thread_num);
+    loop->QueueInLoop(
+        [&, stage] {
+          std::pair<int, int> msg;
+          {
+            std::lock_guard<std::mutex> lock(stages[stage].mutex);
+            msg = stages[stage].mailbox.front();
+            stages[stage].mailbox.pop_front();
+          }
+          int micro_batch = msg.first;
+          int step = msg.second;
+          if (step == 0) begin[micro_batch] = std::chrono::steady_clock::now();
+          std::this_thread::sleep_for(
+              std::chrono::microseconds(cost_us[stage]));
+          if (step + 1 < 2 * stage_num) {
+            post(micro_batch, step + 1);
+          } else {
+            end[micro_batch] = std::chrono::steady_clock::now();
+            if (--remain == 0) done.set_value();
+          }
+          bool more = false;
+          {
+            std::lock_guard<std::mutex> lock(stages[stage].mutex);
+            more = !stages[stage].mailbox.empty();
+            stages[stage].scheduled = more;
+          }
+          if (more) schedule(stage);
+        },
+        priority && step >= stage_num ? 1 : 0,
+        true);
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < micro_batch_num; ++i) post(i, 0);
+  done.get_future().wait();
+  auto stop = std::chrono::steady_clock::now();
+  // joins the loops before the stages go away
+  pool.reset();
+
+  PipelineResult result;
+  result.makespan_ms =
+      std::chrono::duration<double, std::milli>(stop - start).count();
+  result.hold_ms = 0;
+  for (int i = 0; i < micro_batch_num; ++i) {
+    result.hold_ms +=
+        std::chrono::duration<double, std::milli>(end[i] - begin[i]).count();
+  }
+  result.hold_ms /= micro_batch_num;
+  return result;
+}
+
+// Run with --gtest_also_run_disabled_tests to time them.
+TEST(TaskLoop, DISABLED_PipelineBubble) {
+  struct Case {
+    const char* name;
+    bool priority;
+    bool stealing;
+  };
+  std::vector<Case> cases = {{"fifo", false, false},
+                             {"priority", true, false},
+                             {"priority+stealing", true, true}};
+  for (const auto& c : cases) {
+    auto result = RunPipeline(2, c.priority, c.stealing);
+    LOG(INFO) << c.name << ": makespan " << result.makespan_ms
+              << " ms, activations held " << result.hold_ms << " ms";
+  }
+}
+
+// Pools are torn down while their loops still steal from each other and
+// while tasks are still queued. Run under a thread sanitizer to check the
+// loops are only destroyed after every thread is joined.
+TEST(TaskLoop, DestroyWhileStealing) {
+  const int task_num = 200;
+  for (int round = 0; round < 20; ++round) {
+    std::atomic<int> ran(0);
+    std::promise<void> all_ran;
+    TaskLoopThreadPool pool(4);
+    pool.SetWorkStealing(true);
+    pool.Start();
+    // Every task runs exactly once, on its loop or on a peer that stole it.
+    for (int i = 0; i < task_num; ++i) {
+      pool.GetLoop(i % 2)->QueueInLoop(
+          [&] {
+            if (++ran == task_num) all_ran.set_value();
+          },
+          i % 3,
+          true);
+    }
+    ASSERT_EQ(all_ran.get_future().wait_for(std::chrono::seconds(10)),
+              std::future_status::ready);
+    EXPECT_EQ(ran.load(), task_num);
+    // These are still queued or being stolen when the pool goes away.
+    for (int i = 0; i < task_num; ++i) {
+      pool.GetLoop(i % 2)->QueueInLoop([] {}, i % 3, true);
+    }
+  }
+  // A pool that never queued anything still shuts down.
+  TaskLoopThreadPool idle(2);
+  idle.SetWorkStealing(true);
+  idle.Start();
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -30,20 +30,26 @@ std::vector<std::vector<uint64_t>> LayerWiseSampler::sample(
       std::vector<uint64_t>(user_feature_num + 2));
 
   auto max_layer = tree_->Height();
+  size_t path_len = max_layer - start_sample_layer_;
+  auto travel_codes = tree_->GetTravelCodes(target_ids, start_sample_layer_);
   size_t idx = 0;
   for (size_t i = 0; i < input_num; i++) {
-    auto travel_codes =
-        tree_->GetTravelCodes(target_ids[i], start_sample_layer_);
-    auto travel_path = tree_->GetNodes(travel_codes);
-    for (size_t j = 0; j < travel_path.size(); j++) {
+    const uint64_t* travel_path = travel_codes.data() + i * path_len;
+    for (size_t j = 0; j < path_len; j++) {
+      uint64_t travel_id = tree_->GetNodeId(travel_path[j]);
       // user
       if (j > 0 && with_hierarchy) {
-        auto ancestor_codes =
-            tree_->GetAncestorCodes(user_inputs[i], max_layer - j - 1);
-        auto hierarchical_user = tree_->GetNodes(ancestor_codes);
-        for (int idx_offset = 0; idx_offset <= layer_counts_[j]; idx_offset++) {
-          for (size_t k = 0; k < user_feature_num; k++) {
-            outputs[idx + idx_offset][k] = hierarchical_user[k].id();
+        int level = max_layer - j - 1;
+        for (size_t k = 0; k < user_feature_num; k++) {
+          auto code = tree_->GetLeafCode(user_inputs[i][k]);
+          uint64_t user_id = 0;
+          if (code != tree_->max_code_) {
+            user_id = tree_->GetNodeId(
+                tree_->GetAncestorCode(code, max_layer - 1, level));
+          }
+          for (int idx_offset = 0; idx_offset <= layer_counts_[j];
+               idx_offset++) {
+            outputs[idx + idx_offset][k] = user_id;
           }
         }
       } else {
@@ -55,16 +61,15 @@ std::vector<std::vector<uint64_t>> LayerWiseSampler::sample(
       }
 
       // sampler ++
-      outputs[idx][user_feature_num] = travel_path[j].id();
+      outputs[idx][user_feature_num] = travel_id;
       outputs[idx][user_feature_num + 1] = 1.0;
       idx += 1;
       for (int idx_offset = 0; idx_offset < layer_counts_[j]; idx_offset++) {
         int sample_res = 0;
         do {
           sample_res = sampler_vec_[j]->Sample();
-        } while (layer_ids_[j][sample_res].id() == travel_path[j].id());
-        outputs[idx + idx_offset][user_feature_num] =
-            layer_ids_[j][sample_res].id();
+        } while (layer_ids_[j][sample_res] == travel_id);
+        outputs[idx + idx_offset][user_feature_num] = layer_ids_[j][sample_res];
         outputs[idx + idx_offset][user_feature_num + 1] = 0;
       }
       idx += layer_counts_[j];
@@ -99,21 +104,21 @@ void LayerWiseSampler::sample_from_dataset(
       auto target_id =
           data.uint64_feasigns_[sample_feasign_idx].sign().uint64_feasign_;
       auto travel_codes = tree_->GetTravelCodes(target_id, start_sample_layer_);
-      auto travel_path = tree_->GetNodes(travel_codes);
-      for (unsigned int j = 0; j < travel_path.size(); j++) {
+      for (unsigned int j = 0; j < travel_codes.size(); j++) {
+        uint64_t travel_id = tree_->GetNodeId(travel_codes[j]);
         paddle::framework::Record instance(data);
         instance.uint64_feasigns_[sample_feasign_idx].sign().uint64_feasign_ =
-            travel_path[j].id();
+            travel_id;
         sample_results->push_back(instance);
         for (int idx_offset = 0; idx_offset < layer_counts_[j]; idx_offset++) {
           int sample_res = 0;
           do {
             sample_res = sampler_vec_[j]->Sample();
-          } while (layer_ids_[j][sample_res].id() == travel_path[j].id());
+          } while (layer_ids_[j][sample_res] == travel_id);
           paddle::framework::Record instance(data);
           instance.uint64_feasigns_[sample_feasign_idx].sign().uint64_feasign_ =
-              layer_ids_[j][sample_res].id();
-          VLOG(1) << "layer id :" << layer_ids_[j][sample_res].id();
+              layer_ids_[j][sample_res];
+          VLOG(1) << "layer id :" << layer_ids_[j][sample_res];
           // sample_feasign_idx + 1 == label's id
           instance.uint64_feasigns_[sample_feasign_idx + 1]
               .sign()
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/distributed/index_dataset/index_wrapper.h"
@@ -106,7 +107,11 @@ class LayerWiseSampler : public IndexSampler {
     size_t idx = 0;
     while (layer_index >= start_sample_layer_) {
       auto layer_codes = tree_->GetLayerCodes(layer_index);
-      layer_ids_.push_back(tree_->GetNodes(layer_codes));
+      std::vector<uint64_t> layer_ids(layer_codes.size());
+      for (size_t i = 0; i < layer_codes.size(); i++) {
+        layer_ids[i] = tree_->GetNodeId(layer_codes[i]);
+      }
+      layer_ids_.push_back(std::move(layer_ids));
       auto sampler_temp =
           std::make_shared<paddle::operators::math::UniformSampler>(
               layer_ids_[idx].size() - 1, seed_);
@@ -132,7 +137,7 @@ class LayerWiseSampler : public IndexSampler {
   int seed_{0};
   int start_sample_layer_{1};
   std::vector<std::shared_ptr<paddle::operators::math::Sampler>> sampler_vec_;
-  std::vector<std::vector<IndexNode>> layer_ids_;
+  std::vector<std::vector<uint64_t>> layer_ids_;
 };
 
 }  // end namespace distributed
@@ -11,11 +11,11 @@ limitations under the License. */
 
 #include "paddle/fluid/distributed/index_dataset/index_wrapper.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <thread>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/framework/io/fs.h"
@@ -25,6 +25,31 @@ namespace distributed {
 
 std::shared_ptr<IndexWrapper> IndexWrapper::s_instance_(nullptr);
 
+namespace {
+
+// Runs func(begin, end) over [0, num) on several threads once a batch is
+// big enough to pay for them.
+template <typename Func>
+void ParallelForRange(size_t num, Func func) {
+  constexpr size_t kMinBatchPerThread = 4096;
+  size_t thread_num = std::min<size_t>(
+      std::max(1U, std::thread::hardware_concurrency()),
+      num / kMinBatchPerThread);
+  if (thread_num <= 1) {
+    func(0, num);
+    return;
+  }
+  size_t chunk = (num + thread_num - 1) / thread_num;
+  std::vector<std::thread> threads;
+  threads.reserve(thread_num);
+  for (size_t begin = 0; begin < num; begin += chunk) {
+    threads.emplace_back(func, begin, std::min(num, begin + chunk));
+  }
+  for (auto& t : threads) t.join();
+}
+
+}  // namespace
+
 int TreeIndex::Load(const std::string filename) {
   int err_no;
   auto fp = paddle::framework::fs_open_read(filename, &err_no, "");
@@ -41,6 +66,13 @@ int TreeIndex::Load(const std::string filename) {
   fake_node_.set_is_leaf(false);
   fake_node_.set_probability(0.0);
   max_code_ = 0;
+  total_nodes_num_ = 0;
+  nodes_.clear();
+  valid_.clear();
+  // Codes of a TDM tree are dense, so the nodes live in an array indexed by
+  // code that grows as codes are read. Leaf ids are mapped once all ids are
+  // known.
+  std::vector<std::pair<uint64_t, uint64_t>> leaf_codes;
   size_t ret = fread(&num, sizeof(num), 1, fp.get());
   while (ret == 1 && num > 0) {
     std::string content(num, '\0');
@@ -76,21 +108,54 @@ int TreeIndex::Load(const std::string filename) {
       // PADDLE_ENFORCE_NE(node.id(), 0,
       //                  platform::errors::InvalidArgument(
       //                      "Node'id should not be equal to zero."));
-      if (node.is_leaf()) {
-        id_codes_map_[node.id()] = code;
-      }
-      data_[code] = node;
       if (node.id() > max_id_) {
         max_id_ = node.id();
       }
       if (code > max_code_) {
         max_code_ = code;
       }
+      if (code >= nodes_.size()) {
+        nodes_.resize(std::max<uint64_t>(code + 1, nodes_.size() * 2),
+                      fake_node_);
+        valid_.resize((nodes_.size() + 63) / 64, 0);
+      }
+      uint64_t bit = 1ULL << (code & 63);
+      if (!(valid_[code >> 6] & bit)) {
+        total_nodes_num_++;
+        valid_[code >> 6] |= bit;
+      }
+      if (node.is_leaf()) {
+        leaf_codes.emplace_back(node.id(), code);
+      }
+      nodes_[code] = std::move(node);
     }
     ret = fread(&num, sizeof(num), 1, fp.get());
   }
-  total_nodes_num_ = data_.size();
   max_code_ += 1;
+  nodes_.resize(max_code_, fake_node_);
+  nodes_.shrink_to_fit();
+  valid_.resize((max_code_ + 63) / 64, 0);
+
+  // Ids index the embedding table, so they are usually dense as well. Fall
+  // back to a hash map when the id space is much larger than the tree.
+  constexpr uint64_t kMaxIdsPerNode = 4;
+  dense_ids_ = max_id_ / kMaxIdsPerNode < total_nodes_num_;
+  id_codes_.clear();
+  sparse_id_codes_.clear();
+  if (dense_ids_) {
+    id_codes_.assign(max_id_ + 1, max_code_);
+    for (auto& leaf : leaf_codes) id_codes_[leaf.first] = leaf.second;
+  } else {
+    sparse_id_codes_.reserve(leaf_codes.size());
+    for (auto& leaf : leaf_codes) sparse_id_codes_[leaf.first] = leaf.second;
+  }
+
+  level_offsets_.assign(meta_.height() + 1, 0);
+  level_pows_.assign(meta_.height() + 1, 1);
+  for (int l = 1; l <= meta_.height(); l++) {
+    level_offsets_[l] = level_offsets_[l - 1] * meta_.branch() + 1;
+    level_pows_[l] = level_pows_[l - 1] * meta_.branch();
+  }
   return 0;
 }
 
@@ -99,7 +164,7 @@ std::vector<IndexNode> TreeIndex::GetNodes(const std::vector<uint64_t>& codes) {
   nodes.reserve(codes.size());
   for (size_t i = 0; i < codes.size(); i++) {
     if (CheckIsValid(codes[i])) {
-      nodes.push_back(data_.at(codes[i]));
+      nodes.push_back(nodes_[codes[i]]);
     } else {
       nodes.push_back(fake_node_);
     }
@@ -108,8 +173,8 @@ std::vector<IndexNode> TreeIndex::GetNodes(const std::vector<uint64_t>& codes) {
 }
 
 std::vector<uint64_t> TreeIndex::GetLayerCodes(int level) {
-  uint64_t level_num = static_cast<uint64_t>(std::pow(meta_.branch(), level));
-  uint64_t level_offset = level_num - 1;
+  uint64_t level_num = level_pows_[level];
+  uint64_t level_offset = level_offsets_[level];
 
   std::vector<uint64_t> res;
   res.reserve(level_num);
@@ -124,60 +189,49 @@ std::vector<uint64_t> TreeIndex::GetLayerCodes(int level) {
 
 std::vector<uint64_t> TreeIndex::GetAncestorCodes(
     const std::vector<uint64_t>& ids, int level) {
-  std::vector<uint64_t> res;
-  res.reserve(ids.size());
-
-  int cur_level;
-  for (size_t i = 0; i < ids.size(); i++) {
-    if (id_codes_map_.find(ids[i]) == id_codes_map_.end()) {
-      res.push_back(max_code_);
-    } else {
-      auto code = id_codes_map_.at(ids[i]);
-      cur_level = meta_.height() - 1;
-
-      while (level >= 0 && cur_level > level) {
-        code = (code - 1) / meta_.branch();
-        cur_level--;
+  std::vector<uint64_t> res(ids.size());
+  int leaf_level = meta_.height() - 1;
+  ParallelForRange(ids.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      auto code = GetLeafCode(ids[i]);
+      if (code != max_code_ && level >= 0 && level < leaf_level) {
+        code = GetAncestorCode(code, leaf_level, level);
       }
-      res.push_back(code);
+      res[i] = code;
     }
-  }
+  });
   return res;
 }
 
 std::vector<uint64_t> TreeIndex::GetChildrenCodes(uint64_t ancestor,
                                                   int level) {
-  auto level_code_num = static_cast<uint64_t>(std::pow(meta_.branch(), level));
-  auto code_min = level_code_num - 1;
-  auto code_max = meta_.branch() * level_code_num - 1;
-
-  std::vector<uint64_t> parent;
-  parent.push_back(ancestor);
+  int ancestor_level = 0;
+  while (ancestor_level < meta_.height() &&
+         ancestor >= level_offsets_[ancestor_level + 1]) {
+    ancestor_level++;
+  }
   std::vector<uint64_t> res;
-  size_t p_idx = 0;
-  while (true) {
-    size_t p_size = parent.size();
-    for (; p_idx < p_size; p_idx++) {
-      for (int i = 0; i < meta_.branch(); i++) {
-        auto code = parent[p_idx] * meta_.branch() + i + 1;
-        if (data_.find(code) != data_.end()) parent.push_back(code);
-      }
-    }
-    if ((code_min <= parent[p_idx]) && (parent[p_idx] < code_max)) {
-      break;
-    }
+  if (level < ancestor_level || level >= meta_.height()) {
+    return res;
   }
-
-  return std::vector<uint64_t>(parent.begin() + p_idx, parent.end());
+  // The descendants of ancestor at level are a contiguous range of codes.
+  auto span = level_pows_[level - ancestor_level];
+  auto code_min = level_offsets_[level] +
+                  (ancestor - level_offsets_[ancestor_level]) * span;
+  res.reserve(span);
+  for (auto code = code_min; code < code_min + span; code++) {
+    if (CheckIsValid(code)) res.push_back(code);
+  }
+  return res;
 }
 
 std::vector<uint64_t> TreeIndex::GetTravelCodes(uint64_t id, int start_level) {
   std::vector<uint64_t> res;
-  PADDLE_ENFORCE_NE(id_codes_map_.find(id),
-                    id_codes_map_.end(),
+  auto code = GetLeafCode(id);
+  PADDLE_ENFORCE_NE(code,
+                    max_code_,
                     paddle::platform::errors::InvalidArgument(
                         "id = %d doesn't exist in Tree.", id));
-  auto code = id_codes_map_.at(id);
   int level = meta_.height() - 1;
 
   while (level >= start_level) {
@@ -188,12 +242,35 @@ std::vector<uint64_t> TreeIndex::GetTravelCodes(uint64_t id, int start_level) {
   return res;
 }
 
+std::vector<uint64_t> TreeIndex::GetTravelCodes(
+    const std::vector<uint64_t>& ids, int start_level) {
+  int leaf_level = meta_.height() - 1;
+  size_t path_len = std::max(leaf_level - start_level + 1, 0);
+  for (auto id : ids) {
+    PADDLE_ENFORCE_NE(GetLeafCode(id),
+                      max_code_,
+                      paddle::platform::errors::InvalidArgument(
+                          "id = %d doesn't exist in Tree.", id));
+  }
+  std::vector<uint64_t> res(ids.size() * path_len);
+  ParallelForRange(ids.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      auto code = GetLeafCode(ids[i]);
+      uint64_t* row = res.data() + i * path_len;
+      for (size_t j = 0; j < path_len; j++) {
+        row[j] = GetAncestorCode(code, leaf_level, leaf_level - j);
+      }
+    }
+  });
+  return res;
+}
+
 std::vector<IndexNode> TreeIndex::GetAllLeafs() {
   std::vector<IndexNode> res;
-  res.reserve(id_codes_map_.size());
-  for (auto& ite : id_codes_map_) {
-    auto code = ite.second;
-    res.push_back(data_.at(code));
+  for (uint64_t code = 0; code < max_code_; code++) {
+    if (CheckIsValid(code) && nodes_[code].is_leaf()) {
+      res.push_back(nodes_[code]);
+    }
   }
   return res;
 }
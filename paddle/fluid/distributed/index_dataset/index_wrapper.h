@@ -41,12 +41,34 @@ class TreeIndex : public Index {
   uint64_t EmbSize() { return max_id_ + 1; }
   int Load(const std::string path);
 
-  inline bool CheckIsValid(int code) {
-    if (data_.find(code) != data_.end()) {
-      return true;
-    } else {
-      return false;
+  // Nodes are stored in an array indexed by code, with one validity bit
+  // per code, so every lookup below is an array access.
+  inline bool CheckIsValid(uint64_t code) {
+    return code < max_code_ && ((valid_[code >> 6] >> (code & 63)) & 1);
+  }
+  // Returns the code of leaf id, or max_code_ if id is not a leaf.
+  inline uint64_t GetLeafCode(uint64_t id) {
+    if (!dense_ids_) {
+      auto iter = sparse_id_codes_.find(id);
+      return iter == sparse_id_codes_.end() ? max_code_ : iter->second;
+    }
+    return id < id_codes_.size() ? id_codes_[id] : max_code_;
+  }
+  // Returns the id of the node at code, or the id of fake_node_.
+  inline uint64_t GetNodeId(uint64_t code) {
+    return CheckIsValid(code) ? nodes_[code].id() : fake_node_.id();
+  }
+  // Returns the ancestor at level of the node at code, which sits at
+  // code_level. A node at level l has code level_offsets_[l] + i and its
+  // ancestor d levels up is level_offsets_[l - d] + i / branch^d.
+  inline uint64_t GetAncestorCode(uint64_t code, int code_level, int level) {
+    if (code < level_offsets_[code_level]) {
+      // Not really at code_level, walk up one parent at a time.
+      for (int l = code_level; l > level; l--) code = (code - 1) / Branch();
+      return code;
     }
+    return level_offsets_[level] + (code - level_offsets_[code_level]) /
+                                       level_pows_[code_level - level];
   }
 
   std::vector<IndexNode> GetNodes(const std::vector<uint64_t>& codes);
@@ -55,10 +77,22 @@ class TreeIndex : public Index {
                                          int level);
   std::vector<uint64_t> GetChildrenCodes(uint64_t ancestor, int level);
   std::vector<uint64_t> GetTravelCodes(uint64_t id, int start_level);
+  // Travel codes of a batch of ids, row i holds the Height() - start_level
+  // codes of ids[i] from the leaf up.
+  std::vector<uint64_t> GetTravelCodes(const std::vector<uint64_t>& ids,
+                                       int start_level);
   std::vector<IndexNode> GetAllLeafs();
 
-  std::unordered_map<uint64_t, IndexNode> data_;
-  std::unordered_map<uint64_t, uint64_t> id_codes_map_;
+  std::vector<IndexNode> nodes_;
+  std::vector<uint64_t> valid_;
+  // Leaf id -> code. An array indexed by id when the ids are dense enough,
+  // a hash map otherwise, so a few huge ids do not blow up the memory.
+  bool dense_ids_ = true;
+  std::vector<uint64_t> id_codes_;
+  std::unordered_map<uint64_t, uint64_t> sparse_id_codes_;
+  // First code of each level and powers of the branch, Height() + 1 each.
+  std::vector<uint64_t> level_offsets_;
+  std::vector<uint64_t> level_pows_;
   uint64_t total_nodes_num_;
   TreeMeta meta_;
   uint64_t max_id_;
@@ -513,6 +513,52 @@ std::future<int32_t> GraphBrpcClient::batch_sample_neighbors(
 
   return fut;
 }
+std::future<int32_t> GraphBrpcClient::sample_multi_hop(
+    uint32_t table_id,
+    int idx_,
+    std::vector<int64_t> seeds,
+    std::vector<int> fanouts,
+    bool need_weight,
+    int server_index,
+    GraphSubgraph &res) {
+  DownpourBrpcClosure *closure = new DownpourBrpcClosure(1, [&](void *done) {
+    int ret = 0;
+    auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
+    if (closure->check_response(0, PS_GRAPH_SAMPLE_MULTI_HOP) != 0) {
+      ret = -1;
+    } else {
+      auto &res_io_buffer = closure->cntl(0)->response_attachment();
+      butil::IOBufBytesIterator io_buffer_itr(res_io_buffer);
+      size_t bytes_size = io_buffer_itr.bytes_left();
+      std::unique_ptr<char[]> buffer(new char[bytes_size]);
+      io_buffer_itr.copy_and_forward(reinterpret_cast<void *>(buffer.get()),
+                                     bytes_size);
+      ret = res.recover_from_buffer(buffer.get(), bytes_size);
+    }
+    closure->set_promise_value(ret);
+  });
+  auto promise = std::make_shared<std::promise<int32_t>>();
+  closure->add_promise(promise);
+  std::future<int> fut = promise->get_future();
+
+  closure->request(0)->set_cmd_id(PS_GRAPH_SAMPLE_MULTI_HOP);
+  closure->request(0)->set_table_id(table_id);
+  closure->request(0)->set_client_id(_client_id);
+  closure->request(0)->add_params(reinterpret_cast<char *>(&idx_), sizeof(int));
+  closure->request(0)->add_params(reinterpret_cast<char *>(seeds.data()),
+                                  sizeof(int64_t) * seeds.size());
+  closure->request(0)->add_params(reinterpret_cast<char *>(fanouts.data()),
+                                  sizeof(int) * fanouts.size());
+  closure->request(0)->add_params(reinterpret_cast<char *>(&need_weight),
+                                  sizeof(bool));
+
+  GraphPsService_Stub rpc_stub = getServiceStub(GetCmdChannel(server_index));
+  closure->cntl(0)->set_log_id(butil::gettimeofday_ms());
+  rpc_stub.service(
+      closure->cntl(0), closure->request(0), closure->response(0), closure);
+  return fut;
+}
+
 std::future<int32_t> GraphBrpcClient::random_sample_nodes(
     uint32_t table_id,
     int type_id,
@@ -76,6 +76,17 @@ class GraphBrpcClient : public BrpcPsClient {
       bool need_weight,
       int server_index = -1);
 
+  // samples all hops of fanouts on one server and gets the reindexed
+  // subgraph back in a single response
+  virtual std::future<int32_t> sample_multi_hop(
+      uint32_t table_id,
+      int idx,
+      std::vector<int64_t> seeds,
+      std::vector<int> fanouts,
+      bool need_weight,
+      int server_index,
+      GraphSubgraph& res);  // NOLINT
+
   virtual std::future<int32_t> pull_graph_list(
       uint32_t table_id,
       int type_id,
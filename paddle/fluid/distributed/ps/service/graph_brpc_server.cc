@@ -206,6 +206,8 @@ int32_t GraphBrpcService::Initialize() {
   _service_handler_map[PS_PULL_GRAPH_LIST] = &GraphBrpcService::pull_graph_list;
   _service_handler_map[PS_GRAPH_SAMPLE_NEIGHBORS] =
       &GraphBrpcService::graph_random_sample_neighbors;
+  _service_handler_map[PS_GRAPH_SAMPLE_MULTI_HOP] =
+      &GraphBrpcService::graph_sample_multi_hop;
   _service_handler_map[PS_GRAPH_SAMPLE_NODES] =
       &GraphBrpcService::graph_random_sample_nodes;
   _service_handler_map[PS_GRAPH_GET_NODE_FEAT] =
@@ -429,6 +431,52 @@ int32_t GraphBrpcService::graph_random_sample_neighbors(
   }
   return 0;
 }
+int32_t GraphBrpcService::graph_sample_multi_hop(
+    Table *table,
+    const PsRequestMessage &request,
+    PsResponseMessage &response,
+    brpc::Controller *cntl) {
+  CHECK_TABLE_EXIST(table, request, response)
+  if (request.params_size() < 4) {
+    set_response_code(
+        response,
+        -1,
+        "graph_sample_multi_hop request requires at least 4 arguments");
+    return 0;
+  }
+  if (request.params(0).size() != sizeof(int) ||
+      request.params(1).size() % sizeof(uint64_t) != 0 ||
+      request.params(2).size() % sizeof(int) != 0 ||
+      request.params(3).size() != sizeof(bool)) {
+    set_response_code(
+        response, -1, "graph_sample_multi_hop request has malformed arguments");
+    return 0;
+  }
+  int idx_ = *reinterpret_cast<const int *>(request.params(0).c_str());
+  const uint64_t *seed_data =
+      reinterpret_cast<const uint64_t *>(request.params(1).c_str());
+  std::vector<uint64_t> seeds(
+      seed_data, seed_data + request.params(1).size() / sizeof(uint64_t));
+  const int *fanout_data =
+      reinterpret_cast<const int *>(request.params(2).c_str());
+  std::vector<int> fanouts(
+      fanout_data, fanout_data + request.params(2).size() / sizeof(int));
+  const bool need_weight =
+      *reinterpret_cast<const bool *>(request.params(3).c_str());
+  GraphSubgraph subgraph;
+  if ((reinterpret_cast<GraphTable *>(table))
+          ->sample_multi_hop(idx_, seeds, fanouts, need_weight, &subgraph) !=
+      0) {
+    set_response_code(
+        response, -1, "graph_sample_multi_hop got an invalid idx or fanout");
+    return 0;
+  }
+
+  std::unique_ptr<char[]> buffer(new char[subgraph.get_size()]);
+  subgraph.to_buffer(buffer.get());
+  cntl->response_attachment().append(buffer.get(), subgraph.get_size());
+  return 0;
+}
 int32_t GraphBrpcService::graph_random_sample_nodes(
     Table *table,
     const PsRequestMessage &request,
@@ -86,6 +86,10 @@ class GraphBrpcService : public PsBaseService {
                                         const PsRequestMessage &request,
                                         PsResponseMessage &response,  // NOLINT
                                         brpc::Controller *cntl);
+  int32_t graph_sample_multi_hop(Table *table,
+                                 const PsRequestMessage &request,
+                                 PsResponseMessage &response,  // NOLINT
+                                 brpc::Controller *cntl);
   int32_t graph_random_sample_nodes(Table *table,
                                     const PsRequestMessage &request,
                                     PsResponseMessage &response,  // NOLINT
@@ -37,6 +37,7 @@ PHI_DECLARE_bool(graph_get_neighbor_id);
 PHI_DECLARE_int32(gpugraph_storage_mode);
 PHI_DECLARE_uint64(gpugraph_slot_feasign_max_num);
 PHI_DECLARE_bool(graph_metapath_split_opt);
+PHI_DECLARE_bool(graph_edges_to_csr);
 
 namespace paddle {
 namespace distributed {
@@ -192,6 +193,20 @@ paddle::framework::GpuPsCommGraph GraphTable::make_gpu_ps_graph(
         for (size_t j = 0; j < bags[i].size(); j++) {
           auto node_id = bags[i][j];
           node_array[i][j] = node_id;
+          GraphCSR *csr = get_edge_csr(idx, node_id);
+          if (csr != nullptr) {
+            int64_t pos = csr->find(node_id);
+            info_array[i][j].neighbor_offset = edge_array[i].size();
+            info_array[i][j].neighbor_size =
+                pos < 0 ? 0 : csr->get_degree(pos);
+            if (pos >= 0) {
+              const uint64_t *neighbors = csr->neighbor_ids(pos);
+              edge_array[i].insert(edge_array[i].end(),
+                                   neighbors,
+                                   neighbors + csr->get_degree(pos));
+            }
+            continue;
+          }
           Node *v = find_node(GraphTableType::EDGE_TABLE, idx, node_id);
           if (v != nullptr) {
             info_array[i][j].neighbor_offset = edge_array[i].size();
@@ -1066,7 +1081,22 @@ void BasicBfsGraphSampler::init(size_t gpu_num, GraphTable *graph_table,
 
 #endif
 */
+void GraphShard::check_not_frozen() const {
+  PADDLE_ENFORCE_EQ(
+      csr,
+      nullptr,
+      paddle::platform::errors::PreconditionNotMet(
+          "The edges of the graph shard are frozen into a csr snapshot, "
+          "clear the graph before changing its nodes or edges."));
+}
+
 std::vector<Node *> GraphShard::get_batch(int start, int end, int step) {
+  PADDLE_ENFORCE_EQ(
+      is_csr_only(),
+      false,
+      paddle::platform::errors::Unimplemented(
+          "The nodes of the graph shard are released into a csr snapshot, "
+          "get_batch is not supported, list the ids by get_ids_by_range."));
   if (start < 0) start = 0;
   std::vector<Node *> res;
   for (int pos = start; pos < std::min(end, static_cast<int>(bucket.size()));
@@ -1076,7 +1106,52 @@ std::vector<Node *> GraphShard::get_batch(int start, int end, int step) {
   return res;
 }
 
-size_t GraphShard::get_size() { return bucket.size(); }
+size_t GraphShard::get_size() {
+  return is_csr_only() ? csr->node_size() : bucket.size();
+}
+
+void GraphShard::build_csr(bool release_nodes) {
+  // Rebuilding a released shard would replace its edges with an empty csr.
+  if (is_csr_only()) return;
+  csr.reset(new GraphCSR());
+  csr->build(bucket);
+  if (release_nodes) {
+    for (size_t i = 0; i < bucket.size(); i++) {
+      delete bucket[i];
+    }
+    std::vector<Node *>().swap(bucket);
+    std::unordered_map<uint64_t, int>().swap(node_location);
+  }
+}
+
+void GraphShard::unfreeze_csr() {
+  if (is_csr_only()) {
+    bool is_weighted = csr->is_weighted();
+    bucket.reserve(csr->node_size());
+    for (size_t pos = 0; pos < csr->node_size(); pos++) {
+      auto *node = new GraphNode(csr->get_id(pos));
+      node->build_edges(is_weighted);
+      const uint64_t *neighbors = csr->neighbor_ids(pos);
+      const float *weights = csr->neighbor_weights(pos);
+      for (size_t i = 0; i < csr->get_degree(pos); i++) {
+        node->add_edge(neighbors[i], weights == nullptr ? 1.0 : weights[i]);
+      }
+      node_location[node->get_id()] = bucket.size();
+      bucket.push_back(node);
+    }
+  }
+  csr.reset();
+}
+
+int GraphShard::load_csr(const std::string &path) {
+  clear();
+  csr.reset(new GraphCSR());
+  if (csr->load(path) != 0) {
+    csr.reset();
+    return -1;
+  }
+  return 0;
+}
 
 int32_t GraphTable::add_comm_edge(int idx, uint64_t src_id, uint64_t dst_id) {
   size_t src_shard_id = src_id % shard_num;
@@ -1150,11 +1225,13 @@ void GraphShard::clear() {
   }
   bucket.clear();
   node_location.clear();
+  csr.reset();
 }
 
 GraphShard::~GraphShard() { clear(); }
 
 void GraphShard::delete_node(uint64_t id) {
+  check_not_frozen();
   auto iter = node_location.find(id);
   if (iter == node_location.end()) return;
   int pos = iter->second;
@@ -1167,6 +1244,7 @@ void GraphShard::delete_node(uint64_t id) {
   bucket.pop_back();
 }
 GraphNode *GraphShard::add_graph_node(uint64_t id) {
+  check_not_frozen();
   if (node_location.find(id) == node_location.end()) {
     node_location[id] = bucket.size();
     bucket.push_back(new GraphNode(id));
@@ -1175,6 +1253,7 @@ GraphNode *GraphShard::add_graph_node(uint64_t id) {
 }
 
 GraphNode *GraphShard::add_graph_node(Node *node) {
+  check_not_frozen();
   auto id = node->get_id();
   if (node_location.find(id) == node_location.end()) {
     node_location[id] = bucket.size();
@@ -1197,10 +1276,17 @@ FeatureNode *GraphShard::add_feature_node(uint64_t id, bool is_overlap) {
 }
 
 void GraphShard::add_neighbor(uint64_t id, uint64_t dst_id, float weight) {
+  check_not_frozen();
   find_node(id)->add_edge(dst_id, weight);
 }
 
 Node *GraphShard::find_node(uint64_t id) {
+  PADDLE_ENFORCE_EQ(
+      is_csr_only(),
+      false,
+      paddle::platform::errors::Unimplemented(
+          "The nodes of the graph shard are released into a csr snapshot, "
+          "look the node up in the csr instead."));
   auto iter = node_location.find(id);
   return iter == node_location.end() ? nullptr : bucket[iter->second];
 }
@@ -1712,9 +1798,90 @@ int32_t GraphTable::build_sampler(int idx, std::string sample_type) {
       bucket[i]->build_sampler(sample_type);
     }
   }
+  // Csr snapshots keep their alias tables in per-shard arrays, both
+  // "weighted" and "alias" sample by weight there.
+  if (sample_type != "random") {
+    std::vector<std::future<int>> tasks;
+    for (auto &shard : edge_shards[idx]) {
+      if (shard->get_csr() == nullptr) continue;
+      tasks.push_back(load_node_edge_task_pool->enqueue([&shard]() -> int {
+        shard->get_csr()->build_alias();
+        return 0;
+      }));
+    }
+    for (size_t i = 0; i < tasks.size(); i++) tasks[i].get();
+  }
   return 0;
 }
 
+int32_t GraphTable::build_csr(int idx, bool release_nodes) {
+  VLOG(0) << "begin build csr for edge_type[" << id_to_edge[idx] << "]";
+  std::vector<std::future<int>> tasks;
+  for (auto &shard : edge_shards[idx]) {
+    tasks.push_back(
+        load_node_edge_task_pool->enqueue([&shard, release_nodes]() -> int {
+          shard->build_csr(release_nodes);
+          return 0;
+        }));
+  }
+  for (size_t i = 0; i < tasks.size(); i++) tasks[i].get();
+  size_t mem_size = 0;
+  for (auto &shard : edge_shards[idx]) {
+    mem_size += shard->get_csr()->mem_size();
+  }
+  VLOG(0) << "finish build csr for edge_type[" << id_to_edge[idx]
+          << "], total " << mem_size << " bytes";
+  return 0;
+}
+
+std::string GraphTable::get_csr_path(int idx,
+                                     const std::string &path,
+                                     size_t index) {
+  return path + "/" + id_to_edge[idx] + "-" +
+         std::to_string(shard_start + index) + ".csr";
+}
+
+int32_t GraphTable::save_csr(int idx, const std::string &path) {
+  auto &shards = edge_shards[idx];
+  for (size_t i = 0; i < shards.size(); i++) {
+    if (shards[i]->get_csr() == nullptr) {
+      VLOG(0) << "csr of edge_type[" << id_to_edge[idx]
+              << "] is not built, call build_csr first";
+      return -1;
+    }
+  }
+  std::vector<std::future<int>> tasks;
+  for (size_t i = 0; i < shards.size(); i++) {
+    tasks.push_back(
+        load_node_edge_task_pool->enqueue([&shards, &path, i, idx, this]() {
+          return shards[i]->get_csr()->save(get_csr_path(idx, path, i));
+        }));
+  }
+  int32_t ret = 0;
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (tasks[i].get() != 0) ret = -1;
+  }
+  return ret;
+}
+
+int32_t GraphTable::load_csr(int idx, const std::string &path) {
+  auto &shards = edge_shards[idx];
+  std::vector<std::future<int>> tasks;
+  for (size_t i = 0; i < shards.size(); i++) {
+    tasks.push_back(
+        load_node_edge_task_pool->enqueue([&shards, &path, i, idx, this]() {
+          return shards[i]->load_csr(get_csr_path(idx, path, i));
+        }));
+  }
+  int32_t ret = 0;
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (tasks[i].get() != 0) ret = -1;
+  }
+  VLOG(0) << "load csr of edge_type[" << id_to_edge[idx] << "] from " << path
+          << (ret == 0 ? " successfully" : " failed");
+  return ret;
+}
+
 std::pair<uint64_t, uint64_t> GraphTable::parse_edge_file(
     const std::string &path, int idx, bool reverse) {
   std::string sample_type = "random";
@@ -1798,6 +1965,18 @@ int32_t GraphTable::load_edges(const std::string &path,
   uint64_t valid_count = 0;
 
   VLOG(0) << "Begin GraphTable::load_edges() edge_type[" << edge_type << "]";
+  if (FLAGS_graph_edges_to_csr) {
+    // The edges of the files loaded before are merged with the new ones and
+    // packed again below.
+    std::vector<std::future<int>> tasks;
+    for (auto &shard : edge_shards[idx]) {
+      tasks.push_back(load_node_edge_task_pool->enqueue([&shard]() -> int {
+        shard->unfreeze_csr();
+        return 0;
+      }));
+    }
+    for (size_t i = 0; i < tasks.size(); i++) tasks[i].get();
+  }
   if (FLAGS_graph_load_in_parallel) {
     std::vector<std::future<std::pair<uint64_t, uint64_t>>> tasks;
     for (size_t i = 0; i < paths.size(); i++) {
@@ -1835,7 +2014,11 @@ int32_t GraphTable::load_edges(const std::string &path,
   }
 #endif
 
-  if (!build_sampler_on_cpu) {
+  if (FLAGS_graph_edges_to_csr) {
+    // Samplers read neighbor spans from the csr, so the per-node samplers
+    // are not built and the nodes are released.
+    build_csr(idx, true);
+  } else if (!build_sampler_on_cpu) {
     // To reduce memory overhead, CPU samplers won't be created in gpugraph.
     // In order not to affect the sampler function of other scenario,
     // this optimization is only performed in load_edges function.
@@ -1890,6 +2073,14 @@ Node *GraphTable::find_node(GraphTableType table_type, int idx, uint64_t id) {
   Node *node = search_shards[index]->find_node(id);
   return node;
 }
+GraphCSR *GraphTable::get_edge_csr(int idx, uint64_t id) {
+  size_t shard_id = id % shard_num;
+  if (shard_id >= shard_end || shard_id < shard_start) {
+    return nullptr;
+  }
+  return edge_shards[idx][shard_id - shard_start]->get_csr();
+}
+
 uint32_t GraphTable::get_thread_pool_index(uint64_t node_id) {
   return node_id % shard_num % shard_num_per_server % task_pool_size_;
 }
@@ -2021,10 +2212,17 @@ int32_t GraphTable::random_sample_neighbors(
           index++;
         } else {
           node_id = id_list[i][k].node_key;
-          Node *node = find_node(GraphTableType::EDGE_TABLE, idx, node_id);
           int idy = seq_id[i][k];
           int &actual_size = actual_sizes[idy];
-          if (node == nullptr) {
+          GraphCSR *csr = get_edge_csr(idx, node_id);
+          int64_t csr_pos = -1;
+          Node *node = nullptr;
+          if (csr != nullptr) {
+            csr_pos = csr->find(node_id);
+          } else {
+            node = find_node(GraphTableType::EDGE_TABLE, idx, node_id);
+          }
+          if (node == nullptr && csr_pos < 0) {
 #ifdef PADDLE_WITH_HETERPS
             if (search_level == 2) {
               VLOG(2) << "enter sample from ssd for node_id " << node_id;
@@ -2042,7 +2240,16 @@ int32_t GraphTable::random_sample_neighbors(
             continue;
           }
           std::shared_ptr<char> &buffer = buffers[idy];
-          std::vector<int> res = node->sample_k(sample_size, rng);
+          std::vector<int> res;
+          const uint64_t *csr_ids = nullptr;
+          const float *csr_weights = nullptr;
+          if (csr_pos >= 0) {
+            csr->sample_k(csr_pos, sample_size, rng, &res);
+            csr_ids = csr->neighbor_ids(csr_pos);
+            csr_weights = csr->neighbor_weights(csr_pos);
+          } else {
+            res = node->sample_k(sample_size, rng);
+          }
           actual_size =
               res.size() * (need_weight ? (Node::id_size + Node::weight_size)
                                         : Node::id_size);
@@ -2058,11 +2265,15 @@ int32_t GraphTable::random_sample_neighbors(
             buffer.reset(buffer_addr, char_del);
           }
           for (int &x : res) {
-            id = node->get_neighbor_id(x);
+            id = csr_ids != nullptr ? csr_ids[x] : node->get_neighbor_id(x);
             memcpy(buffer_addr + offset, &id, Node::id_size);
             offset += Node::id_size;
             if (need_weight) {
-              weight = node->get_neighbor_weight(x);
+              if (csr_ids != nullptr) {
+                weight = csr_weights != nullptr ? csr_weights[x] : 1.0f;
+              } else {
+                weight = node->get_neighbor_weight(x);
+              }
               memcpy(buffer_addr + offset, &weight, Node::weight_size);
               offset += Node::weight_size;
             }
@@ -2082,6 +2293,128 @@ int32_t GraphTable::random_sample_neighbors(
   return 0;
 }
 
+int32_t GraphTable::sample_multi_hop(int idx,
+                                     const std::vector<uint64_t> &seeds,
+                                     const std::vector<int> &fanouts,
+                                     bool need_weight,
+                                     GraphSubgraph *res) {
+  res->clear();
+  if (idx < 0 || static_cast<size_t>(idx) >= edge_shards.size()) {
+    VLOG(0) << "sample_multi_hop got an invalid edge type index " << idx;
+    return -1;
+  }
+  for (int fanout : fanouts) {
+    if (fanout < 0) {
+      VLOG(0) << "sample_multi_hop got a negative fanout " << fanout;
+      return -1;
+    }
+  }
+  // Graph id -> subgraph index. The sampling tasks only read the node ids,
+  // the map is filled between the hops so that the indices do not depend on
+  // how the tasks are scheduled.
+  std::unordered_map<uint64_t, int64_t> id_map;
+  for (auto id : seeds) {
+    if (id_map.emplace(id, res->node_ids.size()).second) {
+      res->node_ids.push_back(id);
+    }
+  }
+  // Sampled neighbors of node i, still as graph ids.
+  std::vector<std::vector<uint64_t>> neighbor_ids;
+  std::vector<std::vector<float>> neighbor_weights;
+  size_t hop_begin = 0;
+  for (size_t hop = 0; hop < fanouts.size(); hop++) {
+    size_t hop_end = res->node_ids.size();
+    if (hop_begin == hop_end) break;
+    neighbor_ids.resize(hop_end);
+    if (need_weight) neighbor_weights.resize(hop_end);
+
+    std::vector<std::vector<size_t>> rows(task_pool_size_);
+    for (size_t i = hop_begin; i < hop_end; i++) {
+      rows[get_thread_pool_index(res->node_ids[i])].push_back(i);
+    }
+    std::vector<std::future<int>> tasks;
+    int sample_size = fanouts[hop];
+    for (size_t i = 0; i < rows.size(); i++) {
+      if (rows[i].empty()) continue;
+      tasks.push_back(_shards_task_pool[i]->enqueue([&, i, this]() -> int {
+        auto &rng = _shards_task_rng_pool[i];
+        std::vector<int> sampled;
+        for (size_t row : rows[i]) {
+          uint64_t node_id = res->node_ids[row];
+          auto &ids = neighbor_ids[row];
+          GraphCSR *csr = get_edge_csr(idx, node_id);
+          if (csr != nullptr) {
+            int64_t pos = csr->find(node_id);
+            if (pos < 0) continue;
+            csr->sample_k(pos, sample_size, rng, &sampled);
+            const uint64_t *csr_ids = csr->neighbor_ids(pos);
+            const float *csr_weights = csr->neighbor_weights(pos);
+            for (int x : sampled) {
+              ids.push_back(csr_ids[x]);
+              if (need_weight) {
+                neighbor_weights[row].push_back(
+                    csr_weights != nullptr ? csr_weights[x] : 1.0f);
+              }
+            }
+          } else {
+            Node *node = find_node(GraphTableType::EDGE_TABLE, idx, node_id);
+            if (node == nullptr) continue;
+            sampled = node->sample_k(sample_size, rng);
+            for (int x : sampled) {
+              ids.push_back(node->get_neighbor_id(x));
+              if (need_weight) {
+                neighbor_weights[row].push_back(node->get_neighbor_weight(x));
+              }
+            }
+          }
+        }
+        return 0;
+      }));
+    }
+    for (auto &t : tasks) t.get();
+    // New nodes are numbered in the order of the rows that reached them.
+    for (size_t row = hop_begin; row < hop_end; row++) {
+      for (auto id : neighbor_ids[row]) {
+        if (id_map.emplace(id, res->node_ids.size()).second) {
+          res->node_ids.push_back(id);
+        }
+      }
+    }
+    hop_begin = hop_end;
+  }
+
+  size_t node_num = res->node_ids.size();
+  neighbor_ids.resize(node_num);
+  if (need_weight) neighbor_weights.resize(node_num);
+  res->offsets.resize(node_num + 1);
+  res->offsets[0] = 0;
+  for (size_t i = 0; i < node_num; i++) {
+    res->offsets[i + 1] = res->offsets[i] + neighbor_ids[i].size();
+  }
+  res->neighbors.resize(res->offsets[node_num]);
+  if (need_weight) res->weights.resize(res->offsets[node_num]);
+  // Every id has its final index now, the tasks below only read the map.
+  std::vector<std::future<int>> tasks;
+  size_t chunk = (node_num + task_pool_size_ - 1) / task_pool_size_;
+  for (size_t i = 0; i * chunk < node_num; i++) {
+    tasks.push_back(_shards_task_pool[i]->enqueue([&, i, this]() -> int {
+      size_t end = std::min(node_num, (i + 1) * chunk);
+      for (size_t row = i * chunk; row < end; row++) {
+        int64_t offset = res->offsets[row];
+        for (size_t j = 0; j < neighbor_ids[row].size(); j++) {
+          res->neighbors[offset + j] = id_map.at(neighbor_ids[row][j]);
+          if (need_weight) {
+            res->weights[offset + j] = neighbor_weights[row][j];
+          }
+        }
+      }
+      return 0;
+    }));
+  }
+  for (auto &t : tasks) t.get();
+  return 0;
+}
+
 int32_t GraphTable::get_node_feat(int idx,
                                   const std::vector<uint64_t> &node_ids,
                                   const std::vector<std::string> &feature_names,
@@ -41,7 +41,9 @@
 #include "paddle/fluid/distributed/ps/table/accessor.h"
 #include "paddle/fluid/distributed/ps/table/common_table.h"
 #include "paddle/fluid/distributed/ps/table/graph/class_macro.h"
+#include "paddle/fluid/distributed/ps/table/graph/graph_csr.h"
 #include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
+#include "paddle/fluid/distributed/ps/table/graph/graph_subgraph.h"
 #include "paddle/fluid/string/string_helper.h"
 #include "paddle/phi/core/utils/rw_lock.h"
 
@@ -60,19 +62,26 @@ class GraphShard {
   std::vector<Node *> get_batch(int start, int end, int step);
   void get_ids_by_range(int start, int end, std::vector<uint64_t> *res) {
     res->reserve(res->size() + end - start);
+    if (is_csr_only()) {
+      for (int i = start; i < end && i < static_cast<int>(csr->node_size());
+           i++) {
+        res->emplace_back(csr->get_id(i));
+      }
+      return;
+    }
     for (int i = start; i < end && i < static_cast<int>(bucket.size()); i++) {
       res->emplace_back(bucket[i]->get_id());
     }
   }
   size_t get_all_id(std::vector<std::vector<uint64_t>> *shard_keys,
                     int slice_num) {
-    int bucket_num = bucket.size();
+    int bucket_num = get_size();
     shard_keys->resize(slice_num);
     for (int i = 0; i < slice_num; ++i) {
       (*shard_keys)[i].reserve(bucket_num / slice_num);
     }
     for (int i = 0; i < bucket_num; i++) {
-      uint64_t k = bucket[i]->get_id();
+      uint64_t k = is_csr_only() ? csr->get_id(i) : bucket[i]->get_id();
       (*shard_keys)[k % slice_num].emplace_back(k);
     }
     return bucket_num;
@@ -80,6 +89,11 @@ class GraphShard {
   size_t get_all_neighbor_id(std::vector<std::vector<uint64_t>> *total_res,
                              int slice_num) {
     std::vector<uint64_t> keys;
+    if (is_csr_only()) {
+      const uint64_t *begin = csr->neighbor_ids(0);
+      keys.assign(begin, begin + csr->edge_size());
+      return dedup2shard_keys(&keys, total_res, slice_num);
+    }
     for (size_t i = 0; i < bucket.size(); i++) {
       size_t neighbor_size = bucket[i]->get_neighbor_size();
       size_t n = keys.size();
@@ -130,6 +144,19 @@ class GraphShard {
     return node_location;
   }
 
+  // Packs the edges of this shard into a CSR snapshot. With release_nodes
+  // the GraphNode objects are freed and the snapshot becomes the only copy
+  // of the shard, then find_node and get_batch throw instead of returning
+  // nothing. Once the snapshot exists the shard is frozen, adding or
+  // deleting nodes and edges throws until it is cleared or unfrozen.
+  void build_csr(bool release_nodes);
+  // Drops the snapshot so that edges can be added again, the nodes released
+  // into it are rebuilt first.
+  void unfreeze_csr();
+  int load_csr(const std::string &path);
+  GraphCSR *get_csr() { return csr.get(); }
+  bool is_csr_only() const { return bucket.empty() && csr != nullptr; }
+
   void shrink_to_fit() {
     bucket.shrink_to_fit();
     for (size_t i = 0; i < bucket.size(); i++) {
@@ -155,6 +182,10 @@ class GraphShard {
  public:
   std::unordered_map<uint64_t, int> node_location;
   std::vector<Node *> bucket;
+  std::unique_ptr<GraphCSR> csr;
+
+ private:
+  void check_not_frozen() const;
 };
 
 enum LRUResponse { ok = 0, blocked = 1, err = 2 };
@@ -545,6 +576,19 @@ class GraphTable : public Table {
       std::vector<int> &actual_sizes,               // NOLINT
       bool need_weight);
 
+  // Samples fanouts[h] neighbors of every node first reached at hop h, for
+  // all hops in one call, and returns the union as a reindexed subgraph.
+  // Only nodes in the local shards are expanded, nodes owned by other
+  // servers appear in the subgraph without neighbors. New nodes are
+  // numbered in the order they are first reached, so the subgraph does not
+  // depend on the task pool. Returns -1 for an invalid idx or a negative
+  // fanout.
+  virtual int32_t sample_multi_hop(int idx,
+                                   const std::vector<uint64_t> &seeds,
+                                   const std::vector<int> &fanouts,
+                                   bool need_weight,
+                                   GraphSubgraph *res);
+
   int32_t random_sample_nodes(GraphTableType table_type,
                               int idx,
                               int sample_size,
@@ -742,6 +786,16 @@ class GraphTable : public Table {
 #endif
   virtual int32_t add_comm_edge(int idx, uint64_t src_id, uint64_t dst_id);
   virtual int32_t build_sampler(int idx, std::string sample_type = "random");
+  // Freezes the edges of edge type idx into one CSR snapshot per shard.
+  // random_sample_neighbors reads neighbor spans straight from the
+  // snapshots once they exist.
+  virtual int32_t build_csr(int idx, bool release_nodes);
+  // Snapshots are saved as <path>/<edge_type>-<shard_id>.csr and mapped
+  // back read-only by load_csr.
+  int32_t save_csr(int idx, const std::string &path);
+  int32_t load_csr(int idx, const std::string &path);
+  std::string get_csr_path(int idx, const std::string &path, size_t index);
+  GraphCSR *get_edge_csr(int idx, uint64_t id);
   void set_slot_feature_separator(const std::string &ch);
   void set_feature_separator(const std::string &ch);
 
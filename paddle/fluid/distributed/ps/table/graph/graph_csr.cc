@@ -0,0 +1,293 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_csr.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <unordered_set>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace distributed {
+
+size_t GraphCSR::get_data_size(uint64_t node_num,
+                               uint64_t edge_num,
+                               bool is_weighted) {
+  size_t size = sizeof(Header) + sizeof(uint64_t) * node_num +
+                sizeof(uint64_t) * (node_num + 1) + sizeof(uint64_t) * edge_num;
+  if (is_weighted) size += sizeof(float) * edge_num;
+  return size;
+}
+
+void GraphCSR::reset_views() {
+  const Header *header = reinterpret_cast<const Header *>(data_);
+  node_num_ = header->node_num;
+  edge_num_ = header->edge_num;
+  const char *p = data_ + sizeof(Header);
+  node_ids_ = reinterpret_cast<const uint64_t *>(p);
+  p += sizeof(uint64_t) * node_num_;
+  offsets_ = reinterpret_cast<const uint64_t *>(p);
+  p += sizeof(uint64_t) * (node_num_ + 1);
+  neighbors_ = reinterpret_cast<const uint64_t *>(p);
+  p += sizeof(uint64_t) * edge_num_;
+  weights_ =
+      header->is_weighted ? reinterpret_cast<const float *>(p) : nullptr;
+}
+
+void GraphCSR::build(const std::vector<Node *> &bucket) {
+  clear();
+  std::vector<std::pair<uint64_t, Node *>> order;
+  order.reserve(bucket.size());
+  uint64_t edge_num = 0;
+  for (auto *node : bucket) {
+    order.emplace_back(node->get_id(), node);
+    edge_num += node->get_neighbor_size();
+  }
+  std::sort(order.begin(),
+            order.end(),
+            [](const std::pair<uint64_t, Node *> &a,
+               const std::pair<uint64_t, Node *> &b) {
+              return a.first < b.first;
+            });
+
+  uint64_t node_num = order.size();
+  // Reserve room for weights up front and drop it afterwards if every
+  // weight turns out to be 1, which saves a second pass over the nodes.
+  data_size_ = get_data_size(node_num, edge_num, true);
+  data_ = static_cast<char *>(malloc(data_size_));
+  PADDLE_ENFORCE_NOT_NULL(
+      data_,
+      paddle::platform::errors::ResourceExhausted(
+          "Failed to allocate %d bytes for the graph csr.", data_size_));
+  Header *header = reinterpret_cast<Header *>(data_);
+  header->magic = kMagic;
+  header->version = kVersion;
+  header->node_num = node_num;
+  header->edge_num = edge_num;
+  header->is_weighted = 1;
+  reset_views();
+
+  uint64_t *node_ids = const_cast<uint64_t *>(node_ids_);
+  uint64_t *offsets = const_cast<uint64_t *>(offsets_);
+  uint64_t *neighbors = const_cast<uint64_t *>(neighbors_);
+  float *weights = const_cast<float *>(weights_);
+  bool is_weighted = false;
+  uint64_t offset = 0;
+  for (size_t i = 0; i < order.size(); i++) {
+    Node *node = order[i].second;
+    node_ids[i] = order[i].first;
+    offsets[i] = offset;
+    size_t degree = node->get_neighbor_size();
+    for (size_t j = 0; j < degree; j++) {
+      neighbors[offset + j] = node->get_neighbor_id(j);
+      float weight = node->get_neighbor_weight(j);
+      weights[offset + j] = weight;
+      if (weight != 1.0f) is_weighted = true;
+    }
+    offset += degree;
+  }
+  offsets[node_num] = offset;
+
+  if (!is_weighted) {
+    header->is_weighted = 0;
+    data_size_ = get_data_size(node_num, edge_num, false);
+    // Shrinking in place rarely fails, and the larger block stays valid
+    // when it does, so keep it rather than losing the csr.
+    char *shrunk = static_cast<char *>(realloc(data_, data_size_));
+    if (shrunk != nullptr) data_ = shrunk;
+    reset_views();
+  }
+}
+
+int GraphCSR::save(const std::string &path) const {
+  if (data_ == nullptr) {
+    VLOG(0) << "graph csr is empty, nothing is saved to " << path;
+    return -1;
+  }
+  FILE *fp = fopen(path.c_str(), "wb");
+  if (fp == nullptr) {
+    VLOG(0) << "open " << path << " failed: " << strerror(errno);
+    return -1;
+  }
+  size_t written = fwrite(data_, 1, data_size_, fp);
+  int ret = fclose(fp);
+  if (written != data_size_ || ret != 0) {
+    VLOG(0) << "write graph csr to " << path << " failed";
+    return -1;
+  }
+  return 0;
+}
+
+int GraphCSR::load(const std::string &path) {
+  clear();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    VLOG(0) << "open " << path << " failed: " << strerror(errno);
+    return -1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    VLOG(0) << path << " is not a graph csr file";
+    close(fd);
+    return -1;
+  }
+  size_t size = st.st_size;
+  void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    VLOG(0) << "mmap " << path << " failed: " << strerror(errno);
+    return -1;
+  }
+  if (!is_valid(static_cast<const char *>(addr), size)) {
+    VLOG(0) << path << " is not a graph csr file or is corrupted";
+    munmap(addr, size);
+    return -1;
+  }
+  data_ = static_cast<char *>(addr);
+  data_size_ = size;
+  is_mmap_ = true;
+  reset_views();
+  return 0;
+}
+
+bool GraphCSR::is_valid(const char *data, size_t size) {
+  const Header *header = reinterpret_cast<const Header *>(data);
+  if (header->magic != kMagic || header->version != kVersion ||
+      header->is_weighted > 1) {
+    return false;
+  }
+  // Bound the counts by the file size before computing the expected size,
+  // so that a corrupted header can not overflow it.
+  uint64_t max_num = size / sizeof(uint64_t);
+  if (header->node_num >= max_num || header->edge_num >= max_num ||
+      size != get_data_size(
+                  header->node_num, header->edge_num, header->is_weighted)) {
+    return false;
+  }
+  const uint64_t *node_ids =
+      reinterpret_cast<const uint64_t *>(data + sizeof(Header));
+  const uint64_t *offsets = node_ids + header->node_num;
+  // find() binary searches the ids and the spans are read unchecked, so the
+  // ids must be sorted and the offsets must be monotonic and end at edge_num.
+  if (offsets[0] != 0 || offsets[header->node_num] != header->edge_num) {
+    return false;
+  }
+  for (uint64_t i = 0; i < header->node_num; i++) {
+    if (offsets[i] > offsets[i + 1]) return false;
+    if (i > 0 && node_ids[i - 1] >= node_ids[i]) return false;
+  }
+  return true;
+}
+
+void GraphCSR::clear() {
+  if (data_ != nullptr) {
+    if (is_mmap_) {
+      munmap(data_, data_size_);
+    } else {
+      free(data_);
+    }
+  }
+  data_ = nullptr;
+  data_size_ = 0;
+  is_mmap_ = false;
+  node_num_ = edge_num_ = 0;
+  node_ids_ = offsets_ = neighbors_ = nullptr;
+  weights_ = nullptr;
+  std::vector<float>().swap(alias_prob_);
+  std::vector<uint32_t>().swap(alias_idx_);
+}
+
+void GraphCSR::build_alias() {
+  if (weights_ == nullptr) return;
+  alias_prob_.resize(edge_num_);
+  alias_idx_.resize(edge_num_);
+  for (size_t pos = 0; pos < node_num_; pos++) {
+    uint64_t offset = offsets_[pos];
+    AliasTable::build(weights_ + offset,
+                      get_degree(pos),
+                      alias_prob_.data() + offset,
+                      alias_idx_.data() + offset);
+  }
+}
+
+int64_t GraphCSR::find(uint64_t id) const {
+  const uint64_t *end = node_ids_ + node_num_;
+  const uint64_t *iter = std::lower_bound(node_ids_, end, id);
+  if (iter == end || *iter != id) return -1;
+  return iter - node_ids_;
+}
+
+void GraphCSR::sample_k(size_t pos,
+                        int k,
+                        const std::shared_ptr<std::mt19937_64> &rng,
+                        std::vector<int> *res) const {
+  if (has_alias()) {
+    uint64_t offset = offsets_[pos];
+    AliasTable::sample_k(weights_ + offset,
+                         alias_prob_.data() + offset,
+                         alias_idx_.data() + offset,
+                         get_degree(pos),
+                         k,
+                         rng,
+                         res);
+    return;
+  }
+  res->clear();
+  int n = static_cast<int>(get_degree(pos));
+  if (k >= n) {
+    res->resize(n);
+    std::iota(res->begin(), res->end(), 0);
+    return;
+  }
+  // Floyd's algorithm draws exactly k numbers and needs no table of size n.
+  // Small fanouts check membership in res itself.
+  res->reserve(k);
+  if (k <= 64) {
+    for (int j = n - k; j < n; j++) {
+      std::uniform_int_distribution<int> distrib(0, j);
+      int t = distrib(*rng);
+      if (std::find(res->begin(), res->end(), t) != res->end()) t = j;
+      res->push_back(t);
+    }
+    return;
+  }
+  std::unordered_set<int> picked;
+  picked.reserve(k);
+  for (int j = n - k; j < n; j++) {
+    std::uniform_int_distribution<int> distrib(0, j);
+    int t = distrib(*rng);
+    if (!picked.insert(t).second) {
+      t = j;
+      picked.insert(t);
+    }
+    res->push_back(t);
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
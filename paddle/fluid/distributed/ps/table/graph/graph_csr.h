@@ -0,0 +1,121 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
+#include "paddle/phi/core/macros.h"
+
+namespace paddle {
+namespace distributed {
+
+/*
+ * Immutable CSR snapshot of the edges of one graph shard.
+ *
+ * The snapshot is a single buffer holding a header followed by
+ *   node_ids[node_num]     sorted ascending
+ *   offsets[node_num + 1]  neighbors of node_ids[i] are [offsets[i],
+ *                          offsets[i + 1])
+ *   neighbors[edge_num]
+ *   weights[edge_num]      only when the shard is weighted
+ * The in-memory layout is also the file layout, so a saved snapshot is
+ * loaded with a single read-only mmap and sampled without any copy.
+ * Alias tables for weighted sampling are derived data and are kept in
+ * separate arrays indexed like neighbors, they are never saved.
+ */
+class GraphCSR {
+ public:
+  GraphCSR() {}
+  ~GraphCSR() { clear(); }
+
+  // Packs the edges of the GraphNode objects in bucket. Weights are kept
+  // only if some edge has a weight different from 1.
+  void build(const std::vector<Node *> &bucket);
+  int save(const std::string &path) const;
+  int load(const std::string &path);
+  void clear();
+  // Builds one AliasTable per node so that sample_k draws by weight.
+  // Unweighted snapshots keep sampling uniformly.
+  void build_alias();
+  bool has_alias() const { return !alias_prob_.empty(); }
+
+  size_t node_size() const { return node_num_; }
+  size_t edge_size() const { return edge_num_; }
+  bool is_weighted() const { return weights_ != nullptr; }
+  size_t mem_size() const { return data_size_; }
+
+  // Returns the position of id in node_ids, or -1 if id has no edges here.
+  int64_t find(uint64_t id) const;
+  uint64_t get_id(size_t pos) const { return node_ids_[pos]; }
+  size_t get_degree(size_t pos) const {
+    return offsets_[pos + 1] - offsets_[pos];
+  }
+  const uint64_t *neighbor_ids(size_t pos) const {
+    return neighbors_ + offsets_[pos];
+  }
+  // nullptr when the snapshot is unweighted.
+  const float *neighbor_weights(size_t pos) const {
+    return weights_ == nullptr ? nullptr : weights_ + offsets_[pos];
+  }
+
+  // Samples min(k, degree) distinct neighbor slots of the node at pos, by
+  // weight once build_alias has run and uniformly otherwise.
+  void sample_k(size_t pos,
+                int k,
+                const std::shared_ptr<std::mt19937_64> &rng,
+                std::vector<int> *res) const;
+
+ private:
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t node_num;
+    uint64_t edge_num;
+    uint64_t is_weighted;
+  };
+  static constexpr uint32_t kMagic = 0x53435047;  // "GPCS"
+  static constexpr uint32_t kVersion = 1;
+
+  static size_t get_data_size(uint64_t node_num,
+                              uint64_t edge_num,
+                              bool is_weighted);
+  // Checks the header and the layout of a mapped csr file of size bytes.
+  static bool is_valid(const char *data, size_t size);
+  void reset_views();
+
+  char *data_ = nullptr;
+  size_t data_size_ = 0;
+  bool is_mmap_ = false;
+
+  size_t node_num_ = 0;
+  size_t edge_num_ = 0;
+  const uint64_t *node_ids_ = nullptr;
+  const uint64_t *offsets_ = nullptr;
+  const uint64_t *neighbors_ = nullptr;
+  const float *weights_ = nullptr;
+
+  std::vector<float> alias_prob_;
+  std::vector<uint32_t> alias_idx_;
+
+  DISABLE_COPY_AND_ASSIGN(GraphCSR);
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -73,6 +73,8 @@ void GraphNode::build_sampler(std::string sample_type) {
     sampler = new RandomSampler();
   } else if (sample_type == "weighted") {
     sampler = new WeightedSampler();
+  } else if (sample_type == "alias") {
+    sampler = new AliasSampler();
   }
   sampler->build(edges);
 }
@@ -0,0 +1,80 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_subgraph.h"
+
+#include <cstring>
+
+namespace paddle {
+namespace distributed {
+
+void GraphSubgraph::clear() {
+  node_ids.clear();
+  offsets.clear();
+  neighbors.clear();
+  weights.clear();
+}
+
+size_t GraphSubgraph::get_size() const {
+  return sizeof(int64_t) * 3 + sizeof(uint64_t) * node_ids.size() +
+         sizeof(int64_t) * offsets.size() +
+         sizeof(int64_t) * neighbors.size() + sizeof(float) * weights.size();
+}
+
+void GraphSubgraph::to_buffer(char *buffer) const {
+  int64_t header[3] = {static_cast<int64_t>(node_ids.size()),
+                       static_cast<int64_t>(neighbors.size()),
+                       weights.empty() ? 0 : 1};
+  memcpy(buffer, header, sizeof(header));
+  buffer += sizeof(header);
+  memcpy(buffer, node_ids.data(), sizeof(uint64_t) * node_ids.size());
+  buffer += sizeof(uint64_t) * node_ids.size();
+  memcpy(buffer, offsets.data(), sizeof(int64_t) * offsets.size());
+  buffer += sizeof(int64_t) * offsets.size();
+  memcpy(buffer, neighbors.data(), sizeof(int64_t) * neighbors.size());
+  buffer += sizeof(int64_t) * neighbors.size();
+  memcpy(buffer, weights.data(), sizeof(float) * weights.size());
+}
+
+int GraphSubgraph::recover_from_buffer(const char *buffer, size_t size) {
+  clear();
+  int64_t header[3];
+  if (size < sizeof(header)) return -1;
+  memcpy(header, buffer, sizeof(header));
+  buffer += sizeof(header);
+  int64_t node_num = header[0], edge_num = header[1];
+  if (node_num < 0 || edge_num < 0) return -1;
+  size_t expected = sizeof(header) + sizeof(uint64_t) * node_num +
+                    sizeof(int64_t) * (node_num + 1) +
+                    sizeof(int64_t) * edge_num +
+                    (header[2] ? sizeof(float) * edge_num : 0);
+  if (size != expected) return -1;
+  node_ids.resize(node_num);
+  memcpy(node_ids.data(), buffer, sizeof(uint64_t) * node_num);
+  buffer += sizeof(uint64_t) * node_num;
+  offsets.resize(node_num + 1);
+  memcpy(offsets.data(), buffer, sizeof(int64_t) * (node_num + 1));
+  buffer += sizeof(int64_t) * (node_num + 1);
+  neighbors.resize(edge_num);
+  memcpy(neighbors.data(), buffer, sizeof(int64_t) * edge_num);
+  buffer += sizeof(int64_t) * edge_num;
+  if (header[2]) {
+    weights.resize(edge_num);
+    memcpy(weights.data(), buffer, sizeof(float) * edge_num);
+  }
+  return 0;
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,45 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace paddle {
+namespace distributed {
+
+/*
+ * A sampled subgraph in CSR form. Node i of the subgraph is node_ids[i] of
+ * the graph and its sampled neighbors are
+ * neighbors[offsets[i]:offsets[i + 1]], given as subgraph indices. Seeds
+ * come first, followed by the nodes first reached by each hop.
+ */
+struct GraphSubgraph {
+  std::vector<uint64_t> node_ids;
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> neighbors;
+  // Empty unless weights were requested.
+  std::vector<float> weights;
+
+  void clear();
+  // The buffer holds node_num, edge_num and has_weight as int64, then the
+  // four arrays above back to back.
+  size_t get_size() const;
+  void to_buffer(char *buffer) const;
+  int recover_from_buffer(const char *buffer, size_t size);
+};
+
+}  // namespace distributed
+}  // namespace paddle
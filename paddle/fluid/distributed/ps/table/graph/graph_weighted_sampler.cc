@@ -14,9 +14,15 @@
 
 #include "paddle/fluid/distributed/ps/table/graph/graph_weighted_sampler.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 #include "paddle/phi/core/generator.h"
 namespace paddle {
@@ -161,5 +167,148 @@ int WeightedSampler::sample(
   subtract_count_map[this]++;
   return return_idx;
 }
+
+void AliasTable::build(const float *weights,
+                       int n,
+                       float *prob,
+                       uint32_t *alias) {
+  double sum = 0;
+  for (int i = 0; i < n; i++) sum += weights == nullptr ? 1.0 : weights[i];
+  if (sum <= 0) {
+    // Degenerate weights fall back to uniform sampling.
+    weights = nullptr;
+    sum = n;
+  }
+  std::vector<double> scaled(n);
+  std::vector<uint32_t> small, large;
+  small.reserve(n);
+  large.reserve(n);
+  for (int i = 0; i < n; i++) {
+    scaled[i] = (weights == nullptr ? 1.0 : weights[i]) * n / sum;
+    if (scaled[i] < 1.0) {
+      small.push_back(i);
+    } else {
+      large.push_back(i);
+    }
+  }
+  while (!small.empty() && !large.empty()) {
+    uint32_t s = small.back();
+    uint32_t l = large.back();
+    small.pop_back();
+    large.pop_back();
+    prob[s] = scaled[s];
+    alias[s] = l;
+    scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+    if (scaled[l] < 1.0) {
+      small.push_back(l);
+    } else {
+      large.push_back(l);
+    }
+  }
+  // Whatever is left is 1 up to rounding error.
+  for (uint32_t i : large) {
+    prob[i] = 1.0f;
+    alias[i] = i;
+  }
+  for (uint32_t i : small) {
+    prob[i] = 1.0f;
+    alias[i] = i;
+  }
+}
+
+void AliasTable::sample_k(const float *weights,
+                          const float *prob,
+                          const uint32_t *alias,
+                          int n,
+                          int k,
+                          const std::shared_ptr<std::mt19937_64> &rng,
+                          std::vector<int> *res) {
+  res->clear();
+  if (k >= n) {
+    res->resize(n);
+    std::iota(res->begin(), res->end(), 0);
+    return;
+  }
+  res->reserve(k);
+  // One 64-bit draw gives both the slot (high half) and the coin (low half).
+  auto draw = [&]() -> int {
+    uint64_t r = (*rng)();
+    int i = static_cast<int>(((r >> 32) * static_cast<uint64_t>(n)) >> 32);
+    float u = static_cast<float>(r & 0xffffffffULL) * (1.0f / 4294967296.0f);
+    return u < prob[i] ? i : static_cast<int>(alias[i]);
+  };
+  if (2 * k <= n) {
+    // Redrawing on duplicates is the same as drawing from the weights of
+    // the remaining slots. Give up after a fixed budget, which only happens
+    // when a few heavy slots keep getting hit.
+    int budget = 4 * k + 16;
+    if (k <= 64) {
+      while (static_cast<int>(res->size()) < k && budget-- > 0) {
+        int x = draw();
+        if (std::find(res->begin(), res->end(), x) == res->end()) {
+          res->push_back(x);
+        }
+      }
+    } else {
+      std::unordered_set<int> picked;
+      picked.reserve(k);
+      while (static_cast<int>(res->size()) < k && budget-- > 0) {
+        int x = draw();
+        if (picked.insert(x).second) res->push_back(x);
+      }
+    }
+    if (static_cast<int>(res->size()) == k) return;
+    res->clear();
+  }
+  // Weighted reservoir sampling (Efraimidis-Spirakis): keep the k slots
+  // with the largest log(u) / w.
+  std::uniform_real_distribution<float> distrib(0, 1.0);
+  std::vector<std::pair<float, int>> keys(n);
+  for (int i = 0; i < n; i++) {
+    float w = weights == nullptr ? 1.0f : weights[i];
+    float u = distrib(*rng);
+    keys[i].first = w > 0 && u > 0 ? std::log(u) / w
+                                   : -std::numeric_limits<float>::infinity();
+    keys[i].second = i;
+  }
+  std::nth_element(keys.begin(),
+                   keys.begin() + k,
+                   keys.end(),
+                   [](const std::pair<float, int> &a,
+                      const std::pair<float, int> &b) {
+                     return a.first > b.first;
+                   });
+  for (int i = 0; i < k; i++) res->push_back(keys[i].second);
+}
+
+void AliasSampler::build(GraphEdgeBlob *edges) {
+  int n = edges->size();
+  WeightedGraphEdgeBlob *weighted_edges =
+      dynamic_cast<WeightedGraphEdgeBlob *>(edges);
+  // Keep a copy of the weights, the edge blob may grow and reallocate its
+  // weight array after the sampler is built.
+  weights.clear();
+  if (weighted_edges != nullptr) {
+    const std::vector<float> &edge_weights =
+        weighted_edges->export_weight_array();
+    weights.assign(edge_weights.begin(), edge_weights.begin() + n);
+  }
+  prob.resize(n);
+  alias.resize(n);
+  AliasTable::build(weights_data(), n, prob.data(), alias.data());
+}
+
+std::vector<int> AliasSampler::sample_k(
+    int k, const std::shared_ptr<std::mt19937_64> rng) {
+  std::vector<int> sample_result;
+  AliasTable::sample_k(weights_data(),
+                       prob.data(),
+                       alias.data(),
+                       prob.size(),
+                       k,
+                       rng,
+                       &sample_result);
+  return sample_result;
+}
 }  // namespace distributed
 }  // namespace paddle
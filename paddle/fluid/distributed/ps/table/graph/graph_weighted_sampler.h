@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <cstdint>
 #include <ctime>
 #include <memory>
 #include <random>
@@ -31,6 +32,25 @@ class Sampler {
       int k, const std::shared_ptr<std::mt19937_64> rng) = 0;
 };
 
+// Vose alias tables over a span of n edge weights. A table takes n floats
+// and n uint32s, is built in O(n) and draws one neighbor in O(1).
+// A null weights pointer stands for a span of unit weights.
+class AliasTable {
+ public:
+  static void build(const float *weights, int n, float *prob, uint32_t *alias);
+  // Samples min(k, n) distinct slots of the span, each draw weighted by the
+  // weights of the slots not picked yet. Small k redraws on duplicates;
+  // large k, or spans where redraws keep colliding, fall back to weighted
+  // reservoir sampling over the whole span.
+  static void sample_k(const float *weights,
+                       const float *prob,
+                       const uint32_t *alias,
+                       int n,
+                       int k,
+                       const std::shared_ptr<std::mt19937_64> &rng,
+                       std::vector<int> *res);
+};
+
 class RandomSampler : public Sampler {
  public:
   virtual ~RandomSampler() {}
@@ -62,5 +82,23 @@ class WeightedSampler : public Sampler {
       std::unordered_map<WeightedSampler *, int> &subtract_count_map,  // NOLINT
       float &subtract);                                                // NOLINT
 };
+
+class AliasSampler : public Sampler {
+ public:
+  virtual ~AliasSampler() {}
+  virtual void build(GraphEdgeBlob *edges);
+  virtual std::vector<int> sample_k(int k,
+                                    const std::shared_ptr<std::mt19937_64> rng);
+
+ private:
+  // Unweighted edges sample uniformly and keep no weights.
+  const float *weights_data() const {
+    return weights.empty() ? nullptr : weights.data();
+  }
+
+  std::vector<float> weights;
+  std::vector<float> prob;
+  std::vector<uint32_t> alias;
+};
 }  // namespace distributed
 }  // namespace paddle
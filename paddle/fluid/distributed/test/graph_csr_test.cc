@@ -0,0 +1,206 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_csr.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace distributed = paddle::distributed;
+
+// node id -> neighbor ids, inserted out of order on purpose.
+static std::vector<distributed::Node *> make_bucket(bool is_weighted) {
+  std::vector<distributed::Node *> bucket;
+  std::vector<uint64_t> ids = {97, 37, 59, 96, 11};
+  for (size_t i = 0; i < ids.size(); i++) {
+    auto *node = new distributed::GraphNode(ids[i]);
+    node->build_edges(is_weighted);
+    // Node 11 has no neighbors.
+    if (ids[i] != 11) {
+      for (uint64_t j = 0; j < ids[i] % 7 + 1; j++) {
+        node->add_edge(ids[i] * 100 + j, is_weighted ? 0.5f + j : 1.0f);
+      }
+    }
+    bucket.push_back(node);
+  }
+  return bucket;
+}
+
+static void check_csr(const distributed::GraphCSR &csr,
+                      const std::vector<distributed::Node *> &bucket) {
+  ASSERT_EQ(csr.node_size(), bucket.size());
+  size_t edge_num = 0;
+  for (auto *node : bucket) {
+    int64_t pos = csr.find(node->get_id());
+    ASSERT_GE(pos, 0);
+    ASSERT_EQ(csr.get_id(pos), node->get_id());
+    ASSERT_EQ(csr.get_degree(pos), node->get_neighbor_size());
+    for (size_t j = 0; j < node->get_neighbor_size(); j++) {
+      ASSERT_EQ(csr.neighbor_ids(pos)[j], node->get_neighbor_id(j));
+      if (csr.is_weighted()) {
+        ASSERT_EQ(csr.neighbor_weights(pos)[j], node->get_neighbor_weight(j));
+      }
+    }
+    edge_num += node->get_neighbor_size();
+  }
+  ASSERT_EQ(csr.edge_size(), edge_num);
+  for (size_t i = 1; i < csr.node_size(); i++) {
+    ASSERT_LT(csr.get_id(i - 1), csr.get_id(i));
+  }
+  ASSERT_EQ(csr.find(12345), -1);
+}
+
+TEST(GraphCSR, BuildAndSample) {
+  auto bucket = make_bucket(false);
+  distributed::GraphCSR csr;
+  csr.build(bucket);
+  EXPECT_FALSE(csr.is_weighted());
+  EXPECT_EQ(csr.neighbor_weights(0), nullptr);
+  check_csr(csr, bucket);
+
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  std::vector<int> res;
+  int64_t pos = csr.find(97);  // 97 % 7 + 1 = 7 neighbors
+  for (int k = 1; k <= 8; k++) {
+    csr.sample_k(pos, k, rng, &res);
+    ASSERT_EQ(res.size(), std::min<size_t>(k, 7));
+    std::set<int> picked(res.begin(), res.end());
+    ASSERT_EQ(picked.size(), res.size());
+    for (int x : res) {
+      ASSERT_GE(x, 0);
+      ASSERT_LT(x, 7);
+    }
+  }
+  csr.sample_k(csr.find(11), 3, rng, &res);
+  EXPECT_TRUE(res.empty());
+
+  for (auto *node : bucket) delete node;
+}
+
+TEST(GraphCSR, LargeFanout) {
+  distributed::GraphNode node(1);
+  node.build_edges(false);
+  for (int j = 0; j < 1000; j++) node.add_edge(j, 1.0f);
+  std::vector<distributed::Node *> bucket = {&node};
+  distributed::GraphCSR csr;
+  csr.build(bucket);
+
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  std::vector<int> res;
+  csr.sample_k(0, 500, rng, &res);
+  ASSERT_EQ(res.size(), 500UL);
+  std::set<int> picked(res.begin(), res.end());
+  ASSERT_EQ(picked.size(), 500UL);
+  EXPECT_LT(*picked.rbegin(), 1000);
+}
+
+TEST(GraphCSR, AliasSample) {
+  auto bucket = make_bucket(true);
+  distributed::GraphCSR csr;
+  csr.build(bucket);
+  csr.build_alias();
+  ASSERT_TRUE(csr.has_alias());
+
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  std::vector<int> res;
+  int64_t pos = csr.find(97);
+  // Weights of node 97 are 0.5, 1.5, ..., 6.5, so the last slot is picked
+  // 13 times as often as the first one.
+  std::vector<int> hits(7, 0);
+  for (int t = 0; t < 49000; t++) {
+    csr.sample_k(pos, 1, rng, &res);
+    ASSERT_EQ(res.size(), 1UL);
+    hits[res[0]]++;
+  }
+  EXPECT_GT(hits[6], 10 * hits[0]);
+  csr.sample_k(pos, 3, rng, &res);
+  std::set<int> picked(res.begin(), res.end());
+  EXPECT_EQ(picked.size(), 3UL);
+
+  for (auto *node : bucket) delete node;
+}
+
+TEST(GraphCSR, SaveAndLoad) {
+  auto bucket = make_bucket(true);
+  distributed::GraphCSR csr;
+  csr.build(bucket);
+  EXPECT_TRUE(csr.is_weighted());
+  check_csr(csr, bucket);
+
+  std::string path = "graph_csr_test.csr";
+  ASSERT_EQ(csr.save(path), 0);
+  distributed::GraphCSR loaded;
+  ASSERT_EQ(loaded.load(path), 0);
+  EXPECT_TRUE(loaded.is_weighted());
+  EXPECT_EQ(loaded.mem_size(), csr.mem_size());
+  check_csr(loaded, bucket);
+
+  // A truncated file is rejected.
+  FILE *fp = fopen(path.c_str(), "wb");
+  fwrite("GPCS", 1, 4, fp);
+  fclose(fp);
+  EXPECT_EQ(loaded.load(path), -1);
+  EXPECT_EQ(loaded.node_size(), 0UL);
+  EXPECT_EQ(loaded.load("not_exist.csr"), -1);
+  remove(path.c_str());
+
+  for (auto *node : bucket) delete node;
+}
+
+TEST(GraphCSR, LoadRejectsCorruptedLayout) {
+  auto bucket = make_bucket(false);
+  distributed::GraphCSR csr;
+  csr.build(bucket);
+  std::string path = "graph_csr_corrupted_test.csr";
+  ASSERT_EQ(csr.save(path), 0);
+  std::vector<char> data(csr.mem_size());
+  FILE *fp = fopen(path.c_str(), "rb");
+  ASSERT_EQ(fread(data.data(), 1, data.size(), fp), data.size());
+  fclose(fp);
+
+  // The header is 32 bytes, followed by the node ids and the offsets.
+  size_t node_num = csr.node_size();
+  size_t ids_begin = 32;
+  size_t offsets_begin = ids_begin + sizeof(uint64_t) * node_num;
+  auto load_patched = [&](size_t byte_offset, uint64_t value) {
+    std::vector<char> patched = data;
+    memcpy(patched.data() + byte_offset, &value, sizeof(value));
+    FILE *out = fopen(path.c_str(), "wb");
+    fwrite(patched.data(), 1, patched.size(), out);
+    fclose(out);
+    distributed::GraphCSR loaded;
+    return loaded.load(path);
+  };
+  EXPECT_EQ(load_patched(0, 0), -1);  // bad magic and version
+  // Offsets running past the edges or going backwards.
+  EXPECT_EQ(load_patched(offsets_begin + sizeof(uint64_t), uint64_t{1} << 40),
+            -1);
+  EXPECT_EQ(load_patched(offsets_begin + sizeof(uint64_t) * node_num, 0), -1);
+  // Node ids out of order break find().
+  EXPECT_EQ(load_patched(ids_begin, uint64_t{1} << 40), -1);
+  // A node count that overflows the size calculation.
+  EXPECT_EQ(load_patched(8, ~uint64_t{0}), -1);
+  // The untouched file still loads.
+  EXPECT_EQ(load_patched(ids_begin, csr.get_id(0)), 0);
+  remove(path.c_str());
+
+  for (auto *node : bucket) delete node;
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/table/graph/graph_weighted_sampler.h"
+
+namespace distributed = paddle::distributed;
+
+static std::unique_ptr<distributed::WeightedGraphEdgeBlob> make_edges(
+    const std::vector<float> &weights) {
+  std::unique_ptr<distributed::WeightedGraphEdgeBlob> edges(
+      new distributed::WeightedGraphEdgeBlob());
+  for (size_t i = 0; i < weights.size(); i++) {
+    edges->add_edge(i, weights[i]);
+  }
+  return edges;
+}
+
+static void check_distinct(const std::vector<int> &res, int k, int n) {
+  ASSERT_EQ(static_cast<int>(res.size()), std::min(k, n));
+  std::set<int> picked(res.begin(), res.end());
+  ASSERT_EQ(picked.size(), res.size());
+  for (int x : res) {
+    ASSERT_GE(x, 0);
+    ASSERT_LT(x, n);
+  }
+}
+
+TEST(AliasSampler, Distribution) {
+  std::vector<float> weights = {1, 2, 3, 4, 0, 10};
+  auto edges = make_edges(weights);
+  distributed::AliasSampler sampler;
+  sampler.build(edges.get());
+
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  const int trials = 200000;
+  std::vector<int> hits(weights.size(), 0);
+  for (int t = 0; t < trials; t++) {
+    auto res = sampler.sample_k(1, rng);
+    ASSERT_EQ(res.size(), 1UL);
+    hits[res[0]]++;
+  }
+  EXPECT_EQ(hits[4], 0);
+  for (size_t i = 0; i < weights.size(); i++) {
+    double expected = weights[i] / 20.0;
+    EXPECT_NEAR(static_cast<double>(hits[i]) / trials, expected, 0.01);
+  }
+}
+
+TEST(AliasSampler, WithoutReplacement) {
+  std::vector<float> weights;
+  for (int i = 0; i < 300; i++) weights.push_back(1.0f + i % 7);
+  auto edges = make_edges(weights);
+  distributed::AliasSampler sampler;
+  sampler.build(edges.get());
+
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  // Rejection with linear checks, rejection with a hash set, reservoir and
+  // the whole span.
+  for (int k : {5, 100, 250, 300, 400}) {
+    check_distinct(sampler.sample_k(k, rng), k, weights.size());
+  }
+
+  // One heavy slot makes the redraws collide, the reservoir path still
+  // returns k distinct slots and zero weights come last.
+  std::vector<float> skewed(100, 0.0f);
+  skewed[0] = 1e6;
+  for (int i = 1; i < 10; i++) skewed[i] = 1.0f;
+  auto skewed_edges = make_edges(skewed);
+  distributed::AliasSampler skewed_sampler;
+  skewed_sampler.build(skewed_edges.get());
+  auto res = skewed_sampler.sample_k(10, rng);
+  check_distinct(res, 10, skewed.size());
+  for (int x : res) EXPECT_LT(x, 10);
+}
+
+TEST(AliasSampler, Unweighted) {
+  distributed::GraphEdgeBlob edges;
+  for (int i = 0; i < 50; i++) edges.add_edge(i, 1.0f);
+  distributed::AliasSampler sampler;
+  sampler.build(&edges);
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  check_distinct(sampler.sample_k(10, rng), 10, 50);
+  check_distinct(sampler.sample_k(40, rng), 40, 50);
+}
+
+TEST(AliasSampler, EdgesAddedAfterBuild) {
+  std::vector<float> weights = {0, 0, 5, 0};
+  auto edges = make_edges(weights);
+  distributed::AliasSampler sampler;
+  sampler.build(edges.get());
+  // Growing the blob reallocates its weight array, the sampler keeps
+  // sampling the edges it was built on.
+  for (int i = 0; i < 10000; i++) edges->add_edge(100 + i, 1.0f);
+  edges->export_weight_array().shrink_to_fit();
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  for (int t = 0; t < 100; t++) {
+    auto res = sampler.sample_k(1, rng);
+    ASSERT_EQ(res.size(), 1UL);
+    EXPECT_EQ(res[0], 2);
+  }
+  check_distinct(sampler.sample_k(10, rng), 10, weights.size());
+}
+
+// Power-law degrees: the i-th node has about max_degree / (i + 1) ^ 1.1
+// neighbors with uniformly random weights. Run with
+// --gtest_also_run_disabled_tests to compare the samplers.
+TEST(AliasSampler, DISABLED_BenchmarkPowerLaw) {
+  const int node_num = 20000;
+  const int max_degree = 20000;
+  std::mt19937_64 gen(0);
+  std::uniform_real_distribution<float> weight_dist(0.1, 10.0);
+  std::vector<std::unique_ptr<distributed::WeightedGraphEdgeBlob>> edges;
+  size_t edge_num = 0;
+  for (int i = 0; i < node_num; i++) {
+    int degree = std::max(
+        1, static_cast<int>(max_degree / std::pow(i + 1.0, 1.1)) + 1);
+    std::vector<float> weights(degree);
+    for (auto &w : weights) w = weight_dist(gen);
+    edges.emplace_back(make_edges(weights));
+    edge_num += degree;
+  }
+
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  for (int k : {1, 10, 50}) {
+    double seconds[2];
+    for (int s = 0; s < 2; s++) {
+      std::vector<std::unique_ptr<distributed::Sampler>> samplers;
+      for (auto &e : edges) {
+        distributed::Sampler *sampler =
+            s == 0 ? static_cast<distributed::Sampler *>(
+                         new distributed::WeightedSampler())
+                   : new distributed::AliasSampler();
+        sampler->build(e.get());
+        samplers.emplace_back(sampler);
+      }
+      size_t sampled = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (int round = 0; round < 5; round++) {
+        for (auto &sampler : samplers) {
+          sampled += sampler->sample_k(k, rng).size();
+        }
+      }
+      seconds[s] = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+      LOG(INFO) << (s == 0 ? "tree " : "alias") << " sampler, k = " << k
+                << ": " << sampled / seconds[s] << " samples/s";
+      EXPECT_GT(sampled, 0UL);
+    }
+    LOG(INFO) << "k = " << k << ", " << node_num << " nodes, " << edge_num
+              << " edges, alias speedup " << seconds[0] / seconds[1] << "x";
+  }
+}
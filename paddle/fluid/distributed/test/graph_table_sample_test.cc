@@ -27,6 +27,9 @@
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/ps/table/common_graph_table.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(graph_edges_to_csr);
 namespace framework = paddle::framework;
 namespace platform = paddle::platform;
 namespace operators = paddle::operators;
@@ -86,3 +89,97 @@ void testGraphSample() {
 }
 
 TEST(testGraphSample, Run) { testGraphSample(); }
+
+void testMultiHopSample(bool use_csr) {
+  ::paddle::distributed::GraphParameter table_proto;
+  table_proto.add_edge_types("u2u");
+  distributed::GraphTable graph_table;
+  graph_table.Initialize(table_proto);
+  // 1 -> 2, 3; 2 -> 4, 5; 3 -> 5, 6; 5 -> 1
+  std::vector<std::pair<uint64_t, uint64_t>> graph_edges = {
+      {1, 2}, {1, 3}, {2, 4}, {2, 5}, {3, 5}, {3, 6}, {5, 1}};
+  for (auto &edge : graph_edges) {
+    graph_table.add_comm_edge(0, edge.first, edge.second);
+  }
+  graph_table.build_sampler(0);
+  if (use_csr) graph_table.build_csr(0, true);
+
+  distributed::GraphSubgraph subgraph;
+  graph_table.sample_multi_hop(0, {1, 1}, {10, 10}, true, &subgraph);
+  ASSERT_EQ(subgraph.node_ids, std::vector<uint64_t>({1, 2, 3, 4, 5, 6}));
+  ASSERT_EQ(subgraph.offsets, std::vector<int64_t>({0, 2, 4, 6, 6, 6, 6}));
+  ASSERT_EQ(subgraph.neighbors, std::vector<int64_t>({1, 2, 3, 4, 4, 5}));
+  ASSERT_EQ(subgraph.weights, std::vector<float>(6, 1.0f));
+
+  std::unique_ptr<char[]> buffer(new char[subgraph.get_size()]);
+  subgraph.to_buffer(buffer.get());
+  distributed::GraphSubgraph recovered;
+  ASSERT_EQ(recovered.recover_from_buffer(buffer.get(), subgraph.get_size()),
+            0);
+  ASSERT_EQ(recovered.node_ids, subgraph.node_ids);
+  ASSERT_EQ(recovered.offsets, subgraph.offsets);
+  ASSERT_EQ(recovered.neighbors, subgraph.neighbors);
+  ASSERT_EQ(recovered.weights, subgraph.weights);
+  ASSERT_EQ(recovered.recover_from_buffer(buffer.get(), 8), -1);
+
+  // Fanout 1 keeps one neighbor per expanded node.
+  graph_table.sample_multi_hop(0, {1}, {1, 1}, false, &subgraph);
+  ASSERT_EQ(subgraph.offsets[1], 1);
+  ASSERT_EQ(subgraph.neighbors[0], 1);
+  ASSERT_TRUE(subgraph.weights.empty());
+  ASSERT_EQ(subgraph.node_ids.size(), subgraph.offsets.size() - 1);
+
+  // The same call gives the same subgraph, however the tasks are scheduled.
+  distributed::GraphSubgraph first;
+  graph_table.sample_multi_hop(0, {1, 3}, {10, 10}, false, &first);
+  for (int i = 0; i < 10; i++) {
+    graph_table.sample_multi_hop(0, {1, 3}, {10, 10}, false, &subgraph);
+    ASSERT_EQ(subgraph.node_ids, first.node_ids);
+    ASSERT_EQ(subgraph.neighbors, first.neighbors);
+  }
+
+  ASSERT_EQ(graph_table.sample_multi_hop(0, {1}, {2, -1}, false, &subgraph),
+            -1);
+  ASSERT_EQ(graph_table.sample_multi_hop(1, {1}, {2}, false, &subgraph), -1);
+}
+
+TEST(testGraphSample, MultiHop) {
+  testMultiHopSample(false);
+  testMultiHopSample(true);
+}
+
+// Edge files of the same type loaded one by one are merged into the csr.
+TEST(testGraphSample, LoadEdgesToCsr) {
+  FLAGS_graph_edges_to_csr = true;
+  ::paddle::distributed::GraphParameter table_proto;
+  table_proto.add_edge_types("u2i");
+  distributed::GraphTable graph_table;
+  graph_table.Initialize(table_proto);
+
+  char first_file[] = "edges_to_csr_0.txt";
+  char second_file[] = "edges_to_csr_1.txt";
+  prepare_file(first_file,
+               std::vector<std::string>(edges.begin(), edges.begin() + 6));
+  prepare_file(second_file,
+               std::vector<std::string>(edges.begin() + 4, edges.end()));
+  ASSERT_EQ(graph_table.load_edges(first_file, false, "u2i"), 0);
+  ASSERT_EQ(graph_table.load_edges(second_file, false, "u2i"), 0);
+  FLAGS_graph_edges_to_csr = false;
+
+  // 96 has 3 edges in the first file and 2 more in the second, 37 is only
+  // in the first one and 59 only in the second one.
+  std::vector<std::pair<uint64_t, size_t>> degrees = {
+      {37, 3}, {96, 5}, {59, 3}, {97, 3}};
+  for (auto &degree : degrees) {
+    distributed::GraphCSR *csr = graph_table.get_edge_csr(0, degree.first);
+    ASSERT_NE(csr, nullptr);
+    int64_t pos = csr->find(degree.first);
+    ASSERT_GE(pos, 0);
+    EXPECT_EQ(csr->get_degree(pos), degree.second) << degree.first;
+  }
+  distributed::GraphCSR *csr = graph_table.get_edge_csr(0, 96);
+  const float *weights = csr->neighbor_weights(csr->find(96));
+  ASSERT_NE(weights, nullptr);
+  EXPECT_FLOAT_EQ(weights[0], 1.4f);
+  EXPECT_FLOAT_EQ(weights[3], 0.31f);
+}
@@ -0,0 +1,152 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/index_dataset/index_wrapper.h"
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace distributed = paddle::distributed;
+
+namespace {
+
+const int kHeight = 4;
+const int kBranch = 3;
+
+void WriteItem(FILE* fp, const std::string& key, const std::string& value) {
+  distributed::KVItem item;
+  item.set_key(key);
+  item.set_value(value);
+  std::string content = item.SerializeAsString();
+  int num = content.size();
+  fwrite(&num, sizeof(num), 1, fp);
+  fwrite(content.data(), 1, num, fp);
+}
+
+// A tree with branch 3 and 40 codes, leaves at level 3 are codes 13 to 39.
+// A few leaves and the subtree of code 12 are missing. Returns code -> id.
+std::map<uint64_t, uint64_t> WriteTree(const std::string& path,
+                                       uint64_t id_base,
+                                       uint64_t id_step) {
+  std::map<uint64_t, uint64_t> ids;
+  FILE* fp = fopen(path.c_str(), "wb");
+  distributed::TreeMeta meta;
+  meta.set_height(kHeight);
+  meta.set_branch(kBranch);
+  WriteItem(fp, ".tree_meta", meta.SerializeAsString());
+  for (uint64_t code = 0; code < 40; code++) {
+    if (code == 12 || code >= 37 || code == 20 || code == 21 || code == 30) {
+      continue;
+    }
+    distributed::IndexNode node;
+    node.set_id(id_base + code * id_step);
+    node.set_is_leaf(code >= 13);
+    node.set_probability(1.0);
+    WriteItem(fp, std::to_string(code), node.SerializeAsString());
+    ids[code] = node.id();
+  }
+  fclose(fp);
+  return ids;
+}
+
+int GetLevel(uint64_t code) {
+  int level = 0;
+  for (; code > 0; code = (code - 1) / kBranch) level++;
+  return level;
+}
+
+// The per-id results of the map based tree, found by walking the parents.
+std::vector<uint64_t> TravelCodes(uint64_t code, int start_level) {
+  std::vector<uint64_t> res;
+  for (int level = GetLevel(code); level >= start_level; level--) {
+    res.push_back(code);
+    code = (code - 1) / kBranch;
+  }
+  return res;
+}
+
+void CheckTree(uint64_t id_base, uint64_t id_step) {
+  std::string path = "index_wrapper_test.tree";
+  auto ids = WriteTree(path, id_base, id_step);
+  distributed::TreeIndex tree;
+  ASSERT_EQ(tree.Load(path), 0);
+  remove(path.c_str());
+  ASSERT_EQ(tree.Height(), kHeight);
+  ASSERT_EQ(tree.Branch(), kBranch);
+  ASSERT_EQ(tree.TotalNodeNums(), ids.size());
+  ASSERT_EQ(tree.EmbSize(), ids.rbegin()->second + 1);
+  ASSERT_EQ(tree.dense_ids_, id_step == 1);
+
+  for (int level = 0; level < kHeight; level++) {
+    std::vector<uint64_t> expected;
+    for (auto& item : ids) {
+      if (GetLevel(item.first) == level) expected.push_back(item.first);
+    }
+    ASSERT_EQ(tree.GetLayerCodes(level), expected);
+  }
+
+  for (auto& ancestor : ids) {
+    int ancestor_level = GetLevel(ancestor.first);
+    for (int level = 0; level < kHeight; level++) {
+      std::vector<uint64_t> expected;
+      if (level >= ancestor_level) {
+        for (auto& item : ids) {
+          if (GetLevel(item.first) != level) continue;
+          auto path = TravelCodes(item.first, ancestor_level);
+          if (path.back() == ancestor.first) expected.push_back(item.first);
+        }
+      }
+      ASSERT_EQ(tree.GetChildrenCodes(ancestor.first, level), expected);
+    }
+  }
+
+  std::vector<uint64_t> leaf_ids;
+  for (auto& item : ids) {
+    if (item.first >= 13) leaf_ids.push_back(item.second);
+  }
+  ASSERT_EQ(tree.GetAllLeafs().size(), leaf_ids.size());
+  for (int start_level = 0; start_level < kHeight; start_level++) {
+    auto batch = tree.GetTravelCodes(leaf_ids, start_level);
+    size_t path_len = kHeight - start_level;
+    ASSERT_EQ(batch.size(), leaf_ids.size() * path_len);
+    for (size_t i = 0; i < leaf_ids.size(); i++) {
+      auto single = tree.GetTravelCodes(leaf_ids[i], start_level);
+      auto expected = TravelCodes(tree.GetLeafCode(leaf_ids[i]), start_level);
+      ASSERT_EQ(single, expected);
+      ASSERT_EQ(std::vector<uint64_t>(batch.begin() + i * path_len,
+                                      batch.begin() + (i + 1) * path_len),
+                expected);
+      auto ancestor = tree.GetAncestorCodes({leaf_ids[i]}, start_level);
+      ASSERT_EQ(ancestor[0], expected.back());
+      ASSERT_EQ(tree.GetNodeId(expected[0]), leaf_ids[i]);
+    }
+  }
+
+  // Internal nodes and unknown ids are not leaves.
+  ASSERT_EQ(tree.GetLeafCode(ids[1]), tree.GetLeafCode(id_base + 41 * id_step));
+  ASSERT_FALSE(tree.CheckIsValid(tree.GetLeafCode(ids[1])));
+  ASSERT_FALSE(tree.CheckIsValid(12));
+}
+
+}  // namespace
+
+TEST(TreeIndex, DenseIds) { CheckTree(1, 1); }
+
+// Ids far apart are mapped through a hash map instead of an array of
+// max_id entries.
+TEST(TreeIndex, SparseIds) { CheckTree(1ULL << 40, 1000003); }
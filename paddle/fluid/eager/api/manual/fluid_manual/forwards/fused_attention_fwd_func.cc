@@ -426,7 +426,8 @@ fused_attention_dygraph_function(
         grad_node->SetGradOutMeta(QKVBias, 4);
 
         auto QKVBiasOut_accumulation_node =
-            std::make_shared<egr::GradNodeAccumulation>(p_autograd_QKVBiasOut);
+            std::shared_ptr<egr::GradNodeAccumulation>(
+                new egr::GradNodeAccumulation(p_autograd_QKVBiasOut));
         egr::EagerUtils::SetOutRankWithSlot(p_autograd_QKVBiasOut, 0);
         egr::EagerUtils::SetHistory(p_autograd_QKVBiasOut,
                                     QKVBiasOut_accumulation_node);
@@ -439,7 +440,8 @@ fused_attention_dygraph_function(
         grad_node->SetTensorWrapperSrcMaskOut(SrcMaskOut);
 
         auto SrcMaskOut_accumulation_node =
-            std::make_shared<egr::GradNodeAccumulation>(p_autograd_SrcMaskOut);
+            std::shared_ptr<egr::GradNodeAccumulation>(
+                new egr::GradNodeAccumulation(p_autograd_SrcMaskOut));
         egr::EagerUtils::SetOutRankWithSlot(p_autograd_SrcMaskOut, 0);
         egr::EagerUtils::SetHistory(p_autograd_SrcMaskOut,
                                     SrcMaskOut_accumulation_node);
@@ -465,7 +467,8 @@ fused_attention_dygraph_function(
           grad_node->SetTensorWrapperLnOut(LnOut);
 
           auto LnOut_accumulation_node =
-              std::make_shared<egr::GradNodeAccumulation>(p_autograd_LnOut);
+              std::shared_ptr<egr::GradNodeAccumulation>(
+                  new egr::GradNodeAccumulation(p_autograd_LnOut));
           egr::EagerUtils::SetOutRankWithSlot(p_autograd_LnOut, 0);
           egr::EagerUtils::SetHistory(p_autograd_LnOut,
                                       LnOut_accumulation_node);
@@ -493,8 +496,9 @@ fused_attention_dygraph_function(
         grad_node->SetTensorWrapperLn2Variance(Ln2Variance);
 
         auto BiasDropoutResidualOut_accumulation_node =
-            std::make_shared<egr::GradNodeAccumulation>(
-                p_autograd_BiasDropoutResidualOut);
+            std::shared_ptr<egr::GradNodeAccumulation>(
+                new egr::GradNodeAccumulation(
+                    p_autograd_BiasDropoutResidualOut));
         egr::EagerUtils::SetOutRankWithSlot(p_autograd_BiasDropoutResidualOut,
                                             0);
         egr::EagerUtils::SetHistory(p_autograd_BiasDropoutResidualOut,
@@ -523,14 +527,16 @@ fused_attention_dygraph_function(
       egr::EagerUtils::SetHistory(p_autograd_Y, grad_node);
       grad_node->SetGradInMeta(Y, 19);
       auto QKVOut_accumulation_node =
-          std::make_shared<egr::GradNodeAccumulation>(p_autograd_QKVOut);
+          std::shared_ptr<egr::GradNodeAccumulation>(
+              new egr::GradNodeAccumulation(p_autograd_QKVOut));
       egr::EagerUtils::SetOutRankWithSlot(p_autograd_QKVOut, 0);
       egr::EagerUtils::SetHistory(p_autograd_QKVOut, QKVOut_accumulation_node);
       QKVOut_accumulation_node->SetGradInMeta(QKVOut, 0);
       grad_node->SetGradOutMeta(QKVOut, 15);
 
       auto QKTVOut_accumulation_node =
-          std::make_shared<egr::GradNodeAccumulation>(p_autograd_QKTVOut);
+          std::shared_ptr<egr::GradNodeAccumulation>(
+              new egr::GradNodeAccumulation(p_autograd_QKTVOut));
       egr::EagerUtils::SetOutRankWithSlot(p_autograd_QKTVOut, 0);
       egr::EagerUtils::SetHistory(p_autograd_QKTVOut,
                                   QKTVOut_accumulation_node);
@@ -538,7 +544,8 @@ fused_attention_dygraph_function(
       grad_node->SetGradOutMeta(QKTVOut, 16);
 
       auto TransposeOut2_accumulation_node =
-          std::make_shared<egr::GradNodeAccumulation>(p_autograd_TransposeOut2);
+          std::shared_ptr<egr::GradNodeAccumulation>(
+              new egr::GradNodeAccumulation(p_autograd_TransposeOut2));
       egr::EagerUtils::SetOutRankWithSlot(p_autograd_TransposeOut2, 0);
       egr::EagerUtils::SetHistory(p_autograd_TransposeOut2,
                                   TransposeOut2_accumulation_node);
@@ -546,14 +553,16 @@ fused_attention_dygraph_function(
       grad_node->SetGradOutMeta(TransposeOut2, 17);
 
       auto QKOut_accumulation_node =
-          std::make_shared<egr::GradNodeAccumulation>(p_autograd_QKOut);
+          std::shared_ptr<egr::GradNodeAccumulation>(
+              new egr::GradNodeAccumulation(p_autograd_QKOut));
       egr::EagerUtils::SetOutRankWithSlot(p_autograd_QKOut, 0);
       egr::EagerUtils::SetHistory(p_autograd_QKOut, QKOut_accumulation_node);
       QKOut_accumulation_node->SetGradInMeta(QKOut, 0);
       grad_node->SetGradOutMeta(QKOut, 18);
 
       auto SoftmaxOut_accumulation_node =
-          std::make_shared<egr::GradNodeAccumulation>(p_autograd_SoftmaxOut);
+          std::shared_ptr<egr::GradNodeAccumulation>(
+              new egr::GradNodeAccumulation(p_autograd_SoftmaxOut));
       egr::EagerUtils::SetOutRankWithSlot(p_autograd_SoftmaxOut, 0);
       egr::EagerUtils::SetHistory(p_autograd_SoftmaxOut,
                                   SoftmaxOut_accumulation_node);
@@ -562,8 +571,8 @@ fused_attention_dygraph_function(
 
       if (AttnDropoutOut.initialized()) {
         auto AttnDropoutOut_accumulation_node =
-            std::make_shared<egr::GradNodeAccumulation>(
-                p_autograd_AttnDropoutOut);
+            std::shared_ptr<egr::GradNodeAccumulation>(
+                new egr::GradNodeAccumulation(p_autograd_AttnDropoutOut));
         egr::EagerUtils::SetOutRankWithSlot(p_autograd_AttnDropoutOut, 0);
         egr::EagerUtils::SetHistory(p_autograd_AttnDropoutOut,
                                     AttnDropoutOut_accumulation_node);
@@ -572,7 +581,8 @@ fused_attention_dygraph_function(
       }
 
       auto FMHAOut_accumulation_node =
-          std::make_shared<egr::GradNodeAccumulation>(p_autograd_FMHAOut);
+          std::shared_ptr<egr::GradNodeAccumulation>(
+              new egr::GradNodeAccumulation(p_autograd_FMHAOut));
       egr::EagerUtils::SetOutRankWithSlot(p_autograd_FMHAOut, 0);
       egr::EagerUtils::SetHistory(p_autograd_FMHAOut,
                                   FMHAOut_accumulation_node);
@@ -580,7 +590,8 @@ fused_attention_dygraph_function(
       grad_node->SetGradOutMeta(FMHAOut, 21);
 
       auto OutLinearOut_accumulation_node =
-          std::make_shared<egr::GradNodeAccumulation>(p_autograd_OutLinearOut);
+          std::shared_ptr<egr::GradNodeAccumulation>(
+              new egr::GradNodeAccumulation(p_autograd_OutLinearOut));
       egr::EagerUtils::SetOutRankWithSlot(p_autograd_OutLinearOut, 0);
       egr::EagerUtils::SetHistory(p_autograd_OutLinearOut,
                                   OutLinearOut_accumulation_node);
@@ -14,9 +14,20 @@
 
 #include "paddle/fluid/eager/backward.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <tuple>
+
 #include "paddle/fluid/eager/general_grad.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
 
+PHI_DECLARE_int32(eager_backward_num_threads);
+
 namespace egr {
 
 std::unordered_map<GradNodeBase*, int> getInDegreeMap(
@@ -101,6 +112,254 @@ void DuplicateCheck(const std::vector<paddle::Tensor>& inputs, bool is_input) {
 
 GeneralGrad* GeneralGrad::general_grad_ = new GeneralGrad();
 
+namespace {
+
+// Gradient sent to a node, kept until all of them arrived so that they are
+// summed in graph order rather than in the order the threads finish.
+struct PendingGrad {
+  size_t producer_order;
+  size_t producer_slot;
+  size_t producer_rank;
+  size_t slot;
+  size_t rank;
+  paddle::Tensor tensor;
+
+  bool operator<(const PendingGrad& other) const {
+    return std::tie(producer_order, producer_slot, producer_rank) <
+           std::tie(other.producer_order,
+                    other.producer_slot,
+                    other.producer_rank);
+  }
+};
+
+struct ParallelNodeState {
+  std::mutex mutex;
+  int in_degree{0};
+  // Position of the node in the breadth first visit of the graph
+  size_t order{0};
+  std::unique_ptr<GradTensorHolder> input_buffer;
+  std::vector<PendingGrad> pending;
+};
+
+paddle::framework::WorkQueue* GetBackwardWorkQueue(int num_threads) {
+  static std::mutex mutex;
+  static std::unique_ptr<paddle::framework::WorkQueue> queue;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (queue == nullptr ||
+      queue->NumThreads() != static_cast<size_t>(num_threads)) {
+    paddle::framework::WorkQueueOptions options(
+        "EagerBackward", num_threads, true, false);
+    queue = paddle::framework::CreateMultiThreadedWorkQueue(options);
+  }
+  return queue.get();
+}
+
+// Runs the grad nodes whose inputs are ready on a work stealing pool. A node
+// only runs once every producer is done, and the thread finishing the last
+// producer is the only one touching its GradTensorHolder, so accumulation
+// needs no lock of its own.
+class ParallelBackwardRunner {
+ public:
+  ParallelBackwardRunner(bool retain_graph, int num_threads)
+      : retain_graph_(retain_graph),
+        work_queue_(GetBackwardWorkQueue(num_threads)) {}
+
+  void Run(
+      const std::deque<GradNodeBase*>& startup_nodes,
+      std::unordered_map<GradNodeBase*, std::unique_ptr<GradTensorHolder>>*
+          node_input_buffers_dict) {
+    BuildStates(startup_nodes);
+    for (auto& item : *node_input_buffers_dict) {
+      states_.at(item.first)->input_buffer = std::move(item.second);
+    }
+    node_input_buffers_dict->clear();
+
+    std::vector<GradNodeBase*> ready;
+    for (auto* node : startup_nodes) {
+      if (states_.at(node)->in_degree == 0) ready.push_back(node);
+    }
+    {
+      std::lock_guard<std::mutex> lock(done_mutex_);
+      outstanding_ = ready.size();
+    }
+    for (size_t i = 1; i < ready.size(); ++i) Submit(ready[i]);
+    if (!ready.empty()) Execute(ready[0]);
+
+    std::unique_lock<std::mutex> lock(done_mutex_);
+    done_cv_.wait(lock, [this] { return outstanding_ == 0; });
+    if (error_) std::rethrow_exception(error_);
+  }
+
+ private:
+  void BuildStates(const std::deque<GradNodeBase*>& startup_nodes) {
+    std::deque<GradNodeBase*> queue = startup_nodes;
+    for (auto* node : startup_nodes) {
+      states_.emplace(node, std::make_unique<ParallelNodeState>());
+    }
+    size_t order = 0;
+    std::unordered_set<GradNodeBase*> visited;
+    while (!queue.empty()) {
+      GradNodeBase* node = queue.front();
+      queue.pop_front();
+      if (!visited.insert(node).second) continue;
+      states_.at(node)->order = order++;
+      for (const auto& meta_list : node->OutputMeta()) {
+        for (const GradSlotMeta& meta : meta_list) {
+          GradNodeBase* next_node = meta.GetEdge().GetMutableGradNode().get();
+          if (!next_node) continue;
+          auto& state = states_[next_node];
+          if (state == nullptr) state = std::make_unique<ParallelNodeState>();
+          state->in_degree++;
+          queue.push_back(next_node);
+        }
+      }
+    }
+  }
+
+  void Submit(GradNodeBase* node) {
+    work_queue_->AddTask([this, node] { Execute(node); });
+  }
+
+  // Runs node, then keeps running one of the nodes it made ready on this
+  // thread and hands the others to the pool.
+  void Execute(GradNodeBase* node) {
+    while (node != nullptr) {
+      std::vector<GradNodeBase*> ready;
+      if (!failed_) {
+        try {
+          RunNode(node, &ready);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(done_mutex_);
+          if (!error_) error_ = std::current_exception();
+          failed_ = true;
+          ready.clear();
+        }
+      }
+      if (!ready.empty()) {
+        std::lock_guard<std::mutex> lock(done_mutex_);
+        outstanding_ += ready.size();
+      }
+      for (size_t i = 1; i < ready.size(); ++i) Submit(ready[i]);
+      node = ready.empty() ? nullptr : ready[0];
+      // Under the lock, so Run can't return and destroy the runner while
+      // this thread still touches it.
+      std::lock_guard<std::mutex> lock(done_mutex_);
+      if (--outstanding_ == 0) done_cv_.notify_all();
+    }
+  }
+
+  void RunNode(GradNodeBase* node, std::vector<GradNodeBase*>* ready) {
+    VLOG(3) << "Preparing GradNode:" << node->name() << " addr:" << node;
+    paddle::platform::RecordEvent node_record_event(
+        std::string((*node).name()),
+        paddle::platform::TracerEventType::Operator,
+        1);
+    ParallelNodeState* state = states_.at(node).get();
+    if (state->input_buffer == nullptr) {
+      state->input_buffer =
+          std::make_unique<GradTensorHolder>(node->InputMeta());
+    }
+    std::sort(state->pending.begin(), state->pending.end());
+    for (const auto& grad : state->pending) {
+      state->input_buffer->add(grad.slot, grad.rank, grad.tensor, false);
+    }
+    state->pending.clear();
+
+    EnforceGradNodeHasInput(node);
+    paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
+        grad_output_tensors;
+    if (dynamic_cast<egr::GradNodeAccumulation*>(node)) {
+      // Leaf gradients and their hooks, e.g. the reducer of data parallel,
+      // are not thread safe.
+      std::lock_guard<std::mutex> lock(accumulation_mutex_);
+      grad_output_tensors =
+          (*node)(state->input_buffer->Buffers(), false, false);
+    } else {
+      grad_output_tensors =
+          (*node)(state->input_buffer->Buffers(), false, false);
+    }
+    if (!retain_graph_) node->ClearTensorWrappers();
+    state->input_buffer.reset();
+
+    const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
+        metas = node->OutputMeta();
+    PADDLE_ENFORCE(metas.size() == grad_output_tensors.size() || metas.empty(),
+                   paddle::platform::errors::Fatal(
+                       "Number of edges should be either empty ( for leaf node "
+                       ") or the same as number of output grad tensors, but we "
+                       "got edges size is: %d, grad_output size is: %d",
+                       metas.size(),
+                       grad_output_tensors.size()));
+    for (size_t i = 0; i < metas.size(); i++) {
+      for (size_t j = 0; j < metas[i].size(); j++) {
+        const Edge& edge = metas[i][j].GetEdge();
+        if (!edge.IsInitialized()) continue;
+        auto* next_node = edge.GetMutableGradNode().get();
+        if (!next_node || grad_output_tensors[i].empty()) continue;
+        PADDLE_ENFORCE_LT(
+            j,
+            grad_output_tensors[i].size(),
+            paddle::platform::errors::Fatal(
+                "Rank of grad_output_tensors should be less than "
+                "grad_output_tensors[i].size(), which is: %d. This error may "
+                "indicate autoprune or autograd api error. ",
+                grad_output_tensors.size()));
+        auto edge_rank = edge.GetEdgeRankInfo();
+        ParallelNodeState* next_state = states_.at(next_node).get();
+        std::lock_guard<std::mutex> lock(next_state->mutex);
+        next_state->pending.push_back(PendingGrad{state->order,
+                                                  i,
+                                                  j,
+                                                  edge_rank.first,
+                                                  edge_rank.second,
+                                                  grad_output_tensors[i][j]});
+        PADDLE_ENFORCE(
+            --next_state->in_degree >= 0,
+            paddle::platform::errors::Fatal(
+                "Detected in-degree value smaller than zero. For Node: %s"
+                "Node's in-degree cannot be negative.",
+                next_node->name()));
+        if (next_state->in_degree == 0) ready->push_back(next_node);
+      }
+    }
+  }
+
+  bool retain_graph_;
+  paddle::framework::WorkQueue* work_queue_;
+  std::unordered_map<GradNodeBase*, std::unique_ptr<ParallelNodeState>>
+      states_;
+  std::mutex accumulation_mutex_;
+
+  size_t outstanding_{0};
+  std::atomic<bool> failed_{false};
+  std::exception_ptr error_;
+  std::mutex done_mutex_;
+  std::condition_variable done_cv_;
+};
+
+// Only plain CPU backward runs in parallel. Higher order grads trace new
+// nodes through thread local tracer state, general grad and the force
+// sequential nodes need the sequential visit.
+bool UseParallelBackward(const std::vector<paddle::Tensor>& tensors,
+                         const std::deque<GradNodeBase*>& startup_nodes,
+                         bool create_graph,
+                         bool is_general_grad,
+                         bool has_force_sequential_nodes) {
+  if (FLAGS_eager_backward_num_threads <= 1 || create_graph ||
+      is_general_grad || has_force_sequential_nodes || startup_nodes.empty()) {
+    return false;
+  }
+  for (const auto& tensor : tensors) {
+    if (tensor.initialized() &&
+        !paddle::platform::is_cpu_place(tensor.place())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 std::vector<paddle::Tensor> RunBackward(
     const std::vector<paddle::Tensor>& tensors,  // output
     const std::vector<paddle::Tensor>& grad_tensors,
@@ -229,6 +488,19 @@ std::vector<paddle::Tensor> RunBackward(
         inputs, no_grad_vars, orig_queue, &queue, node_input_buffers_dict);
   }
 
+  if (UseParallelBackward(tensors,
+                          queue,
+                          create_graph,
+                          is_general_grad,
+                          !force_sequential_nodes_set.empty())) {
+    VLOG(3) << "Run backward with " << FLAGS_eager_backward_num_threads
+            << " threads";
+    ParallelBackwardRunner runner(retain_graph,
+                                  FLAGS_eager_backward_num_threads);
+    runner.Run(queue, &node_input_buffers_dict);
+    queue.clear();
+  }
+
   VLOG(5) << "Update In degree Map for backward";
   // 3. Compute in_degree for each node
   std::unordered_map<GradNodeBase*, int> node_in_degree_map =
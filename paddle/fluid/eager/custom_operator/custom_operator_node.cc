@@ -294,8 +294,9 @@ RunCustomOpNode::operator()(paddle::small_vector<std::vector<paddle::Tensor>,
     }
     // NOTE(HongyuJia): Does here needs to be consistent with forward process,
     // PassStopGradient to ins_auto_grad_metas?
-    auto grad_node = std::make_shared<egr::RunCustomOpDoubleGradNode>(
-        slot_outs_num, slot_ins_num, op_type_);
+    auto grad_node = std::shared_ptr<egr::RunCustomOpDoubleGradNode>(
+        new egr::RunCustomOpDoubleGradNode(
+            slot_outs_num, slot_ins_num, op_type_));
 
     const auto& slot_map = map;
     // Prepare Grad outputs
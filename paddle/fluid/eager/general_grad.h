@@ -338,7 +338,8 @@ class GeneralGrad {
               } else {
                 auto autograd_meta = egr::AutogradMeta(edge_);
                 std::shared_ptr<GradNodeBase> shared_grad_node_accumulation =
-                    std::make_shared<egr::GradNodeAccumulation>(&autograd_meta);
+                    std::shared_ptr<egr::GradNodeAccumulation>(
+                        new egr::GradNodeAccumulation(&autograd_meta));
                 pre_node_edge.SetGradNode(shared_grad_node_accumulation);
                 copied_node_to_endding_node_map_[node] =
                     shared_grad_node_accumulation;
@@ -18,6 +18,7 @@
 
 #include "paddle/fluid/eager/api/utils/global_utils.h"
 #include "paddle/fluid/eager/eager_tensor.h"
+#include "paddle/fluid/eager/grad_node_memory_pool.h"
 #include "paddle/fluid/eager/hooks.h"
 #include "paddle/phi/api/all.h"
 
@@ -172,6 +173,16 @@ class GradNodeBase {
   // TODO(jiabin): Should we have other constructor here?
   virtual ~GradNodeBase() { VLOG(7) << "Destruct GradNodeBase"; }
 
+  // Every traced op creates a grad node, so their memory is recycled, see
+  // GradNodeMemoryPool. std::make_shared does not call this operator new,
+  // create nodes with std::shared_ptr<T>(new T(...)) like the generated code.
+  static void* operator new(size_t size) {
+    return GradNodeMemoryPool::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    GradNodeMemoryPool::Free(ptr, size);
+  }
+
   /**
    * operator() designed to contain the real backward execution logic, it should
    * be overrided by derived class defined for each operator. It accepts a
@@ -0,0 +1,133 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/eager/grad_node_memory_pool.h"
+
+#include <new>
+
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(eager_grad_node_pool);
+
+namespace egr {
+
+namespace {
+
+constexpr size_t kAlignment = 16;
+// Grad nodes with many TensorWrappers take a few hundred bytes, larger
+// blocks are not worth caching.
+constexpr size_t kMaxBlockSize = 4096;
+constexpr size_t kNumSizeClasses = kMaxBlockSize / kAlignment;
+constexpr size_t kMaxCachedBytes = 16 << 20;
+
+inline size_t SizeClass(size_t size) {
+  return (size + kAlignment - 1) / kAlignment - 1;
+}
+
+inline size_t BlockSize(size_t size_class) {
+  return (size_class + 1) * kAlignment;
+}
+
+class ThreadCache {
+ public:
+  explicit ThreadCache(bool* destroyed) : destroyed_(destroyed) {}
+
+  ~ThreadCache() {
+    Release();
+    *destroyed_ = true;
+  }
+
+  void* Pop(size_t size_class) {
+    FreeBlock* block = free_lists_[size_class];
+    if (block == nullptr) return nullptr;
+    free_lists_[size_class] = block->next;
+    cached_bytes_ -= BlockSize(size_class);
+    return block;
+  }
+
+  bool Push(void* ptr, size_t size_class) {
+    if (cached_bytes_ + BlockSize(size_class) > kMaxCachedBytes) return false;
+    auto* block = static_cast<FreeBlock*>(ptr);
+    block->next = free_lists_[size_class];
+    free_lists_[size_class] = block;
+    cached_bytes_ += BlockSize(size_class);
+    return true;
+  }
+
+  void Release() {
+    for (auto& head : free_lists_) {
+      while (head != nullptr) {
+        FreeBlock* next = head->next;
+        ::operator delete(head);
+        head = next;
+      }
+    }
+    cached_bytes_ = 0;
+  }
+
+  size_t CachedBytes() const { return cached_bytes_; }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  FreeBlock* free_lists_[kNumSizeClasses] = {};
+  size_t cached_bytes_{0};
+  bool* destroyed_;
+};
+
+// Returns nullptr once the cache of the thread is destroyed, grad nodes
+// held by other thread locals may still be freed after that.
+ThreadCache* GetThreadCache() {
+  static thread_local bool destroyed = false;
+  if (destroyed) return nullptr;
+  static thread_local ThreadCache cache(&destroyed);
+  return &cache;
+}
+
+}  // namespace
+
+void* GradNodeMemoryPool::Allocate(size_t size) {
+  if (size > kMaxBlockSize) return ::operator new(size);
+  size_t size_class = SizeClass(size);
+  if (FLAGS_eager_grad_node_pool) {
+    ThreadCache* cache = GetThreadCache();
+    void* ptr = cache == nullptr ? nullptr : cache->Pop(size_class);
+    if (ptr != nullptr) return ptr;
+  }
+  // Always the full block, the block may be cached when it's freed.
+  return ::operator new(BlockSize(size_class));
+}
+
+void GradNodeMemoryPool::Free(void* ptr, size_t size) {
+  if (ptr == nullptr) return;
+  if (size <= kMaxBlockSize && FLAGS_eager_grad_node_pool) {
+    ThreadCache* cache = GetThreadCache();
+    if (cache != nullptr && cache->Push(ptr, SizeClass(size))) return;
+  }
+  ::operator delete(ptr);
+}
+
+void GradNodeMemoryPool::ReleaseThreadCache() {
+  ThreadCache* cache = GetThreadCache();
+  if (cache != nullptr) cache->Release();
+}
+
+size_t GradNodeMemoryPool::ThreadCachedBytes() {
+  ThreadCache* cache = GetThreadCache();
+  return cache == nullptr ? 0 : cache->CachedBytes();
+}
+
+}  // namespace egr
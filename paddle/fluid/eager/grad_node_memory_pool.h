@@ -0,0 +1,44 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+
+namespace egr {
+
+/**
+ * GradNodeMemoryPool recycles the memory of grad nodes and GradTensorHolders.
+ * Every traced op creates a grad node and every backward destroys a whole
+ * graph of them, so with small tensors malloc and free take a visible part
+ * of a step. Freed blocks go to a cache of the freeing thread, sorted by
+ * size class, and are handed out again by the next allocation of the same
+ * class. The cache of a thread is bounded and freed when the thread exits.
+ *
+ * A block may be freed by another thread than the one allocating it, e.g.
+ * when backward runs in parallel, it just moves to the other thread's cache.
+ **/
+class GradNodeMemoryPool {
+ public:
+  static void* Allocate(size_t size);
+  // size must be the one passed to Allocate
+  static void Free(void* ptr, size_t size);
+
+  // Frees all the blocks cached by the calling thread.
+  static void ReleaseThreadCache();
+  // Bytes cached by the calling thread.
+  static size_t ThreadCachedBytes();
+};
+
+}  // namespace egr
@@ -45,6 +45,13 @@ class GradTensorHolder {
 
   GradTensorHolder& operator=(const GradTensorHolder& other) = default;
 
+  static void* operator new(size_t size) {
+    return GradNodeMemoryPool::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    GradNodeMemoryPool::Free(ptr, size);
+  }
+
   // Create new tensor and copy tensor->impl
   void add(size_t slot_id,
            size_t rank,
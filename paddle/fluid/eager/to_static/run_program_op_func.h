@@ -83,7 +83,8 @@ inline void run_program_ad_func(
   if (require_any_grad) {
     egr::EagerUtils::PassStopGradient(false, &p_autograd_outs);
     // Create GradOpNode (1 means [out_grad], 2 means [x_grad, paramx_grad])
-    auto grad_node = std::make_shared<GradNodeRunProgram>(1, 2);
+    auto grad_node = std::shared_ptr<GradNodeRunProgram>(
+        new GradNodeRunProgram(1, 2));
 
     // Set Attributes
     grad_node->SetAttrMap(attrs);
@@ -429,7 +429,8 @@ std::shared_ptr<egr::GradNodeBase> EagerUtils::GetGradAccumulationNode(
     if (!autograd_ptr->StopGradient()) {
       VLOG(6) << "Add GradNodeAccumulation for tensor: " << tensor.name();
       autograd_ptr->SetGradNode(
-          std::make_shared<egr::GradNodeAccumulation>(autograd_ptr));
+          std::shared_ptr<egr::GradNodeAccumulation>(
+              new egr::GradNodeAccumulation(autograd_ptr)));
       return autograd_ptr->GetMutableGradNode();
     } else {
       return nullptr;
@@ -196,12 +196,15 @@ int FCFusePass::ApplyFCPattern(Graph* graph, bool with_relu) const {
     if (!use_gpu && use_fc_padding) {
       auto* scope = param_scope();
       auto* weight = scope->FindVar(w->Name())->GetMutable<phi::DenseTensor>();
-      auto* weight_data = weight->data<float>();
       auto weight_dims = weight->dims();
       int weight_num = product(weight_dims);
       int w_h = weight_dims[0];
       int w_w = weight_dims[1];
-      if (w_h % 128 == 0 && w_w % 128 == 0) {
+      // the int8 weight left by delete_weight_dequant_linear_op_pass is not
+      // padded
+      if (weight->dtype() == phi::DataType::FLOAT32 && w_h % 128 == 0 &&
+          w_w % 128 == 0) {
+        auto* weight_data = weight->data<float>();
         auto* w_var = scope->Var(w_name);
         auto* w_tensor = w_var->GetMutable<phi::DenseTensor>();
 
@@ -244,6 +247,17 @@ int FCFusePass::ApplyFCPattern(Graph* graph, bool with_relu) const {
       desc.SetAttr("Input_scale", mul_op_desc->GetAttr("Input_scale"));
     }
 
+    // For the int8 weight and the scale of x set by
+    // delete_weight_dequant_linear_op_pass and
+    // delete_quant_dequant_linear_op_pass
+    if (mul_op_desc->HasAttr("weight_scale")) {
+      desc.SetAttr("weight_scale", mul_op_desc->GetAttr("weight_scale"));
+    }
+    const std::string x_scale_name = "Input_scale_" + subgraph.at(x)->Name();
+    if (mul_op_desc->HasAttr(x_scale_name)) {
+      desc.SetAttr(x_scale_name, mul_op_desc->GetAttr(x_scale_name));
+    }
+
     bool inscale_flag = false;
     bool outscale_flag = false;
 
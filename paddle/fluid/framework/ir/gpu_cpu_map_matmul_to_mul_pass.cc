@@ -26,6 +26,20 @@ namespace paddle {
 namespace framework {
 namespace ir {
 
+// The scales set by delete_weight_dequant_linear_op_pass and
+// delete_quant_dequant_linear_op_pass, which the int8 fc on CPU runs on.
+static void CopyQuantScales(const OpDesc& from,
+                            const std::string& from_x,
+                            const std::string& to_x,
+                            OpDesc* to) {
+  if (from.HasAttr("weight_scale")) {
+    to->SetAttr("weight_scale", from.GetAttr("weight_scale"));
+  }
+  if (from.HasAttr("Input_scale_" + from_x)) {
+    to->SetAttr("Input_scale_" + to_x, from.GetAttr("Input_scale_" + from_x));
+  }
+}
+
 class Node;
 
 GpuCpuMapMatmul2MulPass::GpuCpuMapMatmul2MulPass() {
@@ -302,6 +316,8 @@ void GpuCpuMapMatmul2MulPass::ApplyImpl(ir::Graph* graph) const {
         desc.SetAttr("out_threshold",
                      matmul_op->Op()->GetAttr("out_threshold"));
       }
+      CopyQuantScales(
+          *matmul_op->Op(), matmul_in_x->Name(), matmul_in_x->Name(), &desc);
       auto mul_node = g->CreateOpNode(&desc);
       IR_NODE_LINK_TO(matmul_in_x, mul_node);
       IR_NODE_LINK_TO(matmul_in_y, mul_node);
@@ -375,6 +391,10 @@ void GpuCpuMapMatmulV2ToMulPass::ApplyImpl(ir::Graph* graph) const {
         desc.SetAttr("out_threshold",
                      matmul_v2_op->Op()->GetAttr("out_threshold"));
       }
+      CopyQuantScales(*matmul_v2_op->Op(),
+                      matmul_v2_in_x->Name(),
+                      matmul_v2_in_x->Name(),
+                      &desc);
       auto mul_node = g->CreateOpNode(&desc);
       IR_NODE_LINK_TO(matmul_v2_in_x, mul_node);
       IR_NODE_LINK_TO(matmul_v2_in_y, mul_node);
@@ -452,6 +472,10 @@ void GpuCpuMapMatmulV2ToMatmulPass::ApplyImpl(ir::Graph* graph) const {
       desc.SetAttr("out_threshold",
                    matmul_v2_op->Op()->GetAttr("out_threshold"));
     }
+    CopyQuantScales(*matmul_v2_op->Op(),
+                    matmul_v2_in_x->Name(),
+                    matmul_v2_in_x->Name(),
+                    &desc);
     auto matmul_node = g->CreateOpNode(&desc);
     IR_NODE_LINK_TO(matmul_v2_in_x, matmul_node);
     IR_NODE_LINK_TO(matmul_v2_in_y, matmul_node);
@@ -532,6 +556,8 @@ void GpuCpuSqueeze2MatmulFusePass::ApplyImpl(ir::Graph* graph) const {
         desc.SetAttr("out_threshold",
                      matmul_op->Op()->GetAttr("out_threshold"));
       }
+      CopyQuantScales(
+          *matmul_op->Op(), matmul_in_x->Name(), squeeze2_in_x->Name(), &desc);
       auto mul_node = g->CreateOpNode(&desc);
       IR_NODE_LINK_TO(squeeze2_in_x, mul_node);
       IR_NODE_LINK_TO(matmul_in_y, mul_node);
@@ -681,6 +707,8 @@ void GpuCpuReshape2MatmulFusePass::ApplyImpl(ir::Graph* graph) const {
             << "GpuCpuReshape2MatmulFusePass in out mul op compat failed.";
         return;
       }
+      CopyQuantScales(
+          *matmul_op->Op(), matmul_in_x->Name(), reshape2_in_x->Name(), &desc);
       auto mul_node = g->CreateOpNode(&desc);
       IR_NODE_LINK_TO(reshape2_in_x, mul_node);
       IR_NODE_LINK_TO(matmul_in_y, mul_node);
@@ -763,6 +791,8 @@ void GpuCpuFlatten2MatmulFusePass::ApplyImpl(ir::Graph* graph) const {
         desc.SetAttr("out_threshold",
                      matmul_op->Op()->GetAttr("out_threshold"));
       }
+      CopyQuantScales(
+          *matmul_op->Op(), matmul_in_x->Name(), flatten2_in_x->Name(), &desc);
       auto mul_node = g->CreateOpNode(&desc);
       IR_NODE_LINK_TO(flatten2_in_x, mul_node);
       IR_NODE_LINK_TO(matmul_in_y, mul_node);
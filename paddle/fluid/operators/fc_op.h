@@ -51,6 +51,43 @@ inline void FCOutputSize(const framework::DDim& in_dims,
   out_dims.push_back(w_dims1);
 }
 
+// The int8 weight only runs on CPU.
+template <typename DeviceContext, typename T>
+struct FCInt8Compute {
+  void operator()(const DeviceContext& dev_ctx,
+                  int M,
+                  int N,
+                  int K,
+                  const T* X,
+                  const phi::DenseTensor& W,
+                  T* Y,
+                  float input_scale,
+                  float weight_scale,
+                  const T* B,
+                  bool relu) const {
+    PADDLE_THROW(platform::errors::Unimplemented(
+        "The int8 weight of fc is only supported on CPU."));
+  }
+};
+
+template <typename T>
+struct FCInt8Compute<phi::CPUContext, T> {
+  void operator()(const phi::CPUContext& dev_ctx,
+                  int M,
+                  int N,
+                  int K,
+                  const T* X,
+                  const phi::DenseTensor& W,
+                  T* Y,
+                  float input_scale,
+                  float weight_scale,
+                  const T* B,
+                  bool relu) const {
+    phi::funcs::FCInt8Functor<phi::CPUContext, T> fc;
+    fc(dev_ctx, M, N, K, X, W, Y, input_scale, {weight_scale}, B, relu);
+  }
+};
+
 template <typename T, typename DeviceContext>
 class FCOpKernel : public framework::OpKernel<T> {
  public:
@@ -80,10 +117,38 @@ class FCOpKernel : public framework::OpKernel<T> {
     int M = phi::product(out_dims) / w_dims1;
 
     const T* input_data = input->data<T>();
-    const T* w_data = w->data<T>();
     auto* output_data =
         dev_ctx.template Alloc<T>(output, output->numel() * sizeof(T));
 
+    if (w->dtype() == phi::DataType::INT8) {
+      // quantized by delete_weight_dequant_linear_op_pass, the scale of the
+      // input is set by delete_quant_dequant_linear_op_pass, without it only
+      // the weight is int8
+      PADDLE_ENFORCE_EQ(ctx.HasAttr("weight_scale"),
+                        true,
+                        platform::errors::InvalidArgument(
+                            "The int8 weight of fc needs the weight_scale."));
+      const std::string input_scale_name =
+          "Input_scale_" + ctx.InputName("Input");
+      const float input_scale = ctx.HasAttr(input_scale_name)
+                                    ? ctx.Attr<float>(input_scale_name)
+                                    : 0.f;
+      FCInt8Compute<DeviceContext, T>()(dev_ctx,
+                                        M,
+                                        w_dims1,
+                                        w_dims0,
+                                        input_data,
+                                        *w,
+                                        output_data,
+                                        input_scale,
+                                        ctx.Attr<float>("weight_scale"),
+                                        bias ? bias->data<T>() : NULL,
+                                        with_relu);
+      return;
+    }
+
+    const T* w_data = w->data<T>();
+
     phi::funcs::FCFunctor<DeviceContext, T> fc;
     fc(dev_ctx,
        M,
@@ -48,12 +48,8 @@ class FusedEmbeddingSeqPoolOp : public framework::OperatorWithKernel {
             "The last dimension of the input tensor 'Ids' should be 1. "
             "But received Ids's size in the last dimension = %d.",
             ids_dims[ids_dims.size() - 1]));
-    // we only support sum now
-    PADDLE_ENFORCE_EQ(combiner,
-                      "sum",
-                      platform::errors::Unimplemented(
-                          "The pooling type of sequence_pool only support sum "
-                          "now. So the 'combiner' must be 'sum'."));
+    // throws for a combiner other than sum, mean and sqrtn
+    phi::funcs::StringToEmbeddingPoolType(combiner);
 
     int64_t last_dim = FusedEmbeddingSeqPoolLastDim(table_dims, ids_dims);
     // in compile time, the lod level of ids must be 1
@@ -92,9 +88,11 @@ class FusedEmbeddingSeqPoolOpMaker : public framework::OpProtoAndCheckerMaker {
     AddOutput("Out", "The lookup results, which have the same type as W.");
     AddAttr<std::string>("combiner",
                          "(string, default sum) "
-                         "A string specifying the reduction op. Currently sum "
-                         "are supported, sum computes the weighted sum of the "
-                         "embedding results for each row.")
+                         "A string specifying the reduction op, one of sum, "
+                         "mean and sqrtn. sum computes the sum of the "
+                         "embedding results for each row, mean divides it by "
+                         "the number of non padding ids of the row, and sqrtn "
+                         "by the square root of that number.")
         .SetDefault("sum");
     AddAttr<int64_t>("padding_idx",
                      "(int64, default -1) "
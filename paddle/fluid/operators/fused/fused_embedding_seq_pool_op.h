@@ -14,16 +14,15 @@ limitations under the License. */
 
 #pragma once
 
-#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/framework/eigen.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/selected_rows_utils.h"
-#include "paddle/phi/kernels/funcs/blas/blas.h"
-#include "paddle/phi/kernels/funcs/jit/kernels.h"
+#include "paddle/phi/kernels/funcs/embedding_pool.h"
 
 namespace paddle {
 namespace operators {
@@ -33,99 +32,6 @@ using DDim = framework::DDim;
 
 constexpr int64_t kNoPadding = -1;
 
-#if defined(PADDLE_WITH_MKLML) && !defined(_WIN32) && !defined(__APPLE__) && \
-    !defined(__OSX__)
-template <typename T>
-void prepare_csr_data(const std::vector<uint64_t> &offset,
-                      const int64_t *ids_data,
-                      const size_t idx_width,
-                      T *csr_vals,
-                      int *csr_colmuns,
-                      int *csr_row_idx,
-                      int64_t padding_idx = kNoPadding) {
-  int val_idx = 0;
-  int row_idx = 0;
-  csr_row_idx[0] = 0;
-
-  std::map<int, int> ids_map;
-
-  // for each sequence in batch
-  for (size_t i = 0; i < offset.size() - 1; ++i) {
-    for (size_t idx = 0; idx < idx_width; ++idx) {
-      ids_map.clear();
-
-      // construct a map for creating csr
-      for (size_t j = offset[i]; j < offset[i + 1]; ++j) {
-        auto ids_value = ids_data[idx + j * idx_width];
-        if (ids_value != padding_idx) {
-          unsigned int word_idx = static_cast<unsigned int>(ids_value);
-          ++ids_map[word_idx];
-        }
-      }
-
-      VLOG(4) << "====sequence %d====" << i;
-      for (std::map<int, int>::const_iterator it = ids_map.begin();
-           it != ids_map.end();
-           ++it) {
-        VLOG(4) << it->first << " => " << it->second;
-        csr_vals[val_idx] = it->second;
-        csr_colmuns[val_idx] = it->first;
-        ++val_idx;
-      }
-      csr_row_idx[row_idx + 1] = csr_row_idx[row_idx] + ids_map.size();
-      ++row_idx;
-    }
-  }
-}
-#else
-template <typename T>
-struct EmbeddingVSumFunctor {
-  void operator()(const framework::ExecutionContext &context,
-                  const phi::DenseTensor *table_t,
-                  const phi::DenseTensor *ids_t,
-                  phi::DenseTensor *output_t) {
-    auto *table = table_t->data<T>();
-    int64_t table_height = table_t->dims()[0];
-    int64_t table_width = table_t->dims()[1];
-    int64_t out_width = output_t->dims()[1];
-    const int64_t *ids = ids_t->data<int64_t>();
-    auto ids_lod = ids_t->lod()[0];
-    int64_t idx_width = ids_t->numel() / ids_lod.back();
-    auto *output = output_t->mutable_data<T>(context.GetPlace());
-
-    PADDLE_ENFORCE_LE(table_width * idx_width,
-                      out_width,
-                      platform::errors::InvalidArgument(
-                          "table_width * idx_width should be less than or "
-                          "equal to out_width. But received "
-                          "table_width * idx_width = %s, out_width = %d.",
-                          table_width * idx_width,
-                          out_width));
-    PADDLE_ENFORCE_GT(ids_lod.size(),
-                      1UL,
-                      platform::errors::InvalidArgument(
-                          "The tensor ids's LoD[0] should be greater than 1. "
-                          "But received the ids's LoD[0] = %d.",
-                          ids_lod.size()));
-
-    phi::jit::emb_seq_pool_attr_t attr(table_height,
-                                       table_width,
-                                       0,
-                                       idx_width,
-                                       out_width,
-                                       phi::jit::SeqPoolType::kSum);
-    for (size_t i = 0; i != ids_lod.size() - 1; ++i) {
-      attr.index_height = ids_lod[i + 1] - ids_lod[i];
-      auto emb_seqpool = phi::jit::KernelFuncs<phi::jit::EmbSeqPoolTuple<T>,
-                                               platform::CPUPlace>::Cache()
-                             .At(attr);
-      emb_seqpool(
-          table, ids + ids_lod[i] * idx_width, output + i * out_width, &attr);
-    }
-  }
-};
-#endif
-
 inline int FusedEmbeddingSeqPoolLastDim(const framework::DDim &table_dims,
                                         const framework::DDim &ids_dims) {
   int64_t last_dim = table_dims[1];
@@ -135,6 +41,57 @@ inline int FusedEmbeddingSeqPoolLastDim(const framework::DDim &table_dims,
   return last_dim;
 }
 
+// The gradient of the lookup at position p = j * idx_width + w of the ids,
+// i.e. the slice of the output gradient of the sequence j belongs to, with
+// the factor the pooling scaled it by.
+template <typename T>
+class FusedEmbeddingSeqPoolLookupGrad {
+ public:
+  FusedEmbeddingSeqPoolLookupGrad(const T *d_output,
+                                  const int64_t *ids,
+                                  const std::vector<uint64_t> &offset,
+                                  int64_t idx_width,
+                                  int64_t width,
+                                  int64_t out_width,
+                                  int64_t padding_idx,
+                                  phi::funcs::EmbeddingPoolType type)
+      : d_output_(d_output),
+        idx_width_(idx_width),
+        width_(width),
+        out_width_(out_width),
+        seq_of_(offset.back()),
+        scales_((offset.size() - 1) * idx_width) {
+    for (size_t i = 0; i + 1 < offset.size(); ++i) {
+      for (uint64_t j = offset[i]; j < offset[i + 1]; ++j) {
+        seq_of_[j] = i;
+      }
+      for (int64_t w = 0; w < idx_width; ++w) {
+        int64_t count = 0;
+        for (uint64_t j = offset[i]; j < offset[i + 1]; ++j) {
+          count += ids[j * idx_width + w] != padding_idx;
+        }
+        scales_[i * idx_width + w] =
+            phi::funcs::EmbeddingPoolScale<T>(type, count);
+      }
+    }
+  }
+
+  std::pair<const T *, T> operator()(int64_t p) const {
+    const int64_t i = seq_of_[p / idx_width_];
+    const int64_t w = p % idx_width_;
+    return {d_output_ + i * out_width_ + w * width_,
+            scales_[i * idx_width_ + w]};
+  }
+
+ private:
+  const T *d_output_;
+  int64_t idx_width_;
+  int64_t width_;
+  int64_t out_width_;
+  std::vector<int64_t> seq_of_;
+  std::vector<T> scales_;
+};
+
 template <typename T, typename DeviceContext>
 class FusedEmbeddingSeqPoolKernel : public framework::OpKernel<T> {
  public:
@@ -145,6 +102,7 @@ class FusedEmbeddingSeqPoolKernel : public framework::OpKernel<T> {
         context.Output<phi::DenseTensor>("Out");  // float tensor
     const phi::DenseTensor *table_var = context.Input<phi::DenseTensor>("W");
     const std::string &combiner_type = context.Attr<std::string>("combiner");
+    int64_t padding_idx = context.Attr<int64_t>("padding_idx");
 
     int64_t last_dim =
         FusedEmbeddingSeqPoolLastDim(table_var->dims(), ids_t->dims());
@@ -160,67 +118,33 @@ class FusedEmbeddingSeqPoolKernel : public framework::OpKernel<T> {
     // in run time, the shape from Ids -> output
     // should be [seq_length, 1] -> [batch_size, last_dim]
     output_t->Resize({batch_size, last_dim});
+    auto *output = output_t->mutable_data<T>(context.GetPlace());
 
-    if (combiner_type == "sum") {
-#if defined(PADDLE_WITH_MKLML) && !defined(_WIN32) && !defined(__APPLE__) && \
-    !defined(__OSX__)
-      int64_t padding_idx = context.Attr<int64_t>("padding_idx");
-      auto output = output_t->mutable_data<T>(context.GetPlace());
-      int64_t table_height = table_var->dims()[0];
-      int64_t table_width = table_var->dims()[1];
-      auto weights = table_var->data<T>();
-
-      const std::vector<uint64_t> offset = ids_lod[0];
-      auto len = ids_t->numel();
-      int idx_width = len / offset.back();
-
-      phi::DenseTensor csr_vals_t, csr_colmuns_t, csr_row_idx_t;
-      csr_vals_t.Resize({len});
-      csr_colmuns_t.Resize({len});
-      csr_row_idx_t.Resize({(batch_size + 1) * idx_width});
-      auto csr_vals = csr_vals_t.mutable_data<T>(context.GetPlace());
-      auto csr_colmuns = csr_colmuns_t.mutable_data<int>(context.GetPlace());
-      auto csr_row_idx = csr_row_idx_t.mutable_data<int>(context.GetPlace());
-      prepare_csr_data<T>(offset,
-                          ids_t->data<int64_t>(),
-                          idx_width,
-                          csr_vals,
-                          csr_colmuns,
-                          csr_row_idx,
-                          padding_idx);
-
-      const char transa = 'N';
-      const T alpha = 1.0;
-      const T beta = 0.0;
-      const char matdescra[] = {'G', 'L', 'N', 'C'};
-
-      const int m = batch_size * idx_width;
-      const int n = table_width;
-      const int k = table_height;
-
-      auto &dev_ctx = context.template device_context<phi::CPUContext>();
-      auto blas = phi::funcs::GetBlas<phi::CPUContext, T>(dev_ctx);
-      blas.CSRMM(&transa,
-                 &m,
-                 &n,
-                 &k,
-                 &alpha,
-                 matdescra,
-                 (const T *)csr_vals,
-                 (const int *)csr_colmuns,
-                 (const int *)csr_row_idx,
-                 (const int *)csr_row_idx + 1,
-                 weights,
-                 &n,
-                 &beta,
-                 output,
-                 &n);
+    const std::vector<uint64_t> &offset = ids_lod[0];
+    int64_t table_height = table_var->dims()[0];
+    int64_t table_width = table_var->dims()[1];
+    // the number of ids looked up by every row of Ids
+    int64_t idx_width = last_dim / table_width;
 
-#else
-      EmbeddingVSumFunctor<T> functor;
-      functor(context, table_var, ids_t, output_t);
-#endif
+    // every column of the ids is a slot of its own, pooled into its slice
+    // of the output, and all of them look up the same table
+    const int64_t *ids = ids_t->data<int64_t>();
+    std::vector<phi::funcs::EmbeddingPoolSlot<T, int64_t>> slots;
+    for (int64_t w = 0; w < idx_width; ++w) {
+      slots.push_back({table_var->data<T>(),
+                       table_height,
+                       ids + w,
+                       idx_width,
+                       offset.data(),
+                       output + w * table_width,
+                       last_dim});
     }
+    phi::funcs::EmbeddingPool(
+        slots,
+        batch_size,
+        table_width,
+        padding_idx,
+        phi::funcs::StringToEmbeddingPoolType(combiner_type));
   }
 };
 
@@ -241,101 +165,67 @@ class FusedEmbeddingSeqPoolGradKernel : public framework::OpKernel<T> {
           "must be either phi::DenseTensor or SelectedRows."));
     }
 
+    auto *ids = context.Input<phi::DenseTensor>("Ids");
+    auto *d_output =
+        context.Input<phi::DenseTensor>(framework::GradVarName("Out"));
+    int64_t padding_idx = context.Attr<int64_t>("padding_idx");
+    const auto &ids_lod = ids->lod();
+    PADDLE_ENFORCE_EQ(ids_lod.size(),
+                      1UL,
+                      platform::errors::InvalidArgument(
+                          "The LoD level of Input(Ids) should be 1. But "
+                          "received Ids's LoD level = %d.",
+                          ids_lod.size()));
+    const std::vector<uint64_t> &offset = ids_lod[0];
+    const int64_t *ids_data = ids->data<int64_t>();
+    int64_t ids_num = ids->numel();
+    int64_t width = table_dim[1];
+    int64_t idx_width = d_output->dims()[1] / width;
+
+    FusedEmbeddingSeqPoolLookupGrad<T> lookup_grad(
+        d_output->data<T>(),
+        ids_data,
+        offset,
+        idx_width,
+        width,
+        d_output->dims()[1],
+        padding_idx,
+        phi::funcs::StringToEmbeddingPoolType(
+            context.Attr<std::string>("combiner")));
+    // the lookups of an id are summed into a single row, by one thread
+    phi::funcs::EmbeddingIdGroups groups = phi::funcs::GroupEmbeddingIds(
+        ids_data, ids_num, table_dim[0], padding_idx);
+
     bool is_sparse = context.Attr<bool>("is_sparse");
     // Since paddings are not trainable and fixed in forward, the gradient of
     // paddings makes no sense and we don't deal with it in backward.
     if (is_sparse) {
-      auto *ids = context.Input<phi::DenseTensor>("Ids");
-      auto *d_output =
-          context.Input<phi::DenseTensor>(framework::GradVarName("Out"));
       auto *d_table =
           context.Output<phi::SelectedRows>(framework::GradVarName("W"));
       // runtime shape
       d_table->set_height(table_dim[0]);
 
-      auto *ids_data = ids->data<int64_t>();
-      int64_t ids_num = ids->numel();
-      auto lod = ids->lod()[0];
-      int64_t out_width = d_output->dims()[1];
-
+      const int64_t rows_num = groups.rows.size();
       phi::Vector<int64_t> *new_rows = d_table->mutable_rows();
-      new_rows->resize(ids_num);
-      std::memcpy(&(*new_rows)[0], ids_data, ids_num * sizeof(int64_t));
+      new_rows->resize(rows_num);
+      if (rows_num > 0) {
+        std::memcpy(
+            &(*new_rows)[0], groups.rows.data(), rows_num * sizeof(int64_t));
+      }
 
       auto *d_table_value = d_table->mutable_value();
-      d_table_value->Resize({ids_num, table_dim[1]});
+      d_table_value->Resize({rows_num, width});
       T *d_table_data = d_table_value->mutable_data<T>(context.GetPlace());
-      const T *d_output_data = d_output->data<T>();
-
-      auto vbroadcast = phi::jit::KernelFuncs<phi::jit::VBroadcastTuple<T>,
-                                              platform::CPUPlace>::Cache()
-                            .At(out_width);
-      for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
-        int64_t h = static_cast<int64_t>(lod[i + 1] - lod[i]);
-        const T *src = d_output_data + i * out_width;
-        T *dst = d_table_data + lod[i] * out_width;
-        vbroadcast(src, dst, h, out_width);
-      }
+      phi::funcs::SumEmbeddingGrads(
+          groups, width, false, lookup_grad, d_table_data);
     } else {
-#if defined(PADDLE_WITH_MKLML) && !defined(_WIN32) && !defined(__APPLE__) && \
-    !defined(__OSX__)
-      auto *ids = context.Input<phi::DenseTensor>("Ids");
-      auto *d_output =
-          context.Input<phi::DenseTensor>(framework::GradVarName("Out"));
       auto *d_table =
           context.Output<phi::DenseTensor>(framework::GradVarName("W"));
-      int64_t padding_idx = context.Attr<int64_t>("padding_idx");
-
       d_table->Resize(table_dim);
       auto *d_table_data = d_table->mutable_data<T>(context.GetPlace());
       memset(d_table_data, 0, d_table->numel() * sizeof(T));
-
-      const auto &ids_lod = ids->lod();
-      PADDLE_ENFORCE_EQ(ids_lod.size(),
-                        1UL,
-                        platform::errors::InvalidArgument(
-                            "The LoD level of Input(Ids) should be 1. But "
-                            "received Ids's LoD level = %d.",
-                            ids_lod.size()));
-      const std::vector<uint64_t> offset = ids_lod[0];
-      auto len = ids->numel();
-      int idx_width = len / offset.back();
-
-      phi::DenseTensor csr_vals_t, csr_colmuns_t, csr_row_idx_t;
-      csr_vals_t.Resize({len});
-      csr_colmuns_t.Resize({len});
-      int64_t batch_size = ids_lod[0].size() - 1;
-      csr_row_idx_t.Resize({(batch_size + 1) * idx_width});
-      auto csr_vals = csr_vals_t.mutable_data<T>(context.GetPlace());
-      auto csr_colmuns = csr_colmuns_t.mutable_data<int>(context.GetPlace());
-      auto csr_row_idx = csr_row_idx_t.mutable_data<int>(context.GetPlace());
-      prepare_csr_data<T>(offset,
-                          ids->data<int64_t>(),
-                          idx_width,
-                          csr_vals,
-                          csr_colmuns,
-                          csr_row_idx,
-                          padding_idx);
-
-      auto *d_output_data = d_output->data<T>();
-      auto &dev_ctx = context.template device_context<phi::CPUContext>();
-      auto blas = phi::funcs::GetBlas<phi::CPUContext, T>(dev_ctx);
-      int width = static_cast<int>(table_dim[1]);
-      int num_seq = batch_size * idx_width;
-      LOG(INFO) << "num seq = " << num_seq << " width = " << width;
-      for (int i = 0; i < num_seq; ++i) {
-        for (int j = csr_row_idx[i]; j < csr_row_idx[i + 1]; ++j) {
-          unsigned int word_idx = csr_colmuns[j];
-          T val = csr_vals[j];
-          blas.AXPY(width,
-                    val,
-                    d_output_data + i * width,
-                    d_table_data + word_idx * width);
-        }
-      }
-#else
-      LOG(ERROR) << "Dense is not supported in fused_embedding_seq_pool_op now";
-#endif
+      phi::funcs::SumEmbeddingGrads(
+          groups, width, true, lookup_grad, d_table_data);
     }
   }
 };
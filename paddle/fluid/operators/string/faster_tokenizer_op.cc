@@ -15,22 +15,25 @@ limitations under the License. */
 
 #include <algorithm>
 #include <chrono>
-#include <codecvt>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <mutex>
 #include <numeric>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/framework/string_array.h"
+#include "paddle/fluid/framework/threadpool.h"
 
 namespace paddle {
 namespace operators {
 
 using std::bad_cast;
-using std::codecvt_utf8;
 using std::endl;
 using std::exception;
 using std::ifstream;
@@ -83,101 +86,270 @@ inline bool IsPunctuation(const wchar_t& ch) {
   return false;
 }
 
-BasicTokenizer::BasicTokenizer(bool do_lower_case /* = true */)
-    : do_lower_case_(do_lower_case) {}
+namespace {
+
+// Runs fn(begin, end) over ranges of [0, n) on the framework thread pool,
+// the calling thread takes the first range. Short batches stay on the
+// calling thread.
+template <typename Fn>
+void ParallelFor(size_t n, const Fn& fn) {
+  constexpr size_t kMinItemsPerTask = 4;
+  size_t max_tasks = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  size_t num_tasks =
+      min(max_tasks, (n + kMinItemsPerTask - 1) / kMinItemsPerTask);
+  if (num_tasks <= 1) {
+    fn(0, n);
+    return;
+  }
+  size_t step = (n + num_tasks - 1) / num_tasks;
+  vector<std::future<void>> futures;
+  auto* pool = framework::ThreadPool::GetInstance();
+  for (size_t begin = step; begin < n; begin += step) {
+    size_t end = min(n, begin + step);
+    futures.emplace_back(pool->Run([&fn, begin, end] { fn(begin, end); }));
+  }
+  fn(0, step);
+  // Every task must be done before an exception leaves fn's scope.
+  for (auto& future : futures) future.wait();
+  for (auto& future : futures) future.get();
+}
 
-wchar_t BasicTokenizer::do_lower_case(wchar_t ch) const {
-  wchar_t new_ch = utf8proc_tolower(ch);
-  return new_ch;
+}  // namespace
+
+constexpr int VocabTrie::kRoot;
+
+VocabTrie::VocabTrie(const framework::Vocab& vocab)
+    : vocab_size_(vocab.size()) {
+  vector<Key> keys;
+  keys.reserve(vocab.size());
+  for (auto& item : vocab) {
+    string key;
+    framework::ConvertWstrToStr(item.first, &key);
+    if (!key.empty()) keys.emplace_back(std::move(key), item.second);
+  }
+  // Bytewise order, so that the children of a node are contiguous and a
+  // key comes before the keys it prefixes.
+  std::sort(keys.begin(), keys.end());
+
+  base_.assign(1024, 0);
+  check_.assign(1024, -1);
+  value_.assign(1024, -1);
+  // The root is never a child.
+  check_[kRoot] = -2;
+  if (!keys.empty()) Build(keys, 0, keys.size(), 0, kRoot);
+
+  size_t used = check_.size();
+  while (used > 1 && check_[used - 1] == -1) --used;
+  base_.resize(used);
+  check_.resize(used);
+  value_.resize(used);
+  base_.shrink_to_fit();
+  check_.shrink_to_fit();
+  value_.shrink_to_fit();
 }
 
-void BasicTokenizer::Tokenize(const string& text, vector<wstring>* res) const {
-  std::wstring unicode_text;
-  bool status = framework::ConvertStrToWstr(text, &unicode_text);
-  if (!status) {
-    // String is converted into wstring failedly.
-    return;
+std::shared_ptr<const VocabTrie> VocabTrie::Get(
+    const framework::Vocab& vocab) {
+  // The trie is cached by the content of the vocab, so a vocab changed in
+  // place or a new one at the address of a freed one never gets a stale
+  // trie. Hashing the entries is far cheaper than building the trie. The
+  // entry hashes are summed, as the iteration order of equal vocabs may
+  // differ.
+  size_t hash = vocab.size();
+  std::hash<wstring> token_hash;
+  for (auto& item : vocab) {
+    uint64_t h = token_hash(item.first) ^
+                 (static_cast<uint64_t>(item.second) * 0x9e3779b97f4a7c15ULL);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    hash += static_cast<size_t>(h ^ (h >> 31));
+  }
+
+  static std::mutex mutex;
+  static unordered_map<size_t, std::shared_ptr<const VocabTrie>> cache;
+  constexpr size_t kMaxCachedVocabs = 16;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = cache.find(hash);
+  if (it != cache.end() && it->second->size() == vocab.size()) {
+    return it->second;
+  }
+  if (cache.size() >= kMaxCachedVocabs) cache.clear();
+  auto trie = std::make_shared<const VocabTrie>(vocab);
+  cache[hash] = trie;
+  return trie;
+}
+
+void VocabTrie::Build(const vector<Key>& keys,
+                      size_t begin,
+                      size_t end,
+                      size_t depth,
+                      int node) {
+  size_t i = begin;
+  if (keys[i].first.size() == depth) {
+    value_[node] = keys[i].second;
+    ++i;
+  }
+  // Distinct wide tokens may share a UTF-8 form, the first one wins.
+  while (i < end && keys[i].first.size() == depth) ++i;
+  if (i == end) return;
+
+  vector<unsigned char> labels;
+  vector<size_t> bounds;
+  for (size_t j = i; j < end; ++j) {
+    auto c = static_cast<unsigned char>(keys[j].first[depth]);
+    if (labels.empty() || labels.back() != c) {
+      labels.push_back(c);
+      bounds.push_back(j);
+    }
+  }
+  bounds.push_back(end);
+
+  int base = FindBase(labels);
+  base_[node] = base;
+  for (auto c : labels) check_[base + c] = node;
+  for (size_t k = 0; k < labels.size(); ++k) {
+    Build(keys, bounds[k], bounds[k + 1], depth + 1, base + labels[k]);
   }
-  std::wstring cache_text = L"";
-  auto PushCacheText = [&]() {
-    if (cache_text != L"") {
-      res->emplace_back(cache_text);
-      cache_text = L"";
+}
+
+int VocabTrie::FindBase(const vector<unsigned char>& labels) {
+  while (next_free_ < check_.size() && check_[next_free_] != -1) {
+    ++next_free_;
+  }
+  size_t first = std::max<size_t>(next_free_, labels[0] + 1);
+  size_t num_used = 0;
+  for (size_t pos = first;; ++pos) {
+    if (pos + 256 > check_.size()) {
+      size_t size = check_.size() * 2;
+      base_.resize(size, 0);
+      check_.resize(size, -1);
+      value_.resize(size, -1);
+    }
+    if (check_[pos] != -1) {
+      ++num_used;
+      continue;
+    }
+    size_t base = pos - labels[0];
+    bool free = true;
+    for (size_t k = 1; k < labels.size() && free; ++k) {
+      free = check_[base + labels[k]] == -1;
+    }
+    if (free) {
+      // Give up the few holes of an almost full region rather than
+      // scanning it for every node, as darts does.
+      if (num_used * 20 >= (pos - first) * 19) next_free_ = pos;
+      return static_cast<int>(base);
+    }
+  }
+}
+
+BasicTokenizer::BasicTokenizer(bool do_lower_case /* = true */)
+    : do_lower_case_(do_lower_case) {}
+
+bool BasicTokenizer::Tokenize(
+    const string& text,
+    string* buffer,
+    vector<std::pair<size_t, size_t>>* tokens) const {
+  buffer->clear();
+  buffer->reserve(text.size());
+  size_t num_tokens = tokens->size();
+  size_t word_begin = 0;
+  auto PushWord = [&]() {
+    if (buffer->size() > word_begin) {
+      tokens->emplace_back(word_begin, buffer->size());
+      word_begin = buffer->size();
     }
   };
-  for (auto& ch : unicode_text) {
+
+  const auto* data = reinterpret_cast<const utf8proc_uint8_t*>(text.data());
+  utf8proc_ssize_t size = text.size();
+  utf8proc_ssize_t pos = 0;
+  utf8proc_uint8_t encoded[4];
+  while (pos < size) {
+    utf8proc_int32_t ch = data[pos];
+    utf8proc_ssize_t len = 1;
+    if (ch >= 0x80) {
+      len = utf8proc_iterate(data + pos, size - pos, &ch);
+      if (len < 0) {
+        // Not valid UTF-8.
+        buffer->clear();
+        tokens->resize(num_tokens);
+        return false;
+      }
+    }
+    pos += len;
     if (ch == 0 || ch == 0xfffd || IsControl(ch)) {
       continue;
     }
     if (do_lower_case_) {
-      ch = do_lower_case(ch);
+      ch = ch < 0x80 ? (ch >= 'A' && ch <= 'Z' ? ch + ('a' - 'A') : ch)
+                     : utf8proc_tolower(ch);
     }
     if (IsChineseChar(ch) || IsPunctuation(ch)) {
-      PushCacheText();
-      res->emplace_back(std::wstring{ch});
+      PushWord();
+      buffer->append(reinterpret_cast<const char*>(encoded),
+                     utf8proc_encode_char(ch, encoded));
+      PushWord();
     } else if (IsWhiteSpace(ch)) {
-      PushCacheText();
+      PushWord();
+    } else if (ch < 0x80) {
+      buffer->push_back(static_cast<char>(ch));
     } else {
-      cache_text += ch;
+      buffer->append(reinterpret_cast<const char*>(encoded),
+                     utf8proc_encode_char(ch, encoded));
     }
   }
-  PushCacheText();
+  PushWord();
+  return true;
 }
 
 WordPieceTokenizer::WordPieceTokenizer(
-    const framework::Vocab* vocab,
-    const wstring& unk_token /* = L"[UNK]"*/,
+    const VocabTrie* trie,
+    int64_t unk_token_id,
     const size_t max_input_chars_per_word /* = 100 */)
-    : vocab_(vocab),
-      unk_token_(unk_token),
-      max_input_chars_per_word_(max_input_chars_per_word) {
-  unk_token_id_ = vocab_->at(unk_token_);
-}
+    : trie_(trie),
+      unk_token_id_(unk_token_id),
+      suffix_root_(trie->Walk(VocabTrie::kRoot, "##", 2)),
+      max_input_chars_per_word_(max_input_chars_per_word) {}
 
-void WordPieceTokenizer::Tokenize(const wstring& text,
+void WordPieceTokenizer::Tokenize(const char* word,
+                                  size_t size,
                                   vector<int64_t>* token_ids) const {
-  size_t len = text.size();
-  if (len > max_input_chars_per_word_) {
-    token_ids->emplace_back(std::move(unk_token_id_));
-    return;
+  size_t num_chars = 0;
+  for (size_t i = 0; i < size; ++i) {
+    // Count the bytes that are not UTF-8 continuation bytes.
+    num_chars += (static_cast<unsigned char>(word[i]) & 0xC0) != 0x80;
   }
-
-  auto it = vocab_->find(text);
-  if (it != vocab_->end()) {
-    token_ids->emplace_back(std::move(it->second));
+  if (num_chars > max_input_chars_per_word_) {
+    token_ids->emplace_back(unk_token_id_);
     return;
   }
 
+  // The whole word is the longest match, so it needs no separate lookup.
+  // A vocab token that matches a prefix of valid UTF-8 always ends on a
+  // character boundary.
+  size_t num_ids = token_ids->size();
   size_t start = 0;
-  vector<int64_t> wordpiece_ids;
-  while (start < len) {
-    size_t end = len;
-    std::wstring cur_substr;
-    int64_t cur_substr_id;
-    while (start < end) {
-      std::wstring sub = text.substr(start, end - start);
-      if (start > 0) {
-        sub = L"##" + sub;
-      }
-      auto it = vocab_->find(sub);
-      if (it != vocab_->end()) {
-        cur_substr = sub;
-        cur_substr_id = it->second;
-        break;
+  while (start < size) {
+    int node = start == 0 ? VocabTrie::kRoot : suffix_root_;
+    int64_t piece_id = -1;
+    size_t end = start;
+    for (size_t i = start; i < size && node >= 0; ++i) {
+      node = trie_->Next(node, static_cast<unsigned char>(word[i]));
+      int64_t id = trie_->Value(node);
+      if (id >= 0) {
+        piece_id = id;
+        end = i + 1;
       }
-      end -= 1;
     }
-
-    if (cur_substr.empty()) {
-      token_ids->emplace_back(std::move(unk_token_id_));
+    if (piece_id < 0) {
+      token_ids->resize(num_ids);
+      token_ids->emplace_back(unk_token_id_);
       return;
-    } else {
-      start = end;
-      wordpiece_ids.emplace_back(std::move(cur_substr_id));
     }
-  }
-  for (auto& token_id : wordpiece_ids) {
-    token_ids->emplace_back(std::move(token_id));
+    token_ids->emplace_back(piece_id);
+    start = end;
   }
 }
 
@@ -197,8 +369,9 @@ BertTokenizer::BertTokenizer(const framework::Vocab* vocab,
       sep_token_(sep_token),
       padding_site_(padding_site),
       vocab_(vocab),
+      trie_(VocabTrie::Get(*vocab)),
       basic_tokenizer_(do_lower_case_),
-      word_piece_tokenizer_(vocab_, unk_token) {
+      word_piece_tokenizer_(trie_.get(), vocab_->at(unk_token)) {
   unk_token_id_ = vocab_->at(unk_token_);
   pad_token_id_ = vocab_->at(pad_token_);
   cls_token_id_ = vocab_->at(cls_token_);
@@ -216,28 +389,15 @@ BertTokenizer::BertTokenizer(const framework::Vocab* vocab,
 
 void BertTokenizer::Tokenize(const string& text,
                              vector<int64_t>* split_token_ids) const {
-  std::vector<std::wstring> tmp_tokens;
-  basic_tokenizer_.Tokenize(text, &tmp_tokens);
-  if (tmp_tokens.empty()) return;
-  split_token_ids->reserve(tmp_tokens.size());
-  for (auto& w_token : tmp_tokens) {
-    const auto& vec_size = w_token.size();
-    if (vec_size == 1) {
-      if (IsChineseChar(w_token[0])) {
-        auto vocab_it = vocab_->find(w_token);
-        if (vocab_it != vocab_->end()) {
-          split_token_ids->emplace_back(std::move(vocab_it->second));
-        } else {
-          split_token_ids->emplace_back(std::move(unk_token_id_));
-        }
-      } else {
-        word_piece_tokenizer_.Tokenize(w_token, split_token_ids);
-      }
-    } else if (vec_size > 1) {
-      word_piece_tokenizer_.Tokenize(w_token, split_token_ids);
-    } else {
-      continue;
-    }
+  string buffer;
+  vector<std::pair<size_t, size_t>> tokens;
+  basic_tokenizer_.Tokenize(text, &buffer, &tokens);
+  if (tokens.empty()) return;
+  split_token_ids->reserve(split_token_ids->size() + tokens.size());
+  for (auto& token : tokens) {
+    word_piece_tokenizer_.Tokenize(buffer.data() + token.first,
+                                   token.second - token.first,
+                                   split_token_ids);
   }
 }
 
@@ -282,28 +442,13 @@ int64_t BertTokenizer::GetNumSpecialTokensToAdd(const bool pair) const {
   }
 }
 
-void BertTokenizer::CreateTokenTypeIdsFromSequences(
-    vector<int64_t>* token_type_ids,
-    const vector<int64_t>& token_ids_0,
-    const vector<int64_t>& token_ids_1 /* = vector<int64_t>() */) const {
-  if (token_ids_1.size() == 0) {
-    vector<int64_t> tmp(token_ids_0.size() + 2, 0);
-    token_type_ids->swap(tmp);
-  } else {
-    vector<int64_t> tmp(token_ids_0.size() + token_ids_1.size() + 3, 0);
-    for (size_t i = token_ids_0.size() + 2; i < tmp.size(); i++) {
-      tmp[i] = 1;
-    }
-    token_type_ids->swap(tmp);
-  }
-}
-
 void BertTokenizer::TruncateSequence(
     vector<int64_t>* ids,
     vector<int64_t>* pair_ids,
     const size_t num_tokens_to_remove /* = 0 */,
     const size_t stride /* = 0 */) const {
   for (size_t i = 0; i < num_tokens_to_remove; i++) {
+    if (ids->empty() && pair_ids->empty()) break;
     if ((pair_ids->size() == 0) || (ids->size() > pair_ids->size())) {
       ids->pop_back();
     } else {
@@ -314,13 +459,11 @@ void BertTokenizer::TruncateSequence(
 
 int64_t BertTokenizer::GetPadTokenID() const { return pad_token_id_; }
 
-int BertTokenizer::Encode(
-    unordered_map<string, vector<int64_t>>* encoded_inputs,
-    const string& text,
-    const string& text_pair /* = "" */,
-    bool is_split_into_words /* = false */,
-    const size_t max_seq_len /* = 0 */,
-    bool pad_to_max_seq_len /* = false */) const {
+int BertTokenizer::Encode(EncodedSequence* encoded,
+                          const string& text,
+                          const string& text_pair /* = "" */,
+                          bool is_split_into_words /* = false */,
+                          const size_t max_seq_len /* = 0 */) const {
   vector<int64_t> ids;
   vector<int64_t> pair_ids;
   if (!is_split_into_words) {
@@ -331,19 +474,17 @@ int BertTokenizer::Encode(
       if (pair_ids.empty()) return 0;
     }
   } else {
-    std::wstring unicode_text;
-    bool status_a = framework::ConvertStrToWstr(text, &unicode_text);
-    if (!status_a) {
-      return 0;
-    }
-    for (size_t i = 0; i < unicode_text.size(); i++) {
-      wstring token = unicode_text.substr(i, 1);
-      auto it = vocab_->find(token);
-      if (it != vocab_->end()) {
-        ids.emplace_back(std::move(it->second));
-      } else {
-        ids.emplace_back(std::move(unk_token_id_));
-      }
+    // Every character is a token.
+    const auto* data = reinterpret_cast<const utf8proc_uint8_t*>(text.data());
+    utf8proc_ssize_t size = text.size();
+    utf8proc_ssize_t pos = 0;
+    while (pos < size) {
+      utf8proc_int32_t ch;
+      utf8proc_ssize_t len = utf8proc_iterate(data + pos, size - pos, &ch);
+      if (len < 0) return 0;
+      int64_t id = trie_->Find(text.data() + pos, len);
+      ids.emplace_back(id >= 0 ? id : unk_token_id_);
+      pos += len;
     }
   }
 
@@ -365,91 +506,53 @@ int BertTokenizer::Encode(
     TruncateSequence(&ids, &pair_ids, total_len - max_seq_len);
   }
 
-  // Add special tokens
-  vector<int64_t> sequence;
-  BuildInputsWithSpecialTokens(&sequence, ids, pair_ids);
-  size_t seq_len = sequence.size();
-  vector<int64_t> token_type_ids;
-  CreateTokenTypeIdsFromSequences(&token_type_ids, ids, pair_ids);
-
-  // Build output dictionnary
-  encoded_inputs->emplace("input_ids", sequence);
-  encoded_inputs->emplace("token_type_ids", token_type_ids);
+  // Add special tokens, [CLS] ids [SEP] is the first segment.
+  BuildInputsWithSpecialTokens(&encoded->input_ids, ids, pair_ids);
+  encoded->segment_len = ids.size() + 2;
   // Check lengths
-  if (max_seq_len > 0 && seq_len > max_seq_len) {
+  if (max_seq_len > 0 && encoded->input_ids.size() > max_seq_len) {
     VLOG(3) << "There is something wrong with the input sequence length."
                " Please check it.";
     // Failed.
     return 0;
   }
-
-  // Padding
-  bool needs_to_be_padded = false;
-  if (pad_to_max_seq_len && max_seq_len > 0 && (seq_len < max_seq_len)) {
-    needs_to_be_padded = true;
-  }
-
-  if (needs_to_be_padded) {
-    int64_t difference = max_seq_len - seq_len;
-    size_t pad_start = max_seq_len - 1 - difference;
-    encoded_inputs->at("token_type_ids").resize(max_seq_len);
-    for (size_t i = max_seq_len - 1; i > pad_start; i--) {
-      encoded_inputs->at("token_type_ids")[i] = pad_token_id_;
-    }
-
-    encoded_inputs->at("input_ids").resize(max_seq_len);
-    for (size_t i = max_seq_len - 1; i > pad_start; i--) {
-      encoded_inputs->at("input_ids")[i] = pad_token_id_;
-    }
-  }
+  // Padding is left to the kernel, which writes the batch into the output
+  // tensors.
   return 1;
 }
 
 void BertTokenizer::BatchEncode(
-    vector<unordered_map<string, vector<int64_t>>>* batch_encode_inputs,
+    vector<EncodedSequence>* batch_encoded,
     const framework::Strings& batch_text,
     const framework::Strings& batch_text_pair /* = vector<string>() */,
     bool is_split_into_words /* = false */,
-    const size_t max_seq_len /* = 0 */,
-    bool pad_to_max_seq_len /* = false */) const {
+    const size_t max_seq_len /* = 0 */) const {
   bool has_text_pair = false;
   if (batch_text_pair.size() != 0) {
     has_text_pair = true;
   }
 
   size_t batch_size = batch_text.size();
-#ifdef PADDLE_WITH_MKLML
-#pragma omp parallel for
-#endif
-  for (size_t i = 0; i < batch_size; i++) {
-    unordered_map<string, vector<int64_t>> res;
-    if (has_text_pair) {
-      auto status = Encode(&res,
-                           batch_text[i],
-                           batch_text_pair[i],
-                           is_split_into_words,
-                           max_seq_len,
-                           pad_to_max_seq_len);
-      if (!status) {
-        res["input_ids"] =
-            std::vector<int64_t>{cls_token_id_, sep_token_id_, cls_token_id_};
-        res["token_type_ids"] = std::vector<int64_t>{0, 0, 1};
-      }
-    } else {
-      auto status = Encode(&res,
+  batch_encoded->resize(batch_size);
+  const string no_text_pair;
+  ParallelFor(batch_size, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      auto& encoded = batch_encoded->at(i);
+      auto status = Encode(&encoded,
                            batch_text[i],
-                           {},
+                           has_text_pair ? batch_text_pair[i] : no_text_pair,
                            is_split_into_words,
-                           max_seq_len,
-                           pad_to_max_seq_len);
-
+                           max_seq_len);
       if (!status) {
-        res["input_ids"] = std::vector<int64_t>{cls_token_id_, sep_token_id_};
-        res["token_type_ids"] = std::vector<int64_t>{0, 0};
+        if (has_text_pair) {
+          encoded.input_ids = {cls_token_id_, sep_token_id_, cls_token_id_};
+        } else {
+          encoded.input_ids = {cls_token_id_, sep_token_id_};
+        }
+        encoded.segment_len = 2;
       }
     }
-    batch_encode_inputs->at(i) = std::move(res);
-  }
+  });
 }
 
 class FasterTokenizerOp : public framework::OperatorWithKernel {
@@ -13,9 +13,12 @@ limitations under the License. */
 
 #include <utf8proc.h>
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/framework/op_registry.h"
@@ -42,31 +45,96 @@ inline bool IsWhiteSpace(const wchar_t& ch);
 using Vocab = unordered_map<wstring, int>;
 using InvVocab = unordered_map<int, wstring>;
 
+// A double-array trie over the UTF-8 bytes of the vocab tokens. Walking it
+// costs two array reads per byte, so the tokenizers match words without
+// building substrings or hashing them.
+class VocabTrie {
+ public:
+  explicit VocabTrie(const framework::Vocab& vocab);
+
+  // Returns the trie of vocab, built on first use and shared by all the
+  // vocabs with the same entries afterwards.
+  static std::shared_ptr<const VocabTrie> Get(const framework::Vocab& vocab);
+
+  static constexpr int kRoot = 0;
+
+  // Returns the child of node along byte c, or -1 if there is none.
+  int Next(int node, unsigned char c) const {
+    size_t pos = static_cast<size_t>(base_[node]) + c;
+    return pos < check_.size() && check_[pos] == node ? static_cast<int>(pos)
+                                                      : -1;
+  }
+  // Walks size bytes from node, returns -1 if they leave the trie.
+  int Walk(int node, const char* data, size_t size) const {
+    for (size_t i = 0; i < size && node >= 0; ++i) {
+      node = Next(node, static_cast<unsigned char>(data[i]));
+    }
+    return node;
+  }
+  // Token id of the token ending at node, or -1.
+  int64_t Value(int node) const { return node < 0 ? -1 : value_[node]; }
+  int64_t Find(const char* data, size_t size) const {
+    return Value(Walk(kRoot, data, size));
+  }
+
+  size_t size() const { return vocab_size_; }
+
+ private:
+  using Key = std::pair<string, int32_t>;
+  void Build(const vector<Key>& keys,
+             size_t begin,
+             size_t end,
+             size_t depth,
+             int node);
+  int FindBase(const vector<unsigned char>& labels);
+
+  vector<int32_t> base_;
+  vector<int32_t> check_;
+  vector<int32_t> value_;
+  size_t next_free_{1};
+  size_t vocab_size_{0};
+};
+
 class BasicTokenizer {
  public:
   explicit BasicTokenizer(bool do_lower_case = true);
-  void Tokenize(const string& text, vector<wstring>* res) const;
+  // Cleans and normalizes the UTF-8 text into *buffer and appends the byte
+  // range [begin, end) of each token in it to *tokens. Returns false and
+  // leaves no token if the text is not valid UTF-8.
+  bool Tokenize(const string& text,
+                string* buffer,
+                vector<std::pair<size_t, size_t>>* tokens) const;
 
  private:
-  wchar_t do_lower_case(wchar_t ch) const;
-
   bool do_lower_case_;
 };
 
 class WordPieceTokenizer {
  public:
-  explicit WordPieceTokenizer(const framework::Vocab* vocab,
-                              const wstring& unk_token = L"[UNK]",
-                              const size_t max_input_chars_per_word = 100);
-  void Tokenize(const wstring& text, vector<int64_t>* output) const;
+  WordPieceTokenizer(const VocabTrie* trie,
+                     int64_t unk_token_id,
+                     const size_t max_input_chars_per_word = 100);
+  // Greedy longest-match-first split of the UTF-8 word, the pieces after
+  // the first one are looked up with the "##" prefix.
+  void Tokenize(const char* word,
+                size_t size,
+                vector<int64_t>* token_ids) const;
 
  private:
-  const framework::Vocab* vocab_;
-  wstring unk_token_{L"[UNK]"};
+  const VocabTrie* trie_;
   int64_t unk_token_id_;
+  // The node "##" leads to, continuation pieces are matched from there.
+  int suffix_root_;
   size_t max_input_chars_per_word_;
 };
 
+// The ids of an encoded sequence (pair), the first segment_len of them
+// have token type 0 and the rest token type 1.
+struct EncodedSequence {
+  vector<int64_t> input_ids;
+  size_t segment_len{0};
+};
+
 class BertTokenizer {
  public:
   explicit BertTokenizer(const framework::Vocab* vocab,
@@ -83,28 +151,25 @@ class BertTokenizer {
       vector<int64_t>* res,
       const vector<int64_t>& token_ids_0,
       const vector<int64_t>& token_ids_1 = vector<int64_t>()) const;
-  void CreateTokenTypeIdsFromSequences(
-      vector<int64_t>* token_type_ids,
-      const vector<int64_t>& token_ids_0,
-      const vector<int64_t>& token_ids_1 = vector<int64_t>()) const;
   void TruncateSequence(vector<int64_t>* ids,
                         vector<int64_t>* pair_ids,
                         const size_t num_tokens_to_remove = 0,
                         const size_t stride = 0) const;
   int64_t GetNumSpecialTokensToAdd(const bool pair = false) const;
-  int Encode(unordered_map<string, vector<int64_t>>* encoded_inputs,
+  // Returns 0 if the text can't be encoded within max_seq_len.
+  int Encode(EncodedSequence* encoded,
              const string& text,
              const string& text_pair = "",
              bool is_split_into_words = false,
-             const size_t max_seq_len = 0,
-             bool pad_to_max_seq_len = false) const;
+             const size_t max_seq_len = 0) const;
+  // Encodes the sequences in parallel. A sequence that can't be encoded
+  // becomes [CLS] [SEP] ([CLS]).
   void BatchEncode(
-      vector<unordered_map<string, vector<int64_t>>>* batch_encode_inputs,
+      vector<EncodedSequence>* batch_encoded,
       const framework::Strings& batch_text,
       const framework::Strings& batch_text_pair = framework::Strings(),
       bool is_split_into_words = false,
-      const size_t max_seq_len = 0,
-      bool pad_to_max_seq_len = false) const;
+      const size_t max_seq_len = 0) const;
 
   int64_t GetPadTokenID() const;
 
@@ -113,6 +178,7 @@ class BertTokenizer {
   wstring unk_token_, pad_token_, cls_token_, mask_token_, sep_token_;
   string padding_site_;
   const framework::Vocab* vocab_;
+  std::shared_ptr<const VocabTrie> trie_;
   BasicTokenizer basic_tokenizer_;
   WordPieceTokenizer word_piece_tokenizer_;
   int64_t unk_token_id_, cls_token_id_, mask_token_id_, pad_token_id_,
@@ -135,7 +201,9 @@ class FasterTokenizerKernel : public framework::OpKernel<T> {
     auto do_lower_case = static_cast<bool>(ctx.Attr<bool>("do_lower_case"));
     auto is_split_into_words =
         static_cast<bool>(ctx.Attr<bool>("is_split_into_words"));
-    auto max_seq_len = static_cast<size_t>(ctx.Attr<int>("max_seq_len"));
+    // A negative max_seq_len means no limit, as 0 does.
+    auto max_seq_len =
+        static_cast<size_t>(std::max(ctx.Attr<int>("max_seq_len"), 0));
     auto pad_to_max_seq_len =
         static_cast<bool>(ctx.Attr<bool>("pad_to_max_seq_len"));
 
@@ -147,32 +215,18 @@ class FasterTokenizerKernel : public framework::OpKernel<T> {
     }
 
     BertTokenizer tokenizer(vocab, do_lower_case);
-    size_t batch_max_seq_len = 0;
     size_t batch_size = text->size();
+    vector<EncodedSequence> batch_encoded(batch_size);
+    tokenizer.BatchEncode(&batch_encoded,
+                          *text,
+                          text_pair ? *text_pair : framework::Strings(),
+                          is_split_into_words,
+                          max_seq_len);
 
-    vector<unordered_map<string, vector<int64_t>>> batch_encode_inputs(
-        batch_size);
-    if (text_pair) {
-      tokenizer.BatchEncode(&batch_encode_inputs,
-                            *text,
-                            *text_pair,
-                            is_split_into_words,
-                            max_seq_len,
-                            pad_to_max_seq_len);
-    } else {
-      tokenizer.BatchEncode(&batch_encode_inputs,
-                            *text,
-                            framework::Strings(),
-                            is_split_into_words,
-                            max_seq_len,
-                            pad_to_max_seq_len);
-    }
-
-    for (size_t i = 0; i < batch_size; ++i) {
-      size_t seq_len = batch_encode_inputs[i]["input_ids"].size();
-      if (seq_len > batch_max_seq_len) {
-        batch_max_seq_len = seq_len;
-      }
+    size_t batch_max_seq_len =
+        pad_to_max_seq_len && max_seq_len > 0 ? max_seq_len : 0;
+    for (auto& encoded : batch_encoded) {
+      batch_max_seq_len = std::max(batch_max_seq_len, encoded.input_ids.size());
     }
 
     input_ids->Resize(
@@ -183,24 +237,19 @@ class FasterTokenizerKernel : public framework::OpKernel<T> {
                                     static_cast<int64_t>(batch_max_seq_len)}));
     auto* seg_ids_data = seg_ids->mutable_data<T>(ctx.GetPlace());
 
-    auto pad_token_id = tokenizer.GetPadTokenID();
+    auto pad_token_id = static_cast<T>(tokenizer.GetPadTokenID());
     for (size_t i = 0; i < batch_size; i++) {
-      auto& encoder_input_ids = batch_encode_inputs[i]["input_ids"];
-      auto& encoder_seg_ids = batch_encode_inputs[i]["token_type_ids"];
-      const size_t& seq_len = encoder_input_ids.size();
-      // Copy the memory
-      std::memcpy(input_ids_data + i * batch_max_seq_len,
-                  encoder_input_ids.data(),
-                  seq_len * sizeof(T));
-      std::memcpy(seg_ids_data + i * batch_max_seq_len,
-                  encoder_seg_ids.data(),
-                  seq_len * sizeof(T));
-      std::memset(input_ids_data + i * batch_max_seq_len + seq_len,
-                  pad_token_id,
-                  (batch_max_seq_len - seq_len) * sizeof(T));
-      std::memset(seg_ids_data + i * batch_max_seq_len + seq_len,
-                  pad_token_id,
-                  (batch_max_seq_len - seq_len) * sizeof(T));
+      const auto& ids = batch_encoded[i].input_ids;
+      size_t seq_len = ids.size();
+      size_t segment_len = std::min(batch_encoded[i].segment_len, seq_len);
+      T* ids_row = input_ids_data + i * batch_max_seq_len;
+      T* seg_row = seg_ids_data + i * batch_max_seq_len;
+      std::copy(ids.begin(), ids.end(), ids_row);
+      std::fill(ids_row + seq_len, ids_row + batch_max_seq_len, pad_token_id);
+      std::fill(seg_row, seg_row + segment_len, static_cast<T>(0));
+      std::fill(seg_row + segment_len, seg_row + seq_len, static_cast<T>(1));
+      std::fill(
+          seg_row + seq_len, seg_row + batch_max_seq_len, static_cast<T>(0));
     }
   }
 };
@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fstream>
 #include <set>
+#include <sstream>
 #include <string>
+#include <thread>
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
@@ -28,6 +31,7 @@
 #include "paddle/fluid/platform/profiler/event_python.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 #include "paddle/fluid/platform/profiler/profiler.h"
+#include "paddle/phi/api/profiler/sampling_profiler.h"
 
 TEST(ProfilerTest, TestHostTracer) {
   using paddle::platform::Profiler;
@@ -141,3 +145,73 @@ TEST(ProfilerTest, TestHostTracerForMem) {
   auto profiler_result = profiler->Stop();
   auto nodetree = profiler_result->GetNodeTrees();
 }
+
+TEST(ProfilerTest, TestSamplingProfiler) {
+  using paddle::platform::RecordEvent;
+  using paddle::platform::TracerEventType;
+  phi::SamplingProfilerOptions options;
+  options.sample_period = 4;
+  options.trace_level = 1;
+  auto& profiler = phi::SamplingProfiler::GetInstance();
+  profiler.Enable(options);
+  for (int i = 0; i < 100; ++i) {
+    RecordEvent event("TestSampling_record1", TracerEventType::Operator, 1);
+  }
+  for (int i = 0; i < 100; ++i) {
+    RecordEvent event(
+        std::string("TestSampling_record2"), TracerEventType::Operator, 2);
+  }
+  profiler.Disable();
+  {
+    RecordEvent event("TestSampling_record3", TracerEventType::Operator, 1);
+  }
+
+  std::set<std::string> names;
+  for (const auto& stats : profiler.GetLatencyStats()) {
+    names.insert(stats.name);
+    if (stats.name == "TestSampling_record1") {
+      EXPECT_EQ(stats.count, 25u);
+      EXPECT_GE(stats.Quantile(1.0), stats.Quantile(0.5));
+    }
+  }
+  EXPECT_EQ(names.count("TestSampling_record1"), 1u);
+  EXPECT_EQ(names.count("TestSampling_record2"), 0u);
+  EXPECT_EQ(names.count("TestSampling_record3"), 0u);
+
+  profiler.DumpChromeTrace("test_sampling_profiler.json");
+  std::ifstream ifs("test_sampling_profiler.json");
+  std::stringstream trace;
+  trace << ifs.rdbuf();
+  EXPECT_NE(trace.str().find("TestSampling_record1"), std::string::npos);
+  profiler.ResetLatencyStats();
+}
+
+TEST(ProfilerTest, TestSamplingProfilerThreadChurn) {
+  using paddle::platform::RecordEvent;
+  using paddle::platform::TracerEventType;
+  phi::SamplingProfilerOptions options;
+  options.sample_period = 1;
+  auto& profiler = phi::SamplingProfiler::GetInstance();
+  profiler.Enable(options);
+  auto record = [] {
+    for (int i = 0; i < 10; ++i) {
+      RecordEvent event("TestSampling_churn", TracerEventType::Operator, 1);
+    }
+  };
+  std::thread(record).join();
+  size_t num_recorders = profiler.NumThreadRecorders();
+  // Each new thread takes over the recorder of an exited one.
+  for (int i = 0; i < 20; ++i) {
+    std::thread(record).join();
+  }
+  profiler.Disable();
+  EXPECT_EQ(profiler.NumThreadRecorders(), num_recorders);
+
+  // The samples of the exited threads are kept.
+  uint64_t count = 0;
+  for (const auto& stats : profiler.GetLatencyStats()) {
+    if (stats.name == "TestSampling_churn") count = stats.count;
+  }
+  EXPECT_EQ(count, 210u);
+  profiler.ResetLatencyStats();
+}
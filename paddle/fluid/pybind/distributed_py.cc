@@ -1320,7 +1320,27 @@ void BindDistributed(py::module *m) {
                   py::arg("group_id") = 0,
                   py::call_guard<py::gil_scoped_release>())
       .def_static("create_default_device",
-                  &ProcessGroupGloo::createDefaultDevice);
+                  &ProcessGroupGloo::createDefaultDevice)
+      .def(
+          "all_reduce_coalesced",
+          [](ProcessGroupGloo &self,
+             py::handle py_tensors,
+             distributed::ReduceOp op,
+             bool sync_op) {
+            auto tensors = CastPyArg2VectorOfTensor(py_tensors.ptr(), 0);
+            std::vector<phi::DenseTensor> dense_tensors;
+            dense_tensors.reserve(tensors.size());
+            for (auto &tensor : tensors) {
+              dense_tensors.push_back(
+                  *std::dynamic_pointer_cast<phi::DenseTensor>(tensor.impl()));
+            }
+            distributed::AllreduceOptions opts{op};
+            return self.AllReduceCoalesced(dense_tensors, opts, sync_op);
+          },
+          py::arg("tensors"),
+          py::arg("op") = distributed::ReduceOp::SUM,
+          py::arg("sync_op") = true,
+          py::call_guard<py::gil_scoped_release>());
 #endif
 
   m->def(
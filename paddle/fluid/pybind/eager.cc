@@ -103,7 +103,8 @@ void EmptyTensorInitializer(TensorObject* self,
 
   if (!autograd_meta->GetMutableGradNode()) {
     autograd_meta->SetGradNode(
-        std::make_shared<egr::GradNodeAccumulation>(autograd_meta));
+        std::shared_ptr<egr::GradNodeAccumulation>(
+            new egr::GradNodeAccumulation(autograd_meta)));
     VLOG(3) << "Tensor(" << name
             << ") have not GradNode, add GradNodeAccumulation"
             << autograd_meta->GradNode() << " for it.";
@@ -503,7 +503,8 @@ static Tensor InitializedEmptyTensor() {
       allocation_ptr, phi::DenseTensorMeta(phi::DataType::FLOAT32, ddims));
   tensor.set_impl(dense_tensor);
   autograd_meta->SetGradNode(
-      std::make_shared<egr::GradNodeAccumulation>(autograd_meta));
+      std::shared_ptr<egr::GradNodeAccumulation>(
+          new egr::GradNodeAccumulation(autograd_meta)));
   return tensor;
 }
 
@@ -828,7 +829,8 @@ static PyObject* eager_api_sparse_coo_tensor(PyObject* self,
       VLOG(3) << "Tensor(" << name
               << ") doesn't have GradNode, add GradNodeAccumulation to it.";
       autograd_meta->SetGradNode(
-          std::make_shared<egr::GradNodeAccumulation>(autograd_meta));
+          std::shared_ptr<egr::GradNodeAccumulation>(
+              new egr::GradNodeAccumulation(autograd_meta)));
     }
   }
   return ToPyObject(tensor);
@@ -878,7 +880,8 @@ static PyObject* eager_api_sparse_csr_tensor(PyObject* self,
       VLOG(3) << "Tensor(" << name
               << ") have not GradNode, add GradNodeAccumulation for it.";
       autograd_meta->SetGradNode(
-          std::make_shared<egr::GradNodeAccumulation>(autograd_meta));
+          std::shared_ptr<egr::GradNodeAccumulation>(
+              new egr::GradNodeAccumulation(autograd_meta)));
     }
   }
   return ToPyObject(tensor);
@@ -553,7 +553,8 @@ static PyObject* tensor_retain_grads(TensorObject* self,
     if (!meta->GetMutableGradNode()) {
       VLOG(6) << "Make grad node of tensor: " << self->tensor.name()
               << "become accumulation node";
-      meta->SetGradNode(std::make_shared<egr::GradNodeAccumulation>(meta));
+      meta->SetGradNode(std::shared_ptr<egr::GradNodeAccumulation>(
+          new egr::GradNodeAccumulation(meta)));
     }
     egr::egr_utils_api::RetainGradForTensor(self->tensor);
   }
@@ -1362,7 +1363,8 @@ static PyObject* tensor_register_grad_hook(TensorObject* self,
         VLOG(6) << "Detected NULL grad_node, Leaf tensor should have had "
                    "grad_node with type: GradNodeAccumulation.";
         autograd_meta->SetGradNode(
-            std::make_shared<egr::GradNodeAccumulation>(autograd_meta));
+            std::shared_ptr<egr::GradNodeAccumulation>(
+                new egr::GradNodeAccumulation(autograd_meta)));
       }
     }
 
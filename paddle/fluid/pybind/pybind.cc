@@ -988,8 +988,10 @@ PYBIND11_MODULE(libpaddle, m) {
   // plugins are loaded for custom kernels, but de-initialized AFTER they are
   // unloaded. We need manually clear symbols(may contain plugins' symbols)
   // stored in this static instance to avoid illegal memory access.
-  m.def("clear_kernel_factory",
-        []() { phi::KernelFactory::Instance().kernels().clear(); });
+  m.def("clear_kernel_factory", []() {
+    phi::KernelFactory::Instance().kernels().clear();
+    phi::KernelFactory::Instance().InvalidateDispatchCaches();
+  });
   m.def("clear_device_manager", []() {
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
     platform::XCCLCommContext::Release();
@@ -2674,6 +2676,18 @@ All parameter, weight, gradient are variables in Paddle.
     return res;
   });
 
+  m.def("save_autotune_cache", [](const std::string &path) {
+    phi::autotune::AutoTuneCache::Instance().Save(path);
+  });
+
+  m.def("load_autotune_cache", [](const std::string &path) {
+    phi::autotune::AutoTuneCache::Instance().Load(path);
+  });
+
+  m.def("autotune_report", [] {
+    return phi::autotune::AutoTuneCache::Instance().TuningReport();
+  });
+
   m.def("enable_layout_autotune",
         [] { return egr::Controller::Instance().EnableLayoutAutoTune(); });
 
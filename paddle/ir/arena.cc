@@ -0,0 +1,71 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/ir/arena.h"
+
+#include <glog/logging.h>
+#include <cstdint>
+
+#include "paddle/ir/utils.h"
+
+namespace ir {
+Arena::~Arena() {
+  for (void *slab : slabs_) {
+    aligned_free(slab);
+  }
+  VLOG(4) << "Destroy an Arena: {slabs = " << slabs_.size()
+          << ", reserved = " << reserved_bytes_
+          << ", allocated = " << allocated_bytes_ << "}";
+}
+
+void *Arena::Allocate(size_t size, size_t alignment) {
+  uintptr_t cur = reinterpret_cast<uintptr_t>(cur_);
+  uintptr_t aligned = (cur + alignment - 1) & ~(alignment - 1);
+  if (cur_ != nullptr && aligned + size <= reinterpret_cast<uintptr_t>(end_)) {
+    cur_ = reinterpret_cast<char *>(aligned + size);
+    allocated_bytes_ += size;
+    return reinterpret_cast<void *>(aligned);
+  }
+  return AllocateSlow(size, alignment);
+}
+
+void *Arena::AllocateSlow(size_t size, size_t alignment) {
+  allocated_bytes_ += size;
+  // A request larger than a quarter of the next slab gets a slab of its own,
+  // so that the free space of the current slab is not wasted.
+  if (size > next_slab_size_ / 4) {
+    void *slab = aligned_malloc(size, alignof(std::max_align_t));
+    if (slab == nullptr) {
+      throw("Alloc memory for arena failed.");
+    }
+    slabs_.push_back(slab);
+    reserved_bytes_ += size;
+    return slab;
+  }
+  char *slab = reinterpret_cast<char *>(
+      aligned_malloc(next_slab_size_, alignof(std::max_align_t)));
+  if (slab == nullptr) {
+    throw("Alloc memory for arena failed.");
+  }
+  slabs_.push_back(slab);
+  reserved_bytes_ += next_slab_size_;
+  cur_ = slab + size;
+  end_ = slab + next_slab_size_;
+  if (next_slab_size_ < kMaxSlabSize) {
+    next_slab_size_ *= 2;
+  }
+  return slab;
+}
+
+}  // namespace ir
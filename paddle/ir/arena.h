@@ -0,0 +1,75 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ir {
+///
+/// \brief Arena is a bump pointer allocator. Memory is carved out of slabs
+/// obtained from aligned_malloc, and it is never released individually: all
+/// slabs are freed at once when the Arena is destroyed. Objects placed in an
+/// Arena still need to be destructed by their owner if their destructors are
+/// not trivial. Arena is not thread safe.
+///
+class Arena {
+ public:
+  static constexpr size_t kMinSlabSize = 4 * 1024;
+  static constexpr size_t kMaxSlabSize = 1024 * 1024;
+
+  Arena() = default;
+
+  ~Arena();
+
+  Arena(const Arena &) = delete;
+
+  Arena &operator=(const Arena &) = delete;
+
+  ///
+  /// \brief Allocate size bytes aligned to alignment, which must be a power of
+  /// two not greater than alignof(std::max_align_t).
+  ///
+  void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  ///
+  /// \brief Number of bytes handed out by Allocate.
+  ///
+  size_t allocated_bytes() const { return allocated_bytes_; }
+
+  ///
+  /// \brief Number of bytes held by the slabs of this Arena.
+  ///
+  size_t reserved_bytes() const { return reserved_bytes_; }
+
+ private:
+  void *AllocateSlow(size_t size, size_t alignment);
+
+  std::vector<void *> slabs_;
+
+  char *cur_{nullptr};
+
+  char *end_{nullptr};
+
+  // Slab sizes grow geometrically from kMinSlabSize to kMaxSlabSize, so that
+  // small programs stay small and large ones need few slabs.
+  size_t next_slab_size_{kMinSlabSize};
+
+  size_t allocated_bytes_{0};
+
+  size_t reserved_bytes_{0};
+};
+
+}  // namespace ir
@@ -17,6 +17,11 @@
 namespace ir {
 Block::~Block() { clear(); }
 
+Block::iterator Block::erase(const_iterator position) {
+  (*position)->destroy();
+  return ops_.erase(position);
+}
+
 void Block::clear() {
   while (!empty()) {
     ops_.back()->destroy();
@@ -21,6 +21,7 @@ namespace ir {
 class Block {
  public:
   using iterator = std::list<Operation *>::iterator;
+  using const_iterator = std::list<Operation *>::const_iterator;
   using reverse_iterator = std::list<Operation *>::reverse_iterator;
 
   Block() = default;
@@ -42,6 +43,8 @@ class Block {
       std::list<Operation *>::const_iterator iterator, Operation *op) {
     return ops_.insert(iterator, op);
   }
+  /// Destroy the op at position and remove it from this block.
+  iterator erase(const_iterator position);
   void clear();
 
  private:
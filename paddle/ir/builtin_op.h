@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "paddle/ir/builtin_trait.h"
 #include "paddle/ir/op_base.h"
 
 namespace ir {
@@ -36,7 +37,7 @@ class GetParameterOp : public ir::Op<GetParameterOp> {
 /// \brief SetParameterOp: SetParameterOp(OpOperand, {StrAttribute,
 /// StrAttribute})
 ///
-class SetParameterOp : public ir::Op<SetParameterOp> {
+class SetParameterOp : public ir::Op<SetParameterOp, SideEffectTrait> {
  public:
   using Op::Op;
   static const char *name() { return "builtin.set_parameter"; }
@@ -0,0 +1,31 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/ir/op_base.h"
+
+namespace ir {
+///
+/// \brief An op with this trait has effects besides producing its results,
+/// e.g. writing a parameter, consuming random state or updating an input
+/// inplace. Transforms such as dce, cse and constant folding must keep these
+/// ops untouched even if their results are never used.
+///
+class SideEffectTrait : public OpTraitBase<SideEffectTrait> {
+ public:
+  explicit SideEffectTrait(Operation *op) : OpTraitBase<SideEffectTrait>(op) {}
+};
+
+}  // namespace ir
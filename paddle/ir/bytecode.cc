@@ -0,0 +1,576 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/ir/bytecode.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "paddle/ir/builtin_attribute.h"
+#include "paddle/ir/builtin_dialect.h"
+#include "paddle/ir/builtin_type.h"
+#include "paddle/ir/dialect.h"
+#include "paddle/ir/ir_context.h"
+#include "paddle/ir/program.h"
+#include "paddle/ir/value_impl.h"
+
+namespace ir {
+namespace {
+enum class BuiltinTypeKind : uint64_t {
+  kBFloat16 = 0,
+  kFloat16,
+  kFloat32,
+  kFloat64,
+  kInt8,
+  kInt16,
+  kInt32,
+  kInt64,
+  kBool,
+  kVector,
+};
+
+enum class BuiltinAttributeKind : uint64_t {
+  kStr = 0,
+  kBool,
+  kFloat,
+  kDouble,
+  kInt32,
+  kInt64,
+  kArray,
+};
+
+bool IsBuiltin(const Dialect &dialect) {
+  return dialect.name() == BuiltinDialect::name();
+}
+}  // namespace
+
+void BytecodeWriter::WriteVarInt(uint64_t value) {
+  while (value >= 0x80) {
+    buffer_->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  buffer_->push_back(static_cast<char>(value));
+}
+
+void BytecodeWriter::WriteSignedVarInt(int64_t value) {
+  // Zigzag encoding keeps small negative numbers small.
+  WriteVarInt((static_cast<uint64_t>(value) << 1) ^
+              static_cast<uint64_t>(value >> 63));
+}
+
+void BytecodeWriter::WriteFloat(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  for (size_t i = 0; i < sizeof(bits); ++i) {
+    buffer_->push_back(static_cast<char>(bits >> (8 * i)));
+  }
+}
+
+void BytecodeWriter::WriteDouble(double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  for (size_t i = 0; i < sizeof(bits); ++i) {
+    buffer_->push_back(static_cast<char>(bits >> (8 * i)));
+  }
+}
+
+void BytecodeWriter::WriteString(const std::string &str) {
+  WriteVarInt(GetStringIndex(str));
+}
+
+void BytecodeWriter::WriteType(ir::Type type) {
+  WriteVarInt(GetTypeIndex(type));
+}
+
+void BytecodeWriter::WriteAttribute(ir::Attribute attr) {
+  WriteVarInt(GetAttributeIndex(attr));
+}
+
+uint64_t BytecodeWriter::GetStringIndex(const std::string &str) {
+  auto it = string_indices_.find(str);
+  if (it != string_indices_.end()) {
+    return it->second;
+  }
+  uint64_t index = strings_.size();
+  strings_.push_back(str);
+  string_indices_.emplace(str, index);
+  return index;
+}
+
+uint64_t BytecodeWriter::GetTypeIndex(ir::Type type) {
+  if (!type) {
+    throw("Can not serialize a null type.");
+  }
+  auto it = type_indices_.find(type);
+  if (it != type_indices_.end()) {
+    return it->second;
+  }
+  // The payload is encoded into its own entry. The types it refers to are
+  // encoded recursively and so get smaller indices.
+  std::string entry;
+  std::string *prev_buffer = buffer_;
+  buffer_ = &entry;
+  const Dialect &dialect = type.dialect();
+  WriteString(dialect.name());
+  if (IsBuiltin(dialect)) {
+    WriteBuiltinType(type);
+  } else {
+    dialect.WriteType(type, this);
+  }
+  buffer_ = prev_buffer;
+
+  uint64_t index = types_.size();
+  types_.push_back(std::move(entry));
+  type_indices_.emplace(type, index);
+  return index;
+}
+
+uint64_t BytecodeWriter::GetAttributeIndex(ir::Attribute attr) {
+  if (!attr) {
+    throw("Can not serialize a null attribute.");
+  }
+  auto it = attribute_indices_.find(attr);
+  if (it != attribute_indices_.end()) {
+    return it->second;
+  }
+  std::string entry;
+  std::string *prev_buffer = buffer_;
+  buffer_ = &entry;
+  const Dialect &dialect = attr.dialect();
+  WriteString(dialect.name());
+  if (IsBuiltin(dialect)) {
+    WriteBuiltinAttribute(attr);
+  } else {
+    dialect.WriteAttribute(attr, this);
+  }
+  buffer_ = prev_buffer;
+
+  uint64_t index = attributes_.size();
+  attributes_.push_back(std::move(entry));
+  attribute_indices_.emplace(attr, index);
+  return index;
+}
+
+void BytecodeWriter::WriteBuiltinType(ir::Type type) {
+  if (type.isa<ir::BFloat16Type>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinTypeKind::kBFloat16));
+  } else if (type.isa<ir::Float16Type>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinTypeKind::kFloat16));
+  } else if (type.isa<ir::Float32Type>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinTypeKind::kFloat32));
+  } else if (type.isa<ir::Float64Type>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinTypeKind::kFloat64));
+  } else if (type.isa<ir::Int8Type>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinTypeKind::kInt8));
+  } else if (type.isa<ir::Int16Type>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinTypeKind::kInt16));
+  } else if (type.isa<ir::Int32Type>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinTypeKind::kInt32));
+  } else if (type.isa<ir::Int64Type>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinTypeKind::kInt64));
+  } else if (type.isa<ir::BoolType>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinTypeKind::kBool));
+  } else if (type.isa<ir::VectorType>()) {
+    std::vector<ir::Type> inner_types = type.dyn_cast<ir::VectorType>().data();
+    WriteVarInt(static_cast<uint64_t>(BuiltinTypeKind::kVector));
+    WriteVarInt(inner_types.size());
+    for (auto inner_type : inner_types) {
+      WriteType(inner_type);
+    }
+  } else {
+    throw("Can not serialize an unknown builtin type.");
+  }
+}
+
+void BytecodeWriter::WriteBuiltinAttribute(ir::Attribute attr) {
+  if (attr.isa<ir::StrAttribute>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinAttributeKind::kStr));
+    WriteString(attr.dyn_cast<ir::StrAttribute>().data());
+  } else if (attr.isa<ir::BoolAttribute>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinAttributeKind::kBool));
+    WriteVarInt(attr.dyn_cast<ir::BoolAttribute>().data());
+  } else if (attr.isa<ir::FloatAttribute>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinAttributeKind::kFloat));
+    WriteFloat(attr.dyn_cast<ir::FloatAttribute>().data());
+  } else if (attr.isa<ir::DoubleAttribute>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinAttributeKind::kDouble));
+    WriteDouble(attr.dyn_cast<ir::DoubleAttribute>().data());
+  } else if (attr.isa<ir::Int32_tAttribute>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinAttributeKind::kInt32));
+    WriteSignedVarInt(attr.dyn_cast<ir::Int32_tAttribute>().data());
+  } else if (attr.isa<ir::Int64_tAttribute>()) {
+    WriteVarInt(static_cast<uint64_t>(BuiltinAttributeKind::kInt64));
+    WriteSignedVarInt(attr.dyn_cast<ir::Int64_tAttribute>().data());
+  } else if (attr.isa<ir::ArrayAttribute>()) {
+    std::vector<ir::Attribute> elements =
+        attr.dyn_cast<ir::ArrayAttribute>().data();
+    WriteVarInt(static_cast<uint64_t>(BuiltinAttributeKind::kArray));
+    WriteVarInt(elements.size());
+    for (auto element : elements) {
+      WriteAttribute(element);
+    }
+  } else {
+    throw("Can not serialize an unknown builtin attribute.");
+  }
+}
+
+void BytecodeWriter::WriteOperation(ir::Operation *op) {
+  WriteString(op->op_name());
+  WriteVarInt(op->num_operands());
+  for (uint32_t i = 0; i < op->num_operands(); ++i) {
+    ir::Value source = op->GetOperandByIndex(i).impl()->source();
+    auto it = value_indices_.find(source);
+    if (it == value_indices_.end()) {
+      throw("The operand of an op is not defined before it.");
+    }
+    WriteVarInt(it->second);
+  }
+  WriteVarInt(op->num_results());
+  for (uint32_t i = 0; i < op->num_results(); ++i) {
+    ir::OpResult result = op->GetResultByIndex(i);
+    WriteType(result.type());
+    uint64_t index = value_indices_.size();
+    value_indices_.emplace(result, index);
+  }
+  // The attributes and the parameters are written sorted by name, so that
+  // the same program is always encoded into the same bytes.
+  std::vector<std::pair<std::string, ir::Attribute>> attributes(
+      op->attribute().begin(), op->attribute().end());
+  std::sort(attributes.begin(),
+            attributes.end(),
+            [](const std::pair<std::string, ir::Attribute> &lhs,
+               const std::pair<std::string, ir::Attribute> &rhs) {
+              return lhs.first < rhs.first;
+            });
+  WriteVarInt(attributes.size());
+  for (auto &attr : attributes) {
+    WriteString(attr.first);
+    WriteAttribute(attr.second);
+  }
+}
+
+void BytecodeWriter::Write(std::ostream &os) {
+  // The ops are encoded first, which fills the string, type and attribute
+  // tables that have to precede them in the output.
+  std::string ops;
+  buffer_ = &ops;
+  for (auto op : *program_->block()) {
+    WriteOperation(op);
+  }
+  std::string parameters;
+  buffer_ = &parameters;
+  std::vector<std::string> parameter_names;
+  parameter_names.reserve(program_->parameters_num());
+  for (auto &parameter : program_->parameters()) {
+    parameter_names.push_back(parameter.first);
+  }
+  std::sort(parameter_names.begin(), parameter_names.end());
+  WriteVarInt(parameter_names.size());
+  for (auto &name : parameter_names) {
+    WriteString(name);
+  }
+
+  std::string header;
+  buffer_ = &header;
+  header.append(kBytecodeMagic, sizeof(kBytecodeMagic) - 1);
+  WriteVarInt(kBytecodeVersion);
+  WriteVarInt(strings_.size());
+  for (auto &str : strings_) {
+    WriteVarInt(str.size());
+    header.append(str);
+  }
+  WriteVarInt(types_.size());
+  for (auto &type : types_) {
+    header.append(type);
+  }
+  WriteVarInt(attributes_.size());
+  for (auto &attr : attributes_) {
+    header.append(attr);
+  }
+  header.append(parameters);
+  WriteVarInt(program_->block()->size());
+  WriteVarInt(value_indices_.size());
+  buffer_ = nullptr;
+
+  os.write(header.data(), header.size());
+  os.write(ops.data(), ops.size());
+  if (!os) {
+    throw("Write the bytecode of program failed.");
+  }
+}
+
+void BytecodeReader::ReadBytes(char *data, size_t size) {
+  if (size > remaining_bytes_ ||
+      is_.rdbuf()->sgetn(data, size) != static_cast<std::streamsize>(size)) {
+    throw("Unexpected end of the bytecode.");
+  }
+  remaining_bytes_ -= size;
+}
+
+uint64_t BytecodeReader::ReadCount(size_t min_element_bytes) {
+  uint64_t count = ReadVarInt();
+  if (count > remaining_bytes_ / min_element_bytes) {
+    throw("The count in the bytecode exceeds the size of the stream.");
+  }
+  return count;
+}
+
+uint64_t BytecodeReader::ReadVarInt() {
+  std::streambuf *buf = is_.rdbuf();
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    int byte = remaining_bytes_ > 0 ? buf->sbumpc()
+                                     : std::char_traits<char>::eof();
+    if (byte == std::char_traits<char>::eof()) {
+      throw("Unexpected end of the bytecode.");
+    }
+    --remaining_bytes_;
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+  throw("Invalid varint in the bytecode.");
+}
+
+int64_t BytecodeReader::ReadSignedVarInt() {
+  uint64_t value = ReadVarInt();
+  return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+float BytecodeReader::ReadFloat() {
+  unsigned char bytes[sizeof(uint32_t)];
+  ReadBytes(reinterpret_cast<char *>(bytes), sizeof(bytes));
+  uint32_t bits = 0;
+  for (size_t i = 0; i < sizeof(bits); ++i) {
+    bits |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+  }
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+double BytecodeReader::ReadDouble() {
+  unsigned char bytes[sizeof(uint64_t)];
+  ReadBytes(reinterpret_cast<char *>(bytes), sizeof(bytes));
+  uint64_t bits = 0;
+  for (size_t i = 0; i < sizeof(bits); ++i) {
+    bits |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+  }
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+const std::string &BytecodeReader::ReadString() {
+  uint64_t index = ReadVarInt();
+  if (index >= strings_.size()) {
+    throw("Invalid string index in the bytecode.");
+  }
+  return strings_[index];
+}
+
+ir::Type BytecodeReader::ReadType() {
+  uint64_t index = ReadVarInt();
+  if (index >= types_.size()) {
+    throw("Invalid type index in the bytecode.");
+  }
+  return types_[index];
+}
+
+ir::Attribute BytecodeReader::ReadAttribute() {
+  uint64_t index = ReadVarInt();
+  if (index >= attributes_.size()) {
+    throw("Invalid attribute index in the bytecode.");
+  }
+  return attributes_[index];
+}
+
+ir::Type BytecodeReader::ReadBuiltinType() {
+  switch (static_cast<BuiltinTypeKind>(ReadVarInt())) {
+    case BuiltinTypeKind::kBFloat16:
+      return ir::BFloat16Type::get(ctx_);
+    case BuiltinTypeKind::kFloat16:
+      return ir::Float16Type::get(ctx_);
+    case BuiltinTypeKind::kFloat32:
+      return ir::Float32Type::get(ctx_);
+    case BuiltinTypeKind::kFloat64:
+      return ir::Float64Type::get(ctx_);
+    case BuiltinTypeKind::kInt8:
+      return ir::Int8Type::get(ctx_);
+    case BuiltinTypeKind::kInt16:
+      return ir::Int16Type::get(ctx_);
+    case BuiltinTypeKind::kInt32:
+      return ir::Int32Type::get(ctx_);
+    case BuiltinTypeKind::kInt64:
+      return ir::Int64Type::get(ctx_);
+    case BuiltinTypeKind::kBool:
+      return ir::BoolType::get(ctx_);
+    case BuiltinTypeKind::kVector: {
+      std::vector<ir::Type> inner_types(ReadCount(1));
+      for (auto &inner_type : inner_types) {
+        inner_type = ReadType();
+      }
+      return ir::VectorType::get(ctx_, inner_types);
+    }
+  }
+  throw("Invalid builtin type kind in the bytecode.");
+}
+
+ir::Attribute BytecodeReader::ReadBuiltinAttribute() {
+  switch (static_cast<BuiltinAttributeKind>(ReadVarInt())) {
+    case BuiltinAttributeKind::kStr:
+      return ir::StrAttribute::get(ctx_, ReadString());
+    case BuiltinAttributeKind::kBool:
+      return ir::BoolAttribute::get(ctx_, ReadVarInt() != 0);
+    case BuiltinAttributeKind::kFloat:
+      return ir::FloatAttribute::get(ctx_, ReadFloat());
+    case BuiltinAttributeKind::kDouble:
+      return ir::DoubleAttribute::get(ctx_, ReadDouble());
+    case BuiltinAttributeKind::kInt32:
+      return ir::Int32_tAttribute::get(
+          ctx_, static_cast<int32_t>(ReadSignedVarInt()));
+    case BuiltinAttributeKind::kInt64:
+      return ir::Int64_tAttribute::get(ctx_, ReadSignedVarInt());
+    case BuiltinAttributeKind::kArray: {
+      std::vector<ir::Attribute> elements(ReadCount(1));
+      for (auto &element : elements) {
+        element = ReadAttribute();
+      }
+      return ir::ArrayAttribute::get(ctx_, elements);
+    }
+  }
+  throw("Invalid builtin attribute kind in the bytecode.");
+}
+
+void BytecodeReader::ReadOperation(Program *program) {
+  uint64_t name_index = ReadVarInt();
+  if (name_index >= strings_.size()) {
+    throw("Invalid string index in the bytecode.");
+  }
+  ir::OpInfo &op_info = op_infos_[name_index];
+  if (!op_info) {
+    op_info = ctx_->GetRegisteredOpInfo(strings_[name_index]);
+    if (!op_info) {
+      throw("The op in the bytecode is not registered.");
+    }
+  }
+
+  std::vector<ir::OpResult> inputs(ReadCount(1));
+  for (auto &input : inputs) {
+    uint64_t index = ReadVarInt();
+    if (index >= values_.size()) {
+      throw("Invalid value index in the bytecode.");
+    }
+    input = values_[index];
+  }
+  std::vector<ir::Type> output_types(ReadCount(1));
+  for (auto &output_type : output_types) {
+    output_type = ReadType();
+  }
+  ir::AttributeMap attributes;
+  // a name and an attribute
+  uint64_t num_attributes = ReadCount(2);
+  for (uint64_t i = 0; i < num_attributes; ++i) {
+    const std::string &name = ReadString();
+    attributes.emplace(name, ReadAttribute());
+  }
+
+  ir::Operation *op = ir::Operation::create(
+      inputs, output_types, attributes, op_info, program->arena());
+  program->InsertOp(op);
+  for (uint32_t i = 0; i < op->num_results(); ++i) {
+    values_.push_back(op->GetResultByIndex(i));
+  }
+}
+
+std::unique_ptr<Program> BytecodeReader::Read() {
+  // The counts read from the stream are checked against the bytes left in
+  // it before anything is allocated for them, when the stream is seekable.
+  std::streambuf *buf = is_.rdbuf();
+  std::streampos begin = buf->pubseekoff(0, std::ios::cur, std::ios::in);
+  std::streampos end = buf->pubseekoff(0, std::ios::end, std::ios::in);
+  if (begin != std::streampos(-1) && end != std::streampos(-1)) {
+    buf->pubseekpos(begin, std::ios::in);
+    remaining_bytes_ = static_cast<size_t>(end - begin);
+  } else {
+    remaining_bytes_ = std::numeric_limits<size_t>::max();
+  }
+
+  char magic[sizeof(kBytecodeMagic) - 1];
+  ReadBytes(magic, sizeof(magic));
+  if (std::memcmp(magic, kBytecodeMagic, sizeof(magic)) != 0) {
+    throw("The stream is not a bytecode of program.");
+  }
+  if (ReadVarInt() != kBytecodeVersion) {
+    throw("The version of the bytecode is not supported.");
+  }
+
+  strings_.resize(ReadCount(1));
+  for (auto &str : strings_) {
+    str.resize(ReadCount(1));
+    ReadBytes(&str[0], str.size());
+  }
+  op_infos_.resize(strings_.size());
+  // a dialect name and a payload
+  uint64_t num_types = ReadCount(2);
+  types_.reserve(num_types);
+  for (uint64_t i = 0; i < num_types; ++i) {
+    const std::string &dialect_name = ReadString();
+    Dialect *dialect = ctx_->GetRegisteredDialect(dialect_name);
+    if (dialect == nullptr) {
+      throw("The dialect of a type in the bytecode is not registered.");
+    }
+    types_.push_back(IsBuiltin(*dialect) ? ReadBuiltinType()
+                                         : dialect->ReadType(this));
+  }
+  uint64_t num_attributes = ReadCount(2);
+  attributes_.reserve(num_attributes);
+  for (uint64_t i = 0; i < num_attributes; ++i) {
+    const std::string &dialect_name = ReadString();
+    Dialect *dialect = ctx_->GetRegisteredDialect(dialect_name);
+    if (dialect == nullptr) {
+      throw("The dialect of an attribute in the bytecode is not registered.");
+    }
+    attributes_.push_back(IsBuiltin(*dialect) ? ReadBuiltinAttribute()
+                                              : dialect->ReadAttribute(this));
+  }
+
+  std::unique_ptr<Program> program = std::make_unique<Program>();
+  uint64_t num_parameters = ReadCount(1);
+  for (uint64_t i = 0; i < num_parameters; ++i) {
+    program->SetParameter(ReadString(), nullptr);
+  }
+  // a name and the numbers of operands, results and attributes
+  uint64_t num_ops = ReadCount(4);
+  // a type for every value
+  values_.reserve(ReadCount(1));
+  for (uint64_t i = 0; i < num_ops; ++i) {
+    ReadOperation(program.get());
+  }
+  return program;
+}
+
+void SerializeProgram(Program *program, std::ostream &os) {
+  BytecodeWriter writer(program);
+  writer.Write(os);
+}
+
+std::unique_ptr<Program> DeserializeProgram(std::istream &is, IrContext *ctx) {
+  BytecodeReader reader(is, ctx);
+  return reader.Read();
+}
+
+}  // namespace ir
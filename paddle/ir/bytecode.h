@@ -0,0 +1,193 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/ir/attribute.h"
+#include "paddle/ir/op_info.h"
+#include "paddle/ir/type.h"
+#include "paddle/ir/value.h"
+
+namespace ir {
+class IrContext;
+class Program;
+
+///
+/// \brief The bytecode is a compact binary format of Program. It is laid out
+/// as follows, all integers are LEB128 varints:
+///
+///   magic "PDIR", version
+///   string table:    num_strings, {size, bytes}...
+///   type table:      num_types, {dialect_name, payload}...
+///   attribute table: num_attributes, {dialect_name, payload}...
+///   parameters:      num_parameters, {name}...
+///   ops:             num_ops, num_values,
+///                    {name, num_operands, {value}..., num_results,
+///                     {type}..., num_attributes, {name, attribute}...}...
+///
+/// Names and dialect names refer to the string table, type and attribute
+/// tables only refer to entries before them. The attributes of an op and the
+/// parameters are sorted by name, so the encoding of a program is stable.
+/// Values are numbered from 0 in the order they are defined by ops.
+/// Parameters are stored by name only, their data is saved and loaded
+/// separately.
+///
+/// Builtin types and attributes are encoded by the writer itself, the others
+/// are encoded by the WriteType/ReadType and WriteAttribute/ReadAttribute
+/// hooks of their dialects.
+///
+constexpr char kBytecodeMagic[] = "PDIR";
+constexpr uint64_t kBytecodeVersion = 1;
+
+class BytecodeWriter {
+ public:
+  explicit BytecodeWriter(Program *program) : program_(program) {}
+
+  ///
+  /// \brief Encode the program and write it to os.
+  ///
+  void Write(std::ostream &os);
+
+  ///
+  /// \brief The following methods are used by the dialect hooks to encode the
+  /// payload of a type or an attribute.
+  ///
+  void WriteVarInt(uint64_t value);
+
+  void WriteSignedVarInt(int64_t value);
+
+  void WriteFloat(float value);
+
+  void WriteDouble(double value);
+
+  void WriteString(const std::string &str);
+
+  void WriteType(ir::Type type);
+
+  void WriteAttribute(ir::Attribute attr);
+
+ private:
+  uint64_t GetStringIndex(const std::string &str);
+
+  uint64_t GetTypeIndex(ir::Type type);
+
+  uint64_t GetAttributeIndex(ir::Attribute attr);
+
+  void WriteBuiltinType(ir::Type type);
+
+  void WriteBuiltinAttribute(ir::Attribute attr);
+
+  void WriteOperation(ir::Operation *op);
+
+  Program *program_;  // not owned
+
+  // The buffer that the Write* methods append to.
+  std::string *buffer_{nullptr};
+
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, uint64_t> string_indices_;
+
+  std::vector<std::string> types_;
+  std::unordered_map<ir::Type, uint64_t> type_indices_;
+
+  std::vector<std::string> attributes_;
+  std::unordered_map<ir::Attribute, uint64_t> attribute_indices_;
+
+  std::unordered_map<ir::Value, uint64_t> value_indices_;
+};
+
+class BytecodeReader {
+ public:
+  BytecodeReader(std::istream &is, IrContext *ctx) : is_(is), ctx_(ctx) {}
+
+  ///
+  /// \brief Read a program from the stream. The ops are created directly in
+  /// the arena of the new program while the stream is consumed.
+  ///
+  std::unique_ptr<Program> Read();
+
+  IrContext *ir_context() const { return ctx_; }
+
+  ///
+  /// \brief The following methods are used by the dialect hooks to decode the
+  /// payload of a type or an attribute.
+  ///
+  uint64_t ReadVarInt();
+
+  ///
+  /// \brief Read the number of the elements that follow, which take at least
+  /// min_element_bytes each. It throws if they can't fit in the rest of the
+  /// stream, so the count can be used to allocate them.
+  ///
+  uint64_t ReadCount(size_t min_element_bytes = 1);
+
+  int64_t ReadSignedVarInt();
+
+  float ReadFloat();
+
+  double ReadDouble();
+
+  const std::string &ReadString();
+
+  ir::Type ReadType();
+
+  ir::Attribute ReadAttribute();
+
+ private:
+  void ReadBytes(char *data, size_t size);
+
+  ir::Type ReadBuiltinType();
+
+  ir::Attribute ReadBuiltinAttribute();
+
+  void ReadOperation(Program *program);
+
+  std::istream &is_;
+
+  // The bytes left in the stream, or the max of size_t if it is unknown.
+  size_t remaining_bytes_{0};
+
+  IrContext *ctx_;  // not owned
+
+  std::vector<std::string> strings_;
+
+  std::vector<ir::Type> types_;
+
+  std::vector<ir::Attribute> attributes_;
+
+  // The OpInfo of the op names indexed as strings_, looked up on first use.
+  std::vector<ir::OpInfo> op_infos_;
+
+  std::vector<ir::OpResult> values_;
+};
+
+///
+/// \brief Serialize a program to the bytecode format described above.
+///
+void SerializeProgram(Program *program, std::ostream &os);
+
+///
+/// \brief Load a program from the bytecode. The dialects it uses need to be
+/// registered in ctx.
+///
+std::unique_ptr<Program> DeserializeProgram(std::istream &is, IrContext *ctx);
+
+}  // namespace ir
@@ -23,6 +23,8 @@
 #include "paddle/ir/type_base.h"
 
 namespace ir {
+class BytecodeReader;
+class BytecodeWriter;
 class DialectInterface;
 ///
 /// \brief Dialect can basically be understood as a namespace. In Dialect, we
@@ -134,6 +136,27 @@ class Dialect {
     throw std::logic_error("dialect has no registered type printing hook");
   }
 
+  ///
+  /// \brief Hooks to encode and decode the payload of the types and attributes
+  /// of this dialect in the bytecode, see paddle/ir/bytecode.h.
+  ///
+  virtual void WriteType(ir::Type type, BytecodeWriter *writer) const {
+    throw std::logic_error("dialect has no registered type writing hook");
+  }
+
+  virtual ir::Type ReadType(BytecodeReader *reader) const {
+    throw std::logic_error("dialect has no registered type reading hook");
+  }
+
+  virtual void WriteAttribute(ir::Attribute attr,
+                              BytecodeWriter *writer) const {
+    throw std::logic_error("dialect has no registered attribute writing hook");
+  }
+
+  virtual ir::Attribute ReadAttribute(BytecodeReader *reader) const {
+    throw std::logic_error("dialect has no registered attribute reading hook");
+  }
+
  private:
   Dialect(const Dialect &) = delete;
 
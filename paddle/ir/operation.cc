@@ -13,16 +13,19 @@
 // limitations under the License.
 
 #include "paddle/ir/operation.h"
+#include "paddle/ir/arena.h"
 #include "paddle/ir/dialect.h"
 #include "paddle/ir/program.h"
 #include "paddle/ir/utils.h"
 
 namespace ir {
-Operation *Operation::create(const OperationArgument &argument) {
+Operation *Operation::create(const OperationArgument &argument,
+                             Arena *arena) {
   return create(argument.inputs_,
                 argument.output_types_,
                 argument.attribute_,
-                argument.info_);
+                argument.info_,
+                arena);
 }
 
 // Allocate the required memory based on the size and number of inputs, outputs,
@@ -31,7 +34,8 @@ Operation *Operation::create(const OperationArgument &argument) {
 Operation *Operation::create(const std::vector<ir::OpResult> &inputs,
                              const std::vector<ir::Type> &output_types,
                              const AttributeMap &attribute,
-                             ir::OpInfo op_info) {
+                             ir::OpInfo op_info,
+                             Arena *arena) {
   // 0. Verify
   if (op_info) {
     op_info.verify(inputs, output_types, attribute);
@@ -52,7 +56,9 @@ Operation *Operation::create(const std::vector<ir::OpResult> &inputs,
   size_t op_mem_size = sizeof(Operation);
   size_t base_size = result_mem_size + op_mem_size + operand_mem_size;
   // 2. Malloc memory.
-  char *base_ptr = reinterpret_cast<char *>(aligned_malloc(base_size, 8));
+  char *base_ptr =
+      arena ? reinterpret_cast<char *>(arena->Allocate(base_size, 8))
+            : reinterpret_cast<char *>(aligned_malloc(base_size, 8));
   // 3.1. Construct OpResults.
   for (size_t idx = num_results; idx > 0; idx--) {
     if (idx > max_inline_result_num) {
@@ -67,6 +73,7 @@ Operation *Operation::create(const std::vector<ir::OpResult> &inputs,
   // 3.2. Construct Operation.
   Operation *op =
       new (base_ptr) Operation(num_results, num_operands, attribute, op_info);
+  op->arena_allocated_ = arena != nullptr;
   base_ptr += sizeof(Operation);
   // 3.3. Construct OpOperands.
   if ((reinterpret_cast<uintptr_t>(base_ptr) & 0x7) != 0) {
@@ -120,6 +127,7 @@ void Operation::destroy() {
       reinterpret_cast<uintptr_t>(this)) {
     throw("Operation address error");
   }
+  bool arena_allocated = arena_allocated_;
   reinterpret_cast<Operation *>(base_ptr)->~Operation();
   base_ptr += sizeof(Operation);
   // 2.3. Deconstruct OpOperand.
@@ -131,7 +139,9 @@ void Operation::destroy() {
   VLOG(4) << "Destroy an Operation: {ptr = "
           << reinterpret_cast<void *>(aligned_ptr)
           << ", size = " << result_mem_size << "}";
-  aligned_free(reinterpret_cast<void *>(aligned_ptr));
+  if (!arena_allocated) {
+    aligned_free(reinterpret_cast<void *>(aligned_ptr));
+  }
 }
 
 IrContext *Operation::ir_context() const { return op_info_.ir_context(); }
@@ -21,6 +21,7 @@
 #include "paddle/ir/value_impl.h"
 
 namespace ir {
+class Arena;
 class OpBase;
 class Program;
 
@@ -30,16 +31,21 @@ class alignas(8) Operation final {
   /// \brief Malloc memory and construct objects in the following order:
   /// OpResultImpls|Operation|OpOperandImpls.
   /// NOTE: Similar to new and delete, the destroy() and the create() need to be
-  /// used in conjunction.
+  /// used in conjunction. If arena is not nullptr, the memory is allocated from
+  /// it and is released together with the arena, e.g. pass Program::arena() for
+  /// the ops inserted into that Program.
   ///
   static Operation *create(const std::vector<ir::OpResult> &inputs,
                            const std::vector<ir::Type> &output_types,
                            const AttributeMap &attribute,
-                           ir::OpInfo op_info);
-  static Operation *create(const OperationArgument &op_argument);
+                           ir::OpInfo op_info,
+                           Arena *arena = nullptr);
+  static Operation *create(const OperationArgument &op_argument,
+                           Arena *arena = nullptr);
 
   ///
-  /// \brief Destroy the operation objects and free memory by create().
+  /// \brief Destroy the operation objects and free memory by create(). The
+  /// memory allocated from an arena is left to the arena.
   ///
   void destroy();
 
@@ -111,6 +117,8 @@ class alignas(8) Operation final {
   uint32_t num_operands_ = 0;
 
   ir::Program *parent_program_{nullptr};
+
+  bool arena_allocated_{false};
 };
 
 }  // namespace ir
@@ -17,6 +17,7 @@
 #include <list>
 #include <unordered_map>
 
+#include "paddle/ir/arena.h"
 #include "paddle/ir/block.h"
 #include "paddle/ir/builtin_attribute.h"
 #include "paddle/ir/operation.h"
@@ -33,12 +34,23 @@ namespace ir {
 ///
 class Program {
  public:
+  using ParameterMap =
+      std::unordered_map<std::string, std::unique_ptr<Parameter>>;
+
   ~Program();
 
   Block* block() { return &block_; }
 
+  ///
+  /// \brief The arena for the ops of this Program, see Operation::create. It
+  /// is released at once after all ops are destroyed.
+  ///
+  Arena* arena() { return &arena_; }
+
   size_t parameters_num() const { return parameters_.size(); }
 
+  const ParameterMap& parameters() const { return parameters_; }
+
   ///
   /// \brief Insert the Operation* constructed by Operation::create(...) into
   /// this Program. NOTE: At this time, the memory management permission of
@@ -52,8 +64,11 @@ class Program {
   void SetParameter(std::string name, std::unique_ptr<Parameter>&& parameter);
 
  private:
+  // NOTE: arena_ must be declared before block_, so that the ops are destroyed
+  // before the memory they live in is released.
+  Arena arena_;
   Block block_;
-  std::unordered_map<std::string, std::unique_ptr<Parameter>> parameters_;
+  ParameterMap parameters_;
 };
 
 std::ostream& operator<<(std::ostream& os, Program& program);
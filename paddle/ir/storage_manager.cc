@@ -17,39 +17,73 @@
 #include <memory>
 #include <unordered_map>
 
+#include "paddle/ir/arena.h"
+
 namespace ir {
 // This is a structure for creating, caching, and looking up Storage of
 // parametric types.
+//
+// The storages are kept in kNumShards hash tables, each one guarded by its own
+// lock for insertion. A table is never modified in place except by pushing a
+// fully initialized node to the head of a bucket, and the nodes are never
+// freed before the manager. So the lookup can search a table without locking
+// and only needs the lock when the storage is missing. When a table grows, a
+// new table is built and published while the old one stays readable.
 struct ParametricStorageManager {
   using StorageBase = StorageManager::StorageBase;
 
+  static constexpr size_t kNumShards = 32;
+
+  static constexpr size_t kMinBuckets = 16;
+
   ParametricStorageManager() {}
 
   ~ParametricStorageManager() {
-    for (const auto &instance : parametric_instances_) {
-      delete instance.second;
+    for (auto &shard : shards_) {
+      Table *table = shard.table.load(std::memory_order_relaxed);
+      if (table == nullptr) continue;
+      for (size_t i = 0; i <= table->mask; ++i) {
+        for (Node *node = table->buckets[i].load(std::memory_order_relaxed);
+             node != nullptr;
+             node = node->next) {
+          delete node->storage;
+        }
+      }
     }
-    parametric_instances_.clear();
   }
 
   // Get the storage of parametric type, if not in the cache, create and
   // insert the cache.
-  StorageBase *GetOrCreate(std::size_t hash_value,
-                           std::function<bool(const StorageBase *)> equal_func,
-                           std::function<StorageBase *()> constructor) {
-    if (parametric_instances_.count(hash_value) != 0) {
-      auto pr = parametric_instances_.equal_range(hash_value);
-      while (pr.first != pr.second) {
-        if (equal_func(pr.first->second)) {
-          VLOG(4) << "Found a cached parametric storage of: [param_hash="
-                  << hash_value << ", storage_ptr=" << pr.first->second << "].";
-          return pr.first->second;
-        }
-        ++pr.first;
-      }
+  StorageBase *GetOrCreate(
+      std::size_t hash_value,
+      const std::function<bool(const StorageBase *)> &equal_func,
+      const std::function<StorageBase *()> &constructor) {
+    Shard &shard = shards_[ShardIndex(hash_value)];
+    StorageBase *storage = Find(
+        shard.table.load(std::memory_order_acquire), hash_value, equal_func);
+    if (storage != nullptr) {
+      VLOG(4) << "Found a cached parametric storage of: [param_hash="
+              << hash_value << ", storage_ptr=" << storage << "].";
+      return storage;
+    }
+
+    std::lock_guard<ir::SpinLock> guard(shard.lock);
+    // Another thread may have created it before the lock is taken.
+    Table *table = shard.table.load(std::memory_order_relaxed);
+    storage = Find(table, hash_value, equal_func);
+    if (storage != nullptr) {
+      return storage;
+    }
+    if (table == nullptr || shard.size >= table->mask + 1) {
+      table = Grow(&shard, table);
     }
-    StorageBase *storage = constructor();
-    parametric_instances_.emplace(hash_value, storage);
+    storage = constructor();
+    Node *node = new (shard.arena.Allocate(sizeof(Node), alignof(Node)))
+        Node{hash_value, storage, nullptr};
+    std::atomic<Node *> &bucket = table->buckets[hash_value & table->mask];
+    node->next = bucket.load(std::memory_order_relaxed);
+    bucket.store(node, std::memory_order_release);
+    ++shard.size;
     VLOG(4) << "No cache found, construct and cache a new parametric storage "
                "of: [param_hash="
             << hash_value << ", storage_ptr=" << storage << "].";
@@ -57,9 +91,88 @@ struct ParametricStorageManager {
   }
 
  private:
-  // In order to prevent hash conflicts, the unordered_multimap data structure
-  // is used for storage.
-  std::unordered_multimap<size_t, StorageBase *> parametric_instances_;
+  struct Node {
+    std::size_t hash_value;
+    StorageBase *storage;
+    // Immutable once the node is published.
+    Node *next;
+  };
+
+  struct Table {
+    std::size_t mask;
+    std::atomic<Node *> *buckets;
+  };
+
+  // NOTE: The shards are not aligned to cache lines, the manager is allocated
+  // by the default operator new. But a shard is at least a cache line large,
+  // so the tables read by lookups in different shards are never in the same
+  // cache line. The table of a shard may share one with the lock and size of
+  // the previous shard, which are only written when a storage is created.
+  struct Shard {
+    std::atomic<Table *> table{nullptr};
+    // The members below are guarded by lock.
+    ir::SpinLock lock;
+    size_t size{0};
+    // Holds the tables and nodes of this shard.
+    ir::Arena arena;
+  };
+  static_assert(sizeof(Shard) >= 64, "A shard should fill a cache line.");
+
+  static size_t ShardIndex(std::size_t hash_value) {
+    // The low bits select the bucket, so mix the hash value and take the high
+    // bits for the shard.
+    uint64_t mixed = static_cast<uint64_t>(hash_value) * 0x9e3779b97f4a7c15ULL;
+    return static_cast<size_t>(mixed >> 59) % kNumShards;
+  }
+
+  static StorageBase *Find(
+      Table *table,
+      std::size_t hash_value,
+      const std::function<bool(const StorageBase *)> &equal_func) {
+    if (table == nullptr) return nullptr;
+    for (Node *node = table->buckets[hash_value & table->mask].load(
+             std::memory_order_acquire);
+         node != nullptr;
+         node = node->next) {
+      if (node->hash_value == hash_value && equal_func(node->storage)) {
+        return node->storage;
+      }
+    }
+    return nullptr;
+  }
+
+  // Build a table with twice the buckets of old_table, copy the nodes into it
+  // and publish it. Must be called with the lock of shard held.
+  static Table *Grow(Shard *shard, Table *old_table) {
+    size_t num_buckets = old_table ? 2 * (old_table->mask + 1) : kMinBuckets;
+    auto *buckets = static_cast<std::atomic<Node *> *>(shard->arena.Allocate(
+        num_buckets * sizeof(std::atomic<Node *>), alignof(std::atomic<Node *>)));
+    for (size_t i = 0; i < num_buckets; ++i) {
+      new (&buckets[i]) std::atomic<Node *>(nullptr);
+    }
+    Table *table = new (shard->arena.Allocate(sizeof(Table), alignof(Table)))
+        Table{num_buckets - 1, buckets};
+    if (old_table != nullptr) {
+      for (size_t i = 0; i <= old_table->mask; ++i) {
+        for (Node *node = old_table->buckets[i].load(std::memory_order_relaxed);
+             node != nullptr;
+             node = node->next) {
+          std::atomic<Node *> &bucket =
+              buckets[node->hash_value & table->mask];
+          Node *copy =
+              new (shard->arena.Allocate(sizeof(Node), alignof(Node)))
+                  Node{node->hash_value,
+                       node->storage,
+                       bucket.load(std::memory_order_relaxed)};
+          bucket.store(copy, std::memory_order_relaxed);
+        }
+      }
+    }
+    shard->table.store(table, std::memory_order_release);
+    return table;
+  }
+
+  Shard shards_[kNumShards];
 };
 
 StorageManager::StorageManager() {}
@@ -71,33 +184,43 @@ StorageManager::StorageBase *StorageManager::GetParametricStorageImpl(
     std::size_t hash_value,
     std::function<bool(const StorageBase *)> equal_func,
     std::function<StorageBase *()> constructor) {
-  std::lock_guard<ir::SpinLock> guard(parametric_instance_lock_);
   VLOG(4) << "Try to get a parametric storage of: [TypeId_hash="
           << std::hash<ir::TypeId>()(type_id) << ", param_hash=" << hash_value
           << "].";
-  if (parametric_instance_.find(type_id) == parametric_instance_.end())
-    throw("The input data pointer is null.");
-  ParametricStorageManager &parametric_storage = *parametric_instance_[type_id];
-  return parametric_storage.GetOrCreate(hash_value, equal_func, constructor);
+  const ParametricInstanceMap *instances =
+      parametric_instance_.load(std::memory_order_acquire);
+  if (instances == nullptr) throw("The input data pointer is null.");
+  auto it = instances->find(type_id);
+  if (it == instances->end()) throw("The input data pointer is null.");
+  return it->second->GetOrCreate(hash_value, equal_func, constructor);
 }
 
 StorageManager::StorageBase *StorageManager::GetParameterlessStorageImpl(
     TypeId type_id) {
-  std::lock_guard<ir::SpinLock> guard(parameterless_instance_lock_);
   VLOG(4) << "Try to get a parameterless storage of: [TypeId_hash="
           << std::hash<ir::TypeId>()(type_id) << "].";
-  if (parameterless_instance_.find(type_id) == parameterless_instance_.end())
-    throw("TypeId not found in IrContext.");
-  StorageBase *parameterless_instance = parameterless_instance_[type_id];
-  return parameterless_instance;
+  const ParameterlessInstanceMap *instances =
+      parameterless_instance_.load(std::memory_order_acquire);
+  if (instances == nullptr) throw("TypeId not found in IrContext.");
+  auto it = instances->find(type_id);
+  if (it == instances->end()) throw("TypeId not found in IrContext.");
+  return it->second;
 }
 
 void StorageManager::RegisterParametricStorageImpl(TypeId type_id) {
   std::lock_guard<ir::SpinLock> guard(parametric_instance_lock_);
   VLOG(4) << "Register a parametric storage of: [TypeId_hash="
           << std::hash<ir::TypeId>()(type_id) << "].";
-  parametric_instance_.emplace(type_id,
-                               std::make_unique<ParametricStorageManager>());
+  const ParametricInstanceMap *instances =
+      parametric_instance_.load(std::memory_order_relaxed);
+  auto new_instances =
+      instances ? std::make_unique<ParametricInstanceMap>(*instances)
+                : std::make_unique<ParametricInstanceMap>();
+  if (new_instances->count(type_id) != 0) return;
+  parametric_managers_.push_back(std::make_unique<ParametricStorageManager>());
+  new_instances->emplace(type_id, parametric_managers_.back().get());
+  parametric_instance_.store(new_instances.get(), std::memory_order_release);
+  parametric_instance_maps_.push_back(std::move(new_instances));
 }
 
 void StorageManager::RegisterParameterlessStorageImpl(
@@ -105,9 +228,17 @@ void StorageManager::RegisterParameterlessStorageImpl(
   std::lock_guard<ir::SpinLock> guard(parameterless_instance_lock_);
   VLOG(4) << "Register a parameterless storage of: [TypeId_hash="
           << std::hash<ir::TypeId>()(type_id) << "].";
-  if (parameterless_instance_.find(type_id) != parameterless_instance_.end())
+  const ParameterlessInstanceMap *instances =
+      parameterless_instance_.load(std::memory_order_relaxed);
+  if (instances != nullptr && instances->count(type_id) != 0)
     throw("storage class already registered");
-  parameterless_instance_.emplace(type_id, constructor());
+  auto new_instances =
+      instances ? std::make_unique<ParameterlessInstanceMap>(*instances)
+                : std::make_unique<ParameterlessInstanceMap>();
+  new_instances->emplace(type_id, constructor());
+  parameterless_instance_.store(new_instances.get(),
+                                std::memory_order_release);
+  parameterless_instance_maps_.push_back(std::move(new_instances));
 }
 
 }  // namespace ir
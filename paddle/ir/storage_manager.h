@@ -14,9 +14,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 #include "paddle/ir/spin_lock.h"
 #include "paddle/ir/type_id.h"
@@ -40,6 +43,12 @@ struct ParametricStorageManager;
 /// provide method 'bool operator==(const ParamKey &) const', used to compare
 /// Storage instance and ParamKey instance.
 ///
+/// StorageManager is thread safe. The parametric storages of a type id are
+/// kept in a table split into shards by hash value. A lookup first searches
+/// its shard without locking, and only takes the lock of the shard to create
+/// a missing storage, so threads interning different or existing storages
+/// rarely contend.
+///
 class StorageManager {
  public:
   ///
@@ -134,14 +143,30 @@ class StorageManager {
   void RegisterParameterlessStorageImpl(
       TypeId type_id, std::function<StorageBase *()> constructor);
 
-  // This map is a mapping between type id and parametric type storage.
-  std::unordered_map<TypeId, std::unique_ptr<ParametricStorageManager>>
-      parametric_instance_;
+  using ParametricInstanceMap =
+      std::unordered_map<TypeId, ParametricStorageManager *>;
+
+  using ParameterlessInstanceMap = std::unordered_map<TypeId, StorageBase *>;
+
+  // The storage classes are registered rarely, while looked up on every get.
+  // So the maps between type id and storage are immutable once published: a
+  // registration copies the current map, inserts into the copy and publishes
+  // it, and lookups read the published map without locking. The retired maps
+  // are released together with the StorageManager.
+  std::vector<std::unique_ptr<ParametricStorageManager>> parametric_managers_;
+
+  std::vector<std::unique_ptr<const ParametricInstanceMap>>
+      parametric_instance_maps_;
+
+  std::atomic<const ParametricInstanceMap *> parametric_instance_{nullptr};
 
   ir::SpinLock parametric_instance_lock_;
 
-  // This map is a mapping between type id and parameterless type storage.
-  std::unordered_map<TypeId, StorageBase *> parameterless_instance_;
+  std::vector<std::unique_ptr<const ParameterlessInstanceMap>>
+      parameterless_instance_maps_;
+
+  std::atomic<const ParameterlessInstanceMap *> parameterless_instance_{
+      nullptr};
 
   ir::SpinLock parameterless_instance_lock_;
 };
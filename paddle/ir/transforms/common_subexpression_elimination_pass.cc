@@ -0,0 +1,130 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/ir/transforms/common_subexpression_elimination_pass.h"
+
+#include <unordered_set>
+
+#include "paddle/ir/builtin_trait.h"
+#include "paddle/ir/program.h"
+#include "paddle/ir/utils.h"
+#include "paddle/pass/pass.h"
+
+namespace {
+
+struct OperationKeyHash {
+  std::size_t operator()(ir::Operation *op) const {
+    std::size_t hash = std::hash<ir::OpInfo>()(op->op_info());
+    for (uint32_t i = 0; i < op->num_operands(); ++i) {
+      hash = ir::hash_combine(
+          hash,
+          std::hash<ir::Value>()(
+              op->GetOperandByIndex(i).impl()->source()));
+    }
+    for (uint32_t i = 0; i < op->num_results(); ++i) {
+      hash = ir::hash_combine(
+          hash, std::hash<ir::Type>()(op->GetResultByIndex(i).type()));
+    }
+    // The iteration order of AttributeMap is unspecified, so the attributes
+    // are combined by an order independent sum.
+    std::size_t attributes_hash = 0;
+    for (auto &attribute : op->attribute()) {
+      attributes_hash +=
+          ir::hash_combine(std::hash<std::string>()(attribute.first),
+                           std::hash<ir::Attribute>()(attribute.second));
+    }
+    return ir::hash_combine(hash, attributes_hash);
+  }
+};
+
+struct OperationKeyEqual {
+  bool operator()(ir::Operation *lhs, ir::Operation *rhs) const {
+    if (lhs == rhs) return true;
+    if (lhs->op_info() != rhs->op_info() ||
+        lhs->num_operands() != rhs->num_operands() ||
+        lhs->num_results() != rhs->num_results()) {
+      return false;
+    }
+    for (uint32_t i = 0; i < lhs->num_operands(); ++i) {
+      if (lhs->GetOperandByIndex(i).impl()->source() !=
+          rhs->GetOperandByIndex(i).impl()->source()) {
+        return false;
+      }
+    }
+    for (uint32_t i = 0; i < lhs->num_results(); ++i) {
+      if (lhs->GetResultByIndex(i).type() != rhs->GetResultByIndex(i).type()) {
+        return false;
+      }
+    }
+    return lhs->attribute() == rhs->attribute();
+  }
+};
+
+bool CanBeEliminated(ir::Operation *op) {
+  return op->op_info() && op->num_results() > 0 &&
+         !op->HasTrait<ir::SideEffectTrait>();
+}
+
+class CommonSubexpressionEliminationPass : public ir::ProgramPass {
+ public:
+  CommonSubexpressionEliminationPass()
+      : ir::ProgramPass("CommonSubexpressionEliminationPass", 2) {}
+
+  void RunOnProgram(ir::Program *program) override {
+    ir::Block *block = program->block();
+    std::unordered_set<ir::Operation *, OperationKeyHash, OperationKeyEqual>
+        known_ops;
+    size_t num_erased = 0;
+    // Ops are visited in program order. Once an op is replaced, the users of
+    // its results refer to the kept op, so a chain of equivalent ops is merged
+    // in a single pass.
+    for (auto it = block->begin(); it != block->end();) {
+      ir::Operation *op = *it;
+      if (!CanBeEliminated(op)) {
+        // An op with side effects may change what the ops seen so far read,
+        // e.g. set_parameter between two get_parameter of the same name, so
+        // they are not reused past it.
+        if (op->op_info() && op->HasTrait<ir::SideEffectTrait>()) {
+          known_ops.clear();
+        }
+        ++it;
+        continue;
+      }
+      auto inserted = known_ops.insert(op);
+      if (inserted.second) {
+        ++it;
+        continue;
+      }
+      ir::Operation *kept_op = *inserted.first;
+      VLOG(4) << "Replace op " << op->op_name() << " by an equivalent op.";
+      for (uint32_t i = 0; i < op->num_results(); ++i) {
+        op->GetResultByIndex(i).ReplaceAllUsesWith(
+            kept_op->GetResultByIndex(i));
+      }
+      it = block->erase(it);
+      ++num_erased;
+    }
+    VLOG(3) << info_.name << " erased " << num_erased << " ops.";
+  }
+};
+
+}  // namespace
+
+namespace ir {
+
+std::unique_ptr<Pass> CreateCommonSubexpressionEliminationPass() {
+  return std::make_unique<CommonSubexpressionEliminationPass>();
+}
+
+}  // namespace ir
@@ -0,0 +1,32 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+
+namespace ir {
+
+class Pass;
+
+///
+/// \brief Merge ops that compute the same value. Two ops are equivalent if
+/// they have the same OpInfo, the same operands, the same result types and the
+/// same attributes. Since types and attributes are uniqued by IrContext, they
+/// are hashed and compared by their storage pointers. Ops with
+/// ir::SideEffectTrait or without results are never merged.
+///
+std::unique_ptr<Pass> CreateCommonSubexpressionEliminationPass();
+
+}  // namespace ir
@@ -0,0 +1,64 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/ir/transforms/dead_code_elimination_pass.h"
+
+#include "paddle/ir/builtin_trait.h"
+#include "paddle/ir/program.h"
+#include "paddle/pass/pass.h"
+
+namespace {
+
+bool IsDeadOp(ir::Operation *op) {
+  if (op->num_results() == 0 || op->HasTrait<ir::SideEffectTrait>()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < op->num_results(); ++i) {
+    if (!op->GetResultByIndex(i).use_empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class DeadCodeEliminationPass : public ir::ProgramPass {
+ public:
+  DeadCodeEliminationPass() : ir::ProgramPass("DeadCodeEliminationPass", 2) {}
+
+  void RunOnProgram(ir::Program *program) override {
+    ir::Block *block = program->block();
+    size_t num_erased = 0;
+    // Erasing an op releases the uses of its operands, so the producers which
+    // are visited later may become dead as well.
+    for (auto it = block->end(); it != block->begin();) {
+      --it;
+      if (IsDeadOp(*it)) {
+        VLOG(4) << "Erase dead op: " << (*it)->op_name();
+        it = block->erase(it);
+        ++num_erased;
+      }
+    }
+    VLOG(3) << info_.name << " erased " << num_erased << " ops.";
+  }
+};
+
+}  // namespace
+
+namespace ir {
+
+std::unique_ptr<Pass> CreateDeadCodeEliminationPass() {
+  return std::make_unique<DeadCodeEliminationPass>();
+}
+
+}  // namespace ir
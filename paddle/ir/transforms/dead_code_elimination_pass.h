@@ -0,0 +1,30 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+
+namespace ir {
+
+class Pass;
+
+///
+/// \brief Erase the ops whose results are all unused. Ops without results or
+/// with ir::SideEffectTrait are always kept. The block is visited in reverse
+/// order, so that a chain of dead ops is erased in a single pass.
+///
+std::unique_ptr<Pass> CreateDeadCodeEliminationPass();
+
+}  // namespace ir
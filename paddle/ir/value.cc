@@ -81,6 +81,15 @@ Value::use_iterator Value::begin() const {
 
 Value::use_iterator Value::end() const { return Value::use_iterator(); }
 
+bool Value::use_empty() const { return impl_->use_empty(); }
+
+void Value::ReplaceAllUsesWith(Value new_value) const {
+  if (impl_ == new_value.impl_) return;
+  while (!impl_->use_empty()) {
+    impl_->first_use()->set_source(new_value);
+  }
+}
+
 // OpResult
 bool OpResult::classof(Value value) {
   return ir::isa<detail::OpResultImpl>(value.impl());
@@ -110,14 +119,24 @@ ir::Value OpOperandImpl::source() const { return source_; }
 
 void OpOperandImpl::release_source() { source_ = nullptr; }
 
+void OpOperandImpl::set_source(ir::Value source) {
+  remove_from_ud_chain();
+  source_ = source;
+  insert_to_ud_chain();
+}
+
 OpOperandImpl::OpOperandImpl(ir::Value source, ir::Operation *owner)
     : source_(source), owner_(owner) {
-  prev_use_addr_ = source.impl()->first_use_addr();
-  next_use_ = source.impl()->first_use();
+  insert_to_ud_chain();
+}
+
+void OpOperandImpl::insert_to_ud_chain() {
+  prev_use_addr_ = source_.impl()->first_use_addr();
+  next_use_ = source_.impl()->first_use();
   if (next_use_) {
     next_use_->prev_use_addr_ = &next_use_;
   }
-  source.impl()->SetFirstUse(this);
+  source_.impl()->SetFirstUse(this);
 }
 
 void OpOperandImpl::remove_from_ud_chain() {
@@ -141,6 +141,14 @@ class Value {
 
   use_iterator end() const;
 
+  bool use_empty() const;
+
+  ///
+  /// \brief Redirect all uses of this value to new_value, after which this
+  /// value has no uses.
+  ///
+  void ReplaceAllUsesWith(Value new_value) const;
+
   friend struct std::hash<Value>;
 
  protected:
@@ -15,6 +15,7 @@
 #include "paddle/pass/pass.h"
 #include "paddle/ir/ir_context.h"
 #include "paddle/ir/operation.h"
+#include "paddle/ir/program.h"
 #include "paddle/pass/pass_adaptor.h"
 #include "paddle/pass/pass_manager.h"
 
@@ -48,6 +49,40 @@ bool detail::PassAdaptor::RunPipeline(const PassManager& pm,
   return true;
 }
 
+bool detail::PassAdaptor::RunPipeline(const PassManager& pm,
+                                      ir::Program* program,
+                                      uint8_t opt_level) {
+  for (auto& pass : pm.GetPasses()) {
+    if (auto* program_pass = dynamic_cast<ProgramPass*>(pass.get())) {
+      if (!RunPass(program_pass, program, opt_level)) {
+        return false;
+      }
+      continue;
+    }
+    for (auto* op : *program->block()) {
+      if (pass->CanScheduleOn(op)) {
+        if (!RunPass(pass.get(), op, opt_level)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+bool detail::PassAdaptor::RunPass(ProgramPass* pass,
+                                  ir::Program* program,
+                                  uint8_t opt_level) {
+  if (opt_level < pass->info_.opt_level) return true;
+
+  pass->pass_state_ = detail::PassExecutionState(program);
+
+  pass->RunOnProgram(program);
+
+  return !pass->pass_state_->pass_failed;
+}
+
 bool detail::PassAdaptor::RunPass(Pass* pass,
                                   ir::Operation* op,
                                   uint8_t opt_level) {
@@ -78,10 +113,21 @@ bool PassManager::Run(ir::Operation* op) {
   return RunPasses(op);
 }
 
+bool PassManager::Run(ir::Program* program) {
+  if (!Initialize(context_)) {
+    return false;
+  }
+  return RunPasses(program);
+}
+
 bool PassManager::RunPasses(ir::Operation* op) {
   return detail::PassAdaptor::RunPipeline(*this, op, opt_level_);
 }
 
+bool PassManager::RunPasses(ir::Program* program) {
+  return detail::PassAdaptor::RunPipeline(*this, program, opt_level_);
+}
+
 bool PassManager::Initialize(ir::IrContext* context) {
   for (auto& pass : GetPasses()) {
     if (!pass->Initialize(context)) return false;
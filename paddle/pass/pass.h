@@ -23,6 +23,7 @@ namespace ir {
 
 class IrContext;
 class Operation;
+class Program;
 
 namespace detail {
 class PassAdaptor;
@@ -33,7 +34,11 @@ namespace detail {
 struct PassExecutionState {
   explicit PassExecutionState(ir::Operation* ir) : ir(ir), pass_failed(false) {}
 
+  explicit PassExecutionState(ir::Program* program)
+      : ir(nullptr), program(program), pass_failed(false) {}
+
   ir::Operation* ir;
+  ir::Program* program{nullptr};
   bool pass_failed;
   // TODO(liuyuanle): Add implementation of AnalysisManager and
   // PreservedAnalyses.
@@ -91,4 +96,26 @@ class Pass {
   friend class detail::PassAdaptor;
 };
 
+/// A pass that runs on a whole Program rather than a single Operation. It is
+/// used by transforms which need to see every op of the program and to erase
+/// or replace ops, such as dce and cse. Program passes are only scheduled by
+/// PassManager::Run(ir::Program*).
+class ProgramPass : public Pass {
+ public:
+  explicit ProgramPass(const char* name,
+                       uint8_t opt_level,
+                       const std::vector<const char*>& dependents = {})
+      : Pass(name, opt_level, dependents) {}
+
+ protected:
+  virtual void RunOnProgram(ir::Program* program) = 0;
+
+  void Run(ir::Operation* op) final {}
+
+  bool CanScheduleOn(ir::Operation* op) const final { return false; }
+
+  friend class PassManager;
+  friend class detail::PassAdaptor;
+};
+
 }  // namespace ir
@@ -19,6 +19,8 @@
 namespace ir {
 
 class Operation;
+class Program;
+class ProgramPass;
 
 class PassManager;
 
@@ -37,10 +39,18 @@ class PassAdaptor final : public Pass {
 
   static bool RunPass(Pass* pass, ir::Operation* op, uint8_t opt_level);
 
+  static bool RunPass(ProgramPass* pass,
+                      ir::Program* program,
+                      uint8_t opt_level);
+
   static bool RunPipeline(const PassManager& pm,
                           ir::Operation* op,
                           uint8_t opt_level);
 
+  static bool RunPipeline(const PassManager& pm,
+                          ir::Program* program,
+                          uint8_t opt_level);
+
   // Use for RunImpl later.
   PassManager* pm_;
 
@@ -22,6 +22,7 @@ namespace ir {
 class IrContext;
 class Operation;
 class Pass;
+class Program;
 
 namespace detail {
 class PassAdaptor;
@@ -43,6 +44,10 @@ class PassManager {
 
   bool Run(ir::Operation *op);
 
+  /// Run ProgramPasses on the whole program, and other passes on each op of
+  /// the program which they can be scheduled on.
+  bool Run(ir::Program *program);
+
   void AddPass(std::unique_ptr<Pass> pass) {
     passes_.emplace_back(std::move(pass));
   }
@@ -50,6 +55,8 @@ class PassManager {
  private:
   bool RunPasses(ir::Operation *op);
 
+  bool RunPasses(ir::Program *program);
+
   bool Initialize(ir::IrContext *context);
 
  private:
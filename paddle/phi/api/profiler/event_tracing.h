@@ -91,6 +91,10 @@ class RecordEvent {
   TracerEventType type_{TracerEventType::UserDefined};
   std::string* attr_{nullptr};
   bool finished_{false};
+  // Set if the event is sampled by SamplingProfiler.
+  const char* sampled_name_{nullptr};
+  TracerEventType sampled_type_{TracerEventType::UserDefined};
+  uint64_t sample_start_ns_;
 };
 
 }  // namespace phi
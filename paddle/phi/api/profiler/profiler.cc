@@ -27,6 +27,7 @@ limitations under the License. */
 #include "paddle/phi/api/profiler/host_event_recorder.h"
 #include "paddle/phi/api/profiler/host_tracer.h"
 #include "paddle/phi/api/profiler/profiler_helper.h"
+#include "paddle/phi/api/profiler/sampling_profiler.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/os_info.h"
 #ifdef PADDLE_WITH_CUDA
@@ -108,6 +109,12 @@ RecordEvent::RecordEvent(const char *name,
   }
 #endif
 #endif
+  if (UNLIKELY(SamplingProfiler::IsEnabled()) &&
+      SamplingProfiler::GetInstance().ShouldSample(level)) {
+    sampled_name_ = name;
+    sampled_type_ = type;
+    sample_start_ns_ = PosixInNsec();
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -142,6 +149,12 @@ RecordEvent::RecordEvent(const std::string &name,
   }
 #endif
 #endif
+  if (UNLIKELY(SamplingProfiler::IsEnabled()) &&
+      SamplingProfiler::GetInstance().ShouldSample(level)) {
+    sampled_name_ = SamplingProfiler::GetInstance().InternName(name);
+    sampled_type_ = type;
+    sample_start_ns_ = PosixInNsec();
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -175,6 +188,12 @@ RecordEvent::RecordEvent(const std::string &name,
   }
 #endif
 #endif
+  if (UNLIKELY(SamplingProfiler::IsEnabled()) &&
+      SamplingProfiler::GetInstance().ShouldSample(level)) {
+    sampled_name_ = SamplingProfiler::GetInstance().InternName(name);
+    sampled_type_ = type;
+    sample_start_ns_ = PosixInNsec();
+  }
 
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
@@ -224,6 +243,11 @@ void RecordEvent::End() {
   }
 #endif
 #endif
+  if (UNLIKELY(sampled_name_ != nullptr)) {
+    SamplingProfiler::GetInstance().RecordSample(
+        sampled_name_, sampled_type_, sample_start_ns_, PosixInNsec());
+    sampled_name_ = nullptr;
+  }
   if (LIKELY(FLAGS_enable_host_event_recorder_hook && is_enabled_)) {
     uint64_t end_ns = PosixInNsec();
     if (LIKELY(shallow_copy_name_ != nullptr)) {
@@ -0,0 +1,396 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/api/profiler/sampling_profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/os_info.h"
+
+namespace phi {
+
+namespace {
+const char* TracerEventTypeName(TracerEventType type) {
+  static const char* names[] = {"Operator",
+                                "Dataloader",
+                                "ProfileStep",
+                                "CudaRuntime",
+                                "Kernel",
+                                "Memcpy",
+                                "Memset",
+                                "UserDefined",
+                                "OperatorInner",
+                                "Forward",
+                                "Backward",
+                                "Optimization",
+                                "Communication",
+                                "PythonOp",
+                                "PythonUserDefined"};
+  static_assert(sizeof(names) / sizeof(names[0]) ==
+                    static_cast<size_t>(TracerEventType::NumTypes),
+                "TracerEventTypeName is not consistent with TracerEventType");
+  return names[static_cast<size_t>(type)];
+}
+
+size_t LatencyBucket(uint64_t latency_ns) {
+  size_t bucket = 0;
+  while (latency_ns != 0 && bucket < SampledLatencyStats::kNumBuckets - 1) {
+    ++bucket;
+    latency_ns >>= 1;
+  }
+  return bucket;
+}
+
+void WriteJsonString(std::ostream& os, const char* str) {
+  os << '"';
+  for (; *str != '\0'; ++str) {
+    if (*str == '"' || *str == '\\') {
+      os << '\\' << *str;
+    } else if (static_cast<unsigned char>(*str) >= 0x20) {
+      os << *str;
+    }
+  }
+  os << '"';
+}
+
+// Chrome tracing takes microseconds.
+void WriteMicroseconds(std::ostream& os, uint64_t ns) {
+  os << ns / 1000 << "." << std::setw(3) << std::setfill('0') << ns % 1000;
+}
+
+struct SampledEvent {
+  const char* name;
+  TracerEventType type;
+  uint64_t start_ns;
+  uint64_t end_ns;
+  uint64_t thread_id;
+};
+}  // namespace
+
+// The samples of one thread. Only the owner thread writes, any thread may read
+// while it is writing. When the owner exits, the recorder is handed over to
+// another thread under recorders_mutex_, the samples of both stay readable.
+class ThreadSampleRecorder {
+ public:
+  explicit ThreadSampleRecorder(uint32_t ring_capacity)
+      : thread_id_(GetCurrentThreadSysId()),
+        slots_(std::max<uint32_t>(ring_capacity, 1)) {}
+
+  DISABLE_COPY_AND_ASSIGN(ThreadSampleRecorder);
+
+ public:
+  size_t RingCapacity() const { return slots_.size(); }
+
+  // Called by the thread taking the recorder over.
+  void ResetOwner() {
+    thread_id_ = GetCurrentThreadSysId();
+    counter_ = 0;
+  }
+
+  bool ShouldSample(uint32_t sample_period) {
+    if (++counter_ < sample_period) {
+      return false;
+    }
+    counter_ = 0;
+    return true;
+  }
+
+  void Record(const char* name,
+              TracerEventType type,
+              uint64_t start_ns,
+              uint64_t end_ns) {
+    // Write the slot under a sequence lock, readers retry or skip a slot whose
+    // sequence is odd or changes while they read it.
+    uint64_t pos = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[pos % slots_.size()];
+    slot.seq.store(2 * pos + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.type.store(type, std::memory_order_relaxed);
+    slot.thread_id.store(thread_id_, std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.end_ns.store(end_ns, std::memory_order_relaxed);
+    slot.seq.store(2 * pos + 2, std::memory_order_release);
+    head_.store(pos + 1, std::memory_order_release);
+
+    uint64_t latency_ns = end_ns > start_ns ? end_ns - start_ns : 0;
+    Histogram* histogram = FindHistogram(name);
+    histogram->count.fetch_add(1, std::memory_order_relaxed);
+    histogram->total_ns.fetch_add(latency_ns, std::memory_order_relaxed);
+    histogram->buckets[LatencyBucket(latency_ns)].fetch_add(
+        1, std::memory_order_relaxed);
+    uint64_t max_ns = histogram->max_ns.load(std::memory_order_relaxed);
+    while (latency_ns > max_ns &&
+           !histogram->max_ns.compare_exchange_weak(
+               max_ns, latency_ns, std::memory_order_relaxed)) {
+    }
+  }
+
+  void CollectEvents(uint64_t min_end_ns, std::vector<SampledEvent>* events) {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t begin = head > slots_.size() ? head - slots_.size() : 0;
+    for (uint64_t pos = begin; pos < head; ++pos) {
+      Slot& slot = slots_[pos % slots_.size()];
+      uint64_t seq = slot.seq.load(std::memory_order_acquire);
+      if (seq != 2 * pos + 2) continue;
+      SampledEvent event{slot.name.load(std::memory_order_relaxed),
+                         slot.type.load(std::memory_order_relaxed),
+                         slot.start_ns.load(std::memory_order_relaxed),
+                         slot.end_ns.load(std::memory_order_relaxed),
+                         slot.thread_id.load(std::memory_order_relaxed)};
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // Overwritten by the owner while reading.
+      if (slot.seq.load(std::memory_order_relaxed) != seq) continue;
+      if (event.end_ns >= min_end_ns) {
+        events->push_back(event);
+      }
+    }
+  }
+
+  void CollectLatencyStats(
+      std::unordered_map<std::string, SampledLatencyStats>* stats) {
+    std::lock_guard<std::mutex> guard(histograms_mutex_);
+    for (auto& kv : histograms_) {
+      const Histogram& histogram = kv.second;
+      SampledLatencyStats& stat = (*stats)[kv.first];
+      stat.name = kv.first;
+      stat.count += histogram.count.load(std::memory_order_relaxed);
+      stat.total_ns += histogram.total_ns.load(std::memory_order_relaxed);
+      stat.max_ns = std::max(stat.max_ns,
+                             histogram.max_ns.load(std::memory_order_relaxed));
+      for (size_t i = 0; i < SampledLatencyStats::kNumBuckets; ++i) {
+        stat.buckets[i] +=
+            histogram.buckets[i].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void ResetLatencyStats() {
+    std::lock_guard<std::mutex> guard(histograms_mutex_);
+    for (auto& kv : histograms_) {
+      Histogram& histogram = kv.second;
+      histogram.count.store(0, std::memory_order_relaxed);
+      histogram.total_ns.store(0, std::memory_order_relaxed);
+      histogram.max_ns.store(0, std::memory_order_relaxed);
+      for (auto& bucket : histogram.buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<TracerEventType> type{TracerEventType::UserDefined};
+    std::atomic<uint64_t> start_ns{0};
+    std::atomic<uint64_t> end_ns{0};
+    std::atomic<uint64_t> thread_id{0};
+  };
+
+  struct Histogram {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    std::atomic<uint64_t> buckets[SampledLatencyStats::kNumBuckets]{};
+  };
+
+  Histogram* FindHistogram(const char* name) {
+    // Only the owner inserts, so it can look up without the lock.
+    auto it = histograms_.find(name);
+    if (it != histograms_.end()) {
+      return &it->second;
+    }
+    std::lock_guard<std::mutex> guard(histograms_mutex_);
+    return &histograms_[name];
+  }
+
+  uint64_t thread_id_;
+  uint32_t counter_{0};
+
+  std::vector<Slot> slots_;
+  std::atomic<uint64_t> head_{0};
+
+  // Keyed by the name pointer, the names are merged by content when read.
+  std::unordered_map<const char*, Histogram> histograms_;
+  std::mutex histograms_mutex_;
+};
+
+uint64_t SampledLatencyStats::Quantile(double q) const {
+  uint64_t target = static_cast<uint64_t>(q * count);
+  uint64_t accumulated = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    accumulated += buckets[i];
+    if (accumulated >= target && accumulated > 0) {
+      return i + 1 < kNumBuckets ? std::min(uint64_t{1} << i, max_ns) : max_ns;
+    }
+  }
+  return max_ns;
+}
+
+void SamplingProfiler::Enable(const SamplingProfilerOptions& options) {
+  sample_period_.store(std::max<uint32_t>(options.sample_period, 1),
+                       std::memory_order_relaxed);
+  trace_level_.store(options.trace_level, std::memory_order_relaxed);
+  ring_capacity_.store(options.ring_capacity, std::memory_order_relaxed);
+  window_ns_.store(options.window_ns, std::memory_order_relaxed);
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void SamplingProfiler::Disable() {
+  enabled_.store(false, std::memory_order_relaxed);
+}
+
+// Gives the recorder of a thread back to the profiler when the thread exits.
+class ThreadSampleRecorderHolder {
+ public:
+  ~ThreadSampleRecorderHolder() {
+    if (recorder != nullptr) {
+      SamplingProfiler::GetInstance().ReleaseRecorder(recorder);
+    }
+  }
+
+  ThreadSampleRecorder* recorder = nullptr;
+};
+
+ThreadSampleRecorder* SamplingProfiler::GetThreadLocalRecorder() {
+  // The recorder is owned by recorders_, which is never shrunk.
+  thread_local ThreadSampleRecorderHolder holder;
+  if (UNLIKELY(holder.recorder == nullptr)) {
+    holder.recorder = AcquireRecorder();
+  }
+  return holder.recorder;
+}
+
+ThreadSampleRecorder* SamplingProfiler::AcquireRecorder() {
+  size_t ring_capacity = std::max<uint32_t>(
+      ring_capacity_.load(std::memory_order_relaxed), 1);
+  std::lock_guard<std::mutex> guard(recorders_mutex_);
+  // A recorder left with another capacity stays free, the options of the
+  // rings only apply to new rings.
+  for (auto it = free_recorders_.begin(); it != free_recorders_.end(); ++it) {
+    ThreadSampleRecorder* recorder = *it;
+    if (recorder->RingCapacity() == ring_capacity) {
+      free_recorders_.erase(it);
+      recorder->ResetOwner();
+      return recorder;
+    }
+  }
+  recorders_.push_back(std::make_shared<ThreadSampleRecorder>(ring_capacity));
+  return recorders_.back().get();
+}
+
+void SamplingProfiler::ReleaseRecorder(ThreadSampleRecorder* recorder) {
+  std::lock_guard<std::mutex> guard(recorders_mutex_);
+  free_recorders_.push_back(recorder);
+}
+
+size_t SamplingProfiler::NumThreadRecorders() {
+  std::lock_guard<std::mutex> guard(recorders_mutex_);
+  return recorders_.size();
+}
+
+bool SamplingProfiler::ShouldSample(uint32_t level) {
+  if (level > trace_level_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  return GetThreadLocalRecorder()->ShouldSample(
+      sample_period_.load(std::memory_order_relaxed));
+}
+
+void SamplingProfiler::RecordSample(const char* name,
+                                    TracerEventType type,
+                                    uint64_t start_ns,
+                                    uint64_t end_ns) {
+  GetThreadLocalRecorder()->Record(name, type, start_ns, end_ns);
+}
+
+const char* SamplingProfiler::InternName(const std::string& name) {
+  std::lock_guard<std::mutex> guard(names_mutex_);
+  return names_.insert(name).first->c_str();
+}
+
+std::vector<SampledLatencyStats> SamplingProfiler::GetLatencyStats() {
+  std::unordered_map<std::string, SampledLatencyStats> stats;
+  {
+    std::lock_guard<std::mutex> guard(recorders_mutex_);
+    for (auto& recorder : recorders_) {
+      recorder->CollectLatencyStats(&stats);
+    }
+  }
+  std::vector<SampledLatencyStats> result;
+  result.reserve(stats.size());
+  for (auto& kv : stats) {
+    result.push_back(std::move(kv.second));
+  }
+  std::sort(result.begin(),
+            result.end(),
+            [](const SampledLatencyStats& lhs, const SampledLatencyStats& rhs) {
+              return lhs.total_ns > rhs.total_ns;
+            });
+  return result;
+}
+
+void SamplingProfiler::ResetLatencyStats() {
+  std::lock_guard<std::mutex> guard(recorders_mutex_);
+  for (auto& recorder : recorders_) {
+    recorder->ResetLatencyStats();
+  }
+}
+
+void SamplingProfiler::DumpChromeTrace(const std::string& path) {
+  uint64_t now_ns = PosixInNsec();
+  uint64_t window_ns = window_ns_.load(std::memory_order_relaxed);
+  uint64_t min_end_ns = now_ns > window_ns ? now_ns - window_ns : 0;
+  std::vector<SampledEvent> events;
+  {
+    std::lock_guard<std::mutex> guard(recorders_mutex_);
+    for (auto& recorder : recorders_) {
+      recorder->CollectEvents(min_end_ns, &events);
+    }
+  }
+  std::sort(events.begin(),
+            events.end(),
+            [](const SampledEvent& lhs, const SampledEvent& rhs) {
+              return lhs.start_ns < rhs.start_ns;
+            });
+
+  std::ofstream ofs(path, std::ios::out | std::ios::trunc);
+  PADDLE_ENFORCE_EQ(
+      ofs.is_open(),
+      true,
+      phi::errors::Unavailable("Failed to open %s to dump the samples.", path));
+  uint64_t pid = GetProcessId();
+  ofs << "{\n\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [";
+  for (size_t i = 0; i < events.size(); ++i) {
+    const SampledEvent& event = events[i];
+    ofs << (i == 0 ? "\n" : ",\n") << "{\"name\": ";
+    WriteJsonString(ofs, event.name);
+    ofs << ", \"cat\": \"" << TracerEventTypeName(event.type)
+        << "\", \"ph\": \"X\", \"pid\": " << pid
+        << ", \"tid\": " << event.thread_id << ", \"ts\": ";
+    WriteMicroseconds(ofs, event.start_ns);
+    ofs << ", \"dur\": ";
+    WriteMicroseconds(
+        ofs, event.end_ns > event.start_ns ? event.end_ns - event.start_ns : 0);
+    ofs << "}";
+  }
+  ofs << "\n]\n}\n";
+}
+
+}  // namespace phi
@@ -0,0 +1,140 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/phi/api/profiler/trace_event.h"
+#include "paddle/phi/core/macros.h"
+
+namespace phi {
+
+struct SamplingProfilerOptions {
+  // Record 1 in sample_period events of each thread.
+  uint32_t sample_period = 100;
+  // Events with a level greater than trace_level are not sampled, works like
+  // HostTraceLevel.
+  uint32_t trace_level = 1;
+  // Number of sampled events kept by the ring of each thread.
+  uint32_t ring_capacity = 4096;
+  // Events ended earlier than window_ns before the dump are not dumped.
+  uint64_t window_ns = 10ULL * 1000 * 1000 * 1000;
+};
+
+// Latency statistics of the sampled events of one name.
+struct SampledLatencyStats {
+  // Bucket i counts the latencies in [2^(i-1), 2^i) ns, bucket 0 counts 0 ns.
+  static constexpr size_t kNumBuckets = 64;
+
+  std::string name;
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+  std::vector<uint64_t> buckets = std::vector<uint64_t>(kNumBuckets, 0);
+
+  // Upper bound of the q-quantile latency (0 < q <= 1), in ns.
+  uint64_t Quantile(double q) const;
+};
+
+class ThreadSampleRecorder;
+class ThreadSampleRecorderHolder;
+
+// An always-on, low overhead alternative to a capture session of the
+// profiler. While enabled, RecordEvent samples 1 in sample_period events of
+// each thread. A sampled event is written to a lock-free ring buffer of its
+// thread, which keeps the latest ring_capacity events, and is added to the
+// latency histogram of its name. Both can be read at any time without
+// stopping the running threads.
+class SamplingProfiler {
+ public:
+  // singleton
+  static SamplingProfiler& GetInstance() {
+    static SamplingProfiler instance;
+    return instance;
+  }
+
+  // Checked by every RecordEvent, keep it cheap.
+  static bool IsEnabled() {
+    return GetInstance().enabled_.load(std::memory_order_relaxed);
+  }
+
+  // thread-safe. The options of the rings take effect on threads that record
+  // their first sampled event after this call.
+  void Enable(const SamplingProfilerOptions& options);
+
+  // thread-safe. The recorded data is kept and can still be read.
+  void Disable();
+
+  // Whether the calling thread should sample its next event of level.
+  bool ShouldSample(uint32_t level);
+
+  // Record a sampled event of the calling thread. name must outlive the
+  // profiler, use InternName for a transient string.
+  void RecordSample(const char* name,
+                    TracerEventType type,
+                    uint64_t start_ns,
+                    uint64_t end_ns);
+
+  // Return a copy of name with static lifetime.
+  const char* InternName(const std::string& name);
+
+  // thread-safe. Aggregate the histograms of all threads by name.
+  std::vector<SampledLatencyStats> GetLatencyStats();
+
+  // thread-safe. Write the sampled events in the rings that ended within
+  // window_ns to path in chrome tracing format.
+  void DumpChromeTrace(const std::string& path);
+
+  // thread-safe. Clear the histograms. The rings are not cleared, their events
+  // expire by the window instead.
+  void ResetLatencyStats();
+
+  // thread-safe. Number of rings, in use or left by exited threads.
+  size_t NumThreadRecorders();
+
+ private:
+  friend class ThreadSampleRecorderHolder;
+
+  SamplingProfiler() = default;
+  DISABLE_COPY_AND_ASSIGN(SamplingProfiler);
+
+  ThreadSampleRecorder* GetThreadLocalRecorder();
+  ThreadSampleRecorder* AcquireRecorder();
+  void ReleaseRecorder(ThreadSampleRecorder* recorder);
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<uint32_t> sample_period_{100};
+  std::atomic<uint32_t> trace_level_{1};
+  std::atomic<uint32_t> ring_capacity_{4096};
+  std::atomic<uint64_t> window_ns_{10ULL * 1000 * 1000 * 1000};
+
+  std::mutex names_mutex_;
+  std::unordered_set<std::string> names_;
+
+  // Hold the recorders of all threads, so that the samples of exited threads
+  // can still be read. The recorder of an exited thread is kept in
+  // free_recorders_ and taken over by the next new thread, so a pool that
+  // keeps replacing its threads does not grow recorders_.
+  std::mutex recorders_mutex_;
+  std::vector<std::shared_ptr<ThreadSampleRecorder>> recorders_;
+  std::vector<ThreadSampleRecorder*> free_recorders_;
+};
+
+}  // namespace phi
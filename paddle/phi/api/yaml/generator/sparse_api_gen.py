@@ -218,8 +218,9 @@ class SparseAPI(ForwardAPI):
         )
         return f"""
     VLOG(6) << "{self.api} api sparse kernel key: [" << kernel_backend << ", " << kernel_layout << ", "<< kernel_data_type << "]";
-    auto kernel_result = phi::KernelFactory::Instance().SelectKernelOrThrowError(
-        "{kernel_name}", {{kernel_backend, kernel_layout, kernel_data_type}});
+    static phi::KernelDispatchCache kernel_dispatch_cache("{kernel_name}");
+    auto kernel_result = kernel_dispatch_cache.SelectKernelOrThrowError(
+        {{kernel_backend, kernel_layout, kernel_data_type}});
     const auto& phi_kernel = kernel_result.kernel;
     if (FLAGS_low_precision_op_list) {{
       phi::KernelFactory::Instance().AddToLowPrecisionKernelList("{self.api}", kernel_data_type);
@@ -208,8 +208,9 @@ class StringsAPI(ForwardAPI):
         return f"""
   // 1. Get kernel signature and kernel
   VLOG(6) << "{self.api} api strings kernel key: [" << kernel_backend << ", " << kernel_layout << ", "<< kernel_data_type << "]";
-  auto kernel_result = phi::KernelFactory::Instance().SelectKernelOrThrowError(
-      "{self.kernel['func'][0]}", {{kernel_backend, kernel_layout, kernel_data_type}});
+  static phi::KernelDispatchCache kernel_dispatch_cache("{self.kernel['func'][0]}");
+  auto kernel_result = kernel_dispatch_cache.SelectKernelOrThrowError(
+      {{kernel_backend, kernel_layout, kernel_data_type}});
   if (FLAGS_low_precision_op_list) {{
     phi::KernelFactory::Instance().AddToLowPrecisionKernelList("{self.api}", kernel_data_type);
   }}
@@ -73,6 +73,7 @@ void CustomKernelMap::RegisterCustomKernels() {
               << "] to Paddle. It will be used like native ones.";
     }
   }
+  KernelFactory::Instance().InvalidateDispatchCaches();
   LOG(INFO) << "Successed in loading " << kernels_.size()
             << " custom kernel(s) from loaded lib(s), will be "
             << "used like native ones.";
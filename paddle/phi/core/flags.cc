@@ -867,6 +867,21 @@ PHI_DEFINE_EXPORTED_bool(graph_metapath_split_opt,
                          "It controls whether load graph node and edge with "
                          "mutli threads parallely.");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_edges_to_csr
+ * Since Version: 2.5.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_graph_edges_to_csr=true would pack the edges of GraphTable
+ *          into csr snapshots after load_edges.
+ * Note: The GraphNode objects are released after packing, and neighbor
+ *       sampling reads the csr snapshots directly.
+ */
+PHI_DEFINE_EXPORTED_bool(graph_edges_to_csr,
+                         false,
+                         "It controls whether pack graph edges into csr "
+                         "snapshots after loading.");
+
 /**
  * Distributed related FLAG
  * Name: FLAGS_graph_get_neighbor_id
@@ -1119,6 +1134,60 @@ PHI_DEFINE_EXPORTED_bool(gpugraph_debug_gpu_memory,
 PHI_DEFINE_EXPORTED_bool(nccl_blocking_wait, false, "nccl blocking wait");
 #endif
 
+/**
+ * EagerReducer related FLAG
+ * Name: FLAGS_gloo_reducer_compress_dtype
+ * Since Version: 2.5.0
+ * Value Range: string, {"", float16, bfloat16}, default=""
+ * Example: FLAGS_gloo_reducer_compress_dtype=bfloat16 would allreduce the
+ * float32 gradient buckets of CPU data parallel training in bfloat16.
+ * Note: Halves the bytes sent by ProcessGroupGloo at the cost of precision.
+ */
+PHI_DEFINE_EXPORTED_string(gloo_reducer_compress_dtype,
+                           "",
+                           "Compress float32 gradient buckets to this dtype "
+                           "before the Gloo allreduce of EagerReducer.");
+
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: FLAGS_gloo_allreduce_algo
+ * Since Version: 2.5.0
+ * Value Range: string, {auto, ring, bcube, halving_doubling}, default=auto
+ * Example: FLAGS_gloo_allreduce_algo=ring would run every allreduce of the
+ * Gloo process groups created afterwards with the ring algorithm.
+ * Note: auto picks the algorithm by message size, see the two flags below.
+ */
+PHI_DEFINE_EXPORTED_string(gloo_allreduce_algo,
+                           "auto",
+                           "Allreduce algorithm of ProcessGroupGloo, one of "
+                           "auto, ring, bcube and halving_doubling.");
+
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: FLAGS_gloo_allreduce_small_bytes
+ * Since Version: 2.5.0
+ * Value Range: int64, default=65536
+ * Note: With FLAGS_gloo_allreduce_algo=auto, messages up to this size use
+ * bcube, which needs the fewest rounds.
+ */
+PHI_DEFINE_EXPORTED_int64(gloo_allreduce_small_bytes,
+                          64 << 10,
+                          "Largest message reduced with bcube in auto mode.");
+
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: FLAGS_gloo_allreduce_large_bytes
+ * Since Version: 2.5.0
+ * Value Range: int64, default=4194304
+ * Note: With FLAGS_gloo_allreduce_algo=auto, messages up to this size use
+ * recursive halving-doubling and larger ones use ring, whose pipelined
+ * chunks make the best use of the bandwidth.
+ */
+PHI_DEFINE_EXPORTED_int64(gloo_allreduce_large_bytes,
+                          4 << 20,
+                          "Largest message reduced with halving-doubling in "
+                          "auto mode.");
+
 /**
  * Autotune related FLAG
  * Name: FLAGS_use_autotune
@@ -1153,6 +1222,35 @@ PHI_DEFINE_EXPORTED_bool(
     false,
     "EinsumOp backward will be speedup at the expense of more gpu memory.");
 
+/**
+ * Eager backward related FLAG
+ * Name: FLAGS_eager_backward_num_threads
+ * Since Version: 2.5.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_eager_backward_num_threads=4 would run the independent
+ * branches of a CPU backward graph on 4 threads.
+ * Note: Gradients are still summed in a fixed order, so the results don't
+ * depend on the number of threads. Higher order grad, paddle.grad and GPU
+ * backward always run sequentially.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_backward_num_threads,
+                          1,
+                          "Number of threads running the grad nodes of a "
+                          "CPU backward pass in eager mode.");
+
+/**
+ * Eager related FLAG
+ * Name: FLAGS_eager_grad_node_pool
+ * Since Version: 2.5.0
+ * Value Range: bool, default=true
+ * Example:
+ * Note: Whether to recycle the memory of freed grad nodes and
+ * GradTensorHolders in a per thread cache instead of returning it to malloc.
+ */
+PHI_DEFINE_EXPORTED_bool(eager_grad_node_pool,
+                         true,
+                         "Recycle the memory of eager grad nodes.");
+
 /**
  * JitLayer related FLAG
  * Name: FLAGS_jit_engine_type
@@ -280,6 +280,45 @@ KernelResult KernelFactory::SelectKernelOrThrowError(
   return {kernel_iter->second, false};
 }
 
+// The flags that SelectKernelOrThrowError depends on.
+static int KernelSelectionFlags() {
+  int flags = FLAGS_enable_api_kernel_fallback ? 1 : 0;
+#if defined(PADDLE_WITH_XPU_KP)
+  flags |= FLAGS_run_kp_kernel ? 2 : 0;
+#endif
+  return flags;
+}
+
+KernelResult KernelDispatchCache::SelectKernelOrThrowError(
+    const KernelKey& kernel_key) {
+  auto& factory = KernelFactory::Instance();
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t kernels_version = factory.KernelsVersion();
+  const int flags = KernelSelectionFlags();
+  if (kernels_version != kernels_version_ || flags != flags_) {
+    kernels_version_ = kernels_version;
+    flags_ = flags;
+    size_ = 0;
+    next_ = 0;
+  }
+  for (int i = 0; i < size_; ++i) {
+    if (entries_[i].kernel_key == kernel_key) {
+      return {*entries_[i].kernel, entries_[i].has_fallback_cpu};
+    }
+  }
+
+  auto result = factory.SelectKernelOrThrowError(kernel_name_, kernel_key);
+  Entry& entry = entries_[next_];
+  entry.kernel_key = kernel_key;
+  entry.kernel = &result.kernel;
+  entry.has_fallback_cpu = result.has_fallback_cpu;
+  next_ = (next_ + 1) % kCapacity;
+  if (size_ < kCapacity) {
+    ++size_;
+  }
+  return result;
+}
+
 const KernelArgsDef& KernelFactory::GetFirstKernelArgsDef(
     const std::string& kernel_name) const {
   auto iter = kernels_.find(kernel_name);
@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <unordered_map>
@@ -342,15 +344,57 @@ class KernelFactory {
 
   void ClearLowPrecisionKernelList() { low_precision_kernels_.clear(); }
 
+  // Kernels live in hash maps and move when kernels are added, so whoever
+  // adds or removes kernels through kernels() calls this to drop the
+  // kernels remembered by the KernelDispatchCaches.
+  void InvalidateDispatchCaches() { kernels_version_++; }
+
+  uint64_t KernelsVersion() const { return kernels_version_.load(); }
+
  private:
   KernelFactory() = default;
 
   KernelNameMap kernels_;
 
+  std::atomic<uint64_t> kernels_version_{0};
+
   // Get the low precision kernel list of current module.
   std::map<const std::string, OpCount> low_precision_kernels_;
 };
 
+/**
+ * Note: A KernelDispatchCache remembers the kernels selected by
+ *       SelectKernelOrThrowError for one kernel name, so that a call site
+ *       that runs the same kernel again and again, like an API, skips the
+ *       lookups by name and by key. It is kept as a static of the call site,
+ *       and holds the last few kernel keys, which are dropped when kernels
+ *       are registered or the fallback flags change.
+ */
+class KernelDispatchCache {
+ public:
+  explicit KernelDispatchCache(const char* kernel_name)
+      : kernel_name_(kernel_name) {}
+
+  KernelResult SelectKernelOrThrowError(const KernelKey& kernel_key);
+
+ private:
+  static constexpr int kCapacity = 4;
+
+  struct Entry {
+    KernelKey kernel_key;
+    const Kernel* kernel = nullptr;
+    bool has_fallback_cpu = false;
+  };
+
+  const std::string kernel_name_;
+  std::mutex mutex_;
+  uint64_t kernels_version_{0};
+  int flags_{0};
+  int size_{0};
+  int next_{0};
+  Entry entries_[kCapacity];
+};
+
 inline std::ostream& operator<<(std::ostream& os, const KernelKey& kernel_key) {
   os << "(" << kernel_key.backend() << ", " << kernel_key.layout() << ", "
      << kernel_key.dtype() << ")";
@@ -31,5 +31,13 @@ void CreateLikeInferMeta(const MetaTensor& x, MetaTensor* out) {
   out->set_layout(x.layout());
 }
 
+void SplitInferMeta(const MetaTensor& x, MetaTensor* out) {
+  auto dims = phi::vectorize(x.dims());
+  dims.push_back(-1);
+  out->set_dims(phi::make_ddim(dims));
+  out->set_dtype(x.dtype());
+  out->set_layout(x.layout());
+}
+
 }  // namespace strings
 }  // namespace phi
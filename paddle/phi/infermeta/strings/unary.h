@@ -27,5 +27,9 @@ void UnchangedInferMeta(const StringTensorMeta& x_meta, MetaTensor* out);
 
 void CreateLikeInferMeta(const MetaTensor& x, MetaTensor* out);
 
+// The tokens of every string of x, in a new last dimension, whose size is
+// known when the kernel runs.
+void SplitInferMeta(const MetaTensor& x, MetaTensor* out);
+
 }  // namespace strings
 }  // namespace phi
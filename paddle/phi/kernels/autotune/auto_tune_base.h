@@ -14,9 +14,18 @@
 
 #pragma once
 
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <type_traits>
+#include <vector>
+
 #include "glog/logging.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/autotune/cpu_timer.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 #include "paddle/phi/kernels/autotune/gpu_timer.h"
+#endif
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
 
 namespace phi {
@@ -78,8 +87,10 @@ class AutoTuneBase {
       if (use_autotune) {
         // All avaliable kernels have ran while picking the best kernel,
         // so there may be no need for another kernel run.
-        auto best_idx = PickBestKernel(ctx, args...);
+        std::vector<float> times;
+        auto best_idx = PickBestKernel(ctx, &times, args...);
         cache.Set(key, best_idx);
+        AutoTuneCache::Instance().AddTuningRecord(algo, key, times, best_idx);
       } else {
         kernels_[0].Run(args...);
       }
@@ -99,15 +110,21 @@ class AutoTuneBase {
             "kernel num must be greater than 0, now is %d", kernels_.size()));
   }
 
+  // Returns the index of the fastest kernel, and the time cost of every
+  // kernel in times.
   template <typename Context, typename... Args>
-  size_t PickBestKernel(const Context& ctx, Args&&... args) {
+  size_t PickBestKernel(const Context& ctx,
+                        std::vector<float>* times,
+                        Args&&... args) {
     std::lock_guard<std::mutex> lock(mutex_);
     size_t best_idx = 0;
     float min_time = std::numeric_limits<float>::max();
 
     // Time cost test estabulished in default stream.
+    times->clear();
     for (int i = 0; i < kernels_.size(); ++i) {
-      auto time = RunAndMeasureKernel<Context>(ctx, i, args...);
+      auto time = RunAndMeasureKernel(ctx, i, args...);
+      times->push_back(time);
       if (time < min_time) {
         min_time = time;
         best_idx = i;
@@ -117,6 +134,7 @@ class AutoTuneBase {
     return best_idx;
   }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   template <typename Context, typename... Args>
   float RunAndMeasureKernel(const Context& ctx, const int idx, Args&&... args) {
     // Regard 1st run as warmup, judge the compare result by the time cost
@@ -139,6 +157,30 @@ class AutoTuneBase {
     }
     return time_cost;
   }
+#endif
+
+  // Host kernels take longer than device ones and are timed as they run,
+  // so fewer cycles are enough.
+  template <typename... Args>
+  float RunAndMeasureKernel(const phi::CPUContext& ctx,
+                            const int idx,
+                            Args&&... args) {
+    constexpr int repeats = 6;
+    phi::CpuTimer timer;
+    float time_cost = 0;
+
+    for (int i = 0; i < repeats; ++i) {
+      timer.Start();
+      kernels_[idx].Run(args...);
+      timer.Stop();
+      auto time = timer.ElapsedTime();
+      if (i > 0) {
+        time_cost += time;
+      }
+      VLOG(3) << "kernel[" << idx << "][" << i << "th time cost is " << time;
+    }
+    return time_cost;
+  }
 };
 
 template <typename T, typename ReturnType, typename... Args>
@@ -168,8 +210,11 @@ class MatmulAutoTuner
     } else {
       bool use_autotune = AutoTuneStatus::Instance().UseAutoTune();
       if (use_autotune) {
-        auto best_idx = this->PickBestKernel(ctx, args...);
+        std::vector<float> times;
+        auto best_idx = this->PickBestKernel(ctx, &times, args...);
         cache.Set(key, best_idx);
+        AutoTuneCache::Instance().AddTuningRecord(
+            AlgorithmType::kMatmul, key, times, best_idx);
       } else {
         this->kernels_[0].Run(args...);
       }
@@ -177,6 +222,7 @@ class MatmulAutoTuner
   }
 };
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 template <bool TransposeA,
           bool TransposeB,
           typename T,
@@ -284,6 +330,7 @@ MakeGatherGemmScatterTuner(ReturnType (*func)(T, T, Args...)) {
                                     ReturnType,
                                     Args...>::Instance(func);
 }
+#endif
 
 // Define the auto_tuner inital object.
 #define DEFINE_AUTOTUNER_COMMON_OBJ(name)                                \
@@ -14,7 +14,12 @@
 
 #include "paddle/phi/kernels/autotune/cache.h"
 
+#include <fstream>
 #include <iomanip>
+#include <sstream>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "glog/logging.h"
 
@@ -37,6 +42,13 @@ std::string AlgorithmTypeString(int64_t algo_type) {
   } else if (algo_type ==
              static_cast<int64_t>(AlgorithmType::kConvBackwardFilter)) {
     return "conv_backward_filter";
+  } else if (algo_type == static_cast<int64_t>(AlgorithmType::kTranspose)) {
+    return "transpose";
+  } else if (algo_type == static_cast<int64_t>(AlgorithmType::kMatmul)) {
+    return "matmul";
+  } else if (algo_type ==
+             static_cast<int64_t>(AlgorithmType::kTransposeCPU)) {
+    return "transpose_cpu";
   }
 #ifdef PADDLE_WITH_CUDNN_FRONTEND
   if (algo_type == static_cast<int64_t>(AlgorithmType::kConvForwardV8)) {
@@ -101,5 +113,202 @@ void AutoTuneCache::UpdateStatus() {
   total_cache_misses_ = cache_misses;
 }
 
+static constexpr char kCacheFileHeader[] = "paddle_autotune_cache";
+static constexpr int kCacheFileVersion = 1;
+
+template <typename T>
+static void WriteVector(std::ostream& os, const std::vector<T>& vec) {
+  os << " " << vec.size();
+  for (const auto& v : vec) {
+    os << " " << v;
+  }
+}
+
+template <typename T>
+static bool ReadVector(std::istream& is, std::vector<T>* vec) {
+  size_t size = 0;
+  if (!(is >> size)) return false;
+  vec->resize(size);
+  for (auto& v : *vec) {
+    if (!(is >> v)) return false;
+  }
+  return true;
+}
+
+// The file holds a line per cached algorithm:
+//   algo <algo type> <key> <algorithm>
+//   matmul <key> <algorithm>
+//   conv <algo type> <algorithm> <workspace size> <exhaustive search>
+//        <dtype> <groups> <data layout> <x dims> <w dims> <strides>
+//        <paddings> <dilations>
+// where every dims is its size followed by its elements.
+void AutoTuneCache::Save(const std::string& path) {
+  std::ofstream fout(path);
+  PADDLE_ENFORCE_EQ(
+      fout.is_open(),
+      true,
+      phi::errors::Unavailable(
+          "Failed to open %s to save the auto-tuning cache.", path));
+  fout << kCacheFileHeader << " " << kCacheFileVersion << "\n";
+  for (auto& v : auto_tune_map_) {
+    for (const auto& item : v.second.Items()) {
+      fout << "algo " << v.first << " " << item.first << " " << item.second
+           << "\n";
+    }
+  }
+  for (const auto& item : matmul_auto_tune_map_.Items()) {
+    fout << "matmul " << item.first << " " << item.second << "\n";
+  }
+  for (auto& v : conv_auto_tune_map_) {
+    for (const auto& item : v.second.Items()) {
+      const ConvCacheKey& key = item.first;
+      const ConvAutoTuneResult& result = item.second;
+      fout << "conv " << v.first << " " << result.algo << " "
+           << result.workspace_size << " " << result.exhaustive_search << " "
+           << static_cast<int>(key.dtype) << " " << key.groups << " "
+           << key.data_layout;
+      WriteVector(fout, key.x_dims);
+      WriteVector(fout, key.w_dims);
+      WriteVector(fout, key.strides);
+      WriteVector(fout, key.paddings);
+      WriteVector(fout, key.dilations);
+      fout << "\n";
+    }
+  }
+  PADDLE_ENFORCE_EQ(
+      fout.good(),
+      true,
+      phi::errors::Unavailable(
+          "Failed to write the auto-tuning cache to %s.", path));
+  VLOG(3) << "Saved the auto-tuning cache to " << path;
+}
+
+void AutoTuneCache::Load(const std::string& path) {
+  std::ifstream fin(path);
+  PADDLE_ENFORCE_EQ(
+      fin.is_open(),
+      true,
+      phi::errors::NotFound("The auto-tuning cache file %s is not found.",
+                            path));
+  std::string header;
+  int version = 0;
+  fin >> header >> version;
+  PADDLE_ENFORCE_EQ(
+      header == kCacheFileHeader && version == kCacheFileVersion,
+      true,
+      phi::errors::InvalidArgument(
+          "%s is not an auto-tuning cache file of version %d.",
+          path,
+          kCacheFileVersion));
+
+  // The whole file is parsed before any entry is merged, so that an invalid
+  // file leaves the cache as it was.
+  std::vector<std::tuple<int64_t, size_t, int64_t>> algo_entries;
+  std::vector<std::pair<size_t, int64_t>> matmul_entries;
+  std::vector<std::tuple<int64_t, ConvCacheKey, ConvAutoTuneResult>>
+      conv_entries;
+  std::string line;
+  std::getline(fin, line);
+  int64_t line_no = 1;
+  while (std::getline(fin, line)) {
+    ++line_no;
+    if (line.empty()) continue;
+    std::istringstream is(line);
+    std::string tag;
+    is >> tag;
+    bool valid = false;
+    if (tag == "algo") {
+      int64_t algo_type = 0;
+      size_t key = 0;
+      int64_t algo = 0;
+      valid = static_cast<bool>(is >> algo_type >> key >> algo) &&
+              auto_tune_map_.count(algo_type) > 0;
+      if (valid) {
+        algo_entries.emplace_back(algo_type, key, algo);
+      }
+    } else if (tag == "matmul") {
+      size_t key = 0;
+      int64_t algo = 0;
+      valid = static_cast<bool>(is >> key >> algo);
+      if (valid) {
+        matmul_entries.emplace_back(key, algo);
+      }
+    } else if (tag == "conv") {
+      int64_t algo_type = 0;
+      ConvAutoTuneResult result;
+      int dtype = 0;
+      ConvCacheKey key;
+      valid = static_cast<bool>(is >> algo_type >> result.algo >>
+                                result.workspace_size >>
+                                result.exhaustive_search >> dtype >>
+                                key.groups >> key.data_layout) &&
+              ReadVector(is, &key.x_dims) && ReadVector(is, &key.w_dims) &&
+              ReadVector(is, &key.strides) && ReadVector(is, &key.paddings) &&
+              ReadVector(is, &key.dilations) &&
+              conv_auto_tune_map_.count(algo_type) > 0;
+      if (valid) {
+        key.dtype = static_cast<phi::DataType>(dtype);
+        conv_entries.emplace_back(algo_type, key, result);
+      }
+    }
+    PADDLE_ENFORCE_EQ(valid,
+                      true,
+                      phi::errors::InvalidArgument(
+                          "Line %d of the auto-tuning cache file %s is "
+                          "invalid: %s",
+                          line_no,
+                          path,
+                          line));
+  }
+
+  for (const auto& entry : algo_entries) {
+    auto_tune_map_[std::get<0>(entry)].Set(std::get<1>(entry),
+                                           std::get<2>(entry));
+  }
+  for (const auto& entry : matmul_entries) {
+    matmul_auto_tune_map_.Set(entry.first, entry.second);
+  }
+  for (const auto& entry : conv_entries) {
+    conv_auto_tune_map_[std::get<0>(entry)].Set(std::get<1>(entry),
+                                                std::get<2>(entry));
+  }
+  VLOG(3) << "Loaded the auto-tuning cache from " << path;
+}
+
+void AutoTuneCache::AddTuningRecord(const AlgorithmType& algo_type,
+                                    size_t key,
+                                    const std::vector<float>& times,
+                                    size_t best_idx) {
+  std::lock_guard<std::mutex> lock(*autotune_cache_mutex_);
+  tuning_records_.push_back(
+      TuningRecord{static_cast<int64_t>(algo_type), key, times, best_idx});
+}
+
+void AutoTuneCache::DescribeKey(size_t key, const std::string& description) {
+  std::lock_guard<std::mutex> lock(*autotune_cache_mutex_);
+  key_descriptions_[key] = description;
+}
+
+std::string AutoTuneCache::TuningReport() {
+  std::lock_guard<std::mutex> lock(*autotune_cache_mutex_);
+  std::ostringstream os;
+  os << std::setprecision(4);
+  for (const auto& record : tuning_records_) {
+    os << AlgorithmTypeString(record.algo_type) << " ";
+    auto it = key_descriptions_.find(record.key);
+    if (it != key_descriptions_.end()) {
+      os << it->second;
+    } else {
+      os << "key " << record.key;
+    }
+    os << ": best kernel " << record.best_idx << ", time cost of kernels";
+    for (float time : record.times) {
+      os << " " << time;
+    }
+    os << " ms\n";
+  }
+  return os.str();
+}
+
 }  // namespace autotune
 }  // namespace phi
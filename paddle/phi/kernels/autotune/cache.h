@@ -16,6 +16,8 @@
 
 #include <algorithm>
 #include <numeric>
+#include <string>
+#include <vector>
 
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/kernels/autotune/cache_base.h"
@@ -49,16 +51,26 @@ enum class AlgorithmType {
   kGatherGemmScatterFP32NN = 7,
   kGatherGemmScatterFP32TN = 8,
   kGatherGemmScatterFP32NT = 9,
+  kTransposeCPU = 10,
 #if !defined(PADDLE_WITH_CUDNN_FRONTEND)
-  kAlgorithmCount = 10
+  kAlgorithmCount = 11
 #else
-  kConvForwardV8 = 10,
-  kConvBackwardDataV8 = 11,
-  kConvBackwardFilterV8 = 12,
-  kAlgorithmCount = 13
+  kConvForwardV8 = 11,
+  kConvBackwardDataV8 = 12,
+  kConvBackwardFilterV8 = 13,
+  kAlgorithmCount = 14
 #endif
 };
 
+// How a shape was tuned: the time cost of every candidate kernel, in ms,
+// and the index of the fastest one.
+struct TuningRecord {
+  int64_t algo_type;
+  size_t key;
+  std::vector<float> times;
+  size_t best_idx;
+};
+
 // AlgorithmsConfigKey -> AlgorithmsID
 // AlgorithmType -> AlgorithmsCache
 using AlgorithmsCacheMap = AlgorithmsCache<size_t, int64_t>;
@@ -126,6 +138,12 @@ class AutoTuneCache {
 #endif
 
   void Clean() {
+    {
+      std::lock_guard<std::mutex> lock(*autotune_cache_mutex_);
+      tuning_records_.clear();
+      key_descriptions_.clear();
+    }
+
     for (auto& v : auto_tune_map_) {
       v.second.Clean();
     }
@@ -143,6 +161,27 @@ class AutoTuneCache {
 
   void UpdateStatus();
 
+  // Writes the tuned algorithms to a file, and merges the ones of such a
+  // file into the cache, so that a process can start with the results of
+  // an earlier tuning. Keys are hashes of the shapes and the algorithms are
+  // indexes of the kernels of every tuner, so a file only fits the build
+  // and the machine that saved it. Enabling auto-tuning cleans the cache,
+  // so load after that. cuDNN frontend plans are not saved.
+  void Save(const std::string& path);
+  void Load(const std::string& path);
+
+  void AddTuningRecord(const AlgorithmType& algo_type,
+                       size_t key,
+                       const std::vector<float>& times,
+                       size_t best_idx);
+
+  // Gives a readable shape to the key of a tuning, for TuningReport.
+  void DescribeKey(size_t key, const std::string& description);
+
+  // A line per tuned shape, with the time cost of every candidate and the
+  // winner.
+  std::string TuningReport();
+
   // The number of total config cached
   int64_t Size() const { return total_size_; }
 
@@ -202,6 +241,8 @@ class AutoTuneCache {
 #ifdef PADDLE_WITH_CUDNN_FRONTEND
   CudnnV8AlgorithmsTypeMap cudnn_v8_auto_tune_map_;
 #endif
+  std::vector<TuningRecord> tuning_records_;
+  std::unordered_map<size_t, std::string> key_descriptions_;
   std::shared_ptr<std::mutex> autotune_cache_mutex_;
   int64_t total_cache_hits_{0};
   int64_t total_cache_misses_{0};
@@ -14,9 +14,12 @@
 
 #include "paddle/phi/kernels/embedding_grad_kernel.h"
 
+#include <utility>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/embedding_pool.h"
 #include "paddle/phi/kernels/funcs/embedding_util.h"
 
 namespace phi {
@@ -63,32 +66,43 @@ struct EmbeddingGradCPUFunctor {
         if (padding_idx_ != kNoPadding && ids_data[i] == padding_idx_) {
           // the gradient of padding_idx should be 0, already done by memset, so
           // do nothing.
-        } else {
-          PADDLE_ENFORCE_LT(
-              ids_data[i],
-              N,
-              phi::errors::InvalidArgument(
-                  "Variable value (input) of "
-                  "OP(paddle.nn.functional.embedding) "
-                  "expected >= 0 and < %ld, but got %ld. Please check input "
-                  "value.",
-                  N,
-                  ids_data[i]));
-          PADDLE_ENFORCE_GE(
-              ids_data[i],
-              0,
-              phi::errors::InvalidArgument(
-                  "Variable value (input) of "
-                  "OP(paddle.nn.functional.embedding) "
-                  "expected >= 0 and < %ld, but got %ld. Please check input "
-                  "value.",
-                  N,
-                  ids_data[i]));
-          for (int j = 0; j < D; ++j) {
-            d_table_data[ids_data[i] * D + j] += d_output_data[i * D + j];
-          }
+          continue;
         }
+        PADDLE_ENFORCE_LT(
+            ids_data[i],
+            N,
+            phi::errors::InvalidArgument(
+                "Variable value (input) of "
+                "OP(paddle.nn.functional.embedding) "
+                "expected >= 0 and < %ld, but got %ld. Please check input "
+                "value.",
+                N,
+                ids_data[i]));
+        PADDLE_ENFORCE_GE(
+            ids_data[i],
+            0,
+            phi::errors::InvalidArgument(
+                "Variable value (input) of "
+                "OP(paddle.nn.functional.embedding) "
+                "expected >= 0 and < %ld, but got %ld. Please check input "
+                "value.",
+                N,
+                ids_data[i]));
       }
+
+      // the lookups of every id are summed into its row by a single thread,
+      // so the rows are updated in parallel without conflicts
+      funcs::EmbeddingIdGroups groups =
+          funcs::GroupEmbeddingIds(ids_data, ids_num, N, padding_idx_);
+      funcs::SumEmbeddingGrads(
+          groups,
+          D,
+          true,
+          [&](int64_t i) {
+            return std::pair<const T*, T>(d_output_data + i * D,
+                                          static_cast<T>(1));
+          },
+          d_table_data);
     }
   }
 
@@ -18,6 +18,7 @@
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/utils/data_type.h"
+#include "paddle/phi/kernels/funcs/embedding_pool.h"
 #include "paddle/phi/kernels/funcs/embedding_util.h"
 
 namespace phi {
@@ -48,32 +49,40 @@ struct EmbeddingCPUFunctor {
     dev_ctx_.template Alloc<T>(out_);
     auto* output = out_->data<T>();
 
+    // ids are checked before the parallel loop, which can't throw
+    for (int64_t i = 0; i < ids_numel; ++i) {
+      if (padding_idx_ != kNoPadding && ids[i] == padding_idx_) continue;
+      PADDLE_ENFORCE_LT(
+          ids[i],
+          row_number,
+          phi::errors::InvalidArgument(
+              "Variable value (input) of OP(fluid.layers.embedding) "
+              "expected >= 0 and < %ld, but got %ld. Please check input "
+              "value.",
+              row_number,
+              ids[i]));
+      PADDLE_ENFORCE_GE(
+          ids[i],
+          0,
+          phi::errors::InvalidArgument(
+              "Variable value (input) of OP(fluid.layers.embedding) "
+              "expected >= 0 and < %ld, but got %ld. Please check input "
+              "value.",
+              row_number,
+              ids[i]));
+    }
+
 #if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
 #pragma omp parallel for
 #endif
-
     for (int64_t i = 0; i < ids_numel; ++i) {
+      const int64_t ahead = i + funcs::kEmbeddingPrefetchDistance;
+      if (ahead < ids_numel && ids[ahead] != padding_idx_) {
+        funcs::PrefetchRow(table + ids[ahead] * row_width, row_width);
+      }
       if (padding_idx_ != kNoPadding && ids[i] == padding_idx_) {
         memset(output + i * row_width, 0, row_width * sizeof(T));
       } else {
-        PADDLE_ENFORCE_LT(
-            ids[i],
-            row_number,
-            phi::errors::InvalidArgument(
-                "Variable value (input) of OP(fluid.layers.embedding) "
-                "expected >= 0 and < %ld, but got %ld. Please check input "
-                "value.",
-                row_number,
-                ids[i]));
-        PADDLE_ENFORCE_GE(
-            ids[i],
-            0,
-            phi::errors::InvalidArgument(
-                "Variable value (input) of OP(fluid.layers.embedding) "
-                "expected >= 0 and < %ld, but got %ld. Please check input "
-                "value.",
-                row_number,
-                ids[i]));
         memcpy(output + i * row_width,
                table + ids[i] * row_width,
                row_width * sizeof(T));
@@ -14,15 +14,63 @@
 
 #include "paddle/phi/kernels/transpose_kernel.h"
 
+#include <sstream>
 #include <vector>
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/autotune/auto_tune_base.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
 namespace phi {
 
+template <typename T>
+void TransposeWithEigen(const CPUContext& ctx,
+                        const DenseTensor& x,
+                        const std::vector<int>& axis,
+                        DenseTensor* out) {
+  switch (axis.size()) {
+    case 1:
+      funcs::Transpose<CPUContext, T, 1> trans1;
+      trans1(ctx, x, out, axis);
+      break;
+    case 2:
+      funcs::Transpose<CPUContext, T, 2> trans2;
+      trans2(ctx, x, out, axis);
+      break;
+    case 3:
+      funcs::Transpose<CPUContext, T, 3> trans3;
+      trans3(ctx, x, out, axis);
+      break;
+    case 4:
+      funcs::Transpose<CPUContext, T, 4> trans4;
+      trans4(ctx, x, out, axis);
+      break;
+    case 5:
+      funcs::Transpose<CPUContext, T, 5> trans5;
+      trans5(ctx, x, out, axis);
+      break;
+    case 6:
+      funcs::Transpose<CPUContext, T, 6> trans6;
+      trans6(ctx, x, out, axis);
+      break;
+    default:
+      // for rank >= 7 situation
+      funcs::TransposeNormal<CPUContext, T> trans_normal;
+      trans_normal(ctx, x, out, axis);
+  }
+}
+
+template <typename T>
+void TransposeWithIndex(const CPUContext& ctx,
+                        const DenseTensor& x,
+                        const std::vector<int>& axis,
+                        DenseTensor* out) {
+  funcs::TransposeNormal<CPUContext, T> trans_normal;
+  trans_normal(ctx, x, out, axis);
+}
+
 template <typename T, typename Context>
 void TransposeKernel(const Context& ctx,
                      const DenseTensor& x,
@@ -41,39 +89,40 @@ void TransposeKernel(const Context& ctx,
     return;
   }
   int rank = formated_axis.size();
-  switch (rank) {
-    case 0:
-      phi::Copy<Context>(ctx, x, ctx.GetPlace(), false, out);
-      break;
-    case 1:
-      funcs::Transpose<Context, T, 1> trans1;
-      trans1(ctx, x, out, formated_axis);
-      break;
-    case 2:
-      funcs::Transpose<Context, T, 2> trans2;
-      trans2(ctx, x, out, formated_axis);
-      break;
-    case 3:
-      funcs::Transpose<Context, T, 3> trans3;
-      trans3(ctx, x, out, formated_axis);
-      break;
-    case 4:
-      funcs::Transpose<Context, T, 4> trans4;
-      trans4(ctx, x, out, formated_axis);
-      break;
-    case 5:
-      funcs::Transpose<Context, T, 5> trans5;
-      trans5(ctx, x, out, formated_axis);
-      break;
-    case 6:
-      funcs::Transpose<Context, T, 6> trans6;
-      trans6(ctx, x, out, formated_axis);
-      break;
-    default:
-      // for rank >= 7 situation
-      funcs::TransposeNormal<Context, T> trans_normal;
-      trans_normal(ctx, x, out, formated_axis);
+  if (rank == 0) {
+    phi::Copy<Context>(ctx, x, ctx.GetPlace(), false, out);
+    return;
+  }
+
+  // Eigen is the default, an index computing loop may be faster for some
+  // shapes. The cache is only looked up while tuning, or once it holds
+  // tuned or loaded shapes, so untuned runs pay nothing for it.
+  auto& status = autotune::AutoTuneStatus::Instance();
+  auto& cache = autotune::AutoTuneCache::Instance().Get(
+      autotune::AlgorithmType::kTransposeCPU);
+  if (rank > 6 || (!status.UseAutoTune() && cache.Size() == 0)) {
+    TransposeWithEigen<T>(ctx, x, formated_axis, out);
+    return;
+  }
+
+  auto* tuner = autotune::MakeTransposeTuner<T>(TransposeWithEigen<T>);
+  tuner->AddCallBack(TransposeWithIndex<T>);
+  size_t key = autotune::TransposeKey(
+      phi::vectorize(x.dims()), formated_axis, x.dtype());
+  if (status.UseAutoTune()) {
+    std::ostringstream description;
+    description << "x [" << x.dims() << "] axis ["
+                << phi::make_ddim(formated_axis) << "] "
+                << DataTypeToString(x.dtype());
+    autotune::AutoTuneCache::Instance().DescribeKey(key, description.str());
   }
+  tuner->Run(ctx,
+             autotune::AlgorithmType::kTransposeCPU,
+             key,
+             ctx,
+             x,
+             formated_axis,
+             out);
 }
 
 }  // namespace phi
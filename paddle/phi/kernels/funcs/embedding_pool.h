@@ -0,0 +1,225 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/errors.h"
+#include "paddle/phi/kernels/funcs/prefetch.h"
+
+namespace phi {
+namespace funcs {
+
+enum class EmbeddingPoolType { kSum, kMean, kSqrtN };
+
+inline EmbeddingPoolType StringToEmbeddingPoolType(
+    const std::string& combiner) {
+  if (combiner == "sum") {
+    return EmbeddingPoolType::kSum;
+  } else if (combiner == "mean") {
+    return EmbeddingPoolType::kMean;
+  } else if (combiner == "sqrtn") {
+    return EmbeddingPoolType::kSqrtN;
+  }
+  PADDLE_THROW(phi::errors::InvalidArgument(
+      "The combiner of an embedding pooling should be one of sum, mean and "
+      "sqrtn, but got %s.",
+      combiner));
+}
+
+// The factor of the sum of count rows in a pooling.
+template <typename T>
+T EmbeddingPoolScale(EmbeddingPoolType type, int64_t count) {
+  if (type == EmbeddingPoolType::kSum || count == 0) {
+    return static_cast<T>(1);
+  } else if (type == EmbeddingPoolType::kMean) {
+    return static_cast<T>(1.0 / count);
+  }
+  return static_cast<T>(1.0 / std::sqrt(static_cast<double>(count)));
+}
+
+// Lookups ahead of the one being summed whose rows are prefetched, so that
+// the rows of a large table, which miss the caches, arrive in time.
+constexpr int64_t kEmbeddingPrefetchDistance = 4;
+
+template <typename IdT>
+void CheckEmbeddingIds(const IdT* ids,
+                       int64_t num,
+                       int64_t stride,
+                       int64_t height,
+                       int64_t padding_idx) {
+  for (int64_t j = 0; j < num; ++j) {
+    const int64_t id = ids[j * stride];
+    if (id == padding_idx) continue;
+    PADDLE_ENFORCE_EQ(
+        id >= 0 && id < height,
+        true,
+        phi::errors::InvalidArgument(
+            "The ids of an embedding lookup should be >= 0 and < %ld, but "
+            "got %ld.",
+            height,
+            id));
+  }
+}
+
+// One slot of a batched embedding lookup, i.e. a feature of a
+// recommendation model, with the table it looks up. The lookups of the
+// i-th sequence of the batch are the ids ids[j * ids_stride] for j in
+// [lod[i], lod[i + 1]), and they are pooled into out + i * out_stride.
+template <typename T, typename IdT>
+struct EmbeddingPoolSlot {
+  const T* table;
+  int64_t table_height;
+  const IdT* ids;
+  int64_t ids_stride;
+  const uint64_t* lod;
+  T* out;
+  int64_t out_stride;
+};
+
+// Looks up and pools every sequence of every slot in a single pass, rows of
+// width elements, skipping padding_idx. The (slot, sequence) pairs run in
+// parallel, and the rows of the next lookups are prefetched while one is
+// being summed.
+template <typename T, typename IdT>
+void EmbeddingPool(const std::vector<EmbeddingPoolSlot<T, IdT>>& slots,
+                   int64_t batch,
+                   int64_t width,
+                   int64_t padding_idx,
+                   EmbeddingPoolType type) {
+  // ids are checked before the parallel region, which can't throw
+  for (const auto& slot : slots) {
+    CheckEmbeddingIds(slot.ids + slot.lod[0] * slot.ids_stride,
+                      slot.lod[batch] - slot.lod[0],
+                      slot.ids_stride,
+                      slot.table_height,
+                      padding_idx);
+  }
+
+  const int64_t slots_num = slots.size();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for collapse(2) schedule(dynamic, 16)
+#endif
+  for (int64_t s = 0; s < slots_num; ++s) {
+    for (int64_t i = 0; i < batch; ++i) {
+      const T* table = slots[s].table;
+      const IdT* ids = slots[s].ids;
+      const int64_t stride = slots[s].ids_stride;
+      const int64_t begin = slots[s].lod[i];
+      const int64_t end = slots[s].lod[i + 1];
+      T* out = slots[s].out + i * slots[s].out_stride;
+      std::fill(out, out + width, static_cast<T>(0));
+
+      for (int64_t j = begin; j < end && j < begin + kEmbeddingPrefetchDistance;
+           ++j) {
+        if (ids[j * stride] != padding_idx) {
+          PrefetchRow(table + ids[j * stride] * width, width);
+        }
+      }
+      int64_t count = 0;
+      for (int64_t j = begin; j < end; ++j) {
+        const int64_t ahead = j + kEmbeddingPrefetchDistance;
+        if (ahead < end && ids[ahead * stride] != padding_idx) {
+          PrefetchRow(table + ids[ahead * stride] * width, width);
+        }
+        const int64_t id = ids[j * stride];
+        if (id == padding_idx) continue;
+        const T* row = table + id * width;
+        for (int64_t c = 0; c < width; ++c) {
+          out[c] += row[c];
+        }
+        ++count;
+      }
+
+      if (type != EmbeddingPoolType::kSum && count > 1) {
+        const T scale = EmbeddingPoolScale<T>(type, count);
+        for (int64_t c = 0; c < width; ++c) {
+          out[c] *= scale;
+        }
+      }
+    }
+  }
+}
+
+// The lookups of a list of ids grouped by id, padding_idx left out: the
+// k-th of rows is looked up at positions[offsets[k]], ...,
+// positions[offsets[k + 1] - 1], in order.
+struct EmbeddingIdGroups {
+  std::vector<int64_t> rows;
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> positions;
+};
+
+template <typename IdT>
+EmbeddingIdGroups GroupEmbeddingIds(const IdT* ids,
+                                    int64_t num,
+                                    int64_t height,
+                                    int64_t padding_idx) {
+  CheckEmbeddingIds(ids, num, 1, height, padding_idx);
+  EmbeddingIdGroups groups;
+  auto& positions = groups.positions;
+  positions.reserve(num);
+  for (int64_t j = 0; j < num; ++j) {
+    if (ids[j] != padding_idx) positions.push_back(j);
+  }
+  std::stable_sort(
+      positions.begin(), positions.end(), [&](int64_t a, int64_t b) {
+        return ids[a] < ids[b];
+      });
+
+  for (size_t k = 0; k < positions.size(); ++k) {
+    const int64_t id = ids[positions[k]];
+    if (k == 0 || id != groups.rows.back()) {
+      groups.rows.push_back(id);
+      groups.offsets.push_back(k);
+    }
+  }
+  groups.offsets.push_back(positions.size());
+  return groups;
+}
+
+// Sums the gradients of the lookups of every group into a row of out, the
+// row of its id if by_id, or the k-th row otherwise. grad(position) gives
+// the gradient of a lookup and its factor. Every row is written by a single
+// thread, so there are no conflicting updates of duplicate ids.
+template <typename T, typename GradFn>
+void SumEmbeddingGrads(const EmbeddingIdGroups& groups,
+                       int64_t width,
+                       bool by_id,
+                       GradFn grad,
+                       T* out) {
+  const int64_t num_rows = groups.rows.size();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+  for (int64_t k = 0; k < num_rows; ++k) {
+    T* dst = out + (by_id ? groups.rows[k] : k) * width;
+    std::fill(dst, dst + width, static_cast<T>(0));
+    for (int64_t p = groups.offsets[k]; p < groups.offsets[k + 1]; ++p) {
+      const std::pair<const T*, T> src = grad(groups.positions[p]);
+      for (int64_t c = 0; c < width; ++c) {
+        dst[c] += src.second * src.first[c];
+      }
+    }
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -14,6 +14,13 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/funcs/fc_functor.h"
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
 #include "paddle/phi/backends/all_context.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
 #include "paddle/phi/kernels/funcs/jit/kernels.h"
@@ -100,5 +107,165 @@ void FCFunctor<DeviceContext, T>::operator()(const DeviceContext& context,
 template class FCFunctor<CPUContext, float>;
 template class FCFunctor<CPUContext, double>;
 
+// The packed or dequantized int8 weights of fc, so that a weight is prepared
+// once instead of on every call. An entry is only used for the allocation
+// it was made from, and is dropped once that allocation is freed.
+template <typename V>
+class FCInt8WeightCache {
+ public:
+  static FCInt8WeightCache& Instance() {
+    static FCInt8WeightCache cache;
+    return cache;
+  }
+
+  template <typename Prepare>
+  std::shared_ptr<const std::vector<V>> Get(
+      const phi::DenseTensor& w,
+      const std::vector<float>& weight_scale,
+      Prepare prepare) {
+    const void* data = w.data();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(data);
+    if (it != entries_.end()) {
+      const Entry& entry = it->second;
+      if (entry.holder.lock() == w.Holder() && entry.dims == w.dims() &&
+          entry.weight_scale == weight_scale) {
+        return entry.weights;
+      }
+    }
+    for (auto iter = entries_.begin(); iter != entries_.end();) {
+      iter = iter->second.holder.expired() ? entries_.erase(iter) : ++iter;
+    }
+    auto weights = std::make_shared<std::vector<V>>();
+    prepare(weights.get());
+    entries_[data] = Entry{w.Holder(), w.dims(), weight_scale, weights};
+    return weights;
+  }
+
+ private:
+  struct Entry {
+    std::weak_ptr<phi::Allocation> holder;
+    DDim dims;
+    std::vector<float> weight_scale;
+    std::shared_ptr<const std::vector<V>> weights;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<const void*, Entry> entries_;
+};
+
+template <typename DeviceContext, typename T>
+void FCInt8Functor<DeviceContext, T>::operator()(
+    const DeviceContext& context,
+    const int M,
+    const int N,
+    const int K,
+    const T* X,
+    const phi::DenseTensor& W,
+    T* Y,
+    float input_scale,
+    const std::vector<float>& weight_scale,
+    const T* B,
+    bool relu) {
+  PADDLE_ENFORCE_EQ(
+      weight_scale.size() == 1 || weight_scale.size() == static_cast<size_t>(N),
+      true,
+      errors::InvalidArgument("The size of weight_scale should be 1 or the "
+                              "width of the weight (%d), but it is %d.",
+                              N,
+                              weight_scale.size()));
+  auto w_scale = [&](int j) {
+    return weight_scale.size() == 1 ? weight_scale[0] : weight_scale[j];
+  };
+
+  PADDLE_ENFORCE_EQ(
+      W.numel(),
+      static_cast<int64_t>(K) * N,
+      errors::InvalidArgument("The size of the int8 weight should be K * N "
+                              "(%d * %d), but it is %d.",
+                              K,
+                              N,
+                              W.numel()));
+  const int8_t* W_data = W.data<int8_t>();
+
+  if (input_scale <= 0.f) {
+    // weight only
+    auto W1 = FCInt8WeightCache<T>::Instance().Get(
+        W, weight_scale, [&](std::vector<T>* weights) {
+          weights->resize(static_cast<size_t>(K) * N);
+          T* W1_data = weights->data();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+          for (int i = 0; i < K; i++) {
+            for (int j = 0; j < N; j++) {
+              W1_data[i * N + j] =
+                  static_cast<T>(W_data[i * N + j] * w_scale(j) / 127.f);
+            }
+          }
+        });
+    FCFunctor<DeviceContext, T>()(context, M, N, K, X, W1->data(), Y, B, relu);
+    return;
+  }
+
+  // the scales are applied after the GEMM, so the packed weight only
+  // depends on W
+  auto packed_w = FCInt8WeightCache<int8_t>::Instance().Get(
+      W, {}, [&](std::vector<int8_t>* weights) {
+        weights->resize(phi::jit::int8_packed_weights_size(K, N));
+        phi::jit::pack_int8_weights(W_data, weights->data(), K, N);
+      });
+  const int8_t* packed_w_data = packed_w->data();
+
+  // x is quantized symmetrically and shifted by 128 into uint8
+  constexpr int kZeroPoint = 128;
+  phi::DenseTensor X1;
+  X1.Resize({M * K});
+  uint8_t* X1_data = context.template HostAlloc<uint8_t>(&X1);
+  const float x_factor = 127.f / input_scale;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < K; j++) {
+      const float q = std::round(static_cast<float>(X[i * K + j]) * x_factor);
+      X1_data[i * K + j] = static_cast<uint8_t>(
+          std::min(std::max(q, -127.f), 127.f) + kZeroPoint);
+    }
+  }
+
+  std::vector<T> scale(N);
+  for (int j = 0; j < N; j++) {
+    scale[j] = static_cast<T>(input_scale * w_scale(j) / (127.f * 127.f));
+  }
+
+  // rows are done by blocks, the kernel for a block is looked up outside of
+  // the parallel loop since the cache of the kernels is per thread
+  constexpr int kRowBlock = 16;
+  const int blocks = (M + kRowBlock - 1) / kRowBlock;
+  const int tail = M - (blocks - 1) * kRowBlock;
+  using Tuple = phi::jit::MatMulInt8Tuple<T>;
+  auto compute = phi::jit::KernelFuncs<Tuple, phi::CPUPlace>::Cache().At(
+      phi::jit::matmul_int8_attr_t(kRowBlock, N, K, kZeroPoint, relu));
+  auto compute_tail = phi::jit::KernelFuncs<Tuple, phi::CPUPlace>::Cache().At(
+      phi::jit::matmul_int8_attr_t(tail, N, K, kZeroPoint, relu));
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int b = 0; b < blocks; b++) {
+    const int rows = b + 1 < blocks ? kRowBlock : tail;
+    const phi::jit::matmul_int8_attr_t attr(rows, N, K, kZeroPoint, relu);
+    (b + 1 < blocks ? compute : compute_tail)(X1_data + b * kRowBlock * K,
+                                              packed_w_data,
+                                              scale.data(),
+                                              B,
+                                              Y + b * kRowBlock * N,
+                                              &attr);
+  }
+}
+
+template class FCInt8Functor<CPUContext, float>;
+template class FCInt8Functor<CPUContext, double>;
+
 }  // namespace funcs
 }  // namespace phi
@@ -15,8 +15,10 @@ limitations under the License. */
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "paddle/phi/backends/all_context.h"
+#include "paddle/phi/core/dense_tensor.h"
 
 namespace phi {
 namespace funcs {
@@ -36,5 +38,27 @@ class FCFunctor {
                   bool weight_pass = false);
 };
 
+// FC with the int8 weight (K x N) quantized by weight_scale, of size 1 or N,
+// as q = w * 127 / weight_scale. With input_scale > 0 X is quantized into
+// uint8 as well and the GEMM is done in int8, otherwise the weight is
+// dequantized and the GEMM is done in T. The packed or dequantized weight
+// is kept for the next calls with the same allocation of W, dims and
+// weight_scale until W is freed, so W must not be changed in place.
+template <typename DeviceContext, typename T>
+class FCInt8Functor {
+ public:
+  void operator()(const DeviceContext& context,
+                  const int M,
+                  const int N,
+                  const int K,
+                  const T* X,
+                  const phi::DenseTensor& W,
+                  T* Y,
+                  float input_scale,
+                  const std::vector<float>& weight_scale,
+                  const T* B = nullptr,
+                  bool relu = false);
+};
+
 }  // namespace funcs
 }  // namespace phi
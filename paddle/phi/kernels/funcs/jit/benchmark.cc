@@ -379,6 +379,53 @@ void BenchKernelMatMul() {
   }
 }
 
+// The int8 GEMM along with the float MatMul of the same sizes.
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelMatMulInt8() {
+  using T = typename KernelTuple::data_type;
+  for (int m : {1, 16, 128}) {
+    for (int nk : {256, 1024}) {
+      const int n = nk, k = nk;
+      phi::DenseTensor x, w, packed, scale, bias, y;
+      x.Resize({m * k});
+      w.Resize({k * n});
+      packed.Resize(
+          {static_cast<int64_t>(jit::int8_packed_weights_size(k, n))});
+      scale.Resize({n});
+      bias.Resize({n});
+      y.Resize({m * n});
+      uint8_t* x_data = x.mutable_data<uint8_t>(PlaceType());
+      int8_t* w_data = w.mutable_data<int8_t>(PlaceType());
+      std::mt19937 rng(100);
+      for (int i = 0; i < m * k; ++i) {
+        x_data[i] = static_cast<uint8_t>(rng());
+      }
+      for (int i = 0; i < k * n; ++i) {
+        w_data[i] = static_cast<int8_t>(rng());
+      }
+      int8_t* packed_data = packed.mutable_data<int8_t>(PlaceType());
+      jit::pack_int8_weights(w_data, packed_data, k, n);
+      RandomVec<T>(n, scale.mutable_data<T>(PlaceType()), 1e-4f, 1e-3f);
+      RandomVec<T>(n, bias.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      const T* scale_data = scale.data<T>();
+      const T* bias_data = bias.data<T>();
+      T* y_data = y.mutable_data<T>(PlaceType());
+      const jit::matmul_int8_attr_t attr(m, n, k, 128);
+      BenchAllImpls<KernelTuple, PlaceType>(
+          attr, x_data, packed_data, scale_data, bias_data, y_data, &attr);
+
+      phi::DenseTensor a, b;
+      a.Resize({m * k});
+      b.Resize({k * n});
+      RandomVec<T>(m * k, a.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      RandomVec<T>(k * n, b.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      const jit::matmul_attr_t fp32_attr{m, n, k};
+      BenchAllImpls<jit::MatMulTuple<T>, PlaceType>(
+          fp32_attr, a.data<T>(), b.data<T>(), y_data, &fp32_attr);
+    }
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void BenchKernelLayerNorm() {
   using T = typename KernelTuple::data_type;
@@ -535,6 +582,7 @@ BENCH_FP32_CPU(CRFDecoding);
 BENCH_FP32_CPU(SeqPool);
 BENCH_FP32_CPU(EmbSeqPool);
 BENCH_FP32_CPU(MatMul);
+BENCH_FP32_CPU(MatMulInt8);
 BENCH_FP32_CPU(Sgd);
 BENCH_FP32_CPU(VBroadcast);
 
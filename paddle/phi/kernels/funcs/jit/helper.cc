@@ -14,6 +14,7 @@
 
 #include "paddle/phi/kernels/funcs/jit/helper.h"
 
+#include <algorithm>
 #include <numeric>
 
 #include "paddle/phi/core/enforce.h"
@@ -56,6 +57,7 @@ const char* to_string(KernelType kt) {
     ONE_CASE(kLayerNorm);
     ONE_CASE(kSeqPool);
     ONE_CASE(kMatMul);
+    ONE_CASE(kMatMulInt8);
     ONE_CASE(kAdam);
     ONE_CASE(kAdamW);
     ONE_CASE(kEmbSeqPool);
@@ -149,5 +151,48 @@ typename std::enable_if<!std::is_same<T, float>::value>::type pack_weights(
       "Only supports pack weights with float type."));
 }
 
+size_t int8_packed_weights_size(int k, int n) {
+  const size_t n16 = (n + 15) / 16 * 16;
+  return (k + 3) / 4 * 4 * n16 + sizeof(int32_t) * n16;
+}
+
+void pack_int8_weights(const int8_t* src, int8_t* dst, int k, int n) {
+  PADDLE_ENFORCE_GT(
+      k,
+      0,
+      phi::errors::InvalidArgument(
+          "The k (weight height) to pack should be larger than 0. "
+          "But it is %d.",
+          k));
+  PADDLE_ENFORCE_GT(
+      n,
+      0,
+      phi::errors::InvalidArgument(
+          "The n (weight width) to pack should be larger than 0. "
+          "But it is %d.",
+          n));
+  const int k4 = (k + 3) / 4;
+  const int panels = (n + 15) / 16;
+  std::memset(dst, 0, int8_packed_weights_size(k, n));
+  for (int p = 0; p < panels; ++p) {
+    const int cols = std::min(16, n - p * 16);
+    int8_t* panel = dst + p * k4 * 64;
+    for (int row = 0; row < k; ++row) {
+      const int8_t* from = src + row * n + p * 16;
+      int8_t* to = panel + row / 4 * 64 + row % 4;
+      for (int c = 0; c < cols; ++c) {
+        to[c * 4] = from[c];
+      }
+    }
+  }
+  int32_t* col_sums = reinterpret_cast<int32_t*>(dst + panels * k4 * 64);
+  for (int row = 0; row < k; ++row) {
+    const int8_t* from = src + row * n;
+    for (int j = 0; j < n; ++j) {
+      col_sums[j] += from[j];
+    }
+  }
+}
+
 }  // namespace jit
 }  // namespace phi
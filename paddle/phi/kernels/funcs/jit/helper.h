@@ -297,9 +297,26 @@ inline std::ostream& operator<<(std::ostream& os, const matmul_attr_t& attr) {
   return os;
 }
 
+inline std::ostream& operator<<(std::ostream& os,
+                                const matmul_int8_attr_t& attr) {
+  os << "M[" << attr.m << "],N[" << attr.n << "],K[" << attr.k
+     << "],x_zero_point[" << attr.x_zero_point << "],with_relu["
+     << (attr.with_relu ? "True" : "False") << "]";
+  return os;
+}
+
 // expose the method to pack matmul weight
 template <typename T>
 void pack_weights(const T* src, T* dst, int n, int k);
 
+// The bytes of the int8 weight (k x n) packed for the MatMulInt8 kernels.
+size_t int8_packed_weights_size(int k, int n);
+
+// Pack the int8 weight (k x n) for the MatMulInt8 kernels: panels of 16
+// columns, in every one of which the 4 bytes of a column from 4 rows are
+// contiguous, padded by zeros up to 16 columns and a multiple of 4 rows,
+// followed by the int32 sums of the columns.
+void pack_int8_weights(const int8_t* src, int8_t* dst, int k, int n);
+
 }  // namespace jit
 }  // namespace phi
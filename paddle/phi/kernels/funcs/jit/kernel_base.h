@@ -35,6 +35,7 @@ typedef enum {
   kLSTMC1H1,
   kLayerNorm,
   kMatMul,
+  kMatMulInt8,
   kSeqPool,
   kVAdd,
   kVAddBias,
@@ -317,6 +318,39 @@ struct MatMulTuple {
   typedef void (*func_type)(const T*, const T*, T*, const matmul_attr_t*);
 };
 
+typedef struct matmul_int8_attr_s {
+  int m, n, k;
+  int x_zero_point;  // x holds the int8 values shifted by x_zero_point
+  bool with_relu;
+  matmul_int8_attr_s() = default;
+  explicit matmul_int8_attr_s(int m_,
+                              int n_,
+                              int k_,
+                              int x_zero_point_ = 0,
+                              bool with_relu_ = false)
+      : m(m_),
+        n(n_),
+        k(k_),
+        x_zero_point(x_zero_point_),
+        with_relu(with_relu_) {}
+} matmul_int8_attr_t;
+
+// x(uint8, m x k), w(int8, k x n, packed by pack_int8_weights), scale(n),
+// bias(n, can be nullptr), y(m x n):
+// y = scale * (x - x_zero_point) * w + bias
+template <typename T>
+struct MatMulInt8Tuple {
+  static constexpr KernelType kernel_type = kMatMulInt8;
+  typedef T data_type;
+  typedef matmul_int8_attr_t attr_type;
+  typedef void (*func_type)(const uint8_t*,
+                            const int8_t*,
+                            const T*,
+                            const T*,
+                            T*,
+                            const matmul_int8_attr_t*);
+};
+
 template <typename T>
 struct CRFDecodingTuple {
   static constexpr KernelType kernel_type = kCRFDecoding;
@@ -0,0 +1,66 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/jit/more/intrinsic/matmul_int8.h"
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/kernels/funcs/jit/registry.h"
+
+namespace phi {
+namespace jit {
+namespace more {
+namespace intrinsic {
+
+// The int8 GEMM needs AVX2 at least, so it is not bound to SIMD_FLAG like
+// the other intrinsic kernels: the kernel of every instruction set is built
+// with its own flags, and the best one the CPU has is picked here.
+static MatMulInt8Tuple<float>::func_type BestMatMulInt8() {
+  static const MatMulInt8Tuple<float>::func_type func =
+      []() -> MatMulInt8Tuple<float>::func_type {
+    auto vnni = GetMatMulInt8Avx512Vnni();
+    if (vnni &&
+        phi::backends::cpu::MayIUse(phi::backends::cpu::avx512_core_vnni)) {
+      return vnni;
+    }
+    auto avx2 = GetMatMulInt8Avx2();
+    if (avx2 && phi::backends::cpu::MayIUse(phi::backends::cpu::avx2)) {
+      return avx2;
+    }
+    return nullptr;
+  }();
+  return func;
+}
+
+void MatMulInt8(const uint8_t* x,
+                const int8_t* w,
+                const float* scale,
+                const float* bias,
+                float* y,
+                const matmul_int8_attr_t* attr) {
+  BestMatMulInt8()(x, w, scale, bias, y, attr);
+}
+
+bool MatMulInt8Kernel::CanBeUsed(
+    const matmul_int8_attr_t& attr UNUSED) const {
+  return BestMatMulInt8() != nullptr;
+}
+
+}  // namespace intrinsic
+}  // namespace more
+}  // namespace jit
+}  // namespace phi
+
+namespace intrinsic = phi::jit::more::intrinsic;
+
+REGISTER_JITKERNEL_MORE(kMatMulInt8, intrinsic, intrinsic::MatMulInt8Kernel);
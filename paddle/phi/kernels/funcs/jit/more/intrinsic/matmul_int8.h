@@ -0,0 +1,49 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include "paddle/phi/kernels/funcs/jit/kernel_base.h"
+
+namespace phi {
+namespace jit {
+namespace more {
+namespace intrinsic {
+
+void MatMulInt8(const uint8_t* x,
+                const int8_t* w,
+                const float* scale,
+                const float* bias,
+                float* y,
+                const matmul_int8_attr_t* attr);
+
+// The kernels of every instruction set, each built by its own source with
+// the flags of the instruction set, or nullptr if the compiler can't target
+// it.
+MatMulInt8Tuple<float>::func_type GetMatMulInt8Avx512Vnni();
+MatMulInt8Tuple<float>::func_type GetMatMulInt8Avx2();
+
+// Runs the kernel of the best instruction set of the CPU, picked at runtime.
+class MatMulInt8Kernel : public KernelMore<MatMulInt8Tuple<float>> {
+ public:
+  MatMulInt8Kernel() { this->func = MatMulInt8; }
+  bool CanBeUsed(
+      const typename MatMulInt8Tuple<float>::attr_type&) const override;
+  const char* ImplType() const override { return "Intrinsic"; }
+};
+
+}  // namespace intrinsic
+}  // namespace more
+}  // namespace jit
+}  // namespace phi
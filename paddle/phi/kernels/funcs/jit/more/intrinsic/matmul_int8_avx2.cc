@@ -0,0 +1,126 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// Built with AVX2 whatever SIMD_FLAG is, see the CMakeLists.txt of this
+// directory. matmul_int8.cc only calls it on CPUs that have it.
+
+#include "paddle/phi/kernels/funcs/jit/more/intrinsic/matmul_int8.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+#include "paddle/phi/kernels/funcs/jit/more/intrinsic/matmul_int8_impl.h"
+#endif
+
+namespace phi {
+namespace jit {
+namespace more {
+namespace intrinsic {
+
+#if defined(__AVX2__)
+namespace {
+
+// Without VNNI the products are done in int16 by vpmaddwd, which is exact,
+// while the pairs of vpmaddubsw would saturate. The 4 bytes of a column of
+// the packed weight widen into 4 int16 and vpmaddwd adds them by pairs, so
+// the two halves of every column are added at the end. A tile is MR rows by
+// half a panel, the columns past n are masked out.
+struct Avx2 {
+  static constexpr int kRowBlock = 4;
+  static constexpr int kColBlock = 8;
+  // the 4 bytes of x widened into 4 int16
+  using XQuadT = uint64_t;
+
+  static XQuadT Widen(uint32_t quad) {
+    uint64_t wide = 0;
+    for (int t = 0; t < 4; ++t) {
+      wide |= static_cast<uint64_t>((quad >> (t * 8)) & 0xFF) << (t * 16);
+    }
+    return wide;
+  }
+
+  template <int MR>
+  static void Tile(const uint64_t* xq,
+                   const int8_t* w,
+                   const int32_t* col_sums,
+                   const float* scale,
+                   const float* bias,
+                   float* y,
+                   int n,
+                   int k4,
+                   int col,
+                   const matmul_int8_attr_t* attr) {
+    const int8_t* pw = w + (col / 16 * k4 * 16 + col % 16) * 4;
+    __m256i acc[MR][2];
+    for (int r = 0; r < MR; ++r) {
+      acc[r][0] = _mm256_setzero_si256();
+      acc[r][1] = _mm256_setzero_si256();
+    }
+    for (int q = 0; q < k4; ++q) {
+      const __m256i w0 = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(pw + q * 64)));
+      const __m256i w1 = _mm256_cvtepi8_epi16(_mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(pw + q * 64 + 16)));
+      for (int r = 0; r < MR; ++r) {
+        const __m256i a = _mm256_set1_epi64x(xq[r * k4 + q]);
+        acc[r][0] = _mm256_add_epi32(acc[r][0], _mm256_madd_epi16(a, w0));
+        acc[r][1] = _mm256_add_epi32(acc[r][1], _mm256_madd_epi16(a, w1));
+      }
+    }
+
+    const __m256i mask =
+        _mm256_cmpgt_epi32(_mm256_set1_epi32(n - col),
+                           _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    const __m256i comp = _mm256_mullo_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col_sums + col)),
+        _mm256_set1_epi32(attr->x_zero_point));
+    const __m256 s = _mm256_maskload_ps(scale + col, mask);
+    const __m256 b =
+        bias ? _mm256_maskload_ps(bias + col, mask) : _mm256_setzero_ps();
+    for (int r = 0; r < MR; ++r) {
+      // columns 0, 1, 4, 5, 2, 3, 6, 7 after the horizontal add
+      const __m256i sums = _mm256_permute4x64_epi64(
+          _mm256_hadd_epi32(acc[r][0], acc[r][1]), 0xD8);
+      __m256 v = _mm256_cvtepi32_ps(_mm256_sub_epi32(sums, comp));
+      v = _mm256_add_ps(_mm256_mul_ps(v, s), b);
+      if (attr->with_relu) {
+        v = _mm256_max_ps(v, _mm256_setzero_ps());
+      }
+      _mm256_maskstore_ps(y + r * n + col, mask, v);
+    }
+  }
+};
+
+void MatMulInt8Avx2(const uint8_t* x,
+                    const int8_t* w,
+                    const float* scale,
+                    const float* bias,
+                    float* y,
+                    const matmul_int8_attr_t* attr) {
+  MatMulInt8Blocked<Avx2>(x, w, scale, bias, y, attr);
+}
+
+}  // namespace
+
+MatMulInt8Tuple<float>::func_type GetMatMulInt8Avx2() {
+  return MatMulInt8Avx2;
+}
+#else
+MatMulInt8Tuple<float>::func_type GetMatMulInt8Avx2() { return nullptr; }
+#endif
+
+}  // namespace intrinsic
+}  // namespace more
+}  // namespace jit
+}  // namespace phi
@@ -0,0 +1,128 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// Built with AVX512F and AVX512-VNNI whatever SIMD_FLAG is, see the
+// CMakeLists.txt of this directory. matmul_int8.cc only calls it on CPUs
+// that have them.
+
+#include "paddle/phi/kernels/funcs/jit/more/intrinsic/matmul_int8.h"
+
+#if defined(__AVX512VNNI__)
+#include <immintrin.h>
+
+#include "paddle/phi/kernels/funcs/jit/more/intrinsic/matmul_int8_impl.h"
+#endif
+
+namespace phi {
+namespace jit {
+namespace more {
+namespace intrinsic {
+
+#if defined(__AVX512VNNI__)
+namespace {
+
+// vpdpbusd multiplies the 4 uint8 of x by the 4 int8 of a column and adds
+// them to the int32 of the column, so a row of a panel of the packed weight
+// is a vector. A tile is MR rows by 2 panels, the columns past n are masked
+// out.
+struct Avx512Vnni {
+  static constexpr int kRowBlock = 6;
+  static constexpr int kColBlock = 32;
+  using XQuadT = uint32_t;
+
+  static XQuadT Widen(uint32_t quad) { return quad; }
+
+  template <int MR>
+  static void Tile(const uint32_t* xq,
+                   const int8_t* w,
+                   const int32_t* col_sums,
+                   const float* scale,
+                   const float* bias,
+                   float* y,
+                   int n,
+                   int k4,
+                   int col,
+                   const matmul_int8_attr_t* attr) {
+    const int rest = n - col;
+    const __mmask16 mask[2] = {
+        static_cast<__mmask16>(rest >= 16 ? 0xFFFF : (1 << rest) - 1),
+        static_cast<__mmask16>(rest >= 32   ? 0xFFFF
+                               : rest > 16 ? (1 << (rest - 16)) - 1
+                                           : 0)};
+    const int8_t* panel0 = w + col / 16 * k4 * 64;
+    // the second panel is all zeros past n
+    const int8_t* panel1 = mask[1] ? panel0 + k4 * 64 : panel0;
+    const __mmask16 load_mask1 = mask[1] ? 0xFFFF : 0;
+    __m512i acc[MR][2];
+    for (int r = 0; r < MR; ++r) {
+      acc[r][0] = _mm512_setzero_si512();
+      acc[r][1] = _mm512_setzero_si512();
+    }
+    for (int q = 0; q < k4; ++q) {
+      const __m512i w0 = _mm512_loadu_si512(panel0 + q * 64);
+      const __m512i w1 =
+          _mm512_maskz_loadu_epi32(load_mask1, panel1 + q * 64);
+      for (int r = 0; r < MR; ++r) {
+        const __m512i a = _mm512_set1_epi32(xq[r * k4 + q]);
+        acc[r][0] = _mm512_dpbusd_epi32(acc[r][0], a, w0);
+        acc[r][1] = _mm512_dpbusd_epi32(acc[r][1], a, w1);
+      }
+    }
+
+    const __m512i zero_point = _mm512_set1_epi32(attr->x_zero_point);
+    const __m512 zero = _mm512_setzero_ps();
+    for (int h = 0; h < 2 && mask[h]; ++h) {
+      const int offset = col + h * 16;
+      const __m512i comp = _mm512_mullo_epi32(
+          _mm512_loadu_si512(col_sums + offset), zero_point);
+      const __m512 s = _mm512_maskz_loadu_ps(mask[h], scale + offset);
+      const __m512 b =
+          bias ? _mm512_maskz_loadu_ps(mask[h], bias + offset) : zero;
+      for (int r = 0; r < MR; ++r) {
+        __m512 v = _mm512_maskz_cvtepi32_ps(
+            mask[h], _mm512_sub_epi32(acc[r][h], comp));
+        v = _mm512_add_ps(_mm512_mul_ps(v, s), b);
+        if (attr->with_relu) {
+          v = _mm512_maskz_max_ps(mask[h], v, zero);
+        }
+        _mm512_mask_storeu_ps(y + r * n + offset, mask[h], v);
+      }
+    }
+  }
+};
+
+void MatMulInt8Avx512Vnni(const uint8_t* x,
+                          const int8_t* w,
+                          const float* scale,
+                          const float* bias,
+                          float* y,
+                          const matmul_int8_attr_t* attr) {
+  MatMulInt8Blocked<Avx512Vnni>(x, w, scale, bias, y, attr);
+}
+
+}  // namespace
+
+MatMulInt8Tuple<float>::func_type GetMatMulInt8Avx512Vnni() {
+  return MatMulInt8Avx512Vnni;
+}
+#else
+MatMulInt8Tuple<float>::func_type GetMatMulInt8Avx512Vnni() {
+  return nullptr;
+}
+#endif
+
+}  // namespace intrinsic
+}  // namespace more
+}  // namespace jit
+}  // namespace phi
@@ -0,0 +1,107 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "paddle/phi/kernels/funcs/jit/kernel_base.h"
+
+// The blocking shared by the int8 GEMM of every instruction set. It is only
+// included by the source of an instruction set, which is built with its
+// flags, so everything here has internal linkage: the copies built with
+// other flags must not be merged by the linker.
+
+namespace phi {
+namespace jit {
+namespace more {
+namespace intrinsic {
+namespace {
+
+// The 4 bytes of x from 4 * q, with the ones past k as zeros.
+inline uint32_t XQuad(const uint8_t* x, int q, int k) {
+  uint32_t quad = 0;
+  std::memcpy(&quad, x + q * 4, std::min(4, k - q * 4));
+  return quad;
+}
+
+// Runs the tile of Isa with MR rows, for rows from 1 to MR.
+template <typename Isa, int MR>
+struct MatMulInt8TileRunner {
+  template <typename... Args>
+  static void Run(int rows, Args... args) {
+    if (rows == MR) {
+      Isa::template Tile<MR>(args...);
+    } else {
+      MatMulInt8TileRunner<Isa, MR - 1>::Run(rows, args...);
+    }
+  }
+};
+
+template <typename Isa>
+struct MatMulInt8TileRunner<Isa, 0> {
+  template <typename... Args>
+  static void Run(int, Args...) {}
+};
+
+// Isa gives the tile of kRowBlock rows by kColBlock columns, and the quads
+// of x in the layout the tile reads them, XQuadT made by Isa::Widen.
+template <typename Isa>
+void MatMulInt8Blocked(const uint8_t* x,
+                       const int8_t* w,
+                       const float* scale,
+                       const float* bias,
+                       float* y,
+                       const matmul_int8_attr_t* attr) {
+  using XQuadT = typename Isa::XQuadT;
+  const int m = attr->m;
+  const int n = attr->n;
+  const int k = attr->k;
+  const int k4 = (k + 3) / 4;
+  const int32_t* col_sums =
+      reinterpret_cast<const int32_t*>(w + (n + 15) / 16 * k4 * 64);
+
+  std::vector<XQuadT> xq(m * k4);
+  for (int i = 0; i < m; ++i) {
+    for (int q = 0; q < k4; ++q) {
+      xq[i * k4 + q] = Isa::Widen(XQuad(x + i * k, q, k));
+    }
+  }
+
+  // a panel of the weight stays in cache for all the rows
+  for (int col = 0; col < n; col += Isa::kColBlock) {
+    for (int i = 0; i < m; i += Isa::kRowBlock) {
+      MatMulInt8TileRunner<Isa, Isa::kRowBlock>::Run(
+          std::min(Isa::kRowBlock, m - i),
+          static_cast<const XQuadT*>(xq.data() + i * k4),
+          w,
+          col_sums,
+          scale,
+          bias,
+          y + i * n,
+          n,
+          k4,
+          col,
+          attr);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace intrinsic
+}  // namespace more
+}  // namespace jit
+}  // namespace phi
@@ -394,6 +394,38 @@ void MatMul(const T* A, const T* B, T* C, const matmul_attr_t* attr) {
   }
 }
 
+// x is a uint8 matrix with (m, k), w is the int8 matrix with (k, n) packed
+// by pack_int8_weights into panels of 16 columns, followed by the sums of
+// its columns
+template <typename T>
+void MatMulInt8(const uint8_t* x,
+                const int8_t* w,
+                const T* scale,
+                const T* bias,
+                T* y,
+                const matmul_int8_attr_t* attr) {
+  int M = attr->m;
+  int N = attr->n;
+  int K = attr->k;
+  const int K4 = (K + 3) / 4;
+  const int32_t* col_sums =
+      reinterpret_cast<const int32_t*>(w + (N + 15) / 16 * K4 * 64);
+  for (int m = 0; m < M; ++m) {
+    const uint8_t* px = x + m * K;
+    T* py = y + m * N;
+    for (int n = 0; n < N; ++n) {
+      const int8_t* pw = w + (n / 16 * K4 * 16 + n % 16) * 4;
+      int32_t acc = -attr->x_zero_point * col_sums[n];
+      for (int k = 0; k < K; ++k) {
+        acc += px[k] * pw[k / 4 * 64 + k % 4];
+      }
+      T res = scale[n] * static_cast<T>(acc) +
+              (bias ? bias[n] : static_cast<T>(0));
+      py[n] = (attr->with_relu && res < 0) ? static_cast<T>(0) : res;
+    }
+  }
+}
+
 // embedding seq pool
 // table is a matrix with (tbl_h, tbl_w)
 // idx is a matrix with (idx_h, idx_w)
@@ -602,6 +634,7 @@ DECLARE_REFER_KERNEL(CRFDecoding);
 DECLARE_REFER_KERNEL(LayerNorm);
 DECLARE_REFER_KERNEL(SeqPool);
 DECLARE_REFER_KERNEL(MatMul);
+DECLARE_REFER_KERNEL(MatMulInt8);
 DECLARE_REFER_KERNEL(EmbSeqPool);
 DECLARE_REFER_KERNEL(Adam);
 DECLARE_REFER_KERNEL(AdamW);
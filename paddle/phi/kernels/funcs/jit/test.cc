@@ -687,6 +687,92 @@ void TestKernelMatMul() {
   FLAGS_acc = last_acc;
 }
 
+template <typename KernelTuple, typename PlaceType>
+void TestKernelMatMulInt8() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  auto last_acc = FLAGS_acc;
+  // the results are up to a few hundreds
+  FLAGS_acc = 1e-3;
+  std::mt19937 rng(100);
+  std::uniform_int_distribution<int> dist(-128, 127);
+  for (int m : {1, 2, 3, 5, 7, 13}) {
+    for (int n : {1, 5, 16, 17, 33, 64}) {
+      for (int k : {1, 3, 4, 7, 64, 129}) {
+        std::vector<uint8_t> x(m * k);
+        std::vector<int8_t> w(k * n);
+        std::vector<int8_t> packed(jit::int8_packed_weights_size(k, n));
+        std::vector<T> scale(n), bias(n), yref(m * n);
+        for (auto& v : x) v = static_cast<uint8_t>(dist(rng) + 128);
+        for (auto& v : w) v = static_cast<int8_t>(dist(rng));
+        RandomVec<T>(
+            n, scale.data(), static_cast<T>(1e-4), static_cast<T>(1e-3));
+        RandomVec<T>(n, bias.data());
+        jit::pack_int8_weights(w.data(), packed.data(), k, n);
+        for (bool with_relu : {false, true}) {
+          const jit::matmul_int8_attr_t attr(m, n, k, 128, with_relu);
+          auto ref = jit::GetReferFunc<KernelTuple>();
+          EXPECT_TRUE(ref != nullptr);
+          ref(x.data(),
+              packed.data(),
+              scale.data(),
+              bias.data(),
+              yref.data(),
+              &attr);
+          // the refer against the dequantized GEMM
+          for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < n; ++j) {
+              double y = 0;
+              for (int l = 0; l < k; ++l) {
+                y += (x[i * k + l] - 128) * static_cast<double>(w[l * n + j]);
+              }
+              y = y * scale[j] + bias[j];
+              y = with_relu && y < 0 ? 0 : y;
+              EXPECT_NEAR(yref[i * n + j], y, 1e-4);
+            }
+          }
+          auto verifier = [](const typename KernelTuple::func_type tgt,
+                             const std::vector<uint8_t>& x,
+                             const std::vector<int8_t>& packed,
+                             const std::vector<T>& scale,
+                             const std::vector<T>& bias,
+                             const std::vector<T>& yref,
+                             const typename KernelTuple::attr_type& attr) {
+            EXPECT_TRUE(tgt != nullptr);
+            std::vector<T> y(yref.size());
+            tgt(x.data(),
+                packed.data(),
+                scale.data(),
+                bias.data(),
+                y.data(),
+                &attr);
+            ExpectEQ<T>(y.data(), yref.data(), yref.size());
+            if (!attr.with_relu) {
+              std::vector<T> y_nobias(yref.size());
+              tgt(x.data(),
+                  packed.data(),
+                  scale.data(),
+                  nullptr,
+                  y_nobias.data(),
+                  &attr);
+              for (int i = 0; i < attr.m; ++i) {
+                for (int j = 0; j < attr.n; ++j) {
+                  EXPECT_NEAR(y_nobias[i * attr.n + j] + bias[j],
+                              y[i * attr.n + j],
+                              FLAGS_acc);
+                }
+              }
+            }
+          };
+          TestAllImpls<KernelTuple, PlaceType>(
+              attr, verifier, x, packed, scale, bias, yref, attr);
+        }
+      }
+    }
+  }
+  FLAGS_acc = last_acc;
+}
+
 template <typename KernelTuple, typename PlaceType>
 void TestKernelAdam() {
   using T = typename KernelTuple::data_type;
@@ -1348,6 +1434,23 @@ TEST(JITKernel_key, matmul) {
   EXPECT_TRUE(key3 != key4);
 }
 
+TEST(JITKernel_key, matmul_int8) {
+  jit::matmul_int8_attr_t attr1(1, 2, 3, 128);
+  jit::matmul_int8_attr_t attr2(1, 2, 3, 128);
+  jit::matmul_int8_attr_t attr3(1, 2, 3, 0);
+  jit::matmul_int8_attr_t attr4(1, 2, 3, 128, true);
+
+  auto key1 = jit::JitCodeKey<jit::matmul_int8_attr_t>(attr1);
+  auto key2 = jit::JitCodeKey<jit::matmul_int8_attr_t>(attr2);
+  auto key3 = jit::JitCodeKey<jit::matmul_int8_attr_t>(attr3);
+  auto key4 = jit::JitCodeKey<jit::matmul_int8_attr_t>(attr4);
+
+  EXPECT_TRUE(key1 == key2);
+  EXPECT_TRUE(key2 != key3);
+  EXPECT_TRUE(key2 != key4);
+  EXPECT_TRUE(key3 != key4);
+}
+
 TEST(JITKernel_key, emb_seq_pool) {
   jit::emb_seq_pool_attr_t attr1(1, 2, 3, 4, 5, jit::SeqPoolType::kSum);
   jit::emb_seq_pool_attr_t attr2(1, 2, 3, 4, 5, jit::SeqPoolType::kSum);
@@ -1460,6 +1563,7 @@ TEST_CPU_KERNEL(CRFDecoding);
 TEST_CPU_KERNEL(SeqPool);
 TEST_CPU_KERNEL(EmbSeqPool);
 TEST_CPU_KERNEL(MatMul);
+TEST_CPU_KERNEL(MatMulInt8);
 TEST_CPU_KERNEL(Adam);
 TEST_CPU_KERNEL(AdamW);
 TEST_CPU_KERNEL(Sgd);
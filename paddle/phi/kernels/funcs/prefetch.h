@@ -0,0 +1,36 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace phi {
+namespace funcs {
+
+// Prefetches the cache lines of a row of width elements, for kernels that
+// gather rows from all over a large table or from many inputs.
+template <typename T>
+inline void PrefetchRow(const T* row, int64_t width) {
+#if defined(__GNUC__) || defined(__clang__)
+  const char* begin = reinterpret_cast<const char*>(row);
+  const char* end = reinterpret_cast<const char*>(row + width);
+  for (const char* p = begin; p < end; p += 64) {
+    __builtin_prefetch(p);
+  }
+#endif
+}
+
+}  // namespace funcs
+}  // namespace phi
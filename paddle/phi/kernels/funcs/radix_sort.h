@@ -0,0 +1,106 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace phi {
+namespace funcs {
+
+constexpr int kRadixBits = 8;
+constexpr int kRadixSize = 1 << kRadixBits;
+
+// The range [*begin, *end) of the n elements handled by thread tid.
+inline void ThreadRange(
+    int64_t n, int tid, int thread_num, int64_t* begin, int64_t* end) {
+  *begin = n * tid / thread_num;
+  *end = n * (tid + 1) / thread_num;
+}
+
+// Stable LSD radix sort of keys in [0, max_key], a byte per pass, moving
+// positions along with them. Every thread counts and then scatters its own
+// range of the keys, so equal keys keep their order. Passes on a byte that
+// is the same for all keys are skipped.
+template <typename IntT>
+void RadixSortKeys(IntT max_key,
+                   int thread_num,
+                   std::vector<IntT>* keys,
+                   std::vector<IntT>* positions) {
+  using UIntT = typename std::make_unsigned<IntT>::type;
+  const int64_t n = keys->size();
+  std::vector<IntT> tmp_keys, tmp_positions;
+  std::vector<int64_t> offsets(thread_num * kRadixSize);
+  for (int shift = 0; shift < static_cast<int>(sizeof(IntT) * 8) &&
+                      (static_cast<UIntT>(max_key) >> shift) > 0;
+       shift += kRadixBits) {
+    const IntT* src_keys = keys->data();
+    std::fill(offsets.begin(), offsets.end(), 0);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(thread_num)
+#endif
+    for (int t = 0; t < thread_num; ++t) {
+      int64_t begin, end;
+      ThreadRange(n, t, thread_num, &begin, &end);
+      int64_t* count = offsets.data() + t * kRadixSize;
+      for (int64_t i = begin; i < end; ++i) {
+        ++count[(static_cast<UIntT>(src_keys[i]) >> shift) & (kRadixSize - 1)];
+      }
+    }
+
+    // exclusive offsets, ordered by digit, then by thread
+    int64_t offset = 0;
+    bool single_digit = false;
+    for (int d = 0; d < kRadixSize; ++d) {
+      int64_t digit_count = 0;
+      for (int t = 0; t < thread_num; ++t) {
+        const int64_t count = offsets[t * kRadixSize + d];
+        offsets[t * kRadixSize + d] = offset;
+        offset += count;
+        digit_count += count;
+      }
+      single_digit = single_digit || digit_count == n;
+    }
+    if (single_digit) continue;
+
+    tmp_keys.resize(n);
+    tmp_positions.resize(n);
+    const IntT* src_positions = positions->data();
+    IntT* dst_keys = tmp_keys.data();
+    IntT* dst_positions = tmp_positions.data();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(thread_num)
+#endif
+    for (int t = 0; t < thread_num; ++t) {
+      int64_t begin, end;
+      ThreadRange(n, t, thread_num, &begin, &end);
+      int64_t* next = offsets.data() + t * kRadixSize;
+      for (int64_t i = begin; i < end; ++i) {
+        const int digit =
+            (static_cast<UIntT>(src_keys[i]) >> shift) & (kRadixSize - 1);
+        const int64_t dst = next[digit]++;
+        dst_keys[dst] = src_keys[i];
+        dst_positions[dst] = src_positions[i];
+      }
+    }
+    keys->swap(tmp_keys);
+    positions->swap(tmp_positions);
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -14,22 +14,27 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/funcs/selected_rows_functor.h"
 
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
 #include <algorithm>
+#include <cstring>
 #include <map>
+#include <numeric>
 #include <set>
 #include <vector>
 
 #include "paddle/phi/core/ddim.h"
 #include "paddle/phi/core/mixed_vector.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
+#include "paddle/phi/kernels/funcs/prefetch.h"
+#include "paddle/phi/kernels/funcs/radix_sort.h"
 
 #ifdef PADDLE_WITH_XPU
 #include "paddle/phi/backends/xpu/enforce_xpu.h"
 #endif
 
-#ifdef PADDLE_WITH_MKLDNN
-#include "paddle/phi/backends/onednn/axpy_handler.h"
-#endif
-
 #include "glog/logging.h"
 
 namespace phi {
@@ -429,69 +434,42 @@ typename std::enable_if<std::is_integral<T>::value>::type elementwise_add_to(
   }
 }
 
-template <typename T, typename DeviceContext>
-typename std::enable_if<std::is_same<T, phi::dtype::bfloat16>::value>::type
-add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
-                  int64_t input_width,
-                  const DeviceContext& context,
-                  T* out_data) {
-#ifndef PADDLE_WITH_MKLDNN
-  auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
-#endif
-  for (auto* input : inputs) {
-    if (input->rows().size() == 0) {
-      continue;
-    }
-    auto* input_data = input->value().data<T>();
-    auto& input_rows = input->rows();
-
-#ifdef PADDLE_WITH_MKLDNN
-    OneDNNContext onednn_context(context.GetPlace());
-    funcs::OneDNNAXPYHandler<T> axpy_handler(
-        input_width, T(1.f), onednn_context.GetEngine());
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      axpy_handler(&input_data[i * input_width],
-                   &out_data[out_i * input_width]);
-    }
-#else
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      elementwise_add_to<T, DeviceContext>(&blas,
-                                           static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
-                                           &out_data[out_i * input_width]);
+// Adds rows of width elements, dst += src, with the jit kernel of the
+// instruction set of the machine for float and double.
+template <typename T, typename Enable = void>
+struct RowAdder {
+  explicit RowAdder(int64_t width) : width_(width) {}
+
+  void operator()(const T* src, T* dst) const {
+    for (int64_t i = 0; i < width_; ++i) {
+      dst[i] += src[i];
     }
-#endif
   }
-}
 
-template <typename T, typename DeviceContext>
-typename std::enable_if<!std::is_same<T, phi::dtype::bfloat16>::value>::type
-add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
-                  int64_t input_width,
-                  const DeviceContext& context,
-                  T* out_data) {
-  VLOG(4) << "[CPU] add_sparse_inputs <" << typeid(T).name();
-  auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
-  for (auto* input : inputs) {
-    if (input->rows().size() == 0) {
-      continue;
-    }
-    auto* input_data = input->value().data<T>();
-    auto& input_rows = input->rows();
-
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      elementwise_add_to<T, DeviceContext>(&blas,
-                                           static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
-                                           &out_data[out_i * input_width]);
-    }
+  int64_t width_;
+};
+
+template <typename T>
+struct RowAdder<T,
+                typename std::enable_if<std::is_same<T, float>::value ||
+                                        std::is_same<T, double>::value>::type> {
+  explicit RowAdder(int64_t width)
+      : width_(width),
+        add_(phi::jit::KernelFuncs<phi::jit::VAddTuple<T>,
+                                   phi::CPUPlace>::Cache()
+                 .At(width)) {}
+
+  void operator()(const T* src, T* dst) const {
+    add_(src, dst, dst, width_);
   }
-}
+
+  int width_;
+  typename phi::jit::VAddTuple<T>::func_type add_;
+};
+
+// Input rows ahead of the one being added that are prefetched, since the
+// rows of an id are gathered from all over the inputs.
+constexpr int64_t kMergeAddPrefetchDistance = 8;
 
 template <typename DeviceContext, typename T>
 struct MergeAddImpl {
@@ -534,7 +512,6 @@ struct MergeAddImpl {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
     size_t row_num = 0;
     for (auto* input : inputs) {
       if (input->rows().size() == 0) {
@@ -550,19 +527,71 @@ struct MergeAddImpl {
           input->height(),
           phi::errors::InvalidArgument("All inputs should have same height."));
       row_num += input->rows().size();
-      merged_row_set.insert(input->rows().begin(), input->rows().end());
     }
 
     out.set_height(input_height);
+
+    // 1. the row ids of all the inputs, in order, and where their data is
+    std::vector<int64_t> keys;
+    std::vector<const T*> row_data;
+    keys.reserve(row_num);
+    row_data.reserve(row_num);
+    for (auto* input : inputs) {
+      if (input->rows().size() == 0) {
+        continue;
+      }
+      const T* input_data = input->value().data<T>();
+      for (size_t i = 0; i < input->rows().size(); ++i) {
+        keys.push_back(input->rows()[i]);
+        row_data.push_back(input_data + i * input_width);
+      }
+    }
+
+    int thread_num = 1;
+#ifdef PADDLE_WITH_MKLML
+    thread_num = std::max<int64_t>(
+        1, std::min<int64_t>(omp_get_max_threads(), row_num / 4096));
+#endif
+
+    // 2. sort the ids stably, positions[i] is where keys[i] came from
+    std::vector<int64_t> positions(row_num);
+    std::iota(positions.begin(), positions.end(), 0);
+    if (!std::is_sorted(keys.begin(), keys.end())) {
+      auto min_max = std::minmax_element(keys.begin(), keys.end());
+      if (*min_max.first >= 0) {
+        RadixSortKeys<int64_t>(*min_max.second, thread_num, &keys, &positions);
+      } else {
+        std::stable_sort(
+            positions.begin(), positions.end(), [&](int64_t a, int64_t b) {
+              return keys[a] < keys[b];
+            });
+        std::vector<int64_t> sorted_keys(row_num);
+        for (size_t i = 0; i < row_num; ++i) {
+          sorted_keys[i] = keys[positions[i]];
+        }
+        keys.swap(sorted_keys);
+      }
+    }
+
+    // 3. every run of equal ids is a row of the output
+    std::vector<int64_t> merge_rows;
+    std::vector<int64_t> run_offsets;
+    for (size_t i = 0; i < row_num; ++i) {
+      if (i == 0 || keys[i] != keys[i - 1]) {
+        merge_rows.push_back(keys[i]);
+        run_offsets.push_back(i);
+      }
+    }
+    run_offsets.push_back(row_num);
+
     DenseTensor* out_tensor = out.mutable_value();
     out_tensor->Resize(phi::make_ddim(
-        {static_cast<int64_t>(merged_row_set.size()), input_width}));
+        {static_cast<int64_t>(merge_rows.size()), input_width}));
     auto* out_data = context.template Alloc<T>(out_tensor);
 
-    if (merged_row_set.size() == row_num && !sorted_result) {
+    if (merge_rows.size() == row_num && !sorted_result) {
       // no duplicated ids, just concat the result together
-      std::vector<int64_t> merge_rows;
-      merge_rows.reserve(row_num);
+      merge_rows.clear();
       // concat rows
       for (auto* in : inputs) {
         merge_rows.insert(
@@ -583,25 +612,30 @@ struct MergeAddImpl {
         copied_numel += in_numel;
       }
     } else {
-      std::vector<int64_t> merge_rows(merged_row_set.begin(),
-                                      merged_row_set.end());
-
-      if (sorted_result) {
-        std::sort(merge_rows.begin(), merge_rows.end());
-      }
-
       out.set_rows(merge_rows);
 
-      phi::funcs::SetConstant<DeviceContext, T> constant_functor;
-      constant_functor(context, out.mutable_value(), static_cast<T>(0.f));
-
-      std::unordered_map<int64_t, size_t> rows_to_id;
-      for (size_t i = 0; i < merge_rows.size(); ++i) {
-        rows_to_id[merge_rows[i]] = i;
+      // 4. every output row is written by a single thread, the first of its
+      // input rows copied and the others added, so it needs no zero filling
+      // and duplicated ids no locks
+      const RowAdder<T> add_row(input_width);
+      const int64_t out_rows = merge_rows.size();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(thread_num) schedule(dynamic, 64)
+#endif
+      for (int64_t k = 0; k < out_rows; ++k) {
+        T* dst = out_data + k * input_width;
+        for (int64_t i = run_offsets[k]; i < run_offsets[k + 1]; ++i) {
+          const int64_t ahead = i + kMergeAddPrefetchDistance;
+          if (ahead < static_cast<int64_t>(row_num)) {
+            PrefetchRow(row_data[positions[ahead]], input_width);
+          }
+          if (i == run_offsets[k]) {
+            memcpy(dst, row_data[positions[i]], input_width * sizeof(T));
+          } else {
+            add_row(row_data[positions[i]], dst);
+          }
+        }
       }
-
-      add_sparse_inputs<T, DeviceContext>(
-          inputs, rows_to_id, input_width, context, out_data);
     }
   }
 };
@@ -14,13 +14,24 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/sparse/coalesce_kernel.h"
 
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/visit_type.h"
+#include "paddle/phi/kernels/funcs/radix_sort.h"
 #include "paddle/phi/kernels/funcs/sparse/flatten_indices.h"
 
 namespace phi {
 namespace sparse {
 
+using funcs::RadixSortKeys;
+using funcs::ThreadRange;
+
 template <typename T, typename IntT>
 void CoalesceCooCPUKernel(const CPUContext& dev_ctx,
                           const SparseCooTensor& x,
@@ -30,37 +41,98 @@ void CoalesceCooCPUKernel(const CPUContext& dev_ctx,
   DenseTensor out_indices = phi::EmptyLike<IntT>(dev_ctx, x_indices);
   DenseTensor out_values = phi::EmptyLike<T>(dev_ctx, x_values);
 
+  const int64_t nnz = x.nnz();
   const int64_t sparse_dim = x.indices().dims()[0];
-  std::vector<IntT> sparse_offsets(sparse_dim), x_indexs(x.nnz());
+  std::vector<IntT> sparse_offsets(sparse_dim);
   phi::funcs::sparse::CalcOffsetsPerDim<IntT>(
       x.dims(), sparse_dim, sparse_offsets.data());
 
-  phi::funcs::sparse::FlattenIndices(x.indices().data<IntT>(),
-                                     sparse_offsets.data(),
-                                     x.nnz(),
-                                     sparse_dim,
-                                     0,
-                                     1,
-                                     x_indexs.data());
+  int thread_num = 1;
+#ifdef PADDLE_WITH_MKLML
+  thread_num = std::max<int64_t>(
+      1, std::min<int64_t>(omp_get_max_threads(), nnz / 4096));
+#endif
+
+  // 1. flatten the indices, and find out whether they are sorted already
+  const IntT* x_indices_ptr = x_indices.data<IntT>();
+  std::vector<IntT> keys(nnz);
+  std::vector<IntT> max_keys(thread_num, 0);
+  std::vector<char> sorted(thread_num, 1);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(thread_num)
+#endif
+  for (int t = 0; t < thread_num; ++t) {
+    int64_t begin, end;
+    ThreadRange(nnz, t, thread_num, &begin, &end);
+    IntT max_key = 0;
+    bool is_sorted = true;
+    for (int64_t i = begin; i < end; ++i) {
+      keys[i] = phi::funcs::sparse::CoordinateToIndex(
+          x_indices_ptr, sparse_offsets.data(), nnz, sparse_dim, i);
+      is_sorted = is_sorted && (i == begin || keys[i - 1] <= keys[i]);
+      max_key = std::max(max_key, keys[i]);
+    }
+    max_keys[t] = max_key;
+    sorted[t] = is_sorted;
+  }
+  bool is_sorted = true;
+  for (int t = 0; t < thread_num; ++t) {
+    int64_t begin, end;
+    ThreadRange(nnz, t, thread_num, &begin, &end);
+    is_sorted = is_sorted && sorted[t] &&
+                (begin == 0 || begin == end || keys[begin - 1] <= keys[begin]);
+  }
+
+  // 2. sort the keys, positions[i] is where keys[i] came from
+  std::vector<IntT> positions;
+  if (!is_sorted) {
+    positions.resize(nnz);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(thread_num)
+#endif
+    for (int64_t i = 0; i < nnz; ++i) {
+      positions[i] = i;
+    }
+    RadixSortKeys<IntT>(*std::max_element(max_keys.begin(), max_keys.end()),
+                        thread_num,
+                        &keys,
+                        &positions);
+  }
+
+  // 3. every run of equal keys is an output element, numbered by a prefix
+  // sum over the runs starting in the range of every thread
+  std::vector<int64_t> run_offsets(thread_num + 1, 0);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(thread_num)
+#endif
+  for (int t = 0; t < thread_num; ++t) {
+    int64_t begin, end;
+    ThreadRange(nnz, t, thread_num, &begin, &end);
+    int64_t runs = 0;
+    for (int64_t i = begin; i < end; ++i) {
+      runs += i == 0 || keys[i] != keys[i - 1];
+    }
+    run_offsets[t + 1] = runs;
+  }
+  for (int t = 0; t < thread_num; ++t) {
+    run_offsets[t + 1] += run_offsets[t];
+  }
+  const int64_t out_nnz = run_offsets[thread_num];
 
   const T* x_values_ptr = x_values.data<T>();
   const int64_t stride =
       x.dims().size() == sparse_dim ? 1 : x.values().dims()[1];
 
-  std::map<IntT, std::vector<int64_t>> indices_to_index;
-  for (uint64_t i = 0; i < x_indexs.size(); i++) {
-    IntT index = x_indexs[i];
-    if (indices_to_index.find(index) == indices_to_index.end()) {
-      std::vector<int64_t> indexs;
-      indexs.push_back(i);
-      indices_to_index[index] = indexs;
-    } else {
-      indices_to_index[index].push_back(i);
-    }
+  // already coalesced
+  if (is_sorted && out_nnz == nnz) {
+    memcpy(out_indices.data<IntT>(),
+           x_indices_ptr,
+           sizeof(IntT) * x_indices.numel());
+    memcpy(out_values.data<T>(), x_values_ptr, sizeof(T) * x_values.numel());
+    out->SetMember(out_indices, out_values, x.dims(), true);
+    return;
   }
 
-  const int64_t out_nnz = indices_to_index.size();
-
   out_indices.Resize({x_indices.dims()[0], out_nnz});
   if (out_values.dims().size() == 1) {
     out_values.Resize(phi::make_ddim({out_nnz}));
@@ -70,24 +142,36 @@ void CoalesceCooCPUKernel(const CPUContext& dev_ctx,
 
   IntT* out_indices_ptr = out_indices.data<IntT>();
   T* out_values_ptr = out_values.data<T>();
-  auto iter = indices_to_index.begin();
 
   Dim<DDim::kMaxRank> const_dims;
   for (int i = 0; i < x.dims().size(); i++) {
     const_dims[i] = x.dims()[i];
   }
 
-  for (int i = 0; iter != indices_to_index.end(); iter++, i++) {
-    phi::funcs::sparse::IndexToCoordinate(
-        iter->first, const_dims, out_nnz, sparse_dim, i, out_indices_ptr);
-    memcpy(out_values_ptr + i * stride,
-           x_values_ptr + iter->second[0] * stride,
-           stride * sizeof(T));
-    for (uint64_t j = 1; j < iter->second.size(); j++) {
-      for (int k = 0; k < stride; k++) {
-        out_values_ptr[i * stride + k] +=
-            x_values_ptr[iter->second[j] * stride + k];
+  // 4. sum the values of every run, in the order of the input, by the
+  // thread where the run starts
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(thread_num)
+#endif
+  for (int t = 0; t < thread_num; ++t) {
+    int64_t begin, end;
+    ThreadRange(nnz, t, thread_num, &begin, &end);
+    int64_t out_index = run_offsets[t];
+    for (int64_t i = begin; i < end; ++i) {
+      if (i > 0 && keys[i] == keys[i - 1]) continue;
+      phi::funcs::sparse::IndexToCoordinate(
+          keys[i], const_dims, out_nnz, sparse_dim, out_index, out_indices_ptr);
+      T* out_row = out_values_ptr + out_index * stride;
+      const int64_t first = positions.empty() ? i : positions[i];
+      memcpy(out_row, x_values_ptr + first * stride, stride * sizeof(T));
+      for (int64_t j = i + 1; j < nnz && keys[j] == keys[i]; ++j) {
+        const T* x_row =
+            x_values_ptr + (positions.empty() ? j : positions[j]) * stride;
+        for (int64_t k = 0; k < stride; k++) {
+          out_row[k] += x_row[k];
+        }
       }
+      ++out_index;
     }
   }
 
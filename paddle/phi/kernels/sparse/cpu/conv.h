@@ -14,7 +14,12 @@ limitations under the License. */
 
 #pragma once
 
-#include <set>
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <vector>
 
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/kernel_registry.h"
@@ -28,9 +33,67 @@ namespace sparse {
 
 using Dims4D = phi::funcs::sparse::Dims4D;
 
+// An open addressing hash map from the linear index of a voxel to an IntT,
+// with linear probing. Linear indices are never negative, so -1 marks an
+// empty slot.
+template <typename IntT>
+class VoxelHashMap {
+ public:
+  explicit VoxelHashMap(int64_t num) {
+    int bits = 4;
+    while ((int64_t{1} << bits) < num * 2) bits++;
+    shift_ = 64 - bits;
+    mask_ = (int64_t{1} << bits) - 1;
+    slots_.assign(mask_ + 1, Slot{-1, 0});
+  }
+
+  // Returns false if key is already in the map.
+  bool Insert(IntT key, IntT value) {
+    for (int64_t i = Hash(key);; i = (i + 1) & mask_) {
+      if (slots_[i].key == key) return false;
+      if (slots_[i].key == -1) {
+        slots_[i].key = key;
+        slots_[i].value = value;
+        return true;
+      }
+    }
+  }
+
+  IntT* Find(IntT key) {
+    return const_cast<IntT*>(static_cast<const VoxelHashMap*>(this)->Find(key));
+  }
+
+  const IntT* Find(IntT key) const {
+    for (int64_t i = Hash(key);; i = (i + 1) & mask_) {
+      if (slots_[i].key == key) return &slots_[i].value;
+      if (slots_[i].key == -1) return nullptr;
+    }
+  }
+
+ private:
+  struct Slot {
+    IntT key;
+    IntT value;
+  };
+  int64_t Hash(IntT key) const {
+    // Fibonacci hashing, so that neighbouring voxels don't cluster.
+    return static_cast<int64_t>(
+        (static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL) >> shift_);
+  }
+
+  int shift_;
+  int64_t mask_;
+  std::vector<Slot> slots_;
+};
+
+// Voxels are split into chunks of this size to build the rulebook in
+// parallel. The chunks don't depend on the number of threads, so the
+// rulebook is the same for any of them.
+constexpr int64_t kRulebookChunkSize = 4096;
+
 // such as: kernel(3, 3, 3), kernel_size = 27
 // counter_per_weight: (kernel_size)
-// TODO(zhangkaihuo): optimize performance with multithreading
+// The rules are sorted by kernel offset, then by input row.
 template <typename T, typename Context, typename IntT = int>
 void ProductRuleBook(const Context& dev_ctx,
                      const SparseCooTensor& x,
@@ -48,89 +111,135 @@ void ProductRuleBook(const Context& dev_ctx,
   int kernel_size = kernel_sizes[0] * kernel_sizes[1] * kernel_sizes[2];
   memset(counter_per_kernel, 0, kernel_size * sizeof(int));
 
-  int rulebook_len = 0;
-  // calc the rulebook_len
   const auto& x_dims = x.dims();
   const Dims4D c_x_dims(x_dims[0], x_dims[3], x_dims[2], x_dims[1]);
   const Dims4D c_kernel_dims(
       1, kernel_sizes[2], kernel_sizes[1], kernel_sizes[0]);
-  const Dims4D c_out_dims(out_dims[0], out_dims[3], out_dims[2], out_dims[1]);
   const Dims4D c_paddings(1, paddings[2], paddings[1], paddings[0]);
   const Dims4D c_strides(1, strides[2], strides[1], strides[0]);
   const Dims4D c_dilations(1, dilations[2], dilations[1], dilations[0]);
 
-  std::set<IntT> hash_in;
+  // The input voxels an output of subm conv must hit, built once.
+  VoxelHashMap<IntT> hash_in(subm ? non_zero_num : 0);
   if (subm) {
-    for (int i = 0; i < non_zero_num; i++) {
+    for (int64_t i = 0; i < non_zero_num; i++) {
       IntT batch = indices_ptr[i];
       IntT in_z = indices_ptr[i + non_zero_num];
       IntT in_y = indices_ptr[i + 2 * non_zero_num];
       IntT in_x = indices_ptr[i + 3 * non_zero_num];
       IntT index = phi::funcs::sparse::PointToIndex<DDim>(
           batch, in_x, in_y, in_z, x_dims);
-      hash_in.insert(index);
+      hash_in.Insert(index, static_cast<IntT>(i));
     }
   }
 
-  auto f_calc_rulebook = [&](IntT* rulebook_ptr) {
-    int kernel_index = 0, rulebook_index = 0;
-    for (int kz = 0; kz < kernel_sizes[0]; kz++) {
-      for (int ky = 0; ky < kernel_sizes[1]; ky++) {
-        for (int kx = 0; kx < kernel_sizes[2]; kx++) {
-          ++kernel_index;
-          for (int64_t i = 0; i < non_zero_num; i++) {
-            IntT batch = indices_ptr[i];
-            IntT in_z = indices_ptr[i + non_zero_num];
-            IntT in_y = indices_ptr[i + 2 * non_zero_num];
-            IntT in_x = indices_ptr[i + 3 * non_zero_num];
-            IntT out_z = (in_z + paddings[0] - kz * dilations[0]) / strides[0];
-            IntT out_y = (in_y + paddings[1] - ky * dilations[1]) / strides[1];
+  // Calls f(kernel_index, in_i, out_index) for the rules of voxels
+  // [begin, end), by voxel and then by kernel offset. The bounds of an axis
+  // are checked once for all the offsets that share it.
+  auto f_visit_rules = [&](int64_t begin, int64_t end, auto&& f) {
+    for (int64_t i = begin; i < end; i++) {
+      IntT batch = indices_ptr[i];
+      IntT in_z = indices_ptr[i + non_zero_num];
+      IntT in_y = indices_ptr[i + 2 * non_zero_num];
+      IntT in_x = indices_ptr[i + 3 * non_zero_num];
+      for (int kz = 0; kz < kernel_sizes[0]; kz++) {
+        if (!phi::funcs::sparse::Check(in_z,
+                                       kz,
+                                       c_paddings[1],
+                                       c_strides[1],
+                                       c_dilations[1],
+                                       c_kernel_dims[1],
+                                       c_x_dims[1])) {
+          continue;
+        }
+        IntT out_z = (in_z + paddings[0] - kz * dilations[0]) / strides[0];
+        for (int ky = 0; ky < kernel_sizes[1]; ky++) {
+          if (!phi::funcs::sparse::Check(in_y,
+                                         ky,
+                                         c_paddings[2],
+                                         c_strides[2],
+                                         c_dilations[2],
+                                         c_kernel_dims[2],
+                                         c_x_dims[2])) {
+            continue;
+          }
+          IntT out_y = (in_y + paddings[1] - ky * dilations[1]) / strides[1];
+          for (int kx = 0; kx < kernel_sizes[2]; kx++) {
+            if (!phi::funcs::sparse::Check(in_x,
+                                           kx,
+                                           c_paddings[3],
+                                           c_strides[3],
+                                           c_dilations[3],
+                                           c_kernel_dims[3],
+                                           c_x_dims[3])) {
+              continue;
+            }
             IntT out_x = (in_x + paddings[2] - kx * dilations[2]) / strides[2];
-            if (phi::funcs::sparse::Check(c_x_dims,
-                                          c_kernel_dims,
-                                          c_paddings,
-                                          c_dilations,
-                                          c_strides,
-                                          in_x,
-                                          in_y,
-                                          in_z,
-                                          kx,
-                                          ky,
-                                          kz)) {
-              if (subm) {
-                IntT out_index = phi::funcs::sparse::PointToIndex<DDim>(
-                    batch, out_x, out_y, out_z, out_dims);
-                if (hash_in.find(out_index) == hash_in.end()) {
-                  continue;
-                }
-              }
-
-              if (rulebook_ptr == nullptr) {
-                counter_per_kernel[kernel_index - 1] += 1;
-                ++rulebook_len;
-              } else {
-                rulebook_ptr[rulebook_index] = kernel_index - 1;
-                rulebook_ptr[rulebook_index + rulebook_len] = i;  // in_i
-                rulebook_ptr[rulebook_index + rulebook_len * 2] =
-                    phi::funcs::sparse::PointToIndex<DDim>(
-                        batch, out_x, out_y, out_z, out_dims);  // out_index
-                ++rulebook_index;
-              }
+            IntT out_index = phi::funcs::sparse::PointToIndex<DDim>(
+                batch, out_x, out_y, out_z, out_dims);
+            if (subm && hash_in.Find(out_index) == nullptr) {
+              continue;
             }
+            f((kz * kernel_sizes[1] + ky) * kernel_sizes[2] + kx, i, out_index);
           }
         }
       }
     }
   };
 
-  f_calc_rulebook(nullptr);
-  // alloc the rulebook
+  // 1. find the rules of every chunk, voxel by voxel, and count them by
+  // kernel offset
+  const int64_t chunk_num =
+      (non_zero_num + kRulebookChunkSize - 1) / kRulebookChunkSize;
+  std::vector<std::vector<IntT>> chunk_rules(chunk_num);
+  std::vector<int> chunk_offsets(chunk_num * kernel_size, 0);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t c = 0; c < chunk_num; c++) {
+    int* chunk_counter = chunk_offsets.data() + c * kernel_size;
+    std::vector<IntT>* rules = &chunk_rules[c];
+    f_visit_rules(c * kRulebookChunkSize,
+                  std::min(non_zero_num, (c + 1) * kRulebookChunkSize),
+                  [&](int kernel_index, int64_t in_i, IntT out_index) {
+                    chunk_counter[kernel_index]++;
+                    rules->push_back(kernel_index);
+                    rules->push_back(in_i);
+                    rules->push_back(out_index);
+                  });
+  }
+
+  // 2. where the rules of every chunk start, grouped by kernel offset
+  int rulebook_len = 0;
+  for (int k = 0; k < kernel_size; k++) {
+    for (int64_t c = 0; c < chunk_num; c++) {
+      int count = chunk_offsets[c * kernel_size + k];
+      chunk_offsets[c * kernel_size + k] = rulebook_len;
+      rulebook_len += count;
+      counter_per_kernel[k] += count;
+    }
+  }
+
+  // 3. move the rules into the rulebook
   *rulebook = phi::Empty(dev_ctx,
                          DenseTensorMeta(phi::CppTypeToDataType<IntT>::Type(),
                                          {3, rulebook_len},
                                          DataLayout::NCHW));
   IntT* rulebook_ptr = rulebook->data<IntT>();
-  f_calc_rulebook(rulebook_ptr);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t c = 0; c < chunk_num; c++) {
+    int* chunk_offset = chunk_offsets.data() + c * kernel_size;
+    const std::vector<IntT>& rules = chunk_rules[c];
+    for (size_t j = 0; j < rules.size(); j += 3) {
+      int pos = chunk_offset[rules[j]]++;
+      rulebook_ptr[pos] = rules[j];
+      rulebook_ptr[pos + rulebook_len] = rules[j + 1];
+      rulebook_ptr[pos + rulebook_len * 2] = rules[j + 2];
+    }
+    std::vector<IntT>().swap(chunk_rules[c]);
+  }
 }
 
 template <typename T, typename Context, typename IntT = int>
@@ -141,12 +250,17 @@ void UpdateRulebookAndOutIndex(const Context& dev_ctx,
                                const DDim& out_dims,
                                DenseTensor* rulebook,
                                SparseCooTensor* out) {
-  std::set<IntT> out_indexs;
   int n = rulebook->dims()[1];
   IntT* rulebook_ptr = rulebook->data<IntT>();
+  // the distinct outputs, and then the row of each of them in out
+  VoxelHashMap<IntT> out_rows(n);
+  std::vector<IntT> out_indexs;
   for (int i = 0; i < n; i++) {
-    out_indexs.insert(rulebook_ptr[i + n * 2]);
+    if (out_rows.Insert(rulebook_ptr[i + n * 2], 0)) {
+      out_indexs.push_back(rulebook_ptr[i + n * 2]);
+    }
   }
+  std::sort(out_indexs.begin(), out_indexs.end());
 
   int out_non_zero_num = out_indexs.size();
   const int64_t sparse_dim = 4;
@@ -158,20 +272,24 @@ void UpdateRulebookAndOutIndex(const Context& dev_ctx,
   phi::DenseTensor out_indices = phi::Empty(dev_ctx, std::move(indices_meta));
   phi::DenseTensor out_values = phi::Empty(dev_ctx, std::move(values_meta));
   IntT* out_indices_ptr = out_indices.data<IntT>();
-  int i = 0;
-  for (auto it = out_indexs.begin(); it != out_indexs.end(); it++, i++) {
-    const IntT index = *it;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < out_non_zero_num; i++) {
+    const IntT index = out_indexs[i];
     IntT batch, x, y, z;
     phi::funcs::sparse::IndexToPoint<DDim>(index, out_dims, &batch, &x, &y, &z);
     out_indices_ptr[i] = batch;
     out_indices_ptr[i + out_non_zero_num] = z;
     out_indices_ptr[i + out_non_zero_num * 2] = y;
     out_indices_ptr[i + out_non_zero_num * 3] = x;
+    *out_rows.Find(index) = i;
   }
-  for (i = 0; i < n; i++) {
-    IntT out_index = rulebook_ptr[i + n * 2];
-    rulebook_ptr[i + n * 2] =
-        std::distance(out_indexs.begin(), out_indexs.find(out_index));
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < n; i++) {
+    rulebook_ptr[i + n * 2] = *out_rows.Find(rulebook_ptr[i + n * 2]);
   }
 
   out->SetMember(out_indices, out_values, out_dims, true);
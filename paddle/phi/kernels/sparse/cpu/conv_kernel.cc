@@ -12,6 +12,8 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <algorithm>
+
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_meta.h"
 #include "paddle/phi/core/tensor_utils.h"
@@ -22,6 +24,10 @@ limitations under the License. */
 namespace phi {
 namespace sparse {
 
+// The features of a block of rules, gathered inputs and gemm outputs, take
+// about this many bytes.
+constexpr int kConvBlockBytes = 256 * 1024;
+
 /**
  * x: (N, D, H, W, C)
  * kernel: (D, H, W, C, OC)
@@ -114,23 +120,6 @@ void Conv3dCooCPUKernel(const CPUContext& dev_ctx,
   }
   // int n = rulebook->dims()[1];
 
-  // 2. gather
-  DenseTensorMeta in_features_meta(
-      x.dtype(), {n, in_channels}, DataLayout::NHWC);
-  DenseTensorMeta out_features_meta(
-      x.dtype(), {n, out_channels}, DataLayout::NHWC);
-  phi::DenseTensor in_features =
-      phi::Empty(dev_ctx, std::move(in_features_meta));
-  phi::DenseTensor out_features =
-      phi::Empty(dev_ctx, std::move(out_features_meta));
-  T* in_features_ptr = in_features.data<T>();
-  T* out_features_ptr = out_features.data<T>();
-
-  Gather<T, IntT>(
-      x.values().data<T>(), rulebook_ptr + n, n, in_channels, in_features_ptr);
-
-  // 3. call gemm for every werght
-  auto blas = phi::funcs::GetBlas<CPUContext, T>(dev_ctx);
   int offset = 0;
   for (int i = 0; i < kernel_size; i++) {
     h_offsets_ptr[i] = offset;
@@ -138,36 +127,66 @@ void Conv3dCooCPUKernel(const CPUContext& dev_ctx,
   }
   h_offsets_ptr[kernel_size] = offset;
 
+  // 2. gather, gemm and scatter, fused for every kernel offset and done a
+  // block of rules at a time, so that the features of a block stay in
+  // cache. The rules of one kernel offset write distinct output rows, so
+  // the blocks of an offset run in parallel.
+  const int block_rows = std::max<int>(
+      16, kConvBlockBytes / ((in_channels + out_channels) * sizeof(T)));
+  int thread_num = 1;
+#ifdef PADDLE_WITH_MKLML
+  thread_num = omp_get_max_threads();
+#endif
+  DenseTensorMeta buffer_meta(
+      x.dtype(),
+      {thread_num, block_rows * (in_channels + out_channels)},
+      DataLayout::NHWC);
+  phi::DenseTensor buffer = phi::Empty(dev_ctx, std::move(buffer_meta));
+  T* buffer_ptr = buffer.data<T>();
+
+  auto blas = phi::funcs::GetBlas<CPUContext, T>(dev_ctx);
+  const T* x_values_ptr = x.values().data<T>();
   const T* kernel_ptr = kernel.data<T>();
+  T* out_values_ptr = out->mutable_values()->data<T>();
+  memset(out_values_ptr, 0, sizeof(T) * out->nnz() * out_channels);
   for (int i = 0; i < kernel_size; i++) {
     if (h_counter_ptr[i] <= 0) {
       continue;
     }
-
-    // call gemm: (n, in_channels) * (in_channels, out_channels)
-    const int M = h_counter_ptr[i];
+    const int count = h_counter_ptr[i];
     const int K = in_channels;   // in_channels
     const int N = out_channels;  // out_channels
-    T* tmp_in_ptr = in_features_ptr + h_offsets_ptr[i] * in_channels;
+    const IntT* in_rules = rulebook_ptr + n + h_offsets_ptr[i];
+    const IntT* out_rules = rulebook_ptr + n * 2 + h_offsets_ptr[i];
     const T* tmp_kernel_ptr = kernel_ptr + i * K * N;
-    T* tmp_out_ptr = out_features_ptr + h_offsets_ptr[i] * out_channels;
-    blas.GEMM(CblasNoTrans,
-              CblasNoTrans,
-              M,
-              N,
-              K,
-              static_cast<T>(1),
-              tmp_in_ptr,
-              tmp_kernel_ptr,
-              static_cast<T>(0),
-              tmp_out_ptr);
+    const int block_num = (count + block_rows - 1) / block_rows;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int b = 0; b < block_num; b++) {
+      int thread_id = 0;
+#ifdef PADDLE_WITH_MKLML
+      thread_id = omp_get_thread_num();
+#endif
+      T* in_block = buffer_ptr + thread_id * block_rows * (K + N);
+      T* out_block = in_block + block_rows * K;
+      const int begin = b * block_rows;
+      const int M = std::min(block_rows, count - begin);
+      Gather<T, IntT>(x_values_ptr, in_rules + begin, M, K, in_block);
+      // call gemm: (M, in_channels) * (in_channels, out_channels)
+      blas.GEMM(CblasNoTrans,
+                CblasNoTrans,
+                M,
+                N,
+                K,
+                static_cast<T>(1),
+                in_block,
+                tmp_kernel_ptr,
+                static_cast<T>(0),
+                out_block);
+      Scatter<T, IntT>(out_block, out_rules + begin, M, N, out_values_ptr);
+    }
   }
-
-  // 4. scatter
-  T* out_values_ptr = out->mutable_values()->data<T>();
-  memset(out_values_ptr, 0, sizeof(T) * out->nnz() * out_channels);
-  Scatter<T, IntT>(
-      out_features_ptr, rulebook_ptr + n * 2, n, out_channels, out_values_ptr);
 }
 
 template <typename T, typename Context>
@@ -0,0 +1,226 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/kernels/funcs/cpu_vec.h"
+
+namespace phi {
+namespace sparse {
+
+// A batched CSR tensor holds `batch` matrices of `rows` rows. The crows of
+// every matrix start from 0 and take rows + 1 entries, its cols and values
+// follow the ones of the previous matrix. Returns where the non zero
+// elements of every matrix start, and their total number at the end.
+template <typename IntT>
+std::vector<int64_t> CsrBatchOffsets(const IntT* crows,
+                                     int64_t batch,
+                                     int64_t rows) {
+  std::vector<int64_t> offsets(batch + 1, 0);
+  for (int64_t b = 0; b < batch; ++b) {
+    offsets[b + 1] = offsets[b] + crows[b * (rows + 1) + rows];
+  }
+  return offsets;
+}
+
+// Splits the batch * rows rows of a batched CSR tensor into one range per
+// thread, so that every range holds about as many non zero elements, with
+// every row counting as one more for the output row it writes. Skewed rows,
+// e.g. the global tokens of sparse attention, don't stall a single thread.
+template <typename IntT>
+std::vector<int64_t> PartitionCsrRows(const IntT* crows,
+                                      const std::vector<int64_t>& offsets,
+                                      int64_t rows) {
+  const int64_t batch = offsets.size() - 1;
+  const int64_t total_rows = batch * rows;
+  int parts = 1;
+#ifdef PADDLE_WITH_MKLML
+  parts = omp_get_max_threads();
+#endif
+  std::vector<int64_t> bounds(parts + 1, total_rows);
+  bounds[0] = 0;
+  if (total_rows == 0) {
+    return bounds;
+  }
+
+  // the cost of the rows before the global row g
+  auto cost = [&](int64_t g) {
+    if (g == total_rows) return offsets[batch] + g;
+    const int64_t b = g / rows;
+    return offsets[b] + crows[b * (rows + 1) + g % rows] + g;
+  };
+  const int64_t total = cost(total_rows);
+  for (int p = 1; p < parts; ++p) {
+    const int64_t target = total * p / parts;
+    int64_t lo = bounds[p - 1], hi = total_rows;
+    while (lo < hi) {
+      const int64_t mid = lo + (hi - lo) / 2;
+      if (cost(mid) < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    bounds[p] = lo;
+  }
+  return bounds;
+}
+
+// out(b) = x(b) * y(b) for a batched CSR x of (rows, k) matrices and dense
+// y of (k, n) matrices. Every output row accumulates the rows of y picked
+// by its non zero elements, two at a time so that it is loaded and stored
+// half as often, in loops the compiler vectorizes.
+template <typename T, typename IntT>
+void CsrDenseMatmul(const IntT* crows,
+                    const IntT* cols,
+                    const T* values,
+                    int64_t batch,
+                    int64_t rows,
+                    int64_t k,
+                    const T* y,
+                    int64_t n,
+                    T* out) {
+  const std::vector<int64_t> offsets = CsrBatchOffsets(crows, batch, rows);
+  const std::vector<int64_t> bounds = PartitionCsrRows(crows, offsets, rows);
+  const int parts = bounds.size() - 1;
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int p = 0; p < parts; ++p) {
+    for (int64_t g = bounds[p]; g < bounds[p + 1]; ++g) {
+      const int64_t b = g / rows;
+      const IntT* row_ptr = crows + b * (rows + 1) + g % rows;
+      const T* y_mat = y + b * k * n;
+      T* out_row = out + g * n;
+      std::fill(out_row, out_row + n, static_cast<T>(0));
+
+      int64_t j = offsets[b] + row_ptr[0];
+      const int64_t end = offsets[b] + row_ptr[1];
+      for (; j + 1 < end; j += 2) {
+        const T v0 = values[j];
+        const T v1 = values[j + 1];
+        const T* y0 = y_mat + cols[j] * n;
+        const T* y1 = y_mat + cols[j + 1] * n;
+        for (int64_t c = 0; c < n; ++c) {
+          out_row[c] += v0 * y0[c] + v1 * y1[c];
+        }
+      }
+      if (j < end) {
+        const T v0 = values[j];
+        const T* y0 = y_mat + cols[j] * n;
+        for (int64_t c = 0; c < n; ++c) {
+          out_row[c] += v0 * y0[c];
+        }
+      }
+    }
+  }
+}
+
+// out_values = (x(b) * y(b)') at the non zero elements of a batched CSR mask
+// of (rows, n) matrices, for dense x of (rows, k) and y of (n, k) matrices,
+// i.e. SDDMM. Every element is the inner product of two contiguous rows.
+template <typename T, typename IntT>
+void MaskedDenseMatmul(const IntT* crows,
+                       const IntT* cols,
+                       int64_t batch,
+                       int64_t rows,
+                       const T* x,
+                       const T* y,
+                       int64_t k,
+                       int64_t n,
+                       T* out_values) {
+  const std::vector<int64_t> offsets = CsrBatchOffsets(crows, batch, rows);
+  const std::vector<int64_t> bounds = PartitionCsrRows(crows, offsets, rows);
+  const int parts = bounds.size() - 1;
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int p = 0; p < parts; ++p) {
+    for (int64_t g = bounds[p]; g < bounds[p + 1]; ++g) {
+      const int64_t b = g / rows;
+      const IntT* row_ptr = crows + b * (rows + 1) + g % rows;
+      const T* x_row = x + g * k;
+      const T* y_mat = y + b * n * k;
+      for (int64_t j = offsets[b] + row_ptr[0]; j < offsets[b] + row_ptr[1];
+           ++j) {
+        if (k == 0) {
+          out_values[j] = static_cast<T>(0);
+          continue;
+        }
+        phi::funcs::vec_mul_reduce<T, backends::cpu::avx>(
+            k, x_row, y_mat + cols[j] * k, out_values + j);
+      }
+    }
+  }
+}
+
+// Transposes a batched CSR tensor of (rows, cols_num) matrices into one of
+// (cols_num, rows) matrices, i.e. into CSC, by a counting sort of every
+// matrix. t_crows takes batch * (cols_num + 1) entries.
+template <typename T, typename IntT>
+void CsrTranspose(const IntT* crows,
+                  const IntT* cols,
+                  const T* values,
+                  int64_t batch,
+                  int64_t rows,
+                  int64_t cols_num,
+                  IntT* t_crows,
+                  IntT* t_cols,
+                  T* t_values) {
+  const std::vector<int64_t> offsets = CsrBatchOffsets(crows, batch, rows);
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t b = 0; b < batch; ++b) {
+    const IntT* b_crows = crows + b * (rows + 1);
+    const IntT* b_cols = cols + offsets[b];
+    const T* b_values = values + offsets[b];
+    IntT* b_t_crows = t_crows + b * (cols_num + 1);
+    IntT* b_t_cols = t_cols + offsets[b];
+    T* b_t_values = t_values + offsets[b];
+    const IntT nnz = b_crows[rows];
+
+    std::fill(b_t_crows, b_t_crows + cols_num + 1, static_cast<IntT>(0));
+    for (IntT j = 0; j < nnz; ++j) {
+      ++b_t_crows[b_cols[j] + 1];
+    }
+    for (int64_t c = 0; c < cols_num; ++c) {
+      b_t_crows[c + 1] += b_t_crows[c];
+    }
+    // next free slot of every column, visited in row order so that the
+    // rows of a column stay sorted
+    std::vector<IntT> next(b_t_crows, b_t_crows + cols_num);
+    for (int64_t i = 0; i < rows; ++i) {
+      for (IntT j = b_crows[i]; j < b_crows[i + 1]; ++j) {
+        const IntT dst = next[b_cols[j]]++;
+        b_t_cols[dst] = static_cast<IntT>(i);
+        b_t_values[dst] = b_values[j];
+      }
+    }
+  }
+}
+
+}  // namespace sparse
+}  // namespace phi
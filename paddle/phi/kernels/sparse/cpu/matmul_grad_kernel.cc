@@ -14,34 +14,191 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/sparse/matmul_grad_kernel.h"
 
+#include <vector>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/meta_tensor.h"
+#include "paddle/phi/core/visit_type.h"
+#include "paddle/phi/kernels/empty_kernel.h"
+#include "paddle/phi/kernels/sparse/cpu/matmul.h"
+#include "paddle/phi/kernels/sparse/empty_kernel.h"
+#include "paddle/phi/kernels/transpose_kernel.h"
 
 namespace phi {
 namespace sparse {
 
-// TODO(zhouwei25): implement CPU backward kernel of " CSR @ DENSE -> DENSE"
+template <typename T, typename IntT, typename Context>
+void MatmulCsrDenseGradCPUKernel(const Context& dev_ctx,
+                                 const SparseCsrTensor& x,
+                                 const DenseTensor& y,
+                                 const DenseTensor& dout,
+                                 SparseCsrTensor* dx,
+                                 DenseTensor* dy) {
+  std::vector<int64_t> xdim_vec = phi::vectorize(x.dims());
+  const size_t ndims = xdim_vec.size();
+  const int64_t rows = xdim_vec[ndims - 2];
+  const int64_t k = xdim_vec[ndims - 1];
+  const int64_t n = y.dims()[ndims - 1];
+  int64_t batch = 1;
+  for (size_t i = 0; i < ndims - 2; ++i) {
+    batch *= xdim_vec[i];
+  }
+
+  // dx{SparseCsr} = dout{Dense} * y'{Dense}
+  if (dx) {
+    // InferMeta of SparseCsrTensor 'dx', CreateLikeInferMeta
+    EmptyLikeCsrKernel<T, Context>(dev_ctx, x, dx);
+    MaskedDenseMatmul<T, IntT>(x.crows().data<IntT>(),
+                               x.cols().data<IntT>(),
+                               batch,
+                               rows,
+                               dout.data<T>(),
+                               y.data<T>(),
+                               n,
+                               k,
+                               dx->mutable_values()->data<T>());
+  }
+
+  // dy{Dense} = x'{SparseCsr} * dout{Dense}
+  if (dy) {
+    // InferMeta of DenseTensor 'dy'
+    MetaTensor meta_dy(dy);
+    meta_dy.set_dims(y.dims());
+    meta_dy.set_dtype(y.dtype());
+    T* dy_ptr = dev_ctx.template Alloc<T>(dy);
+
+    DenseTensor trans_crows = phi::Empty<IntT>(dev_ctx, {batch * (k + 1)});
+    DenseTensor trans_cols = phi::Empty<IntT>(dev_ctx, {x.nnz()});
+    DenseTensor trans_values = phi::Empty<T>(dev_ctx, {x.nnz()});
+    CsrTranspose<T, IntT>(x.crows().data<IntT>(),
+                          x.cols().data<IntT>(),
+                          x.values().data<T>(),
+                          batch,
+                          rows,
+                          k,
+                          trans_crows.data<IntT>(),
+                          trans_cols.data<IntT>(),
+                          trans_values.data<T>());
+    CsrDenseMatmul<T, IntT>(trans_crows.data<IntT>(),
+                            trans_cols.data<IntT>(),
+                            trans_values.data<T>(),
+                            batch,
+                            k,
+                            rows,
+                            dout.data<T>(),
+                            n,
+                            dy_ptr);
+  }
+}
+
+/* Backward of "CSR @ DENSE -> DENSE" */
 template <typename T, typename Context>
-void MatmulCsrDenseGradKernel(const Context& dev_ctx UNUSED,
-                              const SparseCsrTensor& x UNUSED,
-                              const DenseTensor& y UNUSED,
-                              const DenseTensor& dout UNUSED,
-                              SparseCsrTensor* dx UNUSED,
-                              DenseTensor* dy UNUSED) {
-  PADDLE_THROW(phi::errors::Unimplemented(
-      "Not support CPU backward kernel of 'sparse.matmul' now."));
+void MatmulCsrDenseGradKernel(const Context& dev_ctx,
+                              const SparseCsrTensor& x,
+                              const DenseTensor& y,
+                              const DenseTensor& dout,
+                              SparseCsrTensor* dx,
+                              DenseTensor* dy) {
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      x.crows().dtype(), "MatmulCsrDenseGradCPUKernel", ([&] {
+        MatmulCsrDenseGradCPUKernel<T, data_t>(dev_ctx, x, y, dout, dx, dy);
+      }));
+}
+
+template <typename T, typename IntT, typename Context>
+void MaskedMatmulCsrGradCPUKernel(const Context& dev_ctx,
+                                  const DenseTensor& x,
+                                  const DenseTensor& y,
+                                  const SparseCsrTensor& dout,
+                                  DenseTensor* dx,
+                                  DenseTensor* dy) {
+  std::vector<int64_t> xdim_vec = phi::vectorize(x.dims());
+  const size_t ndims = xdim_vec.size();
+  const int64_t rows = xdim_vec[ndims - 2];
+  const int64_t k = xdim_vec[ndims - 1];
+  const int64_t n = y.dims()[ndims - 1];
+  int64_t batch = 1;
+  for (size_t i = 0; i < ndims - 2; ++i) {
+    batch *= xdim_vec[i];
+  }
+
+  // dx{Dense} = dout{SparseCsr} * y'{Dense}
+  if (dx) {
+    // InferMeta of DenseTensor 'dx'
+    MetaTensor meta_dx(dx);
+    meta_dx.set_dims(x.dims());
+    meta_dx.set_dtype(x.dtype());
+    T* dx_ptr = dev_ctx.template Alloc<T>(dx);
+
+    DenseTensor trans_y = TransposeLast2Dim<T, Context>(dev_ctx, y);
+    CsrDenseMatmul<T, IntT>(dout.crows().data<IntT>(),
+                            dout.cols().data<IntT>(),
+                            dout.values().data<T>(),
+                            batch,
+                            rows,
+                            n,
+                            trans_y.data<T>(),
+                            k,
+                            dx_ptr);
+  }
+
+  // dy{Dense} = x'{Dense} * dout{SparseCsr}
+  // That is: dy'{Dense} = dout'{SparseCsr} * x{Dense}
+  if (dy) {
+    DenseTensor trans_crows = phi::Empty<IntT>(dev_ctx, {batch * (n + 1)});
+    DenseTensor trans_cols = phi::Empty<IntT>(dev_ctx, {dout.nnz()});
+    DenseTensor trans_values = phi::Empty<T>(dev_ctx, {dout.nnz()});
+    CsrTranspose<T, IntT>(dout.crows().data<IntT>(),
+                          dout.cols().data<IntT>(),
+                          dout.values().data<T>(),
+                          batch,
+                          rows,
+                          n,
+                          trans_crows.data<IntT>(),
+                          trans_cols.data<IntT>(),
+                          trans_values.data<T>());
+
+    std::vector<int> trans_dim_vec = phi::vectorize<int>(y.dims());
+    std::swap(trans_dim_vec[ndims - 1], trans_dim_vec[ndims - 2]);
+    DenseTensor trans_dy = phi::Empty<T, Context>(dev_ctx, trans_dim_vec);
+    CsrDenseMatmul<T, IntT>(trans_crows.data<IntT>(),
+                            trans_cols.data<IntT>(),
+                            trans_values.data<T>(),
+                            batch,
+                            n,
+                            rows,
+                            x.data<T>(),
+                            k,
+                            trans_dy.data<T>());
+
+    // InferMeta of DenseTensor 'dy'
+    MetaTensor meta_dy(dy);
+    meta_dy.set_dims(y.dims());
+    meta_dy.set_dtype(y.dtype());
+    dev_ctx.template Alloc<T>(dy);
+
+    std::vector<int> axis(ndims);
+    for (size_t i = 0; i < ndims; ++i) {
+      axis[i] = i;
+    }
+    std::swap(axis[ndims - 1], axis[ndims - 2]);
+    TransposeKernel<T, Context>(dev_ctx, trans_dy, axis, dy);
+  }
 }
 
-// TODO(zhouwei25): implement CPU kernel of " DENSE @ DENSE * CSR_MASK -> CSR"
+/* Backward of "DENSE @ DENSE * CSR_MASK -> CSR" */
 template <typename T, typename Context>
-void MaskedMatmulCsrGradKernel(const Context& dev_ctx UNUSED,
-                               const DenseTensor& x UNUSED,
-                               const DenseTensor& y UNUSED,
-                               const SparseCsrTensor& dout UNUSED,
-                               DenseTensor* dx UNUSED,
-                               DenseTensor* dy UNUSED) {
-  PADDLE_THROW(phi::errors::Unimplemented(
-      "Not support CPU backward kernel of 'sparse.masked_matmul' now."));
+void MaskedMatmulCsrGradKernel(const Context& dev_ctx,
+                               const DenseTensor& x,
+                               const DenseTensor& y,
+                               const SparseCsrTensor& dout,
+                               DenseTensor* dx,
+                               DenseTensor* dy) {
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      dout.crows().dtype(), "MaskedMatmulCsrGradCPUKernel", ([&] {
+        MaskedMatmulCsrGradCPUKernel<T, data_t>(dev_ctx, x, y, dout, dx, dy);
+      }));
 }
 
 }  // namespace sparse
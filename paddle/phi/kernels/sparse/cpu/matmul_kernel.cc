@@ -14,31 +14,188 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/sparse/matmul_kernel.h"
 
+#include <vector>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/meta_tensor.h"
+#include "paddle/phi/core/visit_type.h"
+#include "paddle/phi/kernels/sparse/cpu/matmul.h"
+#include "paddle/phi/kernels/sparse/empty_kernel.h"
+#include "paddle/phi/kernels/transpose_kernel.h"
 
 namespace phi {
 namespace sparse {
 
-// TODO(zhouwei25): implement CPU kernel of " CSR @ DENSE -> DENSE"
+template <typename T, typename IntT, typename Context>
+void MatmulCsrDenseCPUKernel(const Context& dev_ctx,
+                             const SparseCsrTensor& x,
+                             const DenseTensor& y,
+                             DenseTensor* out) {
+  std::vector<int64_t> xdim_vec = phi::vectorize(x.dims());
+  std::vector<int64_t> ydim_vec = phi::vectorize(y.dims());
+  auto x_ndims = xdim_vec.size();
+  auto y_ndims = ydim_vec.size();
+  PADDLE_ENFORCE_EQ(
+      x_ndims,
+      y_ndims,
+      phi::errors::PreconditionNotMet("The dims size of Input(x) and Input(y) "
+                                      "should be equal, But received X's "
+                                      "dimensions=%d, Y's dimensions=%d.",
+                                      x_ndims,
+                                      y_ndims));
+  PADDLE_ENFORCE_GE(
+      x_ndims,
+      2,
+      phi::errors::InvalidArgument("the dims size of Input(x) and "
+                                   "Input(y) must be greater than "
+                                   "or eaqual to 2."));
+  for (size_t i = 0; i < x_ndims - 2; ++i) {
+    PADDLE_ENFORCE_EQ(xdim_vec[i],
+                      ydim_vec[i],
+                      phi::errors::InvalidArgument(
+                          "x.dim[%d] and y.dim[%d] must be eaqul.", i, i));
+  }
+  PADDLE_ENFORCE_EQ(
+      xdim_vec[x_ndims - 1],
+      ydim_vec[y_ndims - 2],
+      phi::errors::PreconditionNotMet(
+          "The shape of Input(x) and Input(y) is not suitable for matmul "
+          "opetation, x_dim[-1] must be eaqual to y_dim[-2]."));
+
+  // InferMeta of DenseTensor 'out'
+  std::vector<int64_t> out_dim_vec(ydim_vec);
+  out_dim_vec[y_ndims - 2] = xdim_vec[x_ndims - 2];
+  out_dim_vec[y_ndims - 1] = ydim_vec[y_ndims - 1];
+  MetaTensor meta_out(out);
+  meta_out.set_dims(phi::make_ddim(out_dim_vec));
+  meta_out.set_dtype(y.dtype());
+  T* out_ptr = dev_ctx.template Alloc<T>(out);
+
+  const int64_t rows = xdim_vec[x_ndims - 2];
+  int64_t batch = 1;
+  for (size_t i = 0; i < x_ndims - 2; ++i) {
+    batch *= xdim_vec[i];
+  }
+  CsrDenseMatmul<T, IntT>(x.crows().data<IntT>(),
+                          x.cols().data<IntT>(),
+                          x.values().data<T>(),
+                          batch,
+                          rows,
+                          xdim_vec[x_ndims - 1],
+                          y.data<T>(),
+                          ydim_vec[y_ndims - 1],
+                          out_ptr);
+}
+
+/* CSR @ DENSE -> DENSE */
 template <typename T, typename Context>
-void MatmulCsrDenseKernel(const Context& dev_ctx UNUSED,
-                          const SparseCsrTensor& x UNUSED,
-                          const DenseTensor& y UNUSED,
-                          DenseTensor* out UNUSED) {
-  PADDLE_THROW(phi::errors::Unimplemented(
-      "Not support CPU kernel of 'sparse.matmul' now."));
+void MatmulCsrDenseKernel(const Context& dev_ctx,
+                          const SparseCsrTensor& x,
+                          const DenseTensor& y,
+                          DenseTensor* out) {
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      x.crows().dtype(), "MatmulCsrDenseCPUKernel", ([&] {
+        MatmulCsrDenseCPUKernel<T, data_t>(dev_ctx, x, y, out);
+      }));
+}
+
+template <typename T, typename IntT, typename Context>
+void MaskedMatmulCsrCPUKernel(const Context& dev_ctx,
+                              const DenseTensor& x,
+                              const DenseTensor& y,
+                              const SparseCsrTensor& mask,
+                              SparseCsrTensor* out) {
+  std::vector<int64_t> xdim_vec = phi::vectorize(x.dims());
+  std::vector<int64_t> ydim_vec = phi::vectorize(y.dims());
+  std::vector<int64_t> maskdim_vec = phi::vectorize(mask.dims());
+  auto x_ndims = xdim_vec.size();
+  auto y_ndims = ydim_vec.size();
+  auto mask_ndims = maskdim_vec.size();
+  PADDLE_ENFORCE_EQ(
+      x_ndims,
+      y_ndims,
+      phi::errors::PreconditionNotMet("The dims size of Input(x) and Input(y) "
+                                      "should be equal, But received X's "
+                                      "dimensions=%d, Y's dimensions=%d.",
+                                      x_ndims,
+                                      y_ndims));
+  PADDLE_ENFORCE_EQ(x_ndims,
+                    mask_ndims,
+                    phi::errors::PreconditionNotMet(
+                        "The dims size of Input(x) and Input(mask) "
+                        "should be equal, But received X's "
+                        "dimensions=%d, mask's dimensions=%d.",
+                        x_ndims,
+                        mask_ndims));
+  PADDLE_ENFORCE_GE(
+      x_ndims,
+      2,
+      phi::errors::InvalidArgument("the dims size of Input(x) and "
+                                   "Input(y) must be greater than "
+                                   "or eaqual to 2."));
+  for (size_t i = 0; i < x_ndims - 2; ++i) {
+    PADDLE_ENFORCE_EQ(xdim_vec[i],
+                      ydim_vec[i],
+                      phi::errors::InvalidArgument(
+                          "x.dim[%d] and y.dim[%d] must match.", i, i));
+    PADDLE_ENFORCE_EQ(xdim_vec[i],
+                      maskdim_vec[i],
+                      phi::errors::InvalidArgument(
+                          "x.dim[%d] and mask.dim[%d] must match.", i, i));
+  }
+  PADDLE_ENFORCE_EQ(
+      xdim_vec[x_ndims - 1],
+      ydim_vec[y_ndims - 2],
+      phi::errors::PreconditionNotMet(
+          "The shape of Input(x) and Input(y) is not suitable for matmul "
+          "opetation, x_dim[-1] must be eaqual to y_dim[-2]."));
+  PADDLE_ENFORCE_EQ(
+      maskdim_vec[mask_ndims - 2],
+      xdim_vec[x_ndims - 2],
+      phi::errors::PreconditionNotMet(
+          "The shape of Input(x) and Input(y) is not suitable for matmul "
+          "opetation, mask_dim[-2] must be eaqual to x_dim[-2]."));
+  PADDLE_ENFORCE_EQ(
+      maskdim_vec[mask_ndims - 1],
+      ydim_vec[y_ndims - 1],
+      phi::errors::PreconditionNotMet(
+          "The shape of Input(x) and Input(y) is not suitable for matmul "
+          "opetation, mask_dim[-1] must be eaqual to y_dim[-1]."));
+
+  // InferMeta of SparseCsrTensor 'out', CreateLikeInferMeta
+  EmptyLikeCsrKernel<T, Context>(dev_ctx, mask, out);
+
+  // every element of out is the inner product of a row of x and a column
+  // of y, so transpose y to read both contiguously
+  DenseTensor trans_y = TransposeLast2Dim<T, Context>(dev_ctx, y);
+  const int64_t rows = xdim_vec[x_ndims - 2];
+  int64_t batch = 1;
+  for (size_t i = 0; i < x_ndims - 2; ++i) {
+    batch *= xdim_vec[i];
+  }
+  MaskedDenseMatmul<T, IntT>(mask.crows().data<IntT>(),
+                             mask.cols().data<IntT>(),
+                             batch,
+                             rows,
+                             x.data<T>(),
+                             trans_y.data<T>(),
+                             xdim_vec[x_ndims - 1],
+                             ydim_vec[y_ndims - 1],
+                             out->mutable_values()->data<T>());
 }
 
-// TODO(zhouwei25): implement CPU kernel of " DENSE @ DENSE * CSR_MASK -> CSR"
+/* DENSE @ DENSE * CSR_MASK -> CSR */
 template <typename T, typename Context>
-void MaskedMatmulCsrKernel(const Context& dev_ctx UNUSED,
-                           const DenseTensor& x UNUSED,
-                           const DenseTensor& y UNUSED,
-                           const SparseCsrTensor& mask UNUSED,
-                           SparseCsrTensor* out UNUSED) {
-  PADDLE_THROW(phi::errors::Unimplemented(
-      "Not support CPU kernel of 'sparse.masked_matmul' now."));
+void MaskedMatmulCsrKernel(const Context& dev_ctx,
+                           const DenseTensor& x,
+                           const DenseTensor& y,
+                           const SparseCsrTensor& mask,
+                           SparseCsrTensor* out) {
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      mask.crows().dtype(), "MaskedMatmulCsrCPUKernel", ([&] {
+        MaskedMatmulCsrCPUKernel<T, data_t>(dev_ctx, x, y, mask, out);
+      }));
 }
 
 }  // namespace sparse
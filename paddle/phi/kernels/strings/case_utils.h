@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #pragma once
+#include <cstring>
 #include <string>
 
 #include "paddle/phi/common/pstring.h"
@@ -28,20 +29,77 @@ namespace phi {
 namespace strings {
 
 using pstring = dtype::pstring;
+
+// The host converters below handle 8 chars at once in a 64-bit word (SWAR):
+// a byte is a letter to flip when it is ASCII and its low 7 bits are in
+// [First, Last], which two additions tell without carrying across bytes.
+constexpr uint64_t kAsciiHighBits = 0x8080808080808080ULL;
+constexpr uint64_t kAsciiLowBits = 0x0101010101010101ULL;
+
+template <char First, char Last>
+inline uint64_t FlipAsciiCaseInWord(uint64_t word) {
+  const uint64_t low = word & ~kAsciiHighBits;
+  const uint64_t above_last = low + kAsciiLowBits * (0x7F - Last);
+  const uint64_t from_first = low + kAsciiLowBits * (0x80 - First);
+  const uint64_t in_range = (from_first ^ above_last) & ~word & kAsciiHighBits;
+  // 0x80 >> 2 is 0x20, the case bit of ASCII letters
+  return word ^ (in_range >> 2);
+}
+
+template <char First, char Last>
+inline void FlipAsciiCase(const char* in, size_t size, char* out) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, in + i, sizeof(uint64_t));
+    word = FlipAsciiCaseInWord<First, Last>(word);
+    std::memcpy(out + i, &word, sizeof(uint64_t));
+  }
+  for (; i < size; ++i) {
+    out[i] = (First <= in[i] && in[i] <= Last) ? in[i] ^ 0x20 : in[i];
+  }
+}
+
+// Whether the size bytes of str are all ASCII, 8 at a time.
+inline bool IsAsciiStr(const char* str, size_t size) {
+  uint64_t bits = 0;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, str + i, sizeof(uint64_t));
+    bits |= word;
+  }
+  for (; i < size; ++i) {
+    bits |= static_cast<uint8_t>(str[i]);
+  }
+  return (bits & kAsciiHighBits) == 0;
+}
+
 struct AsciiToLower {
   HOSTDEVICE char operator()(char in) const {
     return ('A' <= in && in <= 'Z') ? in - ('Z' - 'z') : in;
   }
+
+  void operator()(const char* in, size_t size, char* out) const {
+    FlipAsciiCase<'A', 'Z'>(in, size, out);
+  }
 };
 
 struct AsciiToUpper {
   HOSTDEVICE char operator()(char in) const {
     return ('a' <= in && in <= 'z') ? in ^ 0x20 : in;
   }
+
+  void operator()(const char* in, size_t size, char* out) const {
+    FlipAsciiCase<'a', 'z'>(in, size, out);
+  }
 };
 
 template <typename Context>
 struct UTF8ToLower {
+  // converts the strings that turn out to be ASCII
+  using AsciiConverter = AsciiToLower;
+
   HOSTDEVICE UTF8ToLower(const uint8_t* unicode_flag_map,
                          const uint16_t* cases_map)
       : unicode_flag_map_(unicode_flag_map), cases_map_(cases_map) {}
@@ -57,6 +115,9 @@ struct UTF8ToLower {
 
 template <typename Context>
 struct UTF8ToUpper {
+  // converts the strings that turn out to be ASCII
+  using AsciiConverter = AsciiToUpper;
+
   HOSTDEVICE UTF8ToUpper(const uint8_t* unicode_flag_map,
                          const uint16_t* cases_map)
       : unicode_flag_map_(unicode_flag_map), cases_map_(cases_map) {}
@@ -0,0 +1,108 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/strings/strings_length_truncate_kernel.h"
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/pstring.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/strings/case_utils.h"
+
+namespace phi {
+namespace strings {
+
+// The number of unicode chars of the UTF-8 str, i.e. of its bytes that
+// aren't continuation bytes, 8 bytes at a time.
+static int64_t CountUTF8Chars(const char* str, size_t size) {
+  int64_t continuations = 0;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, str + i, sizeof(uint64_t));
+    // the high bit of a continuation byte, 10xxxxxx, is set and the next
+    // isn't, and the multiplication sums the bytes of marks into the top one
+    const uint64_t marks = (word & ~(word << 1) & kAsciiHighBits) >> 7;
+    continuations += (marks * kAsciiLowBits) >> 56;
+  }
+  for (; i < size; ++i) {
+    continuations += (static_cast<uint8_t>(str[i]) & 0xC0) == 0x80;
+  }
+  return size - continuations;
+}
+
+template <typename ContextT>
+void StringLengthKernel(const ContextT& dev_ctx,
+                        const StringTensor& x,
+                        bool use_utf8_encoding,
+                        DenseTensor* out) {
+  const pstring* in = x.data();
+  out->Resize(x.dims());
+  int64_t* out_ptr = dev_ctx.template Alloc<int64_t>(out);
+  const int64_t num = x.numel();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < num; ++i) {
+    out_ptr[i] = use_utf8_encoding ? CountUTF8Chars(in[i].data(), in[i].size())
+                                   : in[i].size();
+  }
+}
+
+template <typename ContextT>
+void StringTruncateKernel(const ContextT& dev_ctx,
+                          const StringTensor& x,
+                          int max_length,
+                          bool use_utf8_encoding,
+                          StringTensor* out) {
+  PADDLE_ENFORCE_GE(max_length,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The max_length of strings_truncate should be "
+                        "non-negative, but received %d.",
+                        max_length));
+  const pstring* in = x.data();
+  pstring* out_ptr = dev_ctx.template Alloc<pstring>(out);
+  const int64_t num = x.numel();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < num; ++i) {
+    const char* str = in[i].data();
+    size_t size = in[i].size();
+    if (size > static_cast<size_t>(max_length)) {
+      size = max_length;
+      // back off to the first byte of the char that is cut
+      while (use_utf8_encoding && size > 0 &&
+             (static_cast<uint8_t>(str[size]) & 0xC0) == 0x80) {
+        --size;
+      }
+    }
+    out_ptr[i] = pstring(str, size);
+  }
+}
+
+}  // namespace strings
+}  // namespace phi
+
+PD_REGISTER_KERNEL_FOR_ALL_DTYPE(
+    strings_length,
+    CPU,
+    ALL_LAYOUT,
+    phi::strings::StringLengthKernel<phi::CPUContext>) {}
+
+PD_REGISTER_KERNEL_FOR_ALL_DTYPE(
+    strings_truncate,
+    CPU,
+    ALL_LAYOUT,
+    phi::strings::StringTruncateKernel<phi::CPUContext>) {}
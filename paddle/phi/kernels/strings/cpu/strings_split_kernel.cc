@@ -0,0 +1,150 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/strings/strings_split_kernel.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/pstring.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/strings/unicode.h"
+
+using pstring = ::phi::dtype::pstring;
+
+namespace phi {
+namespace strings {
+
+enum CharClass : uint8_t { kWordChar = 0, kSpaceChar = 1, kPunctChar = 2 };
+
+// The (offset, size) of every word of str. ascii_classes classifies the
+// ASCII chars, so that most chars take a single lookup.
+static void SplitWords(const char* str,
+                       size_t size,
+                       bool split_punctuation,
+                       bool use_utf8_encoding,
+                       const CharClass* ascii_classes,
+                       const uint8_t* unicode_flag_map,
+                       std::vector<std::pair<size_t, size_t>>* words) {
+  size_t word_begin = 0;
+  bool in_word = false;
+  size_t pos = 0;
+  while (pos < size) {
+    const uint8_t byte = static_cast<uint8_t>(str[pos]);
+    size_t chwidth = 1;
+    CharClass char_class = kWordChar;
+    if (byte < 0x80) {
+      char_class = ascii_classes[byte];
+    } else if (use_utf8_encoding) {
+      chwidth = BytesInUtf8Char(byte);
+      if (chwidth == 0 || pos + chwidth > size) {
+        // a stray continuation byte or a truncated char is part of a word
+        chwidth = 1;
+      } else {
+        uint32_t utf8;
+        UTF8ToUInt32(str + pos, &utf8);
+        const uint32_t unicode = UTF8ToUnicode(utf8);
+        if (unicode <= 0x00FFFF && IsSpace(unicode_flag_map[unicode])) {
+          char_class = kSpaceChar;
+        } else if (split_punctuation && IsPunctuation(unicode)) {
+          char_class = kPunctChar;
+        }
+      }
+    }
+
+    if (char_class == kWordChar) {
+      if (!in_word) {
+        word_begin = pos;
+        in_word = true;
+      }
+    } else {
+      if (in_word) {
+        words->emplace_back(word_begin, pos - word_begin);
+        in_word = false;
+      }
+      if (char_class == kPunctChar) {
+        words->emplace_back(pos, chwidth);
+      }
+    }
+    pos += chwidth;
+  }
+  if (in_word) {
+    words->emplace_back(word_begin, size - word_begin);
+  }
+}
+
+template <typename ContextT>
+void StringSplitKernel(const ContextT& dev_ctx,
+                       const StringTensor& x,
+                       bool split_punctuation,
+                       bool use_utf8_encoding,
+                       StringTensor* out) {
+  const uint8_t* unicode_flag_map = GetUniFlagMap();
+  CharClass ascii_classes[0x80];
+  for (uint32_t c = 0; c < 0x80; ++c) {
+    if (IsSpace(unicode_flag_map[c])) {
+      ascii_classes[c] = kSpaceChar;
+    } else if (split_punctuation && IsPunctuation(c)) {
+      ascii_classes[c] = kPunctChar;
+    } else {
+      ascii_classes[c] = kWordChar;
+    }
+  }
+
+  const pstring* in = x.data();
+  const int64_t num = x.numel();
+  std::vector<std::vector<std::pair<size_t, size_t>>> words(num);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < num; ++i) {
+    SplitWords(in[i].data(),
+               in[i].size(),
+               split_punctuation,
+               use_utf8_encoding,
+               ascii_classes,
+               unicode_flag_map,
+               &words[i]);
+  }
+
+  int64_t max_words = 0;
+  for (const auto& str_words : words) {
+    max_words = std::max<int64_t>(max_words, str_words.size());
+  }
+  auto dims = phi::vectorize(x.dims());
+  dims.push_back(max_words);
+  out->Resize(phi::make_ddim(dims));
+  pstring* out_ptr = dev_ctx.template Alloc<pstring>(out);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < num; ++i) {
+    const char* str = in[i].data();
+    for (size_t k = 0; k < words[i].size(); ++k) {
+      out_ptr[i * max_words + k] =
+          pstring(str + words[i][k].first, words[i][k].second);
+    }
+  }
+}
+
+}  // namespace strings
+}  // namespace phi
+
+PD_REGISTER_KERNEL_FOR_ALL_DTYPE(
+    strings_split,
+    CPU,
+    ALL_LAYOUT,
+    phi::strings::StringSplitKernel<phi::CPUContext>) {}
@@ -0,0 +1,58 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/strings/strings_strip_accents_kernel.h"
+
+#include <string>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/pstring.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/strings/case_utils.h"
+#include "paddle/phi/kernels/strings/unicode.h"
+
+namespace phi {
+namespace strings {
+
+template <typename ContextT>
+void StringStripAccentsKernel(const ContextT& dev_ctx,
+                              const StringTensor& x,
+                              StringTensor* out) {
+  const pstring* in = x.data();
+  pstring* out_ptr = dev_ctx.template Alloc<pstring>(out);
+  const int64_t num = x.numel();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < num; ++i) {
+    const char* str = in[i].data();
+    const size_t size = in[i].size();
+    // ASCII has no accents, which saves decomposing most of the strings
+    std::string result;
+    if (IsAsciiStr(str, size) || !StripAccents(str, size, &result)) {
+      out_ptr[i] = in[i];
+    } else {
+      out_ptr[i] = pstring(result.data(), result.size());
+    }
+  }
+}
+
+}  // namespace strings
+}  // namespace phi
+
+PD_REGISTER_KERNEL_FOR_ALL_DTYPE(
+    strings_strip_accents,
+    CPU,
+    ALL_LAYOUT,
+    phi::strings::StringStripAccentsKernel<phi::CPUContext>) {}
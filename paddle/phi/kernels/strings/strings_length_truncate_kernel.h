@@ -0,0 +1,66 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/string_tensor.h"
+#include "paddle/phi/infermeta/strings/unary.h"
+
+namespace phi {
+namespace strings {
+
+// The lengths of the strings of x, in bytes, or in unicode chars if
+// use_utf8_encoding, as an int64 tensor of the shape of x.
+template <typename ContextT>
+void StringLengthKernel(const ContextT& dev_ctx,
+                        const StringTensor& x,
+                        bool use_utf8_encoding,
+                        DenseTensor* out);
+
+// Truncates the strings of x to at most max_length bytes. If
+// use_utf8_encoding, a unicode char that doesn't fit is dropped as a whole
+// rather than split.
+template <typename ContextT>
+void StringTruncateKernel(const ContextT& dev_ctx,
+                          const StringTensor& x,
+                          int max_length,
+                          bool use_utf8_encoding,
+                          StringTensor* out);
+
+template <typename ContextT>
+DenseTensor StringLength(const ContextT& dev_ctx,
+                         const StringTensor& x,
+                         bool use_utf8_encoding) {
+  DenseTensor dense_out;
+  dense_out.set_meta(DenseTensorMeta(DataType::INT64, x.dims()));
+  StringLengthKernel(dev_ctx, x, use_utf8_encoding, &dense_out);
+  return dense_out;
+}
+
+template <typename ContextT>
+StringTensor StringTruncate(const ContextT& dev_ctx,
+                            const StringTensor& x,
+                            int max_length,
+                            bool use_utf8_encoding) {
+  StringTensor string_out;
+  MetaTensor meta_out(&string_out);
+  UnchangedInferMeta(x.meta(), &meta_out);
+  StringTruncateKernel(
+      dev_ctx, x, max_length, use_utf8_encoding, &string_out);
+  return string_out;
+}
+
+}  // namespace strings
+}  // namespace phi
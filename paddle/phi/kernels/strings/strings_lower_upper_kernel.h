@@ -14,6 +14,7 @@ limitations under the License. */
 
 #pragma once
 #include <algorithm>
+#include <string>
 #include <vector>
 
 #include "paddle/phi/api/lib/utils/allocator.h"
@@ -79,19 +80,27 @@ struct StringCaseConvertKernel {
   }
 };
 
+// The elements are converted in parallel, 8 chars at a time.
 template <typename DeviceContext, typename CharConverter>
 struct AsciiCaseConverter {
   void operator()(const DeviceContext& dev_ctx UNUSED,
                   const pstring* in,
                   pstring* out,
                   size_t num) const {
-    for (size_t i = 0; i < num; ++i) {
-      std::transform(
-          in[i].begin(), in[i].end(), out[i].mdata(), CharConverter());
+    const int64_t n = num;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int64_t i = 0; i < n; ++i) {
+      out[i].resize_uninitialized(in[i].size());
+      CharConverter()(in[i].data(), in[i].size(), out[i].mdata());
     }
   }
 };
 
+// The elements are converted in parallel. The ones that are all ASCII take
+// the path of AsciiCaseConverter, the others are converted a unicode char at
+// a time straight into the output.
 template <typename DeviceContext,
           template <typename DeviceContextT>
           class CharConverter>
@@ -100,20 +109,47 @@ struct UTF8CaseConverter {
                   const pstring* in,
                   pstring* out,
                   size_t num) const {
+    using AsciiConverter =
+        typename CharConverter<DeviceContext>::AsciiConverter;
     auto unicode_flag_map = GetUniFlagMap();
     auto cases_map = GetCharcasesMap();
-    for (size_t i = 0; i < num; ++i) {
-      uint32_t unicode_len = GetUnicodeStrLen(in[i].data(), in[i].size());
-      std::vector<uint32_t> unicode_in(unicode_len, 0);
-      GetUnicodeStr(in[i].data(), unicode_in.data(), unicode_len);
-      std::transform(unicode_in.begin(),
-                     unicode_in.end(),
-                     unicode_in.begin(),
-                     CharConverter<DeviceContext>(unicode_flag_map, cases_map));
-      uint32_t utf8_len = GetUTF8StrLen(unicode_in.data(), unicode_len);
-      std::vector<char> result(utf8_len, 0);
-      GetUTF8Str(unicode_in.data(), result.data(), unicode_len);
-      out[i] = result.data();
+    const CharConverter<DeviceContext> converter(unicode_flag_map, cases_map);
+    const int64_t n = num;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int64_t i = 0; i < n; ++i) {
+      const char* str = in[i].data();
+      const size_t size = in[i].size();
+      if (IsAsciiStr(str, size)) {
+        out[i].resize_uninitialized(size);
+        AsciiConverter()(str, size, out[i].mdata());
+        continue;
+      }
+
+      std::string result;
+      result.reserve(size);
+      char utf8_char[4];
+      size_t pos = 0;
+      while (pos < size) {
+        if (static_cast<uint8_t>(str[pos]) < 0x80) {
+          result.push_back(AsciiConverter()(str[pos++]));
+          continue;
+        }
+        uint32_t chwidth = BytesInUtf8Char(static_cast<uint8_t>(str[pos]));
+        if (chwidth == 0 || pos + chwidth > size) {
+          // a stray continuation byte or a truncated char is kept as it is
+          result.push_back(str[pos++]);
+          continue;
+        }
+        uint32_t utf8;
+        UTF8ToUInt32(str + pos, &utf8);
+        uint32_t unicode = converter(UTF8ToUnicode(utf8));
+        result.append(utf8_char,
+                      UnicodeToUTF8Char(UnicodeToUTF8(unicode), utf8_char));
+        pos += chwidth;
+      }
+      out[i] = pstring(result.data(), result.size());
     }
   }
 };
@@ -0,0 +1,49 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include "paddle/phi/core/string_tensor.h"
+#include "paddle/phi/infermeta/strings/unary.h"
+
+namespace phi {
+namespace strings {
+
+// Splits every string of x into words at whitespace, and into single chars
+// at punctuation as well if split_punctuation. The words of x[i] are
+// out[i, 0], out[i, 1], ..., and the last dimension of out, as large as the
+// most words of a string, is padded with empty strings. Whitespace and
+// punctuation are unicode chars if use_utf8_encoding, and ASCII otherwise.
+template <typename ContextT>
+void StringSplitKernel(const ContextT& dev_ctx,
+                       const StringTensor& x,
+                       bool split_punctuation,
+                       bool use_utf8_encoding,
+                       StringTensor* out);
+
+template <typename ContextT>
+StringTensor StringSplit(const ContextT& dev_ctx,
+                         const StringTensor& x,
+                         bool split_punctuation,
+                         bool use_utf8_encoding) {
+  StringTensor string_out;
+  MetaTensor meta_out(&string_out);
+  SplitInferMeta(x, &meta_out);
+  StringSplitKernel(
+      dev_ctx, x, split_punctuation, use_utf8_encoding, &string_out);
+  return string_out;
+}
+
+}  // namespace strings
+}  // namespace phi
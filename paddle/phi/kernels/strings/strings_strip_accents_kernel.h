@@ -0,0 +1,42 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include "paddle/phi/core/string_tensor.h"
+#include "paddle/phi/infermeta/strings/unary.h"
+
+namespace phi {
+namespace strings {
+
+// Strips the accents of the letters of every UTF-8 string of x, i.e. the
+// nonspacing marks of its canonical decomposition (NFD), as BERT tokenizers
+// do. A string that isn't valid UTF-8 is copied as it is.
+template <typename ContextT>
+void StringStripAccentsKernel(const ContextT& dev_ctx,
+                              const StringTensor& x,
+                              StringTensor* out);
+
+template <typename ContextT>
+StringTensor StringStripAccents(const ContextT& dev_ctx,
+                                const StringTensor& x) {
+  StringTensor string_out;
+  MetaTensor meta_out(&string_out);
+  UnchangedInferMeta(x.meta(), &meta_out);
+  StringStripAccentsKernel(dev_ctx, x, &string_out);
+  return string_out;
+}
+
+}  // namespace strings
+}  // namespace phi
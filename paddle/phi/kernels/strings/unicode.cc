@@ -16,6 +16,8 @@ limitations under the License. */
 
 #include <utf8proc.h>
 
+#include <vector>
+
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/kernels/strings/unicode_flag.h"
 
@@ -46,6 +48,54 @@ const uint16_t* GetCharcasesMap() {
   return reinterpret_cast<const uint16_t*>(utils_map[0]);
 }
 
+bool IsPunctuation(uint32_t chr) {
+  if ((chr >= 33 && chr <= 47) || (chr >= 58 && chr <= 64) ||
+      (chr >= 91 && chr <= 96) || (chr >= 123 && chr <= 126)) {
+    return true;
+  }
+  switch (utf8proc_category(chr)) {
+    case UTF8PROC_CATEGORY_PC:
+    case UTF8PROC_CATEGORY_PD:
+    case UTF8PROC_CATEGORY_PS:
+    case UTF8PROC_CATEGORY_PE:
+    case UTF8PROC_CATEGORY_PI:
+    case UTF8PROC_CATEGORY_PF:
+    case UTF8PROC_CATEGORY_PO:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool StripAccents(const char* str, size_t size, std::string* out) {
+  const auto* data = reinterpret_cast<const utf8proc_uint8_t*>(str);
+  // most decompositions take at most 3 chars, retry once with the exact size
+  std::vector<utf8proc_int32_t> decomposed(size * 3 + 1);
+  utf8proc_ssize_t len = utf8proc_decompose(data,
+                                            size,
+                                            decomposed.data(),
+                                            decomposed.size(),
+                                            UTF8PROC_DECOMPOSE);
+  if (len > static_cast<utf8proc_ssize_t>(decomposed.size())) {
+    decomposed.resize(len);
+    len = utf8proc_decompose(data,
+                             size,
+                             decomposed.data(),
+                             decomposed.size(),
+                             UTF8PROC_DECOMPOSE);
+  }
+  if (len < 0) {
+    return false;
+  }
+  utf8proc_uint8_t encoded[4];
+  for (utf8proc_ssize_t i = 0; i < len; ++i) {
+    if (utf8proc_category(decomposed[i]) == UTF8PROC_CATEGORY_MN) continue;
+    out->append(reinterpret_cast<const char*>(encoded),
+                utf8proc_encode_char(decomposed[i], encoded));
+  }
+  return true;
+}
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 
 const uint8_t* GetGPUUniflagMap() {
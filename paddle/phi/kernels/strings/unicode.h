@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <cstring>
 #include <memory>
+#include <string>
 
 #include "paddle/phi/core/hostdevice.h"
 #include "paddle/phi/core/macros.h"
@@ -188,6 +189,15 @@ HOSTDEVICE inline void GetUTF8Str(const uint32_t* unicode_str,
 const uint8_t* GetUniFlagMap();
 const uint16_t* GetCharcasesMap();
 
+// Whether the unicode char is a punctuation, i.e. of one of the P*
+// categories or an ASCII symbol, the way BERT tokenizers split words.
+bool IsPunctuation(uint32_t chr);
+
+// Appends the canonical decomposition (NFD) of the UTF-8 str of size bytes
+// to out, without its nonspacing marks, i.e. strips the accents of the
+// letters. Returns false, appending nothing, if str isn't valid UTF-8.
+bool StripAccents(const char* str, size_t size, std::string* out);
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 
 const uint8_t* GetGPUUniflagMap();
@@ -13,6 +13,7 @@
 # limitations under the License.
 
 import random
+import time
 import unittest
 from copy import deepcopy
 
@@ -228,6 +229,54 @@ class TestProcessGroupFp32(unittest.TestCase):
         test_gather(pg.size() - 1)
         print("test gather api ok\n")
 
+        # test coalesced allreduce of mixed sizes and dtypes
+        xs = [
+            np.random.random(shape).astype(dtype)
+            for shape, dtype in [
+                ((3,), "float32"),
+                ((4, 5), "float64"),
+                ((7,), "float32"),
+            ]
+        ]
+        tensors = [paddle.to_tensor(x) for x in xs]
+        task = pg.all_reduce_coalesced(tensors)
+        task.wait()
+        for x, t in zip(xs, tensors):
+            np.testing.assert_allclose(t, x * pg.size(), rtol=1e-5)
+        print("test coalesced allreduce api ok\n")
+
+        # test async allreduce, queued buckets are reduced in order on the
+        # communication thread while this thread keeps computing
+        buckets = [
+            np.random.random((1 << 16,)).astype(self.dtype) for _ in range(8)
+        ]
+        weight = paddle.rand([256, 256])
+
+        def run_step(sync_op):
+            tensors = [paddle.to_tensor(b) for b in buckets]
+            tasks = []
+            start = time.time()
+            for t in tensors:
+                # stand-in for the backward of the next layer
+                paddle.matmul(weight, weight)
+                tasks.append(pg.all_reduce(t, core.ReduceOp.SUM, sync_op))
+            for task in tasks:
+                task.wait()
+            return tensors, time.time() - start
+
+        for sync_op in [True, False]:
+            tensors, _ = run_step(sync_op)
+            for b, t in zip(buckets, tensors):
+                np.testing.assert_allclose(t, b * pg.size(), rtol=1e-5)
+        sync_time = min(run_step(True)[1] for _ in range(3))
+        async_time = min(run_step(False)[1] for _ in range(3))
+        print(
+            "test async allreduce api ok, step time without overlap "
+            "{:.2f} ms, with overlap {:.2f} ms\n".format(
+                sync_time * 1000, async_time * 1000
+            )
+        )
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,113 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Sweeps message sizes over the allreduce algorithms of ProcessGroupGloo on
+# loopback and reports the algorithm bandwidth of each, e.g.
+#   python process_group_gloo_benchmark.py --nranks 4
+
+import argparse
+import multiprocessing
+import time
+
+import numpy as np
+
+import paddle
+from paddle.fluid import core
+
+ALGOS = ["ring", "bcube", "halving_doubling", "auto"]
+
+
+def bench_allreduce(pg, numel, iters):
+    tensor = paddle.to_tensor(np.ones([numel], dtype="float32"))
+    pg.all_reduce(tensor, core.ReduceOp.SUM, True)
+    start = time.time()
+    for _ in range(iters):
+        pg.all_reduce(tensor, core.ReduceOp.SUM, True)
+    return (time.time() - start) / iters
+
+
+def bench_coalesced(pg, numel, num_tensors, iters):
+    tensors = [
+        paddle.to_tensor(np.ones([numel], dtype="float32"))
+        for _ in range(num_tensors)
+    ]
+    start = time.time()
+    for _ in range(iters):
+        for tensor in tensors:
+            pg.all_reduce(tensor, core.ReduceOp.SUM, True)
+    unfused = (time.time() - start) / iters
+    start = time.time()
+    for _ in range(iters):
+        pg.all_reduce_coalesced(tensors)
+    fused = (time.time() - start) / iters
+    return unfused, fused
+
+
+def run(rank, args):
+    paddle.device.set_device("cpu")
+    store = core.TCPStore("127.0.0.1", args.port, rank == 0, args.nranks, 60)
+    sizes = [1 << i for i in range(args.min_pow, args.max_pow + 1, 2)]
+    for gid, algo in enumerate(ALGOS):
+        paddle.set_flags({"FLAGS_gloo_allreduce_algo": algo})
+        pg = core.ProcessGroupGloo.create(store, rank, args.nranks, gid + 1)
+
+        # correctness first, every rank contributes rank + 1
+        tensor = paddle.to_tensor(np.full([1000], rank + 1, dtype="float32"))
+        pg.all_reduce(tensor, core.ReduceOp.SUM, True)
+        expected = args.nranks * (args.nranks + 1) / 2
+        np.testing.assert_allclose(tensor.numpy(), expected)
+
+        for numel in sizes:
+            bytes_ = numel * 4
+            iters = max(3, min(200, (64 << 20) // bytes_))
+            seconds = bench_allreduce(pg, numel, iters)
+            # ring-equivalent bus bandwidth, 2 * (n - 1) / n of the data
+            # crosses each link
+            busbw = 2.0 * (args.nranks - 1) / args.nranks * bytes_ / seconds
+            if rank == 0:
+                print(
+                    "{:>16} {:>10} bytes {:>10.1f} us {:>10.2f} MB/s".format(
+                        algo, bytes_, seconds * 1e6, busbw / 1e6
+                    )
+                )
+
+    unfused, fused = bench_coalesced(pg, 256, 64, 20)
+    if rank == 0:
+        print(
+            "64 x 1KB tensors: {:.1f} us one by one, "
+            "{:.1f} us coalesced".format(unfused * 1e6, fused * 1e6)
+        )
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--nranks", type=int, default=2)
+    parser.add_argument("--port", type=int, default=6273)
+    parser.add_argument("--min_pow", type=int, default=8)
+    parser.add_argument("--max_pow", type=int, default=24)
+    args = parser.parse_args()
+
+    procs = [
+        multiprocessing.Process(target=run, args=(rank, args))
+        for rank in range(args.nranks)
+    ]
+    for p in procs:
+        p.start()
+    for p in procs:
+        p.join()
+        assert p.exitcode == 0
+
+
+if __name__ == "__main__":
+    main()
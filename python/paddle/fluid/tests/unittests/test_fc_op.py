@@ -136,6 +136,73 @@ class TestFCOpWithPadding(TestFCOp):
         self.matrix = MatrixGenerate(1, 4, 3, 128, 128, 2)
 
 
+class TestFCOpInt8Weight(unittest.TestCase):
+    # The int8 weight and its scales are set by the quantization passes as
+    # attributes the op proto does not declare, so they are set on the desc.
+    def setUp(self):
+        np.random.seed(SEED)
+        self.matrix = MatrixGenerate(3, 8, 21, 2, 2, 1)
+        self.weights = np.random.randint(
+            -127, 128, self.matrix.weights.shape
+        ).astype("int8")
+        self.weight_scale = 0.5
+        self.input_scale = 0.8
+
+    def run_fc(self, input_scale=None):
+        with paddle_static_guard():
+            main = Program()
+            with program_guard(main, Program()):
+                x = paddle.static.data(
+                    "x", self.matrix.input.shape, dtype="float32"
+                )
+                w = paddle.static.data("w", self.weights.shape, dtype="int8")
+                b = paddle.static.data(
+                    "b", self.matrix.bias.shape, dtype="float32"
+                )
+                out = main.current_block().create_var(dtype="float32")
+                op = main.current_block().append_op(
+                    type="fc",
+                    inputs={'Input': x, 'W': w, 'Bias': b},
+                    outputs={'Out': out},
+                    attrs={'in_num_col_dims': 1, 'activation_type': "relu"},
+                )
+                op.desc._set_float32_attr("weight_scale", self.weight_scale)
+                if input_scale is not None:
+                    op.desc._set_float32_attr("Input_scale_x", input_scale)
+            exe = fluid.Executor(core.CPUPlace())
+            return exe.run(
+                main,
+                feed={
+                    'x': self.matrix.input,
+                    'w': self.weights,
+                    'b': self.matrix.bias,
+                },
+                fetch_list=[out],
+            )[0]
+
+    def test_weight_only(self):
+        x = self.matrix.input.reshape([self.matrix.input.shape[0], -1])
+        w = self.weights.astype("float32") * self.weight_scale / 127
+        expected = np.maximum(np.dot(x, w) + self.matrix.bias, 0)
+        np.testing.assert_allclose(
+            self.run_fc(), expected, rtol=1e-5, atol=1e-5
+        )
+
+    def test_int8_gemm(self):
+        x = self.matrix.input.reshape([self.matrix.input.shape[0], -1])
+        # some of x is above the input scale and gets clipped
+        x_quant = np.clip(np.round(x * 127 / self.input_scale), -127, 127)
+        acc = np.dot(x_quant, self.weights.astype("float64"))
+        expected = np.maximum(
+            acc * self.input_scale * self.weight_scale / (127 * 127)
+            + self.matrix.bias,
+            0,
+        )
+        np.testing.assert_allclose(
+            self.run_fc(self.input_scale), expected, rtol=1e-5, atol=1e-5
+        )
+
+
 class TestFcOp_NumFlattenDims_NegOne(unittest.TestCase):
     def test_api(self):
         def run_program(num_flatten_dims):
@@ -104,6 +104,67 @@ class TestLookupTableOpWithPadding(TestFusedEmbeddingSeqPoolOp):
             )
 
 
+class TestFusedEmbeddingSeqPoolOpMean(OpTest):
+    def setUp(self):
+        self.op_type = "fused_embedding_seq_pool"
+        self.emb_size = 6
+        self.set_combiner()
+        self.table = np.random.random((17, self.emb_size)).astype("float64")
+        self.ids = np.array(
+            [[[4], [3]], [[4], [3]], [[2], [1]], [[16], [1]], [[5], [5]]]
+        ).astype("int64")
+        ids_expand = np.expand_dims(self.ids, axis=1)
+        self.lod = [[3, 2]]
+        padding_idx = 3
+        self.attrs = {
+            'combiner': self.combiner,
+            'padding_idx': padding_idx,
+            'is_sparse': False,
+        }
+        self.inputs = {'W': self.table, 'Ids': (ids_expand, self.lod)}
+
+        ids = np.squeeze(self.ids, axis=2)
+        output = []
+        index = 0
+        for count in self.lod[0]:
+            arr = ids[index : count + index]
+            out = np.zeros([arr.shape[1], self.emb_size])
+            for w in range(arr.shape[1]):
+                kept = [i for i in arr[:, w] if i != padding_idx]
+                if kept:
+                    out[w] = np.sum(self.table[kept], 0) * self.scale(
+                        len(kept)
+                    )
+            output.append(out)
+            index += count
+        self.outputs = {
+            'Out': np.reshape(
+                np.array(output), [len(self.lod[0]), 2 * self.emb_size]
+            )
+        }
+
+    def set_combiner(self):
+        self.combiner = 'mean'
+
+    def scale(self, count):
+        return 1.0 / count
+
+    def test_check_output(self):
+        # TODO(wangzhongpu): support lod in dygraph mode
+        self.check_output(check_dygraph=False)
+
+    def test_check_grad(self):
+        self.check_grad(['W'], 'Out', no_grad_set=['Ids'], check_dygraph=False)
+
+
+class TestFusedEmbeddingSeqPoolOpSqrtN(TestFusedEmbeddingSeqPoolOpMean):
+    def set_combiner(self):
+        self.combiner = 'sqrtn'
+
+    def scale(self, count):
+        return 1.0 / np.sqrt(count)
+
+
 class TestFusedEmbeddingSeqPoolApi(unittest.TestCase):
     def test_api(self):
         with paddle_static_guard():
@@ -170,5 +170,75 @@ class TestMaskedMatmul(unittest.TestCase):
         )
 
 
+class TestMatmulCPU(unittest.TestCase):
+    # x: sparse_csr, y: dense, out: dense, on CPU
+    def setUp(self):
+        self.origin_device = paddle.get_device()
+        paddle.set_device('cpu')
+
+    def tearDown(self):
+        paddle.set_device(self.origin_device)
+
+    def check_result(self, x_shape, y_shape):
+        mask = paddle.randint(0, 2, x_shape[-2:])
+        origin_x = paddle.rand(x_shape) * mask
+        origin_y = paddle.rand(y_shape)
+
+        dense_x = origin_x.detach()
+        dense_x.stop_gradient = False
+        dense_y = origin_y.detach()
+        dense_y.stop_gradient = False
+        dense_out = paddle.matmul(dense_x, dense_y)
+        dense_out.backward()
+
+        sp_x = origin_x.detach().to_sparse_csr()
+        sp_x.stop_gradient = False
+        sp_y = origin_y.detach()
+        sp_y.stop_gradient = False
+        sp_out = paddle.sparse.matmul(sp_x, sp_y)
+        sp_out.backward()
+
+        np.testing.assert_allclose(
+            sp_out.numpy(), dense_out.numpy(), rtol=1e-05
+        )
+        np.testing.assert_allclose(
+            sp_x.grad.to_dense().numpy(),
+            (dense_x.grad * mask).numpy(),
+            rtol=1e-05,
+        )
+        np.testing.assert_allclose(
+            sp_y.grad.numpy(), dense_y.grad.numpy(), rtol=1e-05
+        )
+
+    def test_matmul_2d(self):
+        self.check_result([16, 12], [12, 10])
+
+    def test_matmul_3d(self):
+        self.check_result([8, 16, 12], [8, 12, 10])
+
+    def test_masked_matmul(self):
+        for batch in [[], [3]]:
+            np_mask = np.random.rand(*batch, 10, 6) < 0.2
+            np_x = np.random.rand(*batch, 10, 12)
+            np_y = np.random.rand(*batch, 12, 6)
+            np_out = np.matmul(np_x, np_y) * np_mask
+
+            np_out_grad = np.ones(np_mask.shape) * np_mask
+            np_x_grad = np.matmul(np_out_grad, np.swapaxes(np_y, -1, -2))
+            np_y_grad = np.matmul(np.swapaxes(np_x, -1, -2), np_out_grad)
+
+            x = paddle.to_tensor(np_x, stop_gradient=False)
+            y = paddle.to_tensor(np_y, stop_gradient=False)
+            mask = paddle.to_tensor(np.ones(np_mask.shape) * np_mask)
+            out = paddle.sparse.masked_matmul(x, y, mask.to_sparse_csr())
+            np.testing.assert_allclose(
+                np_out, out.to_dense().numpy(), rtol=1e-05
+            )
+
+            out.backward()
+            np.testing.assert_allclose(np_x_grad, x.grad.numpy(), rtol=1e-05)
+            np.testing.assert_allclose(np_y_grad, y.grad.numpy(), rtol=1e-05)
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -31,6 +31,10 @@ def set_config(config=None):
 
     - enable(bool): Whether to enable kernel tuning.
     - tuning_range(list): Start and end iteration for auto-tuning. Default: [1, 10].
+    - cache_file(str): A file of the algorithms picked by an earlier tuning, saved by
+      `paddle.fluid.core.save_autotune_cache`. They are loaded after the kernel
+      tuning is enabled, so that the tuning iterations only measure new shapes. The
+      file only fits the build and the machine that saved it.
 
     2. layout: When it is enabled, the best data layout such as NCHW or NHWC will be
     determined based on the device and data type. When the origin layout setting is
@@ -121,6 +125,14 @@ def set_config(config=None):
                     "The auto-tuning configuration of the kernel is incorrect."
                     "The `tuning_range` should be list. Use default parameter instead."
                 )
+        if "cache_file" in kernel_config:
+            if isinstance(kernel_config['cache_file'], str):
+                core.load_autotune_cache(kernel_config['cache_file'])
+            else:
+                warnings.warn(
+                    "The auto-tuning configuration of the kernel is incorrect."
+                    "The `cache_file` should be str. Ignore it instead."
+                )
     if "layout" in config_dict:
         layout_config = config_dict["layout"]
         if "enable" in layout_config:
@@ -61,8 +61,9 @@ def fused_embedding_seq_pool(
             no effect to output. If :math:`padding\_idx < 0`, the :math:`padding\_idx`
             will automatically be converted to :math:`size[0] + padding\_idx` to use.
             Default: None.
-        combiner (str): The pooling type of sequence_pool, and only support `sum`.
-            Default: sum.
+        combiner (str): The pooling type of sequence_pool, one of `sum`, `mean`
+            and `sqrtn`, which divide the sum by the number of non padding ids
+            of the sequence and its square root respectively. Default: sum.
         param_attr (ParamAttr): Parameters for this layer.
         dtype (np.dtype|core.VarDesc.VarType|str): The dtype refers to the data type of output
             tensor. It can be float32, float_16, int etc.
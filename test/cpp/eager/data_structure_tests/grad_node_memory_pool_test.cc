@@ -0,0 +1,111 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/eager/grad_node_memory_pool.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(eager_grad_node_pool);
+
+using egr::GradNodeMemoryPool;
+
+TEST(GradNodeMemoryPool, ReuseSameSizeClass) {
+  FLAGS_eager_grad_node_pool = true;
+  GradNodeMemoryPool::ReleaseThreadCache();
+
+  void* ptr = GradNodeMemoryPool::Allocate(100);
+  memset(ptr, 0xff, 100);
+  GradNodeMemoryPool::Free(ptr, 100);
+  ASSERT_EQ(GradNodeMemoryPool::ThreadCachedBytes(), 112UL);
+
+  // Any size of the same 16 bytes class gets the cached block back.
+  void* reused = GradNodeMemoryPool::Allocate(110);
+  ASSERT_EQ(reused, ptr);
+  ASSERT_EQ(GradNodeMemoryPool::ThreadCachedBytes(), 0UL);
+  memset(reused, 0, 110);
+
+  // Another class does not.
+  GradNodeMemoryPool::Free(reused, 110);
+  void* other = GradNodeMemoryPool::Allocate(200);
+  ASSERT_NE(other, reused);
+  ASSERT_EQ(GradNodeMemoryPool::ThreadCachedBytes(), 112UL);
+  GradNodeMemoryPool::Free(other, 200);
+  ASSERT_EQ(GradNodeMemoryPool::ThreadCachedBytes(), 112UL + 208UL);
+
+  GradNodeMemoryPool::ReleaseThreadCache();
+  ASSERT_EQ(GradNodeMemoryPool::ThreadCachedBytes(), 0UL);
+}
+
+TEST(GradNodeMemoryPool, FreeOnAnotherThread) {
+  FLAGS_eager_grad_node_pool = true;
+  GradNodeMemoryPool::ReleaseThreadCache();
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < 8; ++i) {
+    blocks.push_back(GradNodeMemoryPool::Allocate(64));
+  }
+
+  // The blocks move to the cache of the freeing thread, which frees them
+  // when it exits.
+  size_t other_cached_bytes = 0;
+  std::thread other([&blocks, &other_cached_bytes]() {
+    for (void* ptr : blocks) GradNodeMemoryPool::Free(ptr, 64);
+    other_cached_bytes = GradNodeMemoryPool::ThreadCachedBytes();
+    void* reused = GradNodeMemoryPool::Allocate(64);
+    EXPECT_EQ(reused, blocks.back());
+    GradNodeMemoryPool::Free(reused, 64);
+  });
+  other.join();
+  ASSERT_EQ(other_cached_bytes, 8 * 64UL);
+  ASSERT_EQ(GradNodeMemoryPool::ThreadCachedBytes(), 0UL);
+
+  // Blocks from a thread that already exited are cached here.
+  std::thread producer([&blocks]() {
+    for (auto& ptr : blocks) ptr = GradNodeMemoryPool::Allocate(64);
+  });
+  producer.join();
+  for (void* ptr : blocks) GradNodeMemoryPool::Free(ptr, 64);
+  ASSERT_EQ(GradNodeMemoryPool::ThreadCachedBytes(), 8 * 64UL);
+  GradNodeMemoryPool::ReleaseThreadCache();
+}
+
+TEST(GradNodeMemoryPool, LargeBlocksAreNotCached) {
+  FLAGS_eager_grad_node_pool = true;
+  GradNodeMemoryPool::ReleaseThreadCache();
+
+  void* largest = GradNodeMemoryPool::Allocate(4096);
+  GradNodeMemoryPool::Free(largest, 4096);
+  ASSERT_EQ(GradNodeMemoryPool::ThreadCachedBytes(), 4096UL);
+  GradNodeMemoryPool::ReleaseThreadCache();
+
+  void* large = GradNodeMemoryPool::Allocate(4097);
+  memset(large, 0, 4097);
+  GradNodeMemoryPool::Free(large, 4097);
+  ASSERT_EQ(GradNodeMemoryPool::ThreadCachedBytes(), 0UL);
+}
+
+TEST(GradNodeMemoryPool, Disabled) {
+  FLAGS_eager_grad_node_pool = false;
+  GradNodeMemoryPool::ReleaseThreadCache();
+
+  void* ptr = GradNodeMemoryPool::Allocate(32);
+  GradNodeMemoryPool::Free(ptr, 32);
+  ASSERT_EQ(GradNodeMemoryPool::ThreadCachedBytes(), 0UL);
+  FLAGS_eager_grad_node_pool = true;
+}
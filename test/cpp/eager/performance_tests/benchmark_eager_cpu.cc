@@ -41,6 +41,9 @@ PD_DECLARE_KERNEL(add_grad, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(sum, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(sum_grad, CPU, ALL_LAYOUT);
 
+PHI_DECLARE_int32(eager_backward_num_threads);
+PHI_DECLARE_bool(eager_grad_node_pool);
+
 using namespace egr;            // NOLINT
 using namespace egr_utils_api;  // NOLINT
 
@@ -246,6 +249,107 @@ TEST(Benchmark, EagerIntermediateMLPCPU) {
   }
 }
 
+TEST(Benchmark, EagerOpDispatchCPU) {
+  // Prepare Device Contexts
+  eager_test::InitEnv(paddle::platform::CPUPlace());
+
+  // Tiny tensors, so the time goes to tracing and grad node bookkeeping
+  const size_t num_ops = 20000;
+  for (bool use_pool : {false, true}) {
+    FLAGS_eager_grad_node_pool = use_pool;
+    paddle::framework::DDim ddim = phi::make_ddim({1});
+    paddle::Tensor tensor = CreateTensorWithValue(ddim,
+                                                  paddle::platform::CPUPlace(),
+                                                  phi::DataType::FLOAT32,
+                                                  phi::DataLayout::NCHW,
+                                                  1.0,
+                                                  true);
+    RetainGradForTensor(tensor);
+
+    auto t_start = std::chrono::high_resolution_clock::now();
+    for (size_t step = 0; step < 5; step++) {
+      paddle::Tensor out = tensor;
+      for (size_t i = 0; i < num_ops / 5; i++) {
+        out = egr::scale(out, 1.0, 0.0, true, true);
+      }
+      std::vector<paddle::Tensor> target_tensors = {out};
+      Backward(target_tensors, {});
+    }
+    auto t_end = std::chrono::high_resolution_clock::now();
+    double elapsed_time_us =
+        std::chrono::duration<double, std::micro>(t_end - t_start).count();
+    std::cout << "Grad node pool: " << use_pool
+              << ", forward + backward per op: " << elapsed_time_us / num_ops
+              << " us" << std::endl;
+  }
+  FLAGS_eager_grad_node_pool = true;
+}
+
+TEST(Benchmark, EagerWideMLPCPU) {
+  // Prepare Device Contexts
+  eager_test::InitEnv(paddle::platform::CPUPlace());
+
+  auto tracer = std::make_shared<paddle::imperative::Tracer>();
+  paddle::imperative::SetCurrentTracer(tracer);
+
+  // Independent towers, sequential vs parallel backward
+  for (int num_threads : {1, 4}) {
+    FLAGS_eager_backward_num_threads = num_threads;
+    for (const std::string mode : {"Accuracy", "Performance"}) {
+      paddle::framework::DDim ddimX = phi::make_ddim({WIDE_M, WIDE_N});
+      paddle::Tensor X = CreateTensorWithValue(ddimX,
+                                               paddle::platform::CPUPlace(),
+                                               phi::DataType::FLOAT32,
+                                               phi::DataLayout::NCHW,
+                                               MLP_X_VAL,
+                                               true);
+      RetainGradForTensor(X);
+
+      std::vector<paddle::Tensor> Ws;
+      std::vector<paddle::Tensor> Bs;
+      for (size_t i = 0; i < WIDE_NUM_TOWERS; i++) {
+        paddle::framework::DDim ddimW = phi::make_ddim({WIDE_N, WIDE_K});
+        paddle::Tensor W = CreateTensorWithValue(ddimW,
+                                                 paddle::platform::CPUPlace(),
+                                                 phi::DataType::FLOAT32,
+                                                 phi::DataLayout::NCHW,
+                                                 MLP_W_VAL,
+                                                 true);
+        RetainGradForTensor(W);
+
+        paddle::framework::DDim ddimB = phi::make_ddim({WIDE_K});
+        paddle::Tensor B = CreateTensorWithValue(ddimB,
+                                                 paddle::platform::CPUPlace(),
+                                                 phi::DataType::FLOAT32,
+                                                 phi::DataLayout::NCHW,
+                                                 MLP_B_VAL,
+                                                 true);
+        RetainGradForTensor(B);
+
+        Ws.emplace_back(std::move(W));
+        Bs.emplace_back(std::move(B));
+      }
+
+      if (mode == "Accuracy") {
+        benchmark_eager_wide_mlp(X, Ws, Bs, true /* accuracy_check */);
+
+      } else if (mode == "Performance") {
+        auto t_start = std::chrono::high_resolution_clock::now();
+        benchmark_eager_wide_mlp(X, Ws, Bs);
+        auto t_end = std::chrono::high_resolution_clock::now();
+        double elapsed_time_ms =
+            std::chrono::duration<double, std::milli>(t_end - t_start).count();
+        std::cout << "Backward threads: " << num_threads
+                  << ", Duration: " << elapsed_time_ms << " ms" << std::endl;
+
+      } else {
+        PADDLE_THROW(paddle::platform::errors::Fatal("Unknown benchmark mode"));
+      }
+    }
+  }
+  FLAGS_eager_backward_num_threads = 1;
+}
+
 USE_OP_ITSELF(scale);
 USE_OP_ITSELF(elementwise_add);
 USE_OP_ITSELF(matmul_v2);
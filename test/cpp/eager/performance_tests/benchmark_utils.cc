@@ -152,6 +152,40 @@ void benchmark_eager_intermediate_mlp(const paddle::Tensor& X,
   }
 }
 
+/* ------------------------ */
+/* ---- Eager Wide MLP ---- */
+/* ------------------------ */
+void benchmark_eager_wide_mlp(const paddle::Tensor& X,
+                              const std::vector<paddle::Tensor>& Ws,
+                              const std::vector<paddle::Tensor>& Bs,
+                              bool accuracy_check) {
+  size_t max_num_runs = accuracy_check ? 1 : 20;
+  for (size_t run = 0; run < max_num_runs; run++) {
+    paddle::Tensor sum;
+    for (size_t i = 0; i < WIDE_NUM_TOWERS; i++) {
+      paddle::Tensor Out = matmul_v2_dygraph_function(
+          X, Ws[i], {{"trans_x", false}, {"trans_y", false}});
+      Out = elementwise_add_dygraph_function(Out, Bs[i], {});
+      sum = i == 0 ? Out : elementwise_add_dygraph_function(sum, Out, {});
+    }
+    paddle::Tensor Out =
+        reduce_sum_dygraph_function(sum, {{"reduce_all", true}});
+
+    std::vector<paddle::Tensor> target_tensors = {Out};
+    Backward(target_tensors, {});
+  }
+
+  if (accuracy_check) {
+    std::unordered_map<std::string, float> result =
+        compute_wide_mlp_expected_results();
+    eager_test::CompareGradTensorWithValue<float>(X, result["GradX"]);
+    for (size_t i = 0; i < WIDE_NUM_TOWERS; i++) {
+      eager_test::CompareGradTensorWithValue<float>(Ws[i], result["GradW"]);
+      eager_test::CompareGradTensorWithValue<float>(Bs[i], result["GradB"]);
+    }
+  }
+}
+
 }  // namespace egr
 
 namespace paddle {
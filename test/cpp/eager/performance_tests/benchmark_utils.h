@@ -32,6 +32,14 @@
 #define MLP_B_VAL 3.0
 #define MLP_NUM_LINEAR 1000
 
+/* Wide Model Configurations */
+// Out = ReduceSum(sum_i(X[M, N] x W_i[N, K] + B_i[K])), i < WIDE_NUM_TOWERS
+// The towers are independent branches of the backward graph.
+#define WIDE_M 32
+#define WIDE_N 256
+#define WIDE_K 256
+#define WIDE_NUM_TOWERS 16
+
 namespace egr {
 
 inline std::unordered_map<std::string, float> compute_mlp_expected_results() {
@@ -47,6 +55,14 @@ inline std::unordered_map<std::string, float> compute_mlp_expected_results() {
   return {{"Out", Out}, {"GradX", GradX}, {"GradW", GradW0}};
 }
 
+inline std::unordered_map<std::string, float>
+compute_wide_mlp_expected_results() {
+  float GradX = WIDE_NUM_TOWERS * WIDE_K * MLP_W_VAL;
+  float GradW = WIDE_M * MLP_X_VAL;
+  float GradB = WIDE_M;
+  return {{"GradX", GradX}, {"GradW", GradW}, {"GradB", GradB}};
+}
+
 /* ---- Eager Scale ---- */
 void benchmark_eager_scale(const paddle::Tensor& tensor,
                            bool accuracy_check = false);
@@ -65,6 +81,11 @@ void benchmark_eager_intermediate_mlp(const paddle::Tensor& X,
                                       const std::vector<paddle::Tensor>& Bs,
                                       bool accuracy_check = false);
 
+void benchmark_eager_wide_mlp(const paddle::Tensor& X,
+                              const std::vector<paddle::Tensor>& Ws,
+                              const std::vector<paddle::Tensor>& Bs,
+                              bool accuracy_check = false);
+
 }  // namespace egr
 
 namespace paddle {
@@ -14,6 +14,15 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/funcs/selected_rows_functor.h"
 
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <unordered_map>
+
+#include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "paddle/fluid/memory/allocation/allocator_facade.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
@@ -512,3 +521,188 @@ TEST(selected_rows_functor, cpu_sum_to) {
   // row9: 2.0 + 3.0
   EXPECT_EQ(tensor1_data[9 * row_numel + 6], 5.0);
 }
+
+// inputs SelectedRows of random values, whose rows are drawn from
+// rows_num * (1 - dup_ratio) distinct ids
+template <typename T>
+static std::vector<std::unique_ptr<phi::SelectedRows>> RandomSelectedRows(
+    int64_t inputs_num,
+    int64_t rows_num,
+    int64_t row_numel,
+    double dup_ratio,
+    std::mt19937_64* rng) {
+  paddle::platform::CPUPlace cpu_place;
+  const int64_t height = 1 << 30;
+  const int64_t ids_num =
+      std::max<int64_t>(1, static_cast<int64_t>(rows_num * (1 - dup_ratio)));
+  std::vector<int64_t> ids(ids_num);
+  for (auto& id : ids) id = (*rng)() % height;
+  std::vector<std::unique_ptr<phi::SelectedRows>> inputs;
+  for (int64_t n = 0; n < inputs_num; ++n) {
+    std::vector<int64_t> rows(rows_num / inputs_num);
+    for (auto& row : rows) row = ids[(*rng)() % ids_num];
+    if (dup_ratio == 0) {
+      std::copy(ids.begin() + n * rows.size(),
+                ids.begin() + (n + 1) * rows.size(),
+                rows.begin());
+    }
+    inputs.emplace_back(new phi::SelectedRows(rows, height));
+    auto* value = inputs.back()->mutable_value();
+    T* data = value->mutable_data<T>(
+        phi::make_ddim({static_cast<int64_t>(rows.size()), row_numel}),
+        cpu_place);
+    for (int64_t i = 0; i < value->numel(); ++i) {
+      data[i] = static_cast<T>((*rng)() % 100);
+    }
+  }
+  return inputs;
+}
+
+template <typename T>
+static void CheckMergeAdd(
+    const std::vector<std::unique_ptr<phi::SelectedRows>>& inputs,
+    const phi::SelectedRows& output,
+    bool sorted_result) {
+  const int64_t row_numel = output.value().dims()[1];
+  std::map<int64_t, std::vector<T>> expected;
+  for (auto& input : inputs) {
+    const T* data = input->value().data<T>();
+    for (size_t i = 0; i < input->rows().size(); ++i) {
+      auto& sum = expected[input->rows()[i]];
+      sum.resize(row_numel, static_cast<T>(0));
+      for (int64_t j = 0; j < row_numel; ++j) {
+        sum[j] += data[i * row_numel + j];
+      }
+    }
+  }
+
+  const auto& out_rows = output.rows();
+  ASSERT_EQ(out_rows.size(), expected.size());
+  if (sorted_result) {
+    ASSERT_TRUE(std::is_sorted(out_rows.begin(), out_rows.end()));
+  }
+  const T* out_data = output.value().data<T>();
+  for (size_t i = 0; i < out_rows.size(); ++i) {
+    const auto& sum = expected.at(out_rows[i]);
+    for (int64_t j = 0; j < row_numel; ++j) {
+      ASSERT_EQ(out_data[i * row_numel + j], sum[j]);
+    }
+  }
+}
+
+TEST(selected_rows_functor, cpu_merge_add_random) {
+  paddle::platform::CPUPlace cpu_place;
+  phi::CPUContext ctx(cpu_place);
+  ctx.SetAllocator(paddle::memory::allocation::AllocatorFacade::Instance()
+                       .GetAllocator(cpu_place)
+                       .get());
+  std::mt19937_64 rng(2023);
+  for (double dup_ratio : {0.0, 0.5, 0.99}) {
+    for (int64_t rows_num : {1, 100, 30000}) {
+      auto inputs = RandomSelectedRows<float>(1, rows_num, 13, dup_ratio, &rng);
+      for (bool sorted_result : {false, true}) {
+        phi::SelectedRows output;
+        phi::funcs::scatter::MergeAdd<phi::CPUContext, float> merge_add;
+        merge_add(ctx, *inputs[0], &output, sorted_result);
+        CheckMergeAdd<float>(inputs, output, sorted_result);
+      }
+
+      auto int_inputs =
+          RandomSelectedRows<int64_t>(3, rows_num * 3, 5, dup_ratio, &rng);
+      std::vector<const phi::SelectedRows*> inputs_ptr;
+      for (auto& input : int_inputs) inputs_ptr.push_back(input.get());
+      phi::SelectedRows output;
+      phi::funcs::scatter::MergeAdd<phi::CPUContext, int64_t> merge_add;
+      merge_add(ctx, inputs_ptr, &output, true);
+      CheckMergeAdd<int64_t>(int_inputs, output, true);
+    }
+  }
+}
+
+// Negative ids can't be radix sorted, they are merged through a stable
+// sort of the ids instead.
+TEST(selected_rows_functor, cpu_merge_add_negative_ids) {
+  paddle::platform::CPUPlace cpu_place;
+  phi::CPUContext ctx(cpu_place);
+  ctx.SetAllocator(paddle::memory::allocation::AllocatorFacade::Instance()
+                       .GetAllocator(cpu_place)
+                       .get());
+  std::mt19937_64 rng(2023);
+  for (int64_t rows_num : {100, 30000}) {
+    auto inputs = RandomSelectedRows<float>(2, rows_num, 13, 0.5, &rng);
+    std::vector<const phi::SelectedRows*> inputs_ptr;
+    for (auto& input : inputs) {
+      for (auto& row : *input->mutable_rows()) row -= 1 << 29;
+      inputs_ptr.push_back(input.get());
+    }
+    for (bool sorted_result : {false, true}) {
+      phi::SelectedRows output;
+      phi::funcs::scatter::MergeAdd<phi::CPUContext, float> merge_add;
+      merge_add(ctx, inputs_ptr, &output, sorted_result);
+      const auto& out_rows = output.rows();
+      ASSERT_LT(*std::min_element(out_rows.begin(), out_rows.end()), 0);
+      CheckMergeAdd<float>(inputs, output, sorted_result);
+    }
+  }
+}
+
+// MergeAdd of 2e6 rows of 16 floats, the gradient of a large sparse
+// embedding, for a few ratios of duplicated ids, against the former
+// merge by a std::set and a hash map of the ids followed by an axpy of
+// every row.
+// Run with --gtest_also_run_disabled_tests to time them.
+TEST(selected_rows_functor, DISABLED_cpu_merge_add_benchmark) {
+  paddle::platform::CPUPlace cpu_place;
+  phi::CPUContext ctx(cpu_place);
+  ctx.SetAllocator(paddle::memory::allocation::AllocatorFacade::Instance()
+                       .GetAllocator(cpu_place)
+                       .get());
+  std::mt19937_64 rng(2023);
+  const int64_t rows_num = 2000000, row_numel = 16;
+
+  auto ms_since = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  for (double dup_ratio : {0.0, 0.5, 0.9, 0.99}) {
+    auto inputs =
+        RandomSelectedRows<float>(1, rows_num, row_numel, dup_ratio, &rng);
+    const phi::SelectedRows& input = *inputs[0];
+
+    auto start = std::chrono::steady_clock::now();
+    phi::SelectedRows output;
+    phi::funcs::scatter::MergeAdd<phi::CPUContext, float> merge_add;
+    merge_add(ctx, input, &output, true);
+    double merge_ms = ms_since(start);
+
+    start = std::chrono::steady_clock::now();
+    std::set<int64_t> row_set(input.rows().begin(), input.rows().end());
+    std::vector<int64_t> merge_rows(row_set.begin(), row_set.end());
+    std::unordered_map<int64_t, size_t> rows_to_id;
+    for (size_t i = 0; i < merge_rows.size(); ++i) {
+      rows_to_id[merge_rows[i]] = i;
+    }
+    phi::DenseTensor former;
+    float* former_data = former.mutable_data<float>(
+        phi::make_ddim({static_cast<int64_t>(merge_rows.size()), row_numel}),
+        cpu_place);
+    phi::funcs::SetConstant<phi::CPUContext, float> set_zero;
+    set_zero(ctx, &former, 0.f);
+    auto blas = phi::funcs::GetBlas<phi::CPUContext, float>(ctx);
+    const float* input_data = input.value().data<float>();
+    for (size_t i = 0; i < input.rows().size(); ++i) {
+      blas.AXPY(row_numel,
+                1.f,
+                input_data + i * row_numel,
+                former_data + rows_to_id[input.rows()[i]] * row_numel);
+    }
+    double former_ms = ms_since(start);
+
+    ASSERT_EQ(output.rows(), merge_rows);
+    LOG(INFO) << "merge add of " << rows_num << " rows, " << merge_rows.size()
+              << " distinct: " << merge_ms << " ms, former merge "
+              << former_ms << " ms";
+  }
+}
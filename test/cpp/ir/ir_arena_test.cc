@@ -0,0 +1,92 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "paddle/ir/arena.h"
+#include "paddle/ir/builtin_attribute.h"
+#include "paddle/ir/builtin_dialect.h"
+#include "paddle/ir/builtin_op.h"
+#include "paddle/ir/builtin_type.h"
+#include "paddle/ir/ir_context.h"
+#include "paddle/ir/program.h"
+
+TEST(arena_test, allocate) {
+  ir::Arena arena;
+  EXPECT_EQ(arena.allocated_bytes(), 0u);
+  EXPECT_EQ(arena.reserved_bytes(), 0u);
+
+  void *a = arena.Allocate(24, 8);
+  void *b = arena.Allocate(8, 8);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 8, 0u);
+  EXPECT_EQ(reinterpret_cast<char *>(b), reinterpret_cast<char *>(a) + 24);
+  void *c = arena.Allocate(1, 16);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % 16, 0u);
+  EXPECT_GE(arena.allocated_bytes(), 33u);
+
+  // A large request gets its own slab and does not waste the current one.
+  size_t reserved = arena.reserved_bytes();
+  void *large = arena.Allocate(1 << 20, 8);
+  EXPECT_NE(large, nullptr);
+  EXPECT_EQ(arena.reserved_bytes(), reserved + (1 << 20));
+  void *d = arena.Allocate(8, 8);
+  EXPECT_EQ(d, reinterpret_cast<char *>(c) + 8);
+}
+
+namespace {
+// Build a chain of (num_ops / 2) get_parameter + combine pairs.
+void BuildProgram(ir::Program *program, size_t num_ops, bool use_arena) {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  ir::OpInfo get_parameter_info =
+      ctx->GetRegisteredOpInfo(ir::GetParameterOp::name());
+  ir::OpInfo combine_info = ctx->GetRegisteredOpInfo(ir::CombineOp::name());
+  ir::Type fp32 = ir::Float32Type::get(ctx);
+  std::vector<ir::Type> vec_types = {fp32, fp32};
+  ir::Type vec_type = ir::VectorType::get(ctx, vec_types);
+  ir::AttributeMap attributes = {
+      {"parameter_name", ir::StrAttribute::get(ctx, "w")}};
+  ir::Arena *arena = use_arena ? program->arena() : nullptr;
+
+  ir::OpResult prev;
+  for (size_t i = 0; i < num_ops / 2; ++i) {
+    ir::Operation *param = ir::Operation::create(
+        {}, {fp32}, attributes, get_parameter_info, arena);
+    program->InsertOp(param);
+    ir::OpResult cur = param->GetResultByIndex(0);
+    ir::Operation *combine = ir::Operation::create(
+        {cur, prev ? prev : cur}, {vec_type}, {}, combine_info, arena);
+    program->InsertOp(combine);
+    prev = cur;
+  }
+}
+}  // namespace
+
+TEST(arena_test, program_arena) {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<ir::BuiltinDialect>();
+
+  // the time to translate and destroy a large program is measured by
+  // program_translator_benchmark
+  constexpr size_t kNumOps = 1000;
+  for (bool use_arena : {false, true}) {
+    ir::Program program;
+    BuildProgram(&program, kNumOps, use_arena);
+    EXPECT_EQ(program.block()->size(), kNumOps);
+    EXPECT_EQ(program.arena()->reserved_bytes() > 0, use_arena);
+    if (use_arena) {
+      EXPECT_GE(program.arena()->reserved_bytes(),
+                program.arena()->allocated_bytes());
+    }
+  }
+}
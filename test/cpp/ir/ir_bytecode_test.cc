@@ -0,0 +1,160 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "paddle/ir/builtin_attribute.h"
+#include "paddle/ir/builtin_dialect.h"
+#include "paddle/ir/builtin_op.h"
+#include "paddle/ir/builtin_type.h"
+#include "paddle/ir/bytecode.h"
+#include "paddle/ir/ir_context.h"
+#include "paddle/ir/op_base.h"
+#include "paddle/ir/program.h"
+
+class BytecodeTestOp : public ir::Op<BytecodeTestOp> {
+ public:
+  using Op::Op;
+  static const char *name() { return "bytecode_test.op"; }
+  static constexpr const char **attributes_name = nullptr;
+  static constexpr uint32_t attributes_num = 0;
+  static void verify(const std::vector<ir::OpResult> &inputs,
+                     const std::vector<ir::Type> &outputs,
+                     const ir::AttributeMap &attributes) {}
+};
+
+class BytecodeTestDialect : public ir::Dialect {
+ public:
+  explicit BytecodeTestDialect(ir::IrContext *context)
+      : ir::Dialect(name(), context, ir::TypeId::get<BytecodeTestDialect>()) {
+    RegisterOps<BytecodeTestOp>();
+  }
+  static const char *name() { return "bytecode_test"; }
+};
+
+namespace {
+ir::IrContext *GetContext() {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<ir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<BytecodeTestDialect>();
+  return ctx;
+}
+
+ir::Operation *AddTestOp(ir::Program *program,
+                         const std::vector<ir::OpResult> &inputs,
+                         const std::vector<ir::Type> &output_types,
+                         const ir::AttributeMap &attributes) {
+  ir::Operation *op = ir::Operation::create(
+      inputs,
+      output_types,
+      attributes,
+      ir::IrContext::Instance()->GetRegisteredOpInfo(BytecodeTestOp::name()),
+      program->arena());
+  program->InsertOp(op);
+  return op;
+}
+
+void ExpectSameProgram(ir::Program *lhs, ir::Program *rhs) {
+  ASSERT_EQ(lhs->block()->size(), rhs->block()->size());
+  std::unordered_map<ir::Value, ir::Value> value_map;
+  for (auto lit = lhs->block()->begin(), rit = rhs->block()->begin();
+       lit != lhs->block()->end();
+       ++lit, ++rit) {
+    ir::Operation *lop = *lit, *rop = *rit;
+    EXPECT_EQ(lop->op_info(), rop->op_info());
+    EXPECT_EQ(lop->attribute(), rop->attribute());
+    ASSERT_EQ(lop->num_operands(), rop->num_operands());
+    for (uint32_t i = 0; i < lop->num_operands(); ++i) {
+      ir::Value lsrc = lop->GetOperandByIndex(i).impl()->source();
+      ir::Value rsrc = rop->GetOperandByIndex(i).impl()->source();
+      EXPECT_EQ(value_map[lsrc], rsrc);
+    }
+    ASSERT_EQ(lop->num_results(), rop->num_results());
+    for (uint32_t i = 0; i < lop->num_results(); ++i) {
+      EXPECT_EQ(lop->GetResultByIndex(i).type(),
+                rop->GetResultByIndex(i).type());
+      value_map[lop->GetResultByIndex(i)] = rop->GetResultByIndex(i);
+    }
+  }
+}
+}  // namespace
+
+TEST(ir_bytecode_test, round_trip) {
+  ir::IrContext *ctx = GetContext();
+  ir::Type fp32 = ir::Float32Type::get(ctx);
+  ir::Type i64 = ir::Int64Type::get(ctx);
+  std::vector<ir::Type> vec_types = {fp32, i64, ir::BFloat16Type::get(ctx)};
+  ir::Type vec = ir::VectorType::get(ctx, vec_types);
+  std::vector<ir::Attribute> elements = {ir::Int32_tAttribute::get(ctx, -3),
+                                         ir::StrAttribute::get(ctx, "x")};
+
+  ir::Program program;
+  program.SetParameter("w", nullptr);
+  ir::Operation *a = AddTestOp(
+      &program,
+      {},
+      {fp32, vec},
+      {{"str", ir::StrAttribute::get(ctx, "hello")},
+       {"bool", ir::BoolAttribute::get(ctx, true)},
+       {"float", ir::FloatAttribute::get(ctx, 1.5f)},
+       {"double", ir::DoubleAttribute::get(ctx, -2.25)},
+       {"int32", ir::Int32_tAttribute::get(ctx, -7)},
+       {"int64", ir::Int64_tAttribute::get(ctx, int64_t{1} << 40)},
+       {"array", ir::ArrayAttribute::get(ctx, elements)}});
+  ir::Operation *b = AddTestOp(
+      &program,
+      {a->GetResultByIndex(1), a->GetResultByIndex(0), a->GetResultByIndex(0)},
+      {i64},
+      {});
+  AddTestOp(&program, {b->GetResultByIndex(0)}, {}, {});
+
+  std::stringstream ss;
+  ir::SerializeProgram(&program, ss);
+  std::unique_ptr<ir::Program> loaded = ir::DeserializeProgram(ss, ctx);
+  ExpectSameProgram(&program, loaded.get());
+  EXPECT_EQ(loaded->parameters_num(), 1u);
+  EXPECT_EQ(loaded->parameters().count("w"), 1u);
+
+  // The attributes and parameters are sorted, so the loaded program is
+  // encoded into the same bytes.
+  std::stringstream ss2;
+  ir::SerializeProgram(loaded.get(), ss2);
+  EXPECT_EQ(ss.str(), ss2.str());
+  std::unique_ptr<ir::Program> reloaded = ir::DeserializeProgram(ss2, ctx);
+  ExpectSameProgram(&program, reloaded.get());
+}
+
+TEST(ir_bytecode_test, invalid_input) {
+  ir::IrContext *ctx = GetContext();
+  std::stringstream bad_magic("NOTIR");
+  EXPECT_ANY_THROW(ir::DeserializeProgram(bad_magic, ctx));
+
+  ir::Program program;
+  AddTestOp(&program, {}, {ir::Float32Type::get(ctx)}, {});
+  std::stringstream ss;
+  ir::SerializeProgram(&program, ss);
+  std::string bytes = ss.str();
+  std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+  EXPECT_THROW(ir::DeserializeProgram(truncated, ctx), const char *);
+
+  // A corrupt count of strings is rejected before the strings are allocated.
+  std::string huge_count("PDIR\x01", 5);
+  for (int i = 0; i < 5; ++i) {
+    huge_count.push_back('\xff');
+  }
+  huge_count.push_back('\x7f');
+  std::stringstream corrupt(huge_count);
+  EXPECT_THROW(ir::DeserializeProgram(corrupt, ctx), const char *);
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "paddle/ir/builtin_attribute.h"
+#include "paddle/ir/builtin_type.h"
+#include "paddle/ir/ir_context.h"
+#include "test/cpp/phi/core/timer.h"
+
+namespace {
+// Intern num_keys distinct attributes and vector types, repeat times, and
+// record the interned attributes in order.
+void Intern(ir::IrContext *ctx,
+            const std::string &prefix,
+            size_t num_keys,
+            size_t repeat,
+            std::vector<ir::Attribute> *attrs) {
+  ir::Type fp32 = ir::Float32Type::get(ctx);
+  for (size_t r = 0; r < repeat; ++r) {
+    for (size_t i = 0; i < num_keys; ++i) {
+      ir::Attribute attr =
+          ir::StrAttribute::get(ctx, prefix + std::to_string(i));
+      std::vector<ir::Type> types(i % 8 + 1, fp32);
+      ir::VectorType::get(ctx, types);
+      if (r == 0 && attrs != nullptr) attrs->push_back(attr);
+    }
+  }
+}
+}  // namespace
+
+TEST(storage_manager_test, concurrent_interning) {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  constexpr size_t kNumThreads = 8;
+  constexpr size_t kNumKeys = 5000;
+
+  // All threads intern the same keys concurrently and must get the same
+  // storages.
+  std::vector<std::vector<ir::Attribute>> results(kNumThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back(
+        Intern, ctx, "concurrent_", kNumKeys, 1, &results[t]);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 1; t < kNumThreads; ++t) {
+    EXPECT_EQ(results[t], results[0]);
+  }
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    EXPECT_EQ(results[0][i].dyn_cast<ir::StrAttribute>().data(),
+              "concurrent_" + std::to_string(i));
+  }
+}
+
+// Run with --gtest_also_run_disabled_tests to time the lookups.
+TEST(storage_manager_test, DISABLED_benchmark) {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  constexpr size_t kNumKeys = 1000;
+  constexpr size_t kRepeat = 200;
+  // Make the keys exist, so that the benchmark measures the lookups.
+  Intern(ctx, "benchmark_", kNumKeys, 1, nullptr);
+
+  phi::tests::Timer timer;
+  for (size_t num_threads : {1, 2, 4, 8}) {
+    std::vector<std::thread> threads;
+    timer.tic();
+    for (size_t t = 0; t < num_threads; ++t) {
+      threads.emplace_back(
+          Intern, ctx, "benchmark_", kNumKeys, kRepeat, nullptr);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    double ms = timer.toc();
+    LOG(INFO) << num_threads << " threads intern " << 2 * kNumKeys * kRepeat
+              << " storages each: " << ms << " ms";
+  }
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <sys/resource.h>
+
+#include <sstream>
+#include <string>
+
+#include "paddle/fluid/dialect/pd_dialect.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/fluid/translator/translate.h"
+#include "paddle/ir/builtin_dialect.h"
+#include "paddle/ir/bytecode.h"
+#include "paddle/ir/ir_context.h"
+#include "paddle/ir/program.h"
+#include "test/cpp/phi/core/timer.h"
+
+using PaddleDialect = paddle::dialect::PaddleDialect;
+using ProgramDesc = paddle::framework::ProgramDesc;
+using BlockDesc = paddle::framework::BlockDesc;
+using OpDesc = paddle::framework::OpDesc;
+using VarDesc = paddle::framework::VarDesc;
+using VarType = paddle::framework::proto::VarType;
+
+namespace {
+VarDesc *AddTensorVar(BlockDesc *block, const std::string &name) {
+  VarDesc *var = block->Var(name);
+  var->SetType(VarType::LOD_TENSOR);
+  var->SetDataType(VarType::FP32);
+  var->SetShape({-1, 64});
+  return var;
+}
+
+// h_0 = w_0; h_{i+1} = elementwise_add(h_i, w_{i+1}), every w_i is a
+// parameter, so the translated program has 2 * num_layers - 1 ops.
+void BuildLegacyProgram(ProgramDesc *program, size_t num_layers) {
+  BlockDesc *block = program->MutableBlock(0);
+  std::string prev = "w_0";
+  AddTensorVar(block, prev)->SetPersistable(true);
+  for (size_t i = 1; i < num_layers; ++i) {
+    std::string w = "w_" + std::to_string(i);
+    std::string h = "h_" + std::to_string(i);
+    AddTensorVar(block, w)->SetPersistable(true);
+    AddTensorVar(block, h);
+    OpDesc *op = block->AppendOp();
+    op->SetType("elementwise_add");
+    op->SetInput("X", {prev});
+    op->SetInput("Y", {w});
+    op->SetOutput("Out", {h});
+    op->SetAttr("axis", -1);
+    prev = h;
+  }
+}
+
+long PeakRssKb() {  // NOLINT
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+}  // namespace
+
+// Both build programs of 50000 layers. Run with
+// --gtest_also_run_disabled_tests to time them.
+TEST(ProgramTranslatorBenchmark, DISABLED_TranslateAndDestroy) {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<PaddleDialect>();
+  ctx->GetOrRegisterDialect<ir::BuiltinDialect>();
+
+  constexpr size_t kNumLayers = 50000;
+  constexpr int kRepeat = 3;
+  ProgramDesc legacy_program;
+  BuildLegacyProgram(&legacy_program, kNumLayers);
+
+  phi::tests::Timer timer;
+  long rss_before = PeakRssKb();  // NOLINT
+  double translate_ms = 0, destroy_ms = 0;
+  for (int i = 0; i < kRepeat; ++i) {
+    timer.tic();
+    auto program = paddle::TranslateLegacyProgramToProgram(legacy_program);
+    translate_ms += timer.toc();
+    EXPECT_EQ(program->block()->size(), 2 * kNumLayers - 1);
+    timer.tic();
+    program.reset();
+    destroy_ms += timer.toc();
+  }
+  LOG(INFO) << "translate " << kNumLayers << " layers: "
+            << translate_ms / kRepeat << " ms, destroy: "
+            << destroy_ms / kRepeat << " ms, peak rss growth: "
+            << PeakRssKb() - rss_before << " KB";
+}
+
+TEST(ProgramTranslatorBenchmark, DISABLED_LoadFromBytecode) {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<PaddleDialect>();
+  ctx->GetOrRegisterDialect<ir::BuiltinDialect>();
+
+  constexpr size_t kNumLayers = 50000;
+  constexpr int kRepeat = 3;
+  ProgramDesc legacy_program;
+  BuildLegacyProgram(&legacy_program, kNumLayers);
+  auto program = paddle::TranslateLegacyProgramToProgram(legacy_program);
+  std::stringstream ss;
+  ir::SerializeProgram(program.get(), ss);
+  std::string bytecode = ss.str();
+
+  phi::tests::Timer timer;
+  double translate_ms = 0, load_ms = 0;
+  for (int i = 0; i < kRepeat; ++i) {
+    timer.tic();
+    auto translated = paddle::TranslateLegacyProgramToProgram(legacy_program);
+    translate_ms += timer.toc();
+
+    std::stringstream is(bytecode);
+    timer.tic();
+    auto loaded = ir::DeserializeProgram(is, ctx);
+    load_ms += timer.toc();
+    EXPECT_EQ(loaded->block()->size(), translated->block()->size());
+    EXPECT_EQ(loaded->parameters_num(), translated->parameters_num());
+  }
+  LOG(INFO) << "program of " << kNumLayers << " layers, translate: "
+            << translate_ms / kRepeat << " ms, load " << bytecode.size()
+            << " bytes of bytecode: " << load_ms / kRepeat << " ms";
+}
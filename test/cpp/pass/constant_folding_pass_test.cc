@@ -0,0 +1,106 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "paddle/fluid/dialect/pd_dialect.h"
+#include "paddle/fluid/dialect/pd_type.h"
+#include "paddle/fluid/dialect/transforms/constant_folding_pass.h"
+#include "paddle/ir/builtin_attribute.h"
+#include "paddle/ir/builtin_dialect.h"
+#include "paddle/ir/builtin_op.h"
+#include "paddle/ir/builtin_type.h"
+#include "paddle/ir/ir_context.h"
+#include "paddle/ir/program.h"
+#include "paddle/ir/transforms/dead_code_elimination_pass.h"
+#include "paddle/pass/pass.h"
+#include "paddle/pass/pass_manager.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
+
+TEST(constant_folding_pass_test, fold_add) {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<ir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<paddle::dialect::PaddleDialect>();
+
+  ir::Program program;
+  paddle::dialect::DenseTensorTypeStorage::Dim dims = {2, 2};
+  paddle::dialect::DenseTensorTypeStorage::LoD lod = {};
+  size_t offset = 0;
+  ir::Type dense_tensor_dtype = paddle::dialect::DenseTensorType::get(
+      ctx,
+      ir::Float32Type::get(ctx),
+      dims,
+      paddle::dialect::DenseTensorTypeStorage::DataLayout::NCHW,
+      lod,
+      offset);
+  std::vector<float> data_a = {1, 2, 3, 4};
+  std::vector<float> data_b = {5, 6, 7, 8};
+  program.SetParameter(
+      "a",
+      std::make_unique<ir::Parameter>(
+          data_a.data(), 4 * sizeof(float), dense_tensor_dtype));
+  program.SetParameter(
+      "b",
+      std::make_unique<ir::Parameter>(
+          data_b.data(), 4 * sizeof(float), dense_tensor_dtype));
+
+  ir::OpInfo get_parameter_info =
+      ctx->GetRegisteredOpInfo(ir::GetParameterOp::name());
+  ir::Operation *a = ir::Operation::create(
+      {},
+      {dense_tensor_dtype},
+      {{"parameter_name", ir::StrAttribute::get(ctx, "a")}},
+      get_parameter_info);
+  program.InsertOp(a);
+  ir::Operation *b = ir::Operation::create(
+      {},
+      {dense_tensor_dtype},
+      {{"parameter_name", ir::StrAttribute::get(ctx, "b")}},
+      get_parameter_info);
+  program.InsertOp(b);
+  ir::Operation *c =
+      ir::Operation::create({a->GetResultByIndex(0), b->GetResultByIndex(0)},
+                            {dense_tensor_dtype},
+                            {},
+                            ctx->GetRegisteredOpInfo("pd.add"));
+  program.InsertOp(c);
+  program.InsertOp(ir::Operation::create(
+      {c->GetResultByIndex(0)},
+      {},
+      {{"parameter_name", ir::StrAttribute::get(ctx, "c")}},
+      ctx->GetRegisteredOpInfo(ir::SetParameterOp::name())));
+
+  ir::PassManager pm(ctx);
+  pm.AddPass(paddle::dialect::CreateConstantFoldingPass());
+  pm.AddPass(ir::CreateDeadCodeEliminationPass());
+  EXPECT_TRUE(pm.Run(&program));
+
+  // get_parameter(folded) -> set_parameter
+  EXPECT_EQ(program.block()->size(), 2u);
+  ir::Operation *folded = program.block()->front();
+  EXPECT_TRUE(folded->dyn_cast<ir::GetParameterOp>());
+  std::string name = folded->attribute()
+                         .at("parameter_name")
+                         .dyn_cast<ir::StrAttribute>()
+                         .data();
+  ir::Parameter *parameter = program.GetParameter(name);
+  ASSERT_NE(parameter, nullptr);
+  EXPECT_EQ(parameter->type(), dense_tensor_dtype);
+  for (size_t i = 0; i < data_a.size(); ++i) {
+    EXPECT_EQ(static_cast<float *>(parameter->data())[i],
+              data_a[i] + data_b[i]);
+  }
+}
@@ -0,0 +1,201 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+
+#include "paddle/ir/builtin_attribute.h"
+#include "paddle/ir/builtin_dialect.h"
+#include "paddle/ir/builtin_op.h"
+#include "paddle/ir/builtin_type.h"
+#include "paddle/ir/ir_context.h"
+#include "paddle/ir/op_base.h"
+#include "paddle/ir/program.h"
+#include "paddle/ir/transforms/common_subexpression_elimination_pass.h"
+#include "paddle/ir/transforms/dead_code_elimination_pass.h"
+#include "paddle/pass/pass.h"
+#include "paddle/pass/pass_manager.h"
+
+class TransformsTestAddOp : public ir::Op<TransformsTestAddOp> {
+ public:
+  using Op::Op;
+  static const char *name() { return "transforms_test.add"; }
+  static constexpr const char **attributes_name = nullptr;
+  static constexpr uint32_t attributes_num = 0;
+  static void verify(const std::vector<ir::OpResult> &inputs,
+                     const std::vector<ir::Type> &outputs,
+                     const ir::AttributeMap &attributes) {
+    if (inputs.size() != 2) {
+      throw("The size of inputs must be equal to 2.");
+    }
+    if (outputs.size() != 1) {
+      throw("The size of outputs must be equal to 1.");
+    }
+  }
+};
+
+class TransformsTestDialect : public ir::Dialect {
+ public:
+  explicit TransformsTestDialect(ir::IrContext *context)
+      : ir::Dialect(name(), context, ir::TypeId::get<TransformsTestDialect>()) {
+    RegisterOps<TransformsTestAddOp>();
+  }
+  static const char *name() { return "transforms_test"; }
+};
+
+ir::Operation *AddGetParameterOp(ir::Program *program, const char *name) {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  ir::Operation *op = ir::Operation::create(
+      {},
+      {ir::Float32Type::get(ctx)},
+      {{"parameter_name", ir::StrAttribute::get(ctx, name)}},
+      ctx->GetRegisteredOpInfo(ir::GetParameterOp::name()));
+  program->InsertOp(op);
+  return op;
+}
+
+ir::Operation *AddAddOp(ir::Program *program,
+                        ir::Operation *x,
+                        ir::Operation *y) {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  ir::Operation *op = ir::Operation::create(
+      {x->GetResultByIndex(0), y->GetResultByIndex(0)},
+      {ir::Float32Type::get(ctx)},
+      {},
+      ctx->GetRegisteredOpInfo(TransformsTestAddOp::name()));
+  program->InsertOp(op);
+  return op;
+}
+
+// Build the following program:
+//   a = get_parameter("a"); a2 = get_parameter("a"); b = get_parameter("b")
+//   c1 = add(a, b); c2 = add(a2, b); d = add(c1, c2); e = add(a, a)
+//   set_parameter(d, "d")
+void BuildProgram(ir::Program *program) {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<ir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<TransformsTestDialect>();
+
+  ir::Operation *a = AddGetParameterOp(program, "a");
+  ir::Operation *a2 = AddGetParameterOp(program, "a");
+  ir::Operation *b = AddGetParameterOp(program, "b");
+  ir::Operation *c1 = AddAddOp(program, a, b);
+  ir::Operation *c2 = AddAddOp(program, a2, b);
+  ir::Operation *d = AddAddOp(program, c1, c2);
+  AddAddOp(program, a, a);
+  program->InsertOp(ir::Operation::create(
+      {d->GetResultByIndex(0)},
+      {},
+      {{"parameter_name", ir::StrAttribute::get(ctx, "d")}},
+      ctx->GetRegisteredOpInfo(ir::SetParameterOp::name())));
+}
+
+TEST(ir_transforms_test, replace_all_uses_with) {
+  ir::Program program;
+  BuildProgram(&program);
+  auto it = program.block()->begin();
+  ir::Operation *a = *it++;
+  ir::Operation *a2 = *it++;
+  EXPECT_FALSE(a2->GetResultByIndex(0).use_empty());
+  a2->GetResultByIndex(0).ReplaceAllUsesWith(a->GetResultByIndex(0));
+  EXPECT_TRUE(a2->GetResultByIndex(0).use_empty());
+  size_t num_uses = 0;
+  for (auto use = a->GetResultByIndex(0).begin();
+       use != a->GetResultByIndex(0).end();
+       ++use) {
+    ++num_uses;
+  }
+  EXPECT_EQ(num_uses, 4u);
+}
+
+TEST(ir_transforms_test, dead_code_elimination) {
+  ir::Program program;
+  BuildProgram(&program);
+  EXPECT_EQ(program.block()->size(), 8u);
+
+  ir::PassManager pm(ir::IrContext::Instance());
+  pm.AddPass(ir::CreateDeadCodeEliminationPass());
+  EXPECT_TRUE(pm.Run(&program));
+
+  // Only e = add(a, a) is dead.
+  EXPECT_EQ(program.block()->size(), 7u);
+  EXPECT_EQ(std::string(program.block()->back()->op_name()),
+            ir::SetParameterOp::name());
+}
+
+TEST(ir_transforms_test, common_subexpression_elimination) {
+  ir::Program program;
+  BuildProgram(&program);
+
+  ir::PassManager pm(ir::IrContext::Instance());
+  pm.AddPass(ir::CreateCommonSubexpressionEliminationPass());
+  EXPECT_TRUE(pm.Run(&program));
+
+  // a2 is merged into a, then c2 into c1.
+  EXPECT_EQ(program.block()->size(), 6u);
+  auto it = program.block()->begin();
+  ir::Operation *a = *it++;
+  ir::Operation *b = *it++;
+  ir::Operation *c = *it++;
+  ir::Operation *d = *it++;
+  EXPECT_EQ(b->attribute()
+                .at("parameter_name")
+                .dyn_cast<ir::StrAttribute>()
+                .data(),
+            "b");
+  EXPECT_EQ(c->GetOperandByIndex(0).impl()->source(), a->GetResultByIndex(0));
+  EXPECT_EQ(d->GetOperandByIndex(0).impl()->source(), c->GetResultByIndex(0));
+  EXPECT_EQ(d->GetOperandByIndex(1).impl()->source(), c->GetResultByIndex(0));
+
+  pm.AddPass(ir::CreateDeadCodeEliminationPass());
+  EXPECT_TRUE(pm.Run(&program));
+  EXPECT_EQ(program.block()->size(), 5u);
+}
+
+TEST(ir_transforms_test, common_subexpression_elimination_side_effect) {
+  ir::IrContext *ctx = ir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<ir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<TransformsTestDialect>();
+
+  // w1 = get_parameter("w"); set_parameter(add(w1, w1), "w")
+  // w2 = get_parameter("w"); set_parameter(add(w2, w2), "v")
+  ir::Program program;
+  ir::Operation *w1 = AddGetParameterOp(&program, "w");
+  ir::Operation *s = AddAddOp(&program, w1, w1);
+  program.InsertOp(ir::Operation::create(
+      {s->GetResultByIndex(0)},
+      {},
+      {{"parameter_name", ir::StrAttribute::get(ctx, "w")}},
+      ctx->GetRegisteredOpInfo(ir::SetParameterOp::name())));
+  ir::Operation *w2 = AddGetParameterOp(&program, "w");
+  ir::Operation *t = AddAddOp(&program, w2, w2);
+  program.InsertOp(ir::Operation::create(
+      {t->GetResultByIndex(0)},
+      {},
+      {{"parameter_name", ir::StrAttribute::get(ctx, "v")}},
+      ctx->GetRegisteredOpInfo(ir::SetParameterOp::name())));
+
+  ir::PassManager pm(ctx);
+  pm.AddPass(ir::CreateCommonSubexpressionEliminationPass());
+  EXPECT_TRUE(pm.Run(&program));
+
+  // The second read of w comes after the write and is kept.
+  EXPECT_EQ(program.block()->size(), 6u);
+  auto it = program.block()->begin();
+  EXPECT_EQ(*it, w1);
+  std::advance(it, 3);
+  EXPECT_EQ(*it, w2);
+  EXPECT_EQ(t->GetOperandByIndex(0).impl()->source(), w2->GetResultByIndex(0));
+}
@@ -0,0 +1,73 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+
+#include "paddle/phi/api/include/api.h"
+#include "paddle/phi/core/kernel_factory.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "test/cpp/phi/core/timer.h"
+
+PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(scale, CPU, ALL_LAYOUT);
+
+namespace paddle {
+namespace tests {
+
+// The dispatch overhead of an API on a tensor of one element, in ns per op:
+// selecting the kernel by name and key, selecting it through a
+// KernelDispatchCache, and the whole scale API, which runs the latter.
+TEST(API, kernel_dispatch_benchmark) {
+  auto x = experimental::full({1}, 1.0, phi::DataType::FLOAT32, CPUPlace());
+  phi::KernelKey key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT32);
+  phi::KernelDispatchCache cache("scale");
+
+  const size_t cycles = 100000;
+  phi::tests::Timer timer;
+  const phi::Kernel* selected = nullptr;
+  const phi::Kernel* cached = nullptr;
+
+  timer.tic();
+  for (size_t i = 0; i < cycles; ++i) {
+    auto result =
+        phi::KernelFactory::Instance().SelectKernelOrThrowError("scale", key);
+    selected = &result.kernel;
+  }
+  double factory_ms = timer.toc();
+
+  timer.tic();
+  for (size_t i = 0; i < cycles; ++i) {
+    auto result = cache.SelectKernelOrThrowError(key);
+    cached = &result.kernel;
+  }
+  double cache_ms = timer.toc();
+  EXPECT_EQ(cached, selected);
+
+  timer.tic();
+  for (size_t i = 0; i < cycles; ++i) {
+    auto out = experimental::scale(x, 2.0, 1.0, true);
+  }
+  double api_ms = timer.toc();
+
+  LOG(INFO) << "Kernel selection by the factory costs "
+            << factory_ms * 1e6 / cycles << " ns/op.";
+  LOG(INFO) << "Kernel selection by a dispatch cache costs "
+            << cache_ms * 1e6 / cycles << " ns/op.";
+  LOG(INFO) << "The scale API on a tensor of one element costs "
+            << api_ms * 1e6 / cycles << " ns/op.";
+}
+
+}  // namespace tests
+}  // namespace paddle
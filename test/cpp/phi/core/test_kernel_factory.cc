@@ -48,6 +48,49 @@ TEST(KernelFactory, SelectedKernelMap) {
   }
 }
 
+TEST(KernelDispatchCache, SelectKernel) {
+  auto& factory = phi::KernelFactory::Instance();
+  phi::KernelKey key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT32);
+  phi::KernelDispatchCache cache("scale");
+  const Kernel* kernel = &cache.SelectKernelOrThrowError(key).kernel;
+  EXPECT_EQ(kernel, &factory.SelectKernelOrThrowError("scale", key).kernel);
+  EXPECT_EQ(kernel, &cache.SelectKernelOrThrowError(key).kernel);
+
+  phi::KernelKey fp64_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT64);
+  EXPECT_EQ(&cache.SelectKernelOrThrowError(fp64_key).kernel,
+            &factory.SelectKernelOrThrowError("scale", fp64_key).kernel);
+  EXPECT_EQ(kernel, &cache.SelectKernelOrThrowError(key).kernel);
+}
+
+TEST(KernelDispatchCache, InvalidateOnRegistration) {
+  auto& factory = phi::KernelFactory::Instance();
+  phi::KernelKey key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT32);
+  factory.kernels()["dispatch_cache_test"][key] = Kernel();
+  factory.InvalidateDispatchCaches();
+  phi::KernelDispatchCache cache("dispatch_cache_test");
+  EXPECT_EQ(&cache.SelectKernelOrThrowError(key).kernel,
+            &factory.kernels()["dispatch_cache_test"][key]);
+
+  // more kernels of the name may rehash its map and move the kernel
+  for (int i = 1; i < 20; ++i) {
+    factory.kernels()["dispatch_cache_test"][phi::KernelKey(
+        phi::Backend::CPU,
+        phi::DataLayout::ALL_LAYOUT,
+        static_cast<phi::DataType>(i))] = Kernel();
+  }
+  factory.InvalidateDispatchCaches();
+  EXPECT_EQ(&cache.SelectKernelOrThrowError(key).kernel,
+            &factory.kernels()["dispatch_cache_test"][key]);
+
+  factory.kernels().erase("dispatch_cache_test");
+  factory.InvalidateDispatchCaches();
+  EXPECT_THROW(cache.SelectKernelOrThrowError(key),
+               phi::enforce::EnforceNotMet);
+}
+
 template <typename T, typename Context>
 void TestKernel(const Context& dev_ctx,
                 const DenseTensor& x,
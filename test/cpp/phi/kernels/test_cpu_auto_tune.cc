@@ -0,0 +1,145 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/autotune/switch_autotune.h"
+#include "paddle/phi/kernels/empty_kernel.h"
+#include "paddle/phi/kernels/transpose_kernel.h"
+
+namespace autotune = phi::autotune;
+
+TEST(CpuAutoTune, SaveAndLoad) {
+  auto& autotune_cache = autotune::AutoTuneCache::Instance();
+  autotune_cache.Clean();
+  auto& cache = autotune_cache.Get(autotune::AlgorithmType::kTransposeCPU);
+  cache.Set(123, 1);
+  cache.Set(456, 0);
+  autotune_cache.GetMatmul().Set(789, 2);
+  auto& conv_cache =
+      autotune_cache.GetConv(autotune::AlgorithmType::kConvForward);
+  autotune::ConvCacheKey conv_key({4, 224, 224, 3},
+                                  {32, 3, 3, 3},
+                                  {2, 2},
+                                  {0, 0},
+                                  {1, 1},
+                                  phi::DataType::FLOAT32,
+                                  1,
+                                  0);
+  conv_cache.Set(conv_key, autotune::ConvAutoTuneResult(5, 1024, true));
+
+  const std::string path = "cpu_auto_tune_cache.txt";
+  autotune_cache.Save(path);
+  autotune_cache.Clean();
+  EXPECT_EQ(cache.Size(), 0);
+  EXPECT_EQ(conv_cache.Size(), 0);
+
+  autotune_cache.Load(path);
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_EQ(cache.Get(123), 1);
+  EXPECT_EQ(cache.Get(456), 0);
+  EXPECT_EQ(autotune_cache.GetMatmul().Get(789), 2);
+  ASSERT_TRUE(conv_cache.Find(conv_key));
+  auto result = conv_cache.Get(conv_key);
+  EXPECT_EQ(result.algo, 5);
+  EXPECT_EQ(result.workspace_size, 1024UL);
+  EXPECT_TRUE(result.exhaustive_search);
+  std::remove(path.c_str());
+  autotune_cache.Clean();
+}
+
+TEST(CpuAutoTune, LoadInvalidFile) {
+  auto& autotune_cache = autotune::AutoTuneCache::Instance();
+  autotune_cache.Clean();
+  auto& cache = autotune_cache.Get(autotune::AlgorithmType::kTransposeCPU);
+  cache.Set(123, 1);
+
+  // valid lines followed by an invalid one merge nothing
+  const std::string path = "cpu_auto_tune_invalid_cache.txt";
+  {
+    std::ofstream fout(path);
+    fout << "paddle_autotune_cache 1\n"
+         << "algo "
+         << static_cast<int64_t>(autotune::AlgorithmType::kTransposeCPU)
+         << " 123 0\n"
+         << "matmul 790 2\n"
+         << "algo 1000000 456 0\n";
+  }
+  EXPECT_THROW(autotune_cache.Load(path), phi::enforce::EnforceNotMet);
+  EXPECT_EQ(cache.Size(), 1);
+  EXPECT_EQ(cache.Get(123), 1);
+  EXPECT_FALSE(autotune_cache.GetMatmul().Find(790));
+  std::remove(path.c_str());
+  autotune_cache.Clean();
+}
+
+TEST(CpuAutoTune, Transpose) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  auto& status = autotune::AutoTuneStatus::Instance();
+  auto& autotune_cache = autotune::AutoTuneCache::Instance();
+  auto& cache = autotune_cache.Get(autotune::AlgorithmType::kTransposeCPU);
+
+  const std::vector<int64_t> dims = {8, 64, 32};
+  const std::vector<int> axis = {0, 2, 1};
+  phi::DenseTensor x = phi::Empty<float>(*dev_ctx, dims);
+  float* x_ptr = x.data<float>();
+  for (int64_t i = 0; i < x.numel(); ++i) x_ptr[i] = static_cast<float>(i);
+
+  // tunes the shape in the first step, and reuses it in the next
+  status.EnableAutoTune();
+  status.SetAutoTuneRange(1, 3);
+  for (int step = 0; step < 3; ++step) {
+    status.Update();
+    phi::DenseTensor out = phi::Transpose<float>(*dev_ctx, x, axis);
+    const float* out_ptr = out.data<float>();
+    for (int64_t b = 0; b < dims[0]; ++b) {
+      for (int64_t i = 0; i < dims[2]; ++i) {
+        for (int64_t j = 0; j < dims[1]; ++j) {
+          ASSERT_EQ(out_ptr[(b * dims[2] + i) * dims[1] + j],
+                    x_ptr[(b * dims[1] + j) * dims[2] + i]);
+        }
+      }
+    }
+    EXPECT_EQ(cache.Size(), 1);
+  }
+  EXPECT_EQ(cache.CacheHits(), 2);
+
+  // one line for the tuned shape, with the times of the Eigen and the index
+  // kernels, and the winner is the one in the cache
+  std::istringstream report(autotune_cache.TuningReport());
+  std::string line, extra_line;
+  ASSERT_TRUE(static_cast<bool>(std::getline(report, line)));
+  EXPECT_FALSE(static_cast<bool>(std::getline(report, extra_line)));
+  std::regex pattern(
+      "transpose_cpu x \\[8, 64, 32\\] axis \\[0, 2, 1\\] float32: best "
+      "kernel (\\d+), time cost of kernels (\\S+) (\\S+) ms");
+  std::smatch match;
+  ASSERT_TRUE(std::regex_match(line, match, pattern)) << line;
+  EXPECT_GE(std::stof(match[2]), 0.f);
+  EXPECT_GE(std::stof(match[3]), 0.f);
+  size_t key = autotune::TransposeKey(
+      dims, std::vector<int32_t>(axis.begin(), axis.end()), x.dtype());
+  EXPECT_EQ(std::to_string(cache.Get(key)), match[1].str());
+  status.DisableAutoTune();
+}
@@ -0,0 +1,266 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/phi/kernels/funcs/embedding_pool.h"
+
+namespace phi {
+namespace tests {
+
+using funcs::EmbeddingPoolSlot;
+using funcs::EmbeddingPoolType;
+
+static std::vector<float> RandomTable(int64_t height,
+                                      int64_t width,
+                                      std::mt19937_64* rng) {
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::vector<float> table(height * width);
+  for (auto& v : table) v = dist(*rng);
+  return table;
+}
+
+// ids of a table of height rows, uniform or following a Zipf law of
+// exponent 1, as the features of click logs do.
+static std::vector<int64_t> RandomIds(int64_t num,
+                                      int64_t height,
+                                      bool zipf,
+                                      std::mt19937_64* rng) {
+  std::vector<int64_t> ids(num);
+  if (!zipf) {
+    for (auto& id : ids) id = (*rng)() % height;
+    return ids;
+  }
+  std::vector<double> weights(height);
+  for (int64_t i = 0; i < height; ++i) weights[i] = 1.0 / (i + 1);
+  std::discrete_distribution<int64_t> dist(weights.begin(), weights.end());
+  // scatter the hot ids over the table, like a hash of the features
+  const int64_t step = 2654435761LL % height;
+  for (auto& id : ids) id = dist(*rng) * step % height;
+  return ids;
+}
+
+static std::vector<uint64_t> RandomLod(int64_t batch,
+                                       int64_t max_len,
+                                       std::mt19937_64* rng) {
+  std::vector<uint64_t> lod(batch + 1, 0);
+  for (int64_t i = 0; i < batch; ++i) {
+    lod[i + 1] = lod[i] + (*rng)() % (max_len + 1);
+  }
+  return lod;
+}
+
+static std::vector<float> ReferencePool(const std::vector<float>& table,
+                                        const std::vector<int64_t>& ids,
+                                        const std::vector<uint64_t>& lod,
+                                        int64_t width,
+                                        int64_t padding_idx,
+                                        EmbeddingPoolType type) {
+  const int64_t batch = lod.size() - 1;
+  std::vector<float> out(batch * width, 0.f);
+  for (int64_t i = 0; i < batch; ++i) {
+    int64_t count = 0;
+    for (uint64_t j = lod[i]; j < lod[i + 1]; ++j) {
+      if (ids[j] == padding_idx) continue;
+      for (int64_t c = 0; c < width; ++c) {
+        out[i * width + c] += table[ids[j] * width + c];
+      }
+      ++count;
+    }
+    const float scale = funcs::EmbeddingPoolScale<float>(type, count);
+    for (int64_t c = 0; c < width; ++c) out[i * width + c] *= scale;
+  }
+  return out;
+}
+
+TEST(EmbeddingPool, pool_of_slots) {
+  std::mt19937_64 rng(2023);
+  const int64_t batch = 37, width = 13, padding_idx = 2;
+  const std::vector<int64_t> heights = {5, 100, 1000};
+  for (auto type : {EmbeddingPoolType::kSum,
+                    EmbeddingPoolType::kMean,
+                    EmbeddingPoolType::kSqrtN}) {
+    std::vector<std::vector<float>> tables;
+    std::vector<std::vector<int64_t>> ids;
+    std::vector<std::vector<uint64_t>> lods;
+    for (int64_t height : heights) {
+      tables.push_back(RandomTable(height, width, &rng));
+      lods.push_back(RandomLod(batch, 8, &rng));
+      ids.push_back(RandomIds(lods.back().back(), height, false, &rng));
+    }
+
+    // the slots are pooled into the columns of a single output
+    const int64_t out_width = heights.size() * width;
+    std::vector<float> out(batch * out_width);
+    std::vector<EmbeddingPoolSlot<float, int64_t>> slots;
+    for (size_t s = 0; s < heights.size(); ++s) {
+      slots.push_back({tables[s].data(),
+                       heights[s],
+                       ids[s].data(),
+                       1,
+                       lods[s].data(),
+                       out.data() + s * width,
+                       out_width});
+    }
+    funcs::EmbeddingPool(slots, batch, width, padding_idx, type);
+
+    for (size_t s = 0; s < heights.size(); ++s) {
+      std::vector<float> expected =
+          ReferencePool(tables[s], ids[s], lods[s], width, padding_idx, type);
+      for (int64_t i = 0; i < batch; ++i) {
+        for (int64_t c = 0; c < width; ++c) {
+          ASSERT_NEAR(out[i * out_width + s * width + c],
+                      expected[i * width + c],
+                      1e-5);
+        }
+      }
+    }
+  }
+}
+
+TEST(EmbeddingPool, out_of_range_id) {
+  std::vector<float> table(4 * 2, 1.f);
+  std::vector<int64_t> ids = {0, 4};
+  std::vector<uint64_t> lod = {0, 2};
+  std::vector<float> out(2);
+  std::vector<EmbeddingPoolSlot<float, int64_t>> slots = {
+      {table.data(), 4, ids.data(), 1, lod.data(), out.data(), 2}};
+  EXPECT_THROW(funcs::EmbeddingPool(
+                   slots, 1, 2, /*padding_idx=*/-1, EmbeddingPoolType::kSum),
+               phi::enforce::EnforceNotMet);
+}
+
+TEST(EmbeddingPool, grads_of_duplicate_ids) {
+  std::mt19937_64 rng(2023);
+  const int64_t height = 50, width = 7, num = 1000, padding_idx = 3;
+  std::vector<int64_t> ids = RandomIds(num, height, true, &rng);
+  std::vector<float> grads = RandomTable(num, width, &rng);
+  auto grad = [&](int64_t p) {
+    return std::pair<const float*, float>(grads.data() + p * width, 0.5f);
+  };
+
+  std::vector<float> expected(height * width, 0.f);
+  for (int64_t p = 0; p < num; ++p) {
+    if (ids[p] == padding_idx) continue;
+    for (int64_t c = 0; c < width; ++c) {
+      expected[ids[p] * width + c] += 0.5f * grads[p * width + c];
+    }
+  }
+
+  funcs::EmbeddingIdGroups groups =
+      funcs::GroupEmbeddingIds(ids.data(), num, height, padding_idx);
+  ASSERT_EQ(groups.offsets.size(), groups.rows.size() + 1);
+  for (size_t k = 1; k < groups.rows.size(); ++k) {
+    ASSERT_LT(groups.rows[k - 1], groups.rows[k]);
+  }
+
+  // into the rows of a dense table gradient
+  std::vector<float> dense(height * width, 0.f);
+  funcs::SumEmbeddingGrads(groups, width, true, grad, dense.data());
+  for (int64_t i = 0; i < height * width; ++i) {
+    ASSERT_NEAR(dense[i], expected[i], 1e-4);
+  }
+
+  // into one row per distinct id, as a SelectedRows gradient
+  std::vector<float> merged(groups.rows.size() * width);
+  funcs::SumEmbeddingGrads(groups, width, false, grad, merged.data());
+  for (size_t k = 0; k < groups.rows.size(); ++k) {
+    ASSERT_NE(groups.rows[k], padding_idx);
+    for (int64_t c = 0; c < width; ++c) {
+      ASSERT_NEAR(merged[k * width + c],
+                  expected[groups.rows[k] * width + c],
+                  1e-4);
+    }
+  }
+}
+
+// Sum pooling of 26 slots, as in the Criteo data set, of 1e6-row tables
+// for uniform and Zipf ids, against a lookup of the rows one by one
+// followed by a separate pooling pass.
+// Run with --gtest_also_run_disabled_tests to time them.
+TEST(EmbeddingPool, DISABLED_benchmark) {
+  std::mt19937_64 rng(2023);
+  const int64_t slots_num = 26, height = 1000000, width = 16, batch = 2048;
+  std::vector<float> table = RandomTable(height, width, &rng);
+
+  auto ms_since = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  for (bool zipf : {false, true}) {
+    std::vector<std::vector<int64_t>> ids;
+    std::vector<std::vector<uint64_t>> lods;
+    for (int64_t s = 0; s < slots_num; ++s) {
+      lods.push_back(RandomLod(batch, 8, &rng));
+      ids.push_back(RandomIds(lods.back().back(), height, zipf, &rng));
+    }
+    const int64_t out_width = slots_num * width;
+    std::vector<float> out(batch * out_width);
+    std::vector<EmbeddingPoolSlot<float, int64_t>> slots;
+    for (int64_t s = 0; s < slots_num; ++s) {
+      slots.push_back({table.data(),
+                       height,
+                       ids[s].data(),
+                       1,
+                       lods[s].data(),
+                       out.data() + s * width,
+                       out_width});
+    }
+
+    // the best of a few runs of each, the first of which faults the pages
+    // of the outputs in
+    double fused_ms = 1e30, unfused_ms = 1e30;
+    std::vector<float> rows;
+    for (int r = 0; r < 5; ++r) {
+      auto start = std::chrono::steady_clock::now();
+      funcs::EmbeddingPool(slots, batch, width, -1, EmbeddingPoolType::kSum);
+      fused_ms = std::min(fused_ms, ms_since(start));
+
+      start = std::chrono::steady_clock::now();
+      for (int64_t s = 0; s < slots_num; ++s) {
+        rows.resize(ids[s].size() * width);
+        for (size_t j = 0; j < ids[s].size(); ++j) {
+          std::copy(table.begin() + ids[s][j] * width,
+                    table.begin() + (ids[s][j] + 1) * width,
+                    rows.begin() + j * width);
+        }
+        for (int64_t i = 0; i < batch; ++i) {
+          float* dst = out.data() + i * out_width + s * width;
+          std::fill(dst, dst + width, 0.f);
+          for (uint64_t j = lods[s][i]; j < lods[s][i + 1]; ++j) {
+            for (int64_t c = 0; c < width; ++c) dst[c] += rows[j * width + c];
+          }
+        }
+      }
+      unfused_ms = std::min(unfused_ms, ms_since(start));
+    }
+
+    LOG(INFO) << (zipf ? "zipf" : "uniform") << " ids of " << slots_num
+              << " slots: fused pooling " << fused_ms
+              << " ms, lookup then pooling " << unfused_ms << " ms";
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,221 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/kernels/funcs/fc_functor.h"
+
+namespace phi {
+namespace tests {
+
+static phi::DenseTensor RandomInt8Weight(const phi::CPUContext& dev_ctx,
+                                         int K,
+                                         int N,
+                                         std::mt19937* rng) {
+  phi::DenseTensor w;
+  w.Resize({K, N});
+  int8_t* w_data = dev_ctx.template Alloc<int8_t>(&w);
+  std::uniform_int_distribution<int> dist(-127, 127);
+  for (int64_t i = 0; i < w.numel(); ++i) {
+    w_data[i] = static_cast<int8_t>(dist(*rng));
+  }
+  return w;
+}
+
+static std::vector<float> RandomVector(size_t size,
+                                       float low,
+                                       float high,
+                                       std::mt19937* rng) {
+  std::uniform_real_distribution<float> dist(low, high);
+  std::vector<float> vec(size);
+  for (auto& v : vec) v = dist(*rng);
+  return vec;
+}
+
+static float WeightScale(const std::vector<float>& weight_scale, int j) {
+  return weight_scale.size() == 1 ? weight_scale[0] : weight_scale[j];
+}
+
+// x is quantized as round(x * 127 / input_scale) clipped to [-127, 127],
+// the weight holds round(w * 127 / weight_scale).
+static std::vector<float> Int8Fc(const std::vector<float>& x,
+                                 const phi::DenseTensor& w,
+                                 const std::vector<float>& bias,
+                                 float input_scale,
+                                 const std::vector<float>& weight_scale,
+                                 bool relu,
+                                 int M) {
+  const int K = w.dims()[0];
+  const int N = w.dims()[1];
+  const int8_t* w_data = w.data<int8_t>();
+  const float x_factor = 127.f / input_scale;
+  std::vector<float> y(M * N);
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      int64_t acc = 0;
+      for (int k = 0; k < K; ++k) {
+        float q = std::round(x[i * K + k] * x_factor);
+        q = std::min(std::max(q, -127.f), 127.f);
+        acc += static_cast<int64_t>(q) * w_data[k * N + j];
+      }
+      float v = acc * input_scale * WeightScale(weight_scale, j) /
+                    (127.f * 127.f) +
+                bias[j];
+      y[i * N + j] = relu ? std::max(v, 0.f) : v;
+    }
+  }
+  return y;
+}
+
+// fc of x and the dequantized weight w * weight_scale / 127 in float
+static std::vector<float> DequantizedFc(const std::vector<float>& x,
+                                        const phi::DenseTensor& w,
+                                        const std::vector<float>& bias,
+                                        const std::vector<float>& weight_scale,
+                                        bool relu,
+                                        int M) {
+  const int K = w.dims()[0];
+  const int N = w.dims()[1];
+  const int8_t* w_data = w.data<int8_t>();
+  std::vector<float> y(M * N);
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      float v = bias[j];
+      for (int k = 0; k < K; ++k) {
+        v += x[i * K + k] * w_data[k * N + j] * WeightScale(weight_scale, j) /
+             127.f;
+      }
+      y[i * N + j] = relu ? std::max(v, 0.f) : v;
+    }
+  }
+  return y;
+}
+
+static void ExpectNear(const std::vector<float>& actual,
+                       const std::vector<float>& expected,
+                       float tolerance) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size(); ++i) {
+    ASSERT_NEAR(actual[i],
+                expected[i],
+                tolerance * std::max(1.f, std::fabs(expected[i])))
+        << "at " << i;
+  }
+}
+
+TEST(FCInt8Functor, int8_gemm) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  std::mt19937 rng(2023);
+  phi::funcs::FCInt8Functor<phi::CPUContext, float> fc;
+  // blocks of 16 rows and a tail, and per tensor and per channel scales
+  const int M = 37, N = 21, K = 19;
+  const float input_scale = 2.f;
+  phi::DenseTensor w = RandomInt8Weight(*dev_ctx, K, N, &rng);
+  std::vector<float> bias = RandomVector(N, -1.f, 1.f, &rng);
+  // some of x is out of [-input_scale, input_scale] and gets clipped
+  std::vector<float> x = RandomVector(M * K, -2.5f, 2.5f, &rng);
+  for (auto weight_scale :
+       {std::vector<float>{0.5f}, RandomVector(N, 0.1f, 1.f, &rng)}) {
+    for (bool relu : {false, true}) {
+      std::vector<float> y(M * N);
+      fc(*dev_ctx,
+         M,
+         N,
+         K,
+         x.data(),
+         w,
+         y.data(),
+         input_scale,
+         weight_scale,
+         bias.data(),
+         relu);
+      ExpectNear(
+          y, Int8Fc(x, w, bias, input_scale, weight_scale, relu, M), 1e-5f);
+    }
+  }
+}
+
+TEST(FCInt8Functor, weight_only) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  std::mt19937 rng(2023);
+  phi::funcs::FCInt8Functor<phi::CPUContext, float> fc;
+  const int M = 5, N = 18, K = 33;
+  phi::DenseTensor w = RandomInt8Weight(*dev_ctx, K, N, &rng);
+  std::vector<float> bias = RandomVector(N, -1.f, 1.f, &rng);
+  std::vector<float> x = RandomVector(M * K, -1.f, 1.f, &rng);
+  // the second scale is a new entry of the cache for the same weight
+  for (auto weight_scale :
+       {RandomVector(N, 0.1f, 1.f, &rng), std::vector<float>{0.25f}}) {
+    for (bool relu : {false, true}) {
+      std::vector<float> y(M * N);
+      fc(*dev_ctx,
+         M,
+         N,
+         K,
+         x.data(),
+         w,
+         y.data(),
+         0.f,
+         weight_scale,
+         bias.data(),
+         relu);
+      ExpectNear(y, DequantizedFc(x, w, bias, weight_scale, relu, M), 1e-4f);
+    }
+  }
+}
+
+TEST(FCInt8Functor, new_weights) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  std::mt19937 rng(2023);
+  phi::funcs::FCInt8Functor<phi::CPUContext, float> fc;
+  const int M = 3, N = 16, K = 8;
+  const std::vector<float> weight_scale = {1.f};
+  std::vector<float> bias(N, 0.f);
+  std::vector<float> x = RandomVector(M * K, -1.f, 1.f, &rng);
+  // a weight freed and another one allocated, possibly at the same address,
+  // never gets the packed weight of the former one
+  for (int r = 0; r < 4; ++r) {
+    phi::DenseTensor w = RandomInt8Weight(*dev_ctx, K, N, &rng);
+    for (float input_scale : {1.f, 0.f}) {
+      std::vector<float> y(M * N);
+      fc(*dev_ctx,
+         M,
+         N,
+         K,
+         x.data(),
+         w,
+         y.data(),
+         input_scale,
+         weight_scale,
+         bias.data());
+      ExpectNear(y,
+                 input_scale > 0.f
+                     ? Int8Fc(x, w, bias, input_scale, weight_scale, false, M)
+                     : DequantizedFc(x, w, bias, weight_scale, false, M),
+                 1e-4f);
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
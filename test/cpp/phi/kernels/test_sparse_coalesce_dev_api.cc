@@ -0,0 +1,160 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/sparse_coo_tensor.h"
+#include "paddle/phi/kernels/sparse/coalesce_kernel.h"
+
+namespace phi {
+namespace tests {
+
+// nnz random points of a grid of dims, with channels values each, sorted
+// by their coordinates if sorted.
+static SparseCooTensor MakeCoo(const CPUContext& dev_ctx,
+                               const std::vector<int64_t>& dims,
+                               int64_t nnz,
+                               int64_t channels,
+                               bool sorted,
+                               std::mt19937_64* rng) {
+  const int64_t sparse_dim = dims.size();
+  int64_t grid_size = 1;
+  for (int64_t d : dims) grid_size *= d;
+  std::vector<int64_t> points(nnz);
+  for (auto& point : points) point = (*rng)() % grid_size;
+  if (sorted) std::sort(points.begin(), points.end());
+
+  std::vector<int64_t> out_dims(dims);
+  if (channels > 1) out_dims.push_back(channels);
+  DenseTensor indices = phi::Empty<int64_t>(dev_ctx, {sparse_dim, nnz});
+  DenseTensor values =
+      channels > 1 ? phi::Empty<float>(dev_ctx, {nnz, channels})
+                   : phi::Empty<float>(dev_ctx, {nnz});
+  int64_t* indices_ptr = indices.data<int64_t>();
+  for (int64_t i = 0; i < nnz; ++i) {
+    int64_t point = points[i];
+    for (int64_t j = sparse_dim - 1; j >= 0; --j) {
+      indices_ptr[j * nnz + i] = point % dims[j];
+      point /= dims[j];
+    }
+  }
+  float* values_ptr = values.data<float>();
+  for (int64_t i = 0; i < values.numel(); ++i) {
+    values_ptr[i] = static_cast<float>((*rng)() % 1000) / 100.f;
+  }
+  return SparseCooTensor(indices, values, phi::make_ddim(out_dims));
+}
+
+static void CheckCoalesce(const SparseCooTensor& x,
+                          const SparseCooTensor& out) {
+  const int64_t sparse_dim = x.indices().dims()[0];
+  const int64_t nnz = x.nnz();
+  const int64_t channels = x.values().numel() / std::max<int64_t>(nnz, 1);
+  const int64_t* indices = x.indices().data<int64_t>();
+  const float* values = x.values().data<float>();
+  std::map<std::vector<int64_t>, std::vector<float>> expected;
+  for (int64_t i = 0; i < nnz; ++i) {
+    std::vector<int64_t> point;
+    for (int64_t j = 0; j < sparse_dim; ++j) {
+      point.push_back(indices[j * nnz + i]);
+    }
+    auto& sum = expected[point];
+    sum.resize(channels, 0.f);
+    for (int64_t k = 0; k < channels; ++k) {
+      sum[k] += values[i * channels + k];
+    }
+  }
+
+  const int64_t out_nnz = out.nnz();
+  ASSERT_EQ(out_nnz, static_cast<int64_t>(expected.size()));
+  ASSERT_TRUE(out.coalesced());
+  const int64_t* out_indices = out.indices().data<int64_t>();
+  const float* out_values = out.values().data<float>();
+  auto it = expected.begin();
+  for (int64_t i = 0; i < out_nnz; ++i, ++it) {
+    for (int64_t j = 0; j < sparse_dim; ++j) {
+      ASSERT_EQ(out_indices[j * out_nnz + i], it->first[j]);
+    }
+    for (int64_t k = 0; k < channels; ++k) {
+      ASSERT_FLOAT_EQ(out_values[i * channels + k], it->second[k]);
+    }
+  }
+}
+
+TEST(DEV_API, sparse_coalesce) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  std::mt19937_64 rng(2023);
+  for (int64_t nnz : {0, 1, 100, 50000}) {
+    for (int64_t channels : {1, 3}) {
+      for (bool sorted : {false, true}) {
+        SparseCooTensor x =
+            MakeCoo(*dev_ctx, {4, 64, 64}, nnz, channels, sorted, &rng);
+        SparseCooTensor out = sparse::CoalesceCoo<float>(*dev_ctx, x);
+        CheckCoalesce(x, out);
+        // coalescing a coalesced tensor takes the fast path
+        SparseCooTensor again = sparse::CoalesceCoo<float>(*dev_ctx, out);
+        CheckCoalesce(out, again);
+      }
+    }
+  }
+}
+
+// Coalesce of random points with a few duplicates, and of the result,
+// which is already coalesced. Run with --gtest_also_run_disabled_tests to
+// time them. Set SPARSE_COALESCE_BENCHMARK_LARGE to also run 1e8 non zeros,
+// which takes about 5GB.
+TEST(DEV_API, DISABLED_sparse_coalesce_benchmark) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  std::mt19937_64 rng(2023);
+  std::vector<int64_t> sizes = {1000000, 10000000};
+  if (std::getenv("SPARSE_COALESCE_BENCHMARK_LARGE")) {
+    sizes.push_back(100000000);
+  }
+
+  auto ms_since = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  for (int64_t nnz : sizes) {
+    SparseCooTensor x =
+        MakeCoo(*dev_ctx, {16, 20000, 20000}, nnz, 1, false, &rng);
+    auto start = std::chrono::steady_clock::now();
+    SparseCooTensor out = sparse::CoalesceCoo<float>(*dev_ctx, x);
+    double unsorted_ms = ms_since(start);
+    start = std::chrono::steady_clock::now();
+    SparseCooTensor again = sparse::CoalesceCoo<float>(*dev_ctx, out);
+    double coalesced_ms = ms_since(start);
+    EXPECT_EQ(again.nnz(), out.nnz());
+
+    LOG(INFO) << "coalesce of " << nnz << " non zeros: unsorted "
+              << unsorted_ms << " ms, already coalesced " << coalesced_ms
+              << " ms";
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,266 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/sparse_coo_tensor.h"
+#include "paddle/phi/kernels/sparse/conv_kernel.h"
+#include "paddle/phi/kernels/sparse/cpu/conv.h"
+
+namespace phi {
+namespace tests {
+
+using Voxel = std::tuple<int, int, int, int>;  // batch, z, y, x
+
+// Random voxels of a batch of (D, H, W) grids. Like a lidar sweep, most of
+// them lie on a few surfaces, the rest are scattered.
+static std::vector<Voxel> MakeVoxels(
+    int batch, int d, int h, int w, int num, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::set<Voxel> voxels;
+  while (static_cast<int>(voxels.size()) < num) {
+    int b = rng() % batch;
+    int y = rng() % h;
+    int x = rng() % w;
+    int z = rng() % 4 == 0 ? static_cast<int>(rng() % d)
+                           : (x / 8 + y / 16) % d;  // a sloped ground
+    voxels.emplace(b, z, y, x);
+  }
+  return std::vector<Voxel>(voxels.begin(), voxels.end());
+}
+
+static SparseCooTensor MakeCoo(const CPUContext& dev_ctx,
+                               const std::vector<Voxel>& voxels,
+                               const DDim& dims,
+                               std::mt19937* rng) {
+  const int nnz = voxels.size();
+  const int channels = dims[4];
+  DenseTensor indices = phi::Empty(
+      dev_ctx, DenseTensorMeta(DataType::INT32, {4, nnz}, DataLayout::NCHW));
+  DenseTensor values = phi::Empty(
+      dev_ctx,
+      DenseTensorMeta(DataType::FLOAT32, {nnz, channels}, DataLayout::NCHW));
+  int* indices_ptr = indices.data<int>();
+  for (int i = 0; i < nnz; i++) {
+    indices_ptr[i] = std::get<0>(voxels[i]);
+    indices_ptr[i + nnz] = std::get<1>(voxels[i]);
+    indices_ptr[i + nnz * 2] = std::get<2>(voxels[i]);
+    indices_ptr[i + nnz * 3] = std::get<3>(voxels[i]);
+  }
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  float* values_ptr = values.data<float>();
+  for (int i = 0; i < nnz * channels; i++) values_ptr[i] = dist(*rng);
+  return SparseCooTensor(indices, values, dims);
+}
+
+static DenseTensor MakeKernel(const CPUContext& dev_ctx,
+                              const std::vector<int64_t>& dims,
+                              std::mt19937* rng) {
+  DenseTensor kernel = phi::Empty(
+      dev_ctx, DenseTensorMeta(DataType::FLOAT32, dims, DataLayout::NCHW));
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  float* kernel_ptr = kernel.data<float>();
+  for (int64_t i = 0; i < kernel.numel(); i++) kernel_ptr[i] = dist(*rng);
+  return kernel;
+}
+
+// Checks out against a direct evaluation of the convolution at every
+// output position.
+static void CheckConv3d(const SparseCooTensor& x,
+                        const DenseTensor& kernel,
+                        const std::vector<int>& paddings,
+                        const std::vector<int>& strides,
+                        const bool subm,
+                        const SparseCooTensor& out) {
+  const int64_t nnz = x.nnz();
+  const int* indices = x.indices().data<int>();
+  const float* values = x.values().data<float>();
+  std::map<Voxel, int64_t> in_rows;
+  for (int64_t i = 0; i < nnz; i++) {
+    in_rows[Voxel(indices[i],
+                  indices[i + nnz],
+                  indices[i + nnz * 2],
+                  indices[i + nnz * 3])] = i;
+  }
+  const auto& kdims = kernel.dims();
+  const int in_channels = kdims[3];
+  const int out_channels = kdims[4];
+  const float* kernel_ptr = kernel.data<float>();
+  const auto& out_dims = out.dims();
+
+  std::map<Voxel, std::vector<float>> expected;
+  for (int b = 0; b < out_dims[0]; b++) {
+    for (int z = 0; z < out_dims[1]; z++) {
+      for (int y = 0; y < out_dims[2]; y++) {
+        for (int x = 0; x < out_dims[3]; x++) {
+          if (subm && in_rows.count(Voxel(b, z, y, x)) == 0) continue;
+          std::vector<float> acc(out_channels, 0.f);
+          bool hit = false;
+          for (int kz = 0; kz < kdims[0]; kz++) {
+            for (int ky = 0; ky < kdims[1]; ky++) {
+              for (int kx = 0; kx < kdims[2]; kx++) {
+                int iz = z * strides[0] - paddings[0] + kz;
+                int iy = y * strides[1] - paddings[1] + ky;
+                int ix = x * strides[2] - paddings[2] + kx;
+                auto it = in_rows.find(Voxel(b, iz, iy, ix));
+                if (it == in_rows.end()) continue;
+                hit = true;
+                const float* w =
+                    kernel_ptr + ((kz * kdims[1] + ky) * kdims[2] + kx) *
+                                     in_channels * out_channels;
+                for (int ic = 0; ic < in_channels; ic++) {
+                  float v = values[it->second * in_channels + ic];
+                  for (int oc = 0; oc < out_channels; oc++) {
+                    acc[oc] += v * w[ic * out_channels + oc];
+                  }
+                }
+              }
+            }
+          }
+          if (hit) expected[Voxel(b, z, y, x)] = acc;
+        }
+      }
+    }
+  }
+
+  const int64_t out_nnz = out.nnz();
+  ASSERT_EQ(out_nnz, static_cast<int64_t>(expected.size()));
+  const int* out_indices = out.indices().data<int>();
+  const float* out_values = out.values().data<float>();
+  for (int64_t i = 0; i < out_nnz; i++) {
+    Voxel voxel(out_indices[i],
+                out_indices[i + out_nnz],
+                out_indices[i + out_nnz * 2],
+                out_indices[i + out_nnz * 3]);
+    auto it = expected.find(voxel);
+    ASSERT_TRUE(it != expected.end());
+    for (int oc = 0; oc < out_channels; oc++) {
+      ASSERT_NEAR(out_values[i * out_channels + oc], it->second[oc], 1e-4);
+    }
+  }
+}
+
+TEST(DEV_API, sparse_conv3d) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  std::mt19937 rng(2023);
+  const DDim x_dims = {2, 6, 9, 12, 3};
+  SparseCooTensor x =
+      MakeCoo(*dev_ctx, MakeVoxels(2, 6, 9, 12, 150, 1), x_dims, &rng);
+  DenseTensor kernel = MakeKernel(*dev_ctx, {3, 3, 3, 3, 4}, &rng);
+
+  for (bool subm : {false, true}) {
+    std::vector<int> paddings = {1, 1, 1};
+    std::vector<int> strides = subm ? std::vector<int>{1, 1, 1}
+                                    : std::vector<int>{2, 1, 2};
+    DenseTensor rulebook, counter;
+    SparseCooTensor out = sparse::Conv3dCoo<float>(*dev_ctx,
+                                                   x,
+                                                   kernel,
+                                                   paddings,
+                                                   {1, 1, 1},
+                                                   strides,
+                                                   1,
+                                                   subm,
+                                                   "",
+                                                   &rulebook,
+                                                   &counter);
+    CheckConv3d(x, kernel, paddings, strides, subm, out);
+  }
+}
+
+// Rulebook construction and convolution on a synthetic voxel grid of a
+// lidar sweep, for two stacked submanifold layers that share a rulebook.
+// Run with --gtest_also_run_disabled_tests to time them.
+TEST(DEV_API, DISABLED_sparse_conv3d_benchmark) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  std::mt19937 rng(2023);
+  const int channels = 16;
+  const DDim x_dims = {1, 41, 400, 352, channels};
+  SparseCooTensor x = MakeCoo(
+      *dev_ctx, MakeVoxels(1, 41, 400, 352, 60000, 2), x_dims, &rng);
+  DenseTensor kernel =
+      MakeKernel(*dev_ctx, {3, 3, 3, channels, channels}, &rng);
+
+  auto ms_since = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  std::vector<int> kernel_sizes = {3, 3, 3, channels, channels};
+  std::vector<int> ones = {1, 1, 1};
+  DenseTensor rulebook;
+  std::vector<int> counter(27);
+  auto start = std::chrono::steady_clock::now();
+  sparse::ProductRuleBook<float, CPUContext, int>(*dev_ctx,
+                                                  x,
+                                                  kernel_sizes,
+                                                  ones,
+                                                  ones,
+                                                  ones,
+                                                  x_dims,
+                                                  true,
+                                                  &rulebook,
+                                                  counter.data());
+  double rulebook_ms = ms_since(start);
+
+  DenseTensor unused_rulebook, unused_counter;
+  start = std::chrono::steady_clock::now();
+  SparseCooTensor out1 = sparse::Conv3dCoo<float>(*dev_ctx,
+                                                  x,
+                                                  kernel,
+                                                  ones,
+                                                  ones,
+                                                  ones,
+                                                  1,
+                                                  true,
+                                                  "subm1",
+                                                  &unused_rulebook,
+                                                  &unused_counter);
+  double first_ms = ms_since(start);
+  start = std::chrono::steady_clock::now();
+  SparseCooTensor out2 = sparse::Conv3dCoo<float>(*dev_ctx,
+                                                  out1,
+                                                  kernel,
+                                                  ones,
+                                                  ones,
+                                                  ones,
+                                                  1,
+                                                  true,
+                                                  "subm1",
+                                                  &unused_rulebook,
+                                                  &unused_counter);
+  double cached_ms = ms_since(start);
+  EXPECT_EQ(out2.nnz(), x.nnz());
+
+  LOG(INFO) << "subm conv3d of " << x.nnz() << " voxels, " << channels
+            << " -> " << channels << " channels, " << rulebook.dims()[1]
+            << " rules: rulebook " << rulebook_ms << " ms, conv "
+            << first_ms << " ms, conv with cached rulebook " << cached_ms
+            << " ms";
+}
+
+}  // namespace tests
+}  // namespace phi
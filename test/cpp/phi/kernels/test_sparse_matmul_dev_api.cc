@@ -0,0 +1,285 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/sparse_csr_tensor.h"
+#include "paddle/phi/kernels/empty_kernel.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/sparse/matmul_grad_kernel.h"
+#include "paddle/phi/kernels/sparse/matmul_kernel.h"
+
+namespace phi {
+namespace tests {
+
+// A batch of random (rows, cols) matrices, dense and as CSR. Every element
+// is non zero with probability density, and the first row of every matrix
+// is dense, like a global token of sparse attention.
+static SparseCsrTensor MakeCsr(const CPUContext& dev_ctx,
+                               const std::vector<int64_t>& dims,
+                               float density,
+                               std::mt19937* rng,
+                               std::vector<float>* dense) {
+  const int64_t rows = dims[dims.size() - 2];
+  const int64_t cols = dims[dims.size() - 1];
+  const int64_t batch = dims.size() == 3 ? dims[0] : 1;
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::bernoulli_distribution keep(density);
+
+  dense->assign(batch * rows * cols, 0.f);
+  std::vector<int64_t> crows, col_indices;
+  std::vector<float> values;
+  for (int64_t b = 0; b < batch; ++b) {
+    crows.push_back(0);
+    int64_t nnz = 0;
+    for (int64_t i = 0; i < rows; ++i) {
+      for (int64_t j = 0; j < cols; ++j) {
+        if (i > 0 && !keep(*rng)) continue;
+        float v = dist(*rng);
+        (*dense)[(b * rows + i) * cols + j] = v;
+        col_indices.push_back(j);
+        values.push_back(v);
+        ++nnz;
+      }
+      crows.push_back(nnz);
+    }
+  }
+
+  const int64_t nnz = values.size();
+  DenseTensor crows_t = phi::Empty<int64_t>(
+      dev_ctx, {static_cast<int64_t>(crows.size())});
+  DenseTensor cols_t = phi::Empty<int64_t>(dev_ctx, {nnz});
+  DenseTensor values_t = phi::Empty<float>(dev_ctx, {nnz});
+  std::copy(crows.begin(), crows.end(), crows_t.data<int64_t>());
+  std::copy(col_indices.begin(), col_indices.end(), cols_t.data<int64_t>());
+  std::copy(values.begin(), values.end(), values_t.data<float>());
+  return SparseCsrTensor(crows_t, cols_t, values_t, phi::make_ddim(dims));
+}
+
+static DenseTensor MakeDense(const CPUContext& dev_ctx,
+                             const std::vector<int64_t>& dims,
+                             std::mt19937* rng) {
+  DenseTensor t = phi::Empty<float>(dev_ctx, dims);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  float* ptr = t.data<float>();
+  for (int64_t i = 0; i < t.numel(); ++i) ptr[i] = dist(*rng);
+  return t;
+}
+
+// out(b) = op(x(b)) * op(y(b)) for row major batched matrices
+static std::vector<float> DenseMatmul(const float* x,
+                                      const float* y,
+                                      int64_t batch,
+                                      int64_t m,
+                                      int64_t k,
+                                      int64_t n,
+                                      bool trans_x,
+                                      bool trans_y) {
+  std::vector<float> out(batch * m * n, 0.f);
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t i = 0; i < m; ++i) {
+      for (int64_t j = 0; j < n; ++j) {
+        float acc = 0.f;
+        for (int64_t l = 0; l < k; ++l) {
+          float xv = trans_x ? x[(b * k + l) * m + i] : x[(b * m + i) * k + l];
+          float yv = trans_y ? y[(b * n + j) * k + l] : y[(b * k + l) * n + j];
+          acc += xv * yv;
+        }
+        out[(b * m + i) * n + j] = acc;
+      }
+    }
+  }
+  return out;
+}
+
+static void ExpectNear(const float* actual,
+                       const std::vector<float>& expected) {
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(actual[i], expected[i], 1e-4) << "at " << i;
+  }
+}
+
+// Gathers the dense elements at the non zeros of csr, in its order.
+static std::vector<float> AtNonZeros(const std::vector<float>& dense,
+                                     const SparseCsrTensor& csr) {
+  const auto& dims = csr.dims();
+  const int64_t rows = dims[dims.size() - 2];
+  const int64_t cols = dims[dims.size() - 1];
+  const int64_t batch = dims.size() == 3 ? dims[0] : 1;
+  const int64_t* crows = csr.crows().data<int64_t>();
+  const int64_t* col_indices = csr.cols().data<int64_t>();
+  std::vector<float> out;
+  int64_t offset = 0;
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t i = 0; i < rows; ++i) {
+      const int64_t* row = crows + b * (rows + 1) + i;
+      for (int64_t j = offset + row[0]; j < offset + row[1]; ++j) {
+        out.push_back(dense[(b * rows + i) * cols + col_indices[j]]);
+      }
+    }
+    offset += crows[b * (rows + 1) + rows];
+  }
+  return out;
+}
+
+TEST(DEV_API, sparse_matmul_csr_dense) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  std::mt19937 rng(2023);
+  for (int64_t batch : {1, 3}) {
+    const int64_t m = 17, k = 13, n = 9;
+    std::vector<int64_t> x_dims = {m, k}, y_dims = {k, n};
+    if (batch > 1) {
+      x_dims.insert(x_dims.begin(), batch);
+      y_dims.insert(y_dims.begin(), batch);
+    }
+    std::vector<float> dense_x;
+    SparseCsrTensor x = MakeCsr(*dev_ctx, x_dims, 0.3f, &rng, &dense_x);
+    DenseTensor y = MakeDense(*dev_ctx, y_dims, &rng);
+    DenseTensor out;
+    sparse::MatmulCsrDenseKernel<float>(*dev_ctx, x, y, &out);
+    std::vector<float> expected = DenseMatmul(
+        dense_x.data(), y.data<float>(), batch, m, k, n, false, false);
+    ExpectNear(out.data<float>(), expected);
+
+    DenseTensor dout = MakeDense(*dev_ctx, phi::vectorize(out.dims()), &rng);
+    SparseCsrTensor dx;
+    DenseTensor dy;
+    sparse::MatmulCsrDenseGradKernel<float>(*dev_ctx, x, y, dout, &dx, &dy);
+    std::vector<float> expected_dx = DenseMatmul(
+        dout.data<float>(), y.data<float>(), batch, m, n, k, false, true);
+    ExpectNear(dx.values().data<float>(), AtNonZeros(expected_dx, x));
+    ExpectNear(dy.data<float>(),
+               DenseMatmul(dense_x.data(),
+                           dout.data<float>(),
+                           batch,
+                           k,
+                           m,
+                           n,
+                           true,
+                           false));
+  }
+}
+
+TEST(DEV_API, sparse_masked_matmul_csr) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  std::mt19937 rng(2023);
+  for (int64_t batch : {1, 3}) {
+    const int64_t m = 17, k = 13, n = 9;
+    std::vector<int64_t> x_dims = {m, k}, y_dims = {k, n}, mask_dims = {m, n};
+    if (batch > 1) {
+      x_dims.insert(x_dims.begin(), batch);
+      y_dims.insert(y_dims.begin(), batch);
+      mask_dims.insert(mask_dims.begin(), batch);
+    }
+    DenseTensor x = MakeDense(*dev_ctx, x_dims, &rng);
+    DenseTensor y = MakeDense(*dev_ctx, y_dims, &rng);
+    std::vector<float> dense_mask;
+    SparseCsrTensor mask =
+        MakeCsr(*dev_ctx, mask_dims, 0.3f, &rng, &dense_mask);
+    SparseCsrTensor out;
+    sparse::MaskedMatmulCsrKernel<float>(*dev_ctx, x, y, mask, &out);
+    std::vector<float> expected = DenseMatmul(
+        x.data<float>(), y.data<float>(), batch, m, k, n, false, false);
+    ExpectNear(out.values().data<float>(), AtNonZeros(expected, mask));
+
+    // the mask doubles as dout
+    DenseTensor dx, dy;
+    sparse::MaskedMatmulCsrGradKernel<float>(*dev_ctx, x, y, mask, &dx, &dy);
+    ExpectNear(dx.data<float>(),
+               DenseMatmul(dense_mask.data(),
+                           y.data<float>(),
+                           batch,
+                           m,
+                           n,
+                           k,
+                           false,
+                           true));
+    ExpectNear(dy.data<float>(),
+               DenseMatmul(x.data<float>(),
+                           dense_mask.data(),
+                           batch,
+                           k,
+                           m,
+                           n,
+                           true,
+                           false));
+  }
+}
+
+// SpMM and SDDMM of a (4096, 4096) sparse matrix and 64 dense columns, as
+// in sparse attention, against a dense gemm of the same shape.
+// Run with --gtest_also_run_disabled_tests to time them.
+TEST(DEV_API, DISABLED_sparse_matmul_benchmark) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  std::mt19937 rng(2023);
+  const int64_t m = 4096, k = 4096, n = 64;
+  DenseTensor y = MakeDense(*dev_ctx, {k, n}, &rng);
+  DenseTensor q = MakeDense(*dev_ctx, {m, n}, &rng);
+  DenseTensor trans_y = MakeDense(*dev_ctx, {n, k}, &rng);
+
+  auto ms_since = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  std::vector<float> dense_x;
+  for (float density : {0.3f, 0.1f, 0.01f, 0.001f}) {
+    SparseCsrTensor x = MakeCsr(*dev_ctx, {m, k}, density, &rng, &dense_x);
+    DenseTensor x_dense = phi::Empty<float>(*dev_ctx, {m, k});
+    std::copy(dense_x.begin(), dense_x.end(), x_dense.data<float>());
+
+    DenseTensor out;
+    sparse::MatmulCsrDenseKernel<float>(*dev_ctx, x, y, &out);
+    auto start = std::chrono::steady_clock::now();
+    sparse::MatmulCsrDenseKernel<float>(*dev_ctx, x, y, &out);
+    double spmm_ms = ms_since(start);
+
+    SparseCsrTensor masked;
+    start = std::chrono::steady_clock::now();
+    sparse::MaskedMatmulCsrKernel<float>(*dev_ctx, q, trans_y, x, &masked);
+    double sddmm_ms = ms_since(start);
+
+    auto blas = phi::funcs::GetBlas<CPUContext, float>(*dev_ctx);
+    DenseTensor dense_out = phi::Empty<float>(*dev_ctx, {m, n});
+    start = std::chrono::steady_clock::now();
+    blas.GEMM(CblasNoTrans,
+              CblasNoTrans,
+              m,
+              n,
+              k,
+              1.f,
+              x_dense.data<float>(),
+              y.data<float>(),
+              0.f,
+              dense_out.data<float>());
+    double gemm_ms = ms_since(start);
+
+    LOG(INFO) << "density " << density << ", nnz " << x.nnz() << ": spmm "
+              << spmm_ms << " ms, sddmm " << sddmm_ms << " ms, dense gemm "
+              << gemm_ms << " ms";
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -15,8 +15,11 @@ limitations under the License. */
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
+#include <random>
 #include <string>
+#include <vector>
 
 #include "glog/logging.h"
 
@@ -28,6 +31,7 @@ limitations under the License. */
 #include "paddle/phi/core/string_tensor.h"
 #include "paddle/phi/kernels/strings/strings_empty_kernel.h"
 #include "paddle/phi/kernels/strings/strings_lower_upper_kernel.h"
+#include "paddle/phi/kernels/strings/unicode.h"
 namespace phi {
 namespace tests {
 
@@ -128,5 +132,150 @@ TEST(DEV_API, strings_cast_convert_utf8) {
   ASSERT_EQ(dense_upper_out.data()[0].data(), expected_results[1]);
 }
 
+TEST(DEV_API, strings_cast_convert_mixed) {
+  // ASCII strings of every length around the 8 chars handled at a time,
+  // with the chars just outside of the letter ranges, along with UTF-8
+  // strings and a stray continuation byte
+  std::vector<std::string> strs;
+  for (size_t len = 0; len < 20; ++len) {
+    std::string str;
+    for (size_t i = 0; i < len; ++i) {
+      str.push_back("@AZ[`az{Hw 9~"[i % 13]);
+    }
+    strs.push_back(str);
+  }
+  strs.push_back("Déjà VU Ëë");
+  strs.push_back("ABC\x80" "def");
+
+  const DDim dims({static_cast<int64_t>(strs.size())});
+  StringTensorMeta meta(dims);
+  phi::DeviceContextPool& pool = phi::DeviceContextPool::Instance();
+  auto* dev_ctx = static_cast<phi::CPUContext*>(pool.Get(phi::CPUPlace()));
+  const auto string_allocator =
+      std::make_unique<paddle::experimental::DefaultAllocator>(phi::CPUPlace());
+  StringTensor dense_x(string_allocator.get(), meta);
+  pstring* dense_x_data = dev_ctx->template Alloc<pstring>(&dense_x);
+  for (size_t i = 0; i < strs.size(); ++i) {
+    dense_x_data[i] = strs[i];
+  }
+
+  for (bool use_utf8_encoding : {false, true}) {
+    auto lower_out =
+        phi::strings::StringLower(*dev_ctx, dense_x, use_utf8_encoding);
+    auto upper_out =
+        phi::strings::StringUpper(*dev_ctx, dense_x, use_utf8_encoding);
+    for (size_t i = 0; i + 2 < strs.size(); ++i) {
+      std::string lower = strs[i], upper = strs[i];
+      std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+      std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+      ASSERT_EQ(lower, lower_out.data()[i]);
+      ASSERT_EQ(upper, upper_out.data()[i]);
+    }
+    const size_t utf8 = strs.size() - 2, stray = strs.size() - 1;
+    if (use_utf8_encoding) {
+      ASSERT_EQ(std::string("déjà vu ëë"), lower_out.data()[utf8]);
+      ASSERT_EQ(std::string("DÉJÀ VU ËË"), upper_out.data()[utf8]);
+    } else {
+      ASSERT_EQ(std::string("déjà vu Ëë"), lower_out.data()[utf8]);
+      ASSERT_EQ(std::string("DéJà VU Ëë"), upper_out.data()[utf8]);
+    }
+    ASSERT_EQ(std::string("abc\x80" "def"), lower_out.data()[stray]);
+    ASSERT_EQ(std::string("ABC\x80" "DEF"), upper_out.data()[stray]);
+  }
+}
+
+// Lower case of 1e6 short ASCII strings and of 1e5 longer UTF-8 ones,
+// against the former kernels: a char at a time with std::transform for
+// ASCII, and decoding into a buffer of unicode chars then encoding again for
+// UTF-8.
+// Run with --gtest_also_run_disabled_tests to time them.
+TEST(DEV_API, DISABLED_strings_cast_convert_benchmark) {
+  phi::DeviceContextPool& pool = phi::DeviceContextPool::Instance();
+  auto* dev_ctx = static_cast<phi::CPUContext*>(pool.Get(phi::CPUPlace()));
+  const auto string_allocator =
+      std::make_unique<paddle::experimental::DefaultAllocator>(phi::CPUPlace());
+  std::mt19937 rng(2023);
+  const char* ascii_chars =
+      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ ,.";
+  const char* utf8_chars[] = {"a", "Q", "é", "Ó", "ß", "中", " "};
+
+  auto ms_since = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  for (bool use_utf8_encoding : {false, true}) {
+    const int64_t num = use_utf8_encoding ? 100000 : 1000000;
+    StringTensor x(string_allocator.get(), StringTensorMeta(DDim({num})));
+    pstring* x_data = dev_ctx->template Alloc<pstring>(&x);
+    for (int64_t i = 0; i < num; ++i) {
+      std::string str;
+      const size_t len = use_utf8_encoding ? 64 : 8 + rng() % 40;
+      for (size_t j = 0; j < len; ++j) {
+        if (use_utf8_encoding) {
+          str += utf8_chars[rng() % 7];
+        } else {
+          str.push_back(ascii_chars[rng() % 55]);
+        }
+      }
+      x_data[i] = str;
+    }
+
+    // the best of a few runs of each, both allocating their output
+    double kernel_ms = 1e30, former_ms = 1e30;
+    for (int r = 0; r < 3; ++r) {
+      auto start = std::chrono::steady_clock::now();
+      auto out = phi::strings::StringLower(*dev_ctx, x, use_utf8_encoding);
+      kernel_ms = std::min(kernel_ms, ms_since(start));
+
+      start = std::chrono::steady_clock::now();
+      StringTensor former(string_allocator.get(),
+                          StringTensorMeta(DDim({num})));
+      pstring* former_out = dev_ctx->template Alloc<pstring>(&former);
+      if (!use_utf8_encoding) {
+        for (int64_t i = 0; i < num; ++i) {
+          former_out[i].resize(x_data[i].size());
+          std::transform(x_data[i].begin(),
+                         x_data[i].end(),
+                         former_out[i].mdata(),
+                         phi::strings::AsciiToLower());
+        }
+      } else {
+        auto unicode_flag_map = phi::strings::GetUniFlagMap();
+        auto cases_map = phi::strings::GetCharcasesMap();
+        phi::strings::UTF8ToLower<phi::CPUContext> converter(unicode_flag_map,
+                                                             cases_map);
+        for (int64_t i = 0; i < num; ++i) {
+          uint32_t unicode_len = phi::strings::GetUnicodeStrLen(
+              x_data[i].data(), x_data[i].size());
+          std::vector<uint32_t> unicode_in(unicode_len, 0);
+          phi::strings::GetUnicodeStr(
+              x_data[i].data(), unicode_in.data(), unicode_len);
+          std::transform(unicode_in.begin(),
+                         unicode_in.end(),
+                         unicode_in.begin(),
+                         converter);
+          uint32_t utf8_len =
+              phi::strings::GetUTF8StrLen(unicode_in.data(), unicode_len);
+          std::vector<char> result(utf8_len, 0);
+          phi::strings::GetUTF8Str(
+              unicode_in.data(), result.data(), unicode_len);
+          former_out[i] = result.data();
+        }
+      }
+      former_ms = std::min(former_ms, ms_since(start));
+
+      for (int64_t i = 0; i < num; i += 997) {
+        ASSERT_EQ(former_out[i], out.data()[i]);
+      }
+    }
+
+    LOG(INFO) << "lower case of " << num
+              << (use_utf8_encoding ? " utf8" : " ascii") << " strings: "
+              << kernel_ms << " ms, former kernel " << former_ms << " ms";
+  }
+}
+
 }  // namespace tests
 }  // namespace phi
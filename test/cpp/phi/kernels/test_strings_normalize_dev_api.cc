@@ -0,0 +1,136 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/api/lib/utils/allocator.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/pstring.h"
+#include "paddle/phi/core/string_tensor.h"
+#include "paddle/phi/kernels/strings/strings_length_truncate_kernel.h"
+#include "paddle/phi/kernels/strings/strings_split_kernel.h"
+#include "paddle/phi/kernels/strings/strings_strip_accents_kernel.h"
+
+namespace phi {
+namespace tests {
+
+using DDim = phi::DDim;
+using pstring = phi::dtype::pstring;
+
+static StringTensor MakeStrings(const phi::CPUContext& dev_ctx,
+                                const std::vector<std::string>& strs) {
+  const auto string_allocator =
+      std::make_unique<paddle::experimental::DefaultAllocator>(phi::CPUPlace());
+  StringTensor x(string_allocator.get(),
+                 StringTensorMeta(DDim({static_cast<int64_t>(strs.size())})));
+  pstring* x_data = dev_ctx.template Alloc<pstring>(&x);
+  for (size_t i = 0; i < strs.size(); ++i) {
+    x_data[i] = strs[i];
+  }
+  return x;
+}
+
+TEST(DEV_API, strings_split) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  StringTensor x = MakeStrings(
+      *dev_ctx, {"  Hello, world!  ", "single", "", "中文。標點　全角"});
+
+  StringTensor out = phi::strings::StringSplit(*dev_ctx, x, true, true);
+  ASSERT_EQ(out.dims(), DDim({4, 4}));
+  const std::vector<std::string> expected = {"Hello",
+                                             ",",
+                                             "world",
+                                             "!",
+                                             "single",
+                                             "",
+                                             "",
+                                             "",
+                                             "",
+                                             "",
+                                             "",
+                                             "",
+                                             "中文",
+                                             "。",
+                                             "標點",
+                                             "全角"};
+  for (int64_t i = 0; i < out.numel(); ++i) {
+    ASSERT_EQ(std::string(out.data()[i].data(), out.data()[i].size()),
+              expected[i]);
+  }
+
+  // punctuation stays in the words, ASCII whitespace only
+  out = phi::strings::StringSplit(*dev_ctx, x, false, false);
+  ASSERT_EQ(out.dims(), DDim({4, 2}));
+  ASSERT_EQ(out.data()[0], "Hello,");
+  ASSERT_EQ(out.data()[1], "world!");
+  ASSERT_EQ(out.data()[6], "中文。標點　全角");
+}
+
+TEST(DEV_API, strings_strip_accents) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  StringTensor x = MakeStrings(*dev_ctx,
+                               {"Crème Brûlée à São Paulo",
+                                "plain ascii",
+                                "Ångström, naïve"});
+  StringTensor out = phi::strings::StringStripAccents(*dev_ctx, x);
+  ASSERT_EQ(out.numel(), 3);
+  ASSERT_EQ(out.data()[0], "Creme Brulee a Sao Paulo");
+  ASSERT_EQ(out.data()[1], "plain ascii");
+  ASSERT_EQ(out.data()[2], "Angstrom, naive");
+}
+
+TEST(DEV_API, strings_length_truncate) {
+  auto* dev_ctx = reinterpret_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  const std::string long_str =
+      "A Large Pstring Whose Length Is Longer Than 22.";
+  const std::string utf8_str = "aé€😀aé€😀aé€😀aé€😀";
+  StringTensor x = MakeStrings(*dev_ctx, {long_str, utf8_str, ""});
+
+  DenseTensor bytes = phi::strings::StringLength(*dev_ctx, x, false);
+  DenseTensor chars = phi::strings::StringLength(*dev_ctx, x, true);
+  ASSERT_EQ(bytes.data<int64_t>()[0], static_cast<int64_t>(long_str.size()));
+  ASSERT_EQ(bytes.data<int64_t>()[1], static_cast<int64_t>(utf8_str.size()));
+  ASSERT_EQ(bytes.data<int64_t>()[2], 0);
+  ASSERT_EQ(chars.data<int64_t>()[0], static_cast<int64_t>(long_str.size()));
+  ASSERT_EQ(chars.data<int64_t>()[1], 16);
+  ASSERT_EQ(chars.data<int64_t>()[2], 0);
+
+  for (int max_length = 0; max_length <= 50; ++max_length) {
+    StringTensor out =
+        phi::strings::StringTruncate(*dev_ctx, x, max_length, true);
+    ASSERT_EQ(out.data()[0], long_str.substr(0, max_length));
+    // the unicode char that doesn't fit is dropped as a whole
+    const std::string truncated(out.data()[1].data(), out.data()[1].size());
+    ASSERT_LE(truncated.size(), static_cast<size_t>(max_length));
+    ASSERT_EQ(utf8_str.compare(0, truncated.size(), truncated), 0);
+    ASSERT_TRUE(truncated.size() == utf8_str.size() ||
+                (utf8_str[truncated.size()] & 0xC0) != 0x80);
+    ASSERT_GT(truncated.size() + 4,
+              std::min<size_t>(max_length, utf8_str.size()));
+
+    out = phi::strings::StringTruncate(*dev_ctx, x, max_length, false);
+    ASSERT_EQ(out.data()[1], utf8_str.substr(0, max_length));
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
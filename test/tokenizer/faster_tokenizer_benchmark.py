@@ -0,0 +1,104 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Measures the throughput of the faster_tokenizer op against the python
+# BertTokenizer on the vocab of a released BERT model, e.g.
+#   python faster_tokenizer_benchmark.py --model bert-base-uncased
+
+import argparse
+import random
+import time
+
+from bert_tokenizer import BertTokenizer
+from test_faster_tokenizer_op import FasterTokenizer, to_string_tensor
+
+import paddle
+
+ZH_TEXT = (
+    '选择珠江花园的原因就是方便，有电动扶梯直接到达海边，周围餐馆、食廊、商场、'
+    '超市、摊位一应俱全。酒店装修一般，但还算整洁。 泳池在大堂的屋顶，因此很小，'
+    '不过女儿倒是喜欢。 包的早餐是西式的，还算丰富。 服务吗，一般'
+)
+EN_TEXT = (
+    'Tokenization is now a visible share of the end-to-end latency of BERT '
+    'serving. The unaffable reviewer re-tokenized everything, including '
+    'hyphenated-words, numbers like 3.1415926 and URLs like paddlepaddle.org.'
+)
+
+
+def make_texts(num, seed=2023):
+    rng = random.Random(seed)
+    words = (EN_TEXT + ' ' + ZH_TEXT).split(' ')
+    texts = []
+    for _ in range(num):
+        rng.shuffle(words)
+        texts.append(' '.join(words[: rng.randint(4, len(words))]))
+    return texts
+
+
+def bench(fn, iters):
+    fn()
+    start = time.time()
+    for _ in range(iters):
+        fn()
+    return (time.time() - start) / iters
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--model", type=str, default="bert-base-chinese")
+    parser.add_argument("--max_seq_len", type=int, default=128)
+    parser.add_argument("--iters", type=int, default=20)
+    args = parser.parse_args()
+
+    paddle.set_device("cpu")
+    py_tokenizer = BertTokenizer.from_pretrained(args.model)
+    faster_tokenizer = FasterTokenizer(py_tokenizer.vocab)
+    do_lower_case = py_tokenizer.do_lower_case
+
+    for batch_size in [1, 8, 32, 128, 512]:
+        texts = make_texts(batch_size)
+        num_bytes = sum(len(text.encode("utf-8")) for text in texts)
+        texts_tensor = to_string_tensor(texts, "texts")
+
+        def run_op():
+            faster_tokenizer(
+                text=texts_tensor,
+                do_lower_case=do_lower_case,
+                max_seq_len=args.max_seq_len,
+                pad_to_max_seq_len=True,
+            )
+
+        def run_py():
+            py_tokenizer(
+                text=texts,
+                max_seq_len=args.max_seq_len,
+                pad_to_max_seq_len=True,
+            )
+
+        op_seconds = bench(run_op, args.iters)
+        py_seconds = bench(run_py, max(1, args.iters // 10))
+        print(
+            "batch {:>4}: faster_tokenizer {:>10.1f} seq/s {:>7.2f} MB/s, "
+            "python {:>9.1f} seq/s".format(
+                batch_size,
+                batch_size / op_seconds,
+                num_bytes / op_seconds / 1e6,
+                batch_size / py_seconds,
+            )
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -432,5 +432,77 @@ class TestBertTokenizerOp(unittest.TestCase):
         paddle.disable_static()
 
 
+class TestFasterTokenizerOpSmallVocab(unittest.TestCase):
+    def setUp(self):
+        # [PAD] is not 0, so that padding is told apart from zeros.
+        vocab = [
+            "[UNK]",
+            "[CLS]",
+            "[SEP]",
+            "[MASK]",
+            "[PAD]",
+            "un",
+            "##aff",
+            "##able",
+            "hello",
+            ",",
+            "中",
+            "##s",
+            "world",
+        ]
+        self.vocab = {token: i for i, token in enumerate(vocab)}
+        self.faster_tokenizer = FasterTokenizer(self.vocab)
+        self.texts_tensor = to_string_tensor(
+            ["Unaffable, hello worlds 中 xyz", "hello"], "texts"
+        )
+        self.text_pairs_tensor = to_string_tensor(
+            ["hello", "中"], "text_pairs"
+        )
+
+    def test_padding(self):
+        input_ids, token_type_ids = self.faster_tokenizer(
+            text=self.texts_tensor, do_lower_case=True
+        )
+        np.testing.assert_array_equal(
+            input_ids.numpy(),
+            [
+                [1, 5, 6, 7, 9, 8, 12, 11, 10, 0, 2],
+                [1, 8, 2, 4, 4, 4, 4, 4, 4, 4, 4],
+            ],
+        )
+        np.testing.assert_array_equal(
+            token_type_ids.numpy(), np.zeros([2, 11], dtype="int64")
+        )
+
+    def test_truncation_and_pad_to_max_seq_len(self):
+        input_ids, token_type_ids = self.faster_tokenizer(
+            text=self.texts_tensor,
+            text_pair=self.text_pairs_tensor,
+            do_lower_case=True,
+            max_seq_len=8,
+            pad_to_max_seq_len=True,
+        )
+        np.testing.assert_array_equal(
+            input_ids.numpy(),
+            [[1, 5, 6, 7, 9, 2, 8, 2], [1, 8, 2, 10, 2, 4, 4, 4]],
+        )
+        np.testing.assert_array_equal(
+            token_type_ids.numpy(),
+            [[0, 0, 0, 0, 0, 0, 1, 1], [0, 0, 0, 1, 1, 0, 0, 0]],
+        )
+
+    def test_vocab_with_other_ids(self):
+        # Same tokens, other ids: the cached trie of the first vocab must not
+        # be reused for the second one.
+        text = to_string_tensor(["hello"], "text")
+        input_ids, _ = self.faster_tokenizer(text=text)
+        np.testing.assert_array_equal(input_ids.numpy(), [[1, 8, 2]])
+        reversed_vocab = {
+            token: len(self.vocab) - 1 - i for token, i in self.vocab.items()
+        }
+        input_ids, _ = FasterTokenizer(reversed_vocab)(text=text)
+        np.testing.assert_array_equal(input_ids.numpy(), [[11, 4, 10]])
+
+
 if __name__ == '__main__':
     unittest.main()